@@ -77,6 +77,28 @@ EntitiesInText EntitiesFromMTP(
 	return result;
 }
 
+void ResolveMentionNames(
+		not_null<Main::Session*> session,
+		EntitiesInText &entities) {
+	for (auto &entity : entities) {
+		if (entity.type() != EntityType::MentionName) {
+			continue;
+		}
+		const auto fields = MentionNameDataToFields(entity.data());
+		if (fields.accessHash) {
+			continue;
+		} else if (const auto user = session->data().userLoaded(fields.userId)) {
+			entity = EntityInText(
+				EntityType::MentionName,
+				entity.offset(),
+				entity.length(),
+				MentionNameDataFromFields({
+					fields.userId,
+					user->accessHash() }));
+		}
+	}
+}
+
 MTPVector<MTPMessageEntity> EntitiesToMTP(
 		not_null<Main::Session*> session,
 		const EntitiesInText &entities,
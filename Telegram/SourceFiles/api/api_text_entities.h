@@ -24,6 +24,12 @@ enum class ConvertOption {
 	Main::Session *session,
 	const QVector<MTPMessageEntity> &entities);
 
+// Entities parsed without a session (for example on a worker thread)
+// don't have access hashes in mention names, they are filled here.
+void ResolveMentionNames(
+	not_null<Main::Session*> session,
+	EntitiesInText &entities);
+
 [[nodiscard]] MTPVector<MTPMessageEntity> EntitiesToMTP(
 	not_null<Main::Session*> session,
 	const EntitiesInText &entities,
@@ -55,6 +55,9 @@ constexpr auto kNoUpdatesTimeout = 60 * 1000;
 // If nothing is received in 1 min when was a sleepmode we ping.
 constexpr auto kNoUpdatesAfterSleepTimeout = 60 * crl::time(1000);
 
+// Texts of differences with that many new messages are parsed on a worker.
+constexpr auto kPrepareTextsInBackgroundCount = 64;
+
 enum class DataIsLoadedResult {
 	NotLoaded = 0,
 	FromNotLoaded = 1,
@@ -62,6 +65,48 @@ enum class DataIsLoadedResult {
 	Ok = 3,
 };
 
+[[nodiscard]] QVector<MTPMessage> DifferenceMessages(
+		const MTPupdates_Difference &difference) {
+	return difference.match([](const MTPDupdates_difference &data) {
+		return data.vnew_messages().v;
+	}, [](const MTPDupdates_differenceSlice &data) {
+		return data.vnew_messages().v;
+	}, [](const auto &) {
+		return QVector<MTPMessage>();
+	});
+}
+
+[[nodiscard]] QVector<MTPMessage> DifferenceMessages(
+		const MTPupdates_ChannelDifference &difference) {
+	return difference.match([](const MTPDupdates_channelDifference &data) {
+		return data.vnew_messages().v;
+	}, [](const MTPDupdates_channelDifferenceTooLong &data) {
+		return data.vmessages().v;
+	}, [](const MTPDupdates_channelDifferenceEmpty &) {
+		return QVector<MTPMessage>();
+	});
+}
+
+// Called on a worker thread, doesn't touch the session.
+[[nodiscard]] base::flat_map<FullMsgId, TextWithEntities> PrepareTexts(
+		const QVector<MTPMessage> &messages) {
+	auto result = base::flat_map<FullMsgId, TextWithEntities>();
+	for (const auto &message : messages) {
+		if (message.type() != mtpc_message) {
+			continue;
+		}
+		const auto &data = message.c_message();
+		const auto channel = peerToChannel(PeerFromMessage(message));
+		result.emplace(FullMsgId(channel, data.vid().v), TextWithEntities{
+			TextUtilities::Clean(qs(data.vmessage())),
+			Api::EntitiesFromMTP(
+				nullptr,
+				data.ventities().value_or_empty())
+		});
+	}
+	return result;
+}
+
 bool IsForceLogoutNotification(const MTPDupdateServiceNotification &data) {
 	return qs(data.vtype()).startsWith(qstr("AUTH_KEY_DROP_"));
 }
@@ -250,6 +295,10 @@ void Updates::checkLastUpdate(bool afterSleep) {
 void Updates::feedUpdateVector(
 		const MTPVector<MTPUpdate> &updates,
 		bool skipMessageIds) {
+	const auto owner = &session().data();
+	owner->startChatListBatch();
+	const auto batch = gsl::finally([&] { owner->finishChatListBatch(); });
+
 	for (const auto &update : updates.v) {
 		if (skipMessageIds && update.type() == mtpc_updateMessageID) {
 			continue;
@@ -356,6 +405,10 @@ void Updates::channelDifferenceDone(
 
 void Updates::feedChannelDifference(
 		const MTPDupdates_channelDifference &data) {
+	const auto owner = &session().data();
+	owner->startChatListBatch();
+	const auto batch = gsl::finally([&] { owner->finishChatListBatch(); });
+
 	session().data().processUsers(data.vusers());
 	session().data().processChats(data.vchats());
 
@@ -430,32 +483,56 @@ void Updates::differenceDone(const MTPupdates_Difference &result) {
 	};
 }
 
+bool Updates::ChannelDeadlines::set(
+		not_null<ChannelData*> channel,
+		crl::time when) {
+	const auto i = _when.find(channel);
+	if (i == end(_when)) {
+		_when.emplace(channel, when);
+	} else if (i->second > when) {
+		_queue.remove(std::make_pair(i->second, channel));
+		i->second = when;
+	} else {
+		return false;
+	}
+	_queue.emplace(when, channel);
+	return true;
+}
+
+bool Updates::ChannelDeadlines::remove(not_null<ChannelData*> channel) {
+	const auto i = _when.find(channel);
+	if (i == end(_when)) {
+		return false;
+	}
+	_queue.remove(std::make_pair(i->second, channel));
+	_when.erase(i);
+	return true;
+}
+
+crl::time Updates::ChannelDeadlines::next() const {
+	return _queue.empty() ? 0 : _queue.begin()->first;
+}
+
+ChannelData *Updates::ChannelDeadlines::takeExpired(crl::time now) {
+	if (_queue.empty() || _queue.begin()->first > now) {
+		return nullptr;
+	}
+	const auto channel = _queue.begin()->second;
+	_queue.erase(_queue.begin());
+	_when.remove(channel);
+	return channel;
+}
+
 bool Updates::whenGetDiffChanged(
 		ChannelData *channel,
 		int32 ms,
-		base::flat_map<not_null<ChannelData*>, crl::time> &whenMap,
+		ChannelDeadlines &deadlines,
 		crl::time &curTime) {
 	if (channel) {
 		if (ms <= 0) {
-			const auto i = whenMap.find(channel);
-			if (i != whenMap.cend()) {
-				whenMap.erase(i);
-			} else {
-				return false;
-			}
-		} else {
-			auto when = crl::now() + ms;
-			const auto i = whenMap.find(channel);
-			if (i != whenMap.cend()) {
-				if (i->second > when) {
-					i->second = when;
-				} else {
-					return false;
-				}
-			} else {
-				whenMap.emplace(channel, when);
-			}
+			return deadlines.remove(channel);
 		}
+		return deadlines.set(channel, crl::now() + ms);
 	} else {
 		if (ms <= 0) {
 			if (curTime) {
@@ -521,6 +598,10 @@ void Updates::feedDifference(
 		const MTPVector<MTPMessage> &msgs,
 		const MTPVector<MTPUpdate> &other) {
 	Core::App().checkAutoLock();
+	const auto owner = &session().data();
+	owner->startChatListBatch();
+	const auto batch = gsl::finally([&] { owner->finishChatListBatch(); });
+
 	session().data().processUsers(users);
 	session().data().processChats(chats);
 	feedMessageIds(other);
@@ -528,6 +609,34 @@ void Updates::feedDifference(
 	feedUpdateVector(other, true);
 }
 
+void Updates::prepareMessageTexts(
+		QVector<MTPMessage> messages,
+		FnMut<void()> done) {
+	if (messages.size() < kPrepareTextsInBackgroundCount) {
+		done();
+		return;
+	}
+	// The difference stays requested until done() is called,
+	// so the updates received meanwhile wait for it in the PtsWaiter.
+	const auto session = _session;
+	crl::async([
+		=,
+		messages = std::move(messages),
+		done = std::move(done)
+	]() mutable {
+		auto texts = PrepareTexts(messages);
+		crl::on_main(session, [
+			=,
+			texts = std::move(texts),
+			done = std::move(done)
+		]() mutable {
+			session->data().setPreparedMessageTexts(std::move(texts));
+			done();
+			session->data().clearPreparedMessageTexts();
+		});
+	});
+}
+
 void Updates::differenceFail(const RPCError &error) {
 	LOG(("RPC Error in getDifference: %1 %2: %3"
 		).arg(error.code()
@@ -545,16 +654,13 @@ void Updates::getDifferenceByPts() {
 			getDifference();
 		}
 	}
-	for (auto i = _whenGetDiffByPts.begin(); i != _whenGetDiffByPts.cend();) {
-		if (i->second > now) {
-			wait = wait ? std::min(wait, i->second - now) : (i->second - now);
-			++i;
-		} else {
-			getChannelDifference(
-				i->first,
-				ChannelDifferenceRequest::PtsGapOrShortPoll);
-			i = _whenGetDiffByPts.erase(i);
-		}
+	while (const auto channel = _whenGetDiffByPts.takeExpired(now)) {
+		getChannelDifference(
+			channel,
+			ChannelDifferenceRequest::PtsGapOrShortPoll);
+	}
+	if (const auto next = _whenGetDiffByPts.next()) {
+		wait = wait ? std::min(wait, next - now) : (next - now);
 	}
 	if (wait) {
 		_byPtsTimer.callOnce(wait);
@@ -576,14 +682,11 @@ void Updates::getDifferenceAfterFail() {
 			getDifference();
 		}
 	}
-	for (auto i = _whenGetDiffAfterFail.begin(); i != _whenGetDiffAfterFail.cend();) {
-		if (i->second > now) {
-			wait = wait ? std::min(wait, i->second - now) : (i->second - now);
-			++i;
-		} else {
-			getChannelDifference(i->first, ChannelDifferenceRequest::AfterFail);
-			i = _whenGetDiffAfterFail.erase(i);
-		}
+	while (const auto channel = _whenGetDiffAfterFail.takeExpired(now)) {
+		getChannelDifference(channel, ChannelDifferenceRequest::AfterFail);
+	}
+	if (const auto next = _whenGetDiffAfterFail.next()) {
+		wait = wait ? std::min(wait, next - now) : (next - now);
 	}
 	if (wait) {
 		_failDifferenceTimer.callOnce(wait);
@@ -614,7 +717,9 @@ void Updates::getDifference() {
 		MTP_int(_updatesDate),
 		MTP_int(_updatesQts)
 	)).done([=](const MTPupdates_Difference &result) {
-		differenceDone(result);
+		prepareMessageTexts(DifferenceMessages(result), [=] {
+			differenceDone(result);
+		});
 	}).fail([=](const RPCError &error) {
 		differenceFail(error);
 	}).send();
@@ -649,7 +754,9 @@ void Updates::getChannelDifference(
 		MTP_int(channel->pts()),
 		MTP_int(kChannelGetDifferenceLimit)
 	)).done([=](const MTPupdates_ChannelDifference &result) {
-		channelDifferenceDone(channel, result);
+		prepareMessageTexts(DifferenceMessages(result), [=] {
+			channelDifferenceDone(channel, result);
+		});
 	}).fail([=](const RPCError &error) {
 		channelDifferenceFail(channel, error);
 	}).send();
@@ -102,6 +102,12 @@ private:
 		not_null<ChannelData*> channel,
 		const RPCError &error);
 	void failDifferenceStartTimerFor(ChannelData *channel);
+
+	// Parses the message texts of a large difference on a worker thread
+	// and calls done() on the main thread while they are available.
+	void prepareMessageTexts(
+		QVector<MTPMessage> messages,
+		FnMut<void()> done);
 	void feedChannelDifference(const MTPDupdates_channelDifference &data);
 
 	void mtpUpdateReceived(const MTPUpdates &updates);
@@ -114,10 +120,28 @@ private:
 	// Doesn't call sendHistoryChangeNotifications itself.
 	void feedUpdate(const MTPUpdate &update);
 
+	// When to request the difference of each waiting channel, with an
+	// index by time so that one timer serves all of them and only the
+	// expired ones are visited when it fires.
+	class ChannelDeadlines final {
+	public:
+		// Returns false if the channel already waits for an earlier time.
+		bool set(not_null<ChannelData*> channel, crl::time when);
+		bool remove(not_null<ChannelData*> channel);
+
+		[[nodiscard]] crl::time next() const;
+		[[nodiscard]] ChannelData *takeExpired(crl::time now);
+
+	private:
+		base::flat_map<not_null<ChannelData*>, crl::time> _when;
+		base::flat_set<std::pair<crl::time, not_null<ChannelData*>>> _queue;
+
+	};
+
 	bool whenGetDiffChanged(
 		ChannelData *channel,
 		int32 ms,
-		base::flat_map<not_null<ChannelData*>, crl::time> &whenMap,
+		ChannelDeadlines &deadlines,
 		crl::time &curTime);
 
 	const not_null<Main::Session*> _session;
@@ -130,8 +154,8 @@ private:
 
 	PtsWaiter _ptsWaiter;
 
-	base::flat_map<not_null<ChannelData*>, crl::time> _whenGetDiffByPts;
-	base::flat_map<not_null<ChannelData*>, crl::time> _whenGetDiffAfterFail;
+	ChannelDeadlines _whenGetDiffByPts;
+	ChannelDeadlines _whenGetDiffAfterFail;
 	crl::time _getDifferenceTimeByPts = 0;
 	crl::time _getDifferenceTimeAfterFail = 0;
 
@@ -103,12 +103,17 @@ constexpr auto kSharedMediaLimit = 100;
 //constexpr auto kFeedMessagesLimit = 50; // #feed
 constexpr auto kReadFeaturedSetsTimeout = crl::time(1000);
 constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
+constexpr auto kFileLoaderWorkersMax = 4;
 //constexpr auto kFeedReadTimeout = crl::time(1000); // #feed
 constexpr auto kStickersByEmojiInvalidateTimeout = crl::time(60 * 60 * 1000);
+constexpr auto kStickerSetRequestsLimit = 16;
 constexpr auto kNotifySettingSaveTimeout = crl::time(1000);
 constexpr auto kDialogsFirstLoad = 20;
 constexpr auto kDialogsPerPage = 500;
 constexpr auto kBlockedFirstSlice = 16;
+constexpr auto kPeersPerRequest = 100;
+constexpr auto kFullPeerRequestsLimit = 8;
+constexpr auto kFileReferenceMessagesPerRequest = 100;
 
 using PhotoFileLocationId = Data::PhotoFileLocationId;
 using DocumentFileLocationId = Data::DocumentFileLocationId;
@@ -236,14 +241,20 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 : MTP::Sender(&session->account().mtp())
 , _session(session)
 , _messageDataResolveDelayed([=] { resolveMessageDatas(); })
+, _peerResolveDelayed([=] { resolvePeers(); })
 , _webPagesTimer([=] { resolveWebPages(); })
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
 , _dialogsLoadState(std::make_unique<DialogsLoadState>())
-, _fileLoader(std::make_unique<TaskQueue>(kFileLoaderQueueStopTimeout))
+, _fileLoader(std::make_unique<TaskQueue>(
+	kFileLoaderQueueStopTimeout,
+	std::clamp(QThread::idealThreadCount() - 1, 1, kFileLoaderWorkersMax)))
 //, _feedReadTimer([=] { readFeeds(); }) // #feed
 , _topPromotionTimer([=] { refreshTopPromotion(); })
 , _updateNotifySettingsTimer([=] { sendNotifySettingsUpdates(); })
+, _messageFileReferencesResolveDelayed([=] {
+	resolveMessageFileReferences();
+})
 , _selfDestruct(std::make_unique<Api::SelfDestruct>(this))
 , _sensitiveContent(std::make_unique<Api::SensitiveContent>(this)) {
 	crl::on_main(session, [=] {
@@ -1087,11 +1098,22 @@ void ApiWrap::requestFullPeer(not_null<PeerData*> peer) {
 	if (_fullPeerRequests.contains(peer)) {
 		return;
 	}
+	const auto sent = _fullPeerRequests.size()
+		- int(_fullPeerRequestsQueue.size());
+	if (sent >= kFullPeerRequestsLimit) {
+		_fullPeerRequests.insert(peer, 0);
+		_fullPeerRequestsQueue.push_back(peer);
+		return;
+	}
+	sendFullPeerRequest(peer);
+}
 
+void ApiWrap::sendFullPeerRequest(not_null<PeerData*> peer) {
 	const auto requestId = [&] {
 		const auto failHandler = [=](const RPCError &error) {
 			_fullPeerRequests.remove(peer);
 			migrateFail(peer, error);
+			sendQueuedFullPeerRequests();
 		};
 		if (const auto user = peer->asUser()) {
 			if (_session->supportMode()) {
@@ -1125,6 +1147,30 @@ void ApiWrap::requestFullPeer(not_null<PeerData*> peer) {
 	_fullPeerRequests.insert(peer, requestId);
 }
 
+void ApiWrap::finishFullPeerRequest(
+		not_null<PeerData*> peer,
+		mtpRequestId requestId) {
+	const auto i = _fullPeerRequests.find(peer);
+	if (i != _fullPeerRequests.cend() && i.value() == requestId) {
+		_fullPeerRequests.erase(i);
+		sendQueuedFullPeerRequests();
+	}
+}
+
+void ApiWrap::sendQueuedFullPeerRequests() {
+	// The last requested peer is usually the one shown right now.
+	while (!_fullPeerRequestsQueue.empty()) {
+		const auto sent = _fullPeerRequests.size()
+			- int(_fullPeerRequestsQueue.size());
+		if (sent >= kFullPeerRequestsLimit) {
+			return;
+		}
+		const auto peer = _fullPeerRequestsQueue.back();
+		_fullPeerRequestsQueue.pop_back();
+		sendFullPeerRequest(peer);
+	}
+}
+
 void ApiWrap::processFullPeer(
 		not_null<PeerData*> peer,
 		const MTPmessages_ChatFull &result) {
@@ -1164,10 +1210,7 @@ void ApiWrap::gotChatFull(
 	});
 
 	if (req) {
-		const auto i = _fullPeerRequests.find(peer);
-		if (i != _fullPeerRequests.cend() && i.value() == req) {
-			_fullPeerRequests.erase(i);
-		}
+		finishFullPeerRequest(peer, req);
 	}
 	fullPeerUpdated().notify(peer);
 }
@@ -1178,6 +1221,9 @@ void ApiWrap::gotUserFull(
 		mtpRequestId req) {
 	const auto &d = result.c_userFull();
 	if (user == _session->user() && !_session->validateSelf(d.vuser())) {
+		if (req) {
+			finishFullPeerRequest(user, req);
+		}
 		constexpr auto kRequestUserAgainTimeout = crl::time(10000);
 		base::call_delayed(kRequestUserAgainTimeout, _session, [=] {
 			requestFullPeer(user);
@@ -1187,10 +1233,7 @@ void ApiWrap::gotUserFull(
 	Data::ApplyUserUpdate(user, d);
 
 	if (req) {
-		const auto i = _fullPeerRequests.find(user);
-		if (i != _fullPeerRequests.cend() && i.value() == req) {
-			_fullPeerRequests.erase(i);
-		}
+		finishFullPeerRequest(user, req);
 	}
 	fullPeerUpdated().notify(user);
 }
@@ -1200,37 +1243,89 @@ void ApiWrap::requestPeer(not_null<PeerData*> peer) {
 		return;
 	}
 
-	const auto requestId = [&] {
-		const auto failHandler = [=](const RPCError &error) {
-			_peerRequests.remove(peer);
-		};
-		const auto chatHandler = [=](const MTPmessages_Chats &result) {
-			_peerRequests.remove(peer);
-			const auto &chats = result.match([](const auto &data) {
-				return data.vchats();
-			});
-			_session->data().applyMaximumChatVersions(chats);
-			_session->data().processChats(chats);
-		};
+	// Peers requested in one event loop iteration go in the same requests.
+	_peerRequests.insert(peer, 0);
+	_peerResolveDelayed.call();
+}
+
+void ApiWrap::resolvePeers() {
+	auto users = std::vector<not_null<UserData*>>();
+	auto chats = std::vector<not_null<ChatData*>>();
+	auto channels = std::vector<not_null<ChannelData*>>();
+	for (auto i = _peerRequests.cbegin(); i != _peerRequests.cend(); ++i) {
+		if (i.value()) {
+			continue;
+		}
+		const auto peer = i.key();
 		if (const auto user = peer->asUser()) {
-			return request(MTPusers_GetUsers(
-				MTP_vector<MTPInputUser>(1, user->inputUser)
-			)).done([=](const MTPVector<MTPUser> &result) {
-				_peerRequests.remove(user);
-				_session->data().processUsers(result);
-			}).fail(failHandler).send();
+			users.push_back(user);
 		} else if (const auto chat = peer->asChat()) {
-			return request(MTPmessages_GetChats(
-				MTP_vector<MTPint>(1, chat->inputChat)
-			)).done(chatHandler).fail(failHandler).send();
+			chats.push_back(chat);
 		} else if (const auto channel = peer->asChannel()) {
-			return request(MTPchannels_GetChannels(
-				MTP_vector<MTPInputChannel>(1, channel->inputChannel)
-			)).done(chatHandler).fail(failHandler).send();
+			channels.push_back(channel);
+		} else {
+			Unexpected("Peer type in resolvePeers.");
+		}
+	}
+
+	const auto send = [&](auto &&list, auto input, auto wrap, auto done) {
+		using Peer = typename std::decay_t<decltype(list)>::value_type;
+		for (auto from = 0; from < int(list.size()); from += kPeersPerRequest) {
+			const auto till = std::min(
+				from + kPeersPerRequest,
+				int(list.size()));
+			const auto part = std::vector<Peer>(
+				begin(list) + from,
+				begin(list) + till);
+			const auto finish = [=] {
+				for (const auto peer : part) {
+					_peerRequests.remove(peer);
+				}
+			};
+			auto inputs = QVector<decltype(input(part.front()))>();
+			inputs.reserve(part.size());
+			for (const auto peer : part) {
+				inputs.push_back(input(peer));
+			}
+			using Request = decltype(wrap(MTP_vector(std::move(inputs))));
+			using Response = typename Request::ResponseType;
+			const auto requestId = request(wrap(
+				MTP_vector(std::move(inputs))
+			)).done([=](const Response &result) {
+				finish();
+				done(result);
+			}).fail([=](const RPCError &error) {
+				finish();
+			}).afterDelay(kSmallDelayMs).send();
+			for (const auto peer : part) {
+				_peerRequests.insert(peer, requestId);
+			}
 		}
-		Unexpected("Peer type in requestPeer.");
-	}();
-	_peerRequests.insert(peer, requestId);
+	};
+	const auto chatsDone = [=](const MTPmessages_Chats &result) {
+		const auto &chats = result.match([](const auto &data) {
+			return data.vchats();
+		});
+		_session->data().applyMaximumChatVersions(chats);
+		_session->data().processChats(chats);
+	};
+	send(users, [](not_null<UserData*> user) {
+		return user->inputUser;
+	}, [](MTPVector<MTPInputUser> &&list) {
+		return MTPusers_GetUsers(std::move(list));
+	}, [=](const MTPVector<MTPUser> &result) {
+		_session->data().processUsers(result);
+	});
+	send(chats, [](not_null<ChatData*> chat) {
+		return chat->inputChat;
+	}, [](MTPVector<MTPint> &&list) {
+		return MTPmessages_GetChats(std::move(list));
+	}, chatsDone);
+	send(channels, [](not_null<ChannelData*> channel) {
+		return channel->inputChannel;
+	}, [](MTPVector<MTPInputChannel> &&list) {
+		return MTPchannels_GetChannels(std::move(list));
+	}, chatsDone);
 }
 
 void ApiWrap::requestPeerSettings(not_null<PeerData*> peer) {
@@ -1845,16 +1940,31 @@ void ApiWrap::scheduleStickerSetRequest(uint64 setId, uint64 access) {
 }
 
 void ApiWrap::requestStickerSets() {
+	// Don't flood with hundreds of requests when many sets have changed,
+	// the rest are sent when the previous ones finish.
+	auto left = kStickerSetRequestsLimit;
+	for (const auto &request : _stickerSetRequests) {
+		if (request.second && !--left) {
+			return;
+		}
+	}
 	for (auto i = _stickerSetRequests.begin(), j = i, e = _stickerSetRequests.end(); i != e; i = j) {
 		++j;
 		if (i.value().second) continue;
 
-		auto waitMs = (j == e) ? 0 : kSmallDelayMs;
+		const auto last = (j == e) || (left == 1);
+		auto waitMs = last ? 0 : kSmallDelayMs;
 		i.value().second = request(MTPmessages_GetStickerSet(MTP_inputStickerSetID(MTP_long(i.key()), MTP_long(i.value().first)))).done([this, setId = i.key()](const MTPmessages_StickerSet &result) {
 			gotStickerSet(setId, result);
+			requestStickerSets();
 		}).fail([this, setId = i.key()](const RPCError &error) {
 			_stickerSetRequests.remove(setId);
+			requestStickerSets();
 		}).afterDelay(waitMs).send();
+		if (last) {
+			return;
+		}
+		--left;
 	}
 }
 
@@ -2730,42 +2840,106 @@ void ApiWrap::requestFileReference(
 	_fileReferenceHandlers.emplace(origin, std::move(handlers));
 
 	request(std::move(data)).done([=](const auto &result) {
-		const auto parsed = Data::GetFileReferences(result);
-		for (const auto &p : parsed.data) {
-			// Unpack here the parsed pair by hand to workaround a GCC bug.
-			// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87122
-			const auto &origin = p.first;
-			const auto &reference = p.second;
-			const auto documentId = base::get_if<DocumentFileLocationId>(
-				&origin);
-			if (documentId) {
-				_session->data().document(
-					documentId->id
-				)->refreshFileReference(reference);
-			}
-			const auto photoId = base::get_if<PhotoFileLocationId>(&origin);
-			if (photoId) {
-				_session->data().photo(
-					photoId->id
-				)->refreshFileReference(reference);
-			}
+		fileReferencesDone({ origin }, Data::GetFileReferences(result));
+	}).fail([=](const RPCError &error) {
+		fileReferencesDone({ origin }, UpdatedFileReferences());
+	}).send();
+}
+
+void ApiWrap::requestMessageFileReference(
+		ChannelData *channel,
+		FullMsgId itemId,
+		FileReferencesHandler &&handler) {
+	const auto origin = Data::FileOrigin(itemId);
+	const auto i = _fileReferenceHandlers.find(origin);
+	if (i != end(_fileReferenceHandlers)) {
+		i->second.push_back(std::move(handler));
+		return;
+	}
+	auto handlers = std::vector<FileReferencesHandler>();
+	handlers.push_back(std::move(handler));
+	_fileReferenceHandlers.emplace(origin, std::move(handlers));
+
+	// All the messages with expired media shown at once are requested
+	// by one getMessages for each channel.
+	_messageFileReferenceRequests[channel].push_back(itemId);
+	_messageFileReferencesResolveDelayed.call();
+}
+
+void ApiWrap::resolveMessageFileReferences() {
+	for (auto &[channel, ids] : base::take(_messageFileReferenceRequests)) {
+		const auto count = int(ids.size());
+		for (auto from = 0; from < count;) {
+			const auto till = std::min(
+				from + kFileReferenceMessagesPerRequest,
+				count);
+			requestMessagesFileReferences(
+				channel,
+				{ begin(ids) + from, begin(ids) + till });
+			from = till;
 		}
-		const auto i = _fileReferenceHandlers.find(origin);
-		Assert(i != end(_fileReferenceHandlers));
-		auto handlers = std::move(i->second);
-		_fileReferenceHandlers.erase(i);
-		for (auto &handler : handlers) {
-			handler(parsed);
+	}
+}
+
+void ApiWrap::requestMessagesFileReferences(
+		ChannelData *channel,
+		std::vector<FullMsgId> ids) {
+	auto inputs = QVector<MTPInputMessage>();
+	inputs.reserve(ids.size());
+	auto origins = std::vector<Data::FileOrigin>();
+	origins.reserve(ids.size());
+	for (const auto &id : ids) {
+		inputs.push_back(MTP_inputMessageID(MTP_int(id.msg)));
+		origins.push_back(id);
+	}
+	const auto send = [&](auto &&data) {
+		request(std::move(data)).done([=](
+				const MTPmessages_Messages &result) {
+			fileReferencesDone(origins, Data::GetFileReferences(result));
+		}).fail([=](const RPCError &error) {
+			fileReferencesDone(origins, UpdatedFileReferences());
+		}).send();
+	};
+	if (channel) {
+		send(MTPchannels_GetMessages(
+			channel->inputChannel,
+			MTP_vector<MTPInputMessage>(inputs)));
+	} else {
+		send(MTPmessages_GetMessages(MTP_vector<MTPInputMessage>(inputs)));
+	}
+}
+
+void ApiWrap::fileReferencesDone(
+		const std::vector<Data::FileOrigin> &origins,
+		const UpdatedFileReferences &data) {
+	for (const auto &p : data.data) {
+		// Unpack here the parsed pair by hand to workaround a GCC bug.
+		// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87122
+		const auto &origin = p.first;
+		const auto &reference = p.second;
+		const auto documentId = base::get_if<DocumentFileLocationId>(
+			&origin);
+		if (documentId) {
+			_session->data().document(
+				documentId->id
+			)->refreshFileReference(reference);
 		}
-	}).fail([=](const RPCError &error) {
+		const auto photoId = base::get_if<PhotoFileLocationId>(&origin);
+		if (photoId) {
+			_session->data().photo(
+				photoId->id
+			)->refreshFileReference(reference);
+		}
+	}
+	for (const auto &origin : origins) {
 		const auto i = _fileReferenceHandlers.find(origin);
 		Assert(i != end(_fileReferenceHandlers));
 		auto handlers = std::move(i->second);
 		_fileReferenceHandlers.erase(i);
 		for (auto &handler : handlers) {
-			handler(UpdatedFileReferences());
+			handler(data);
 		}
-	}).send();
+	}
 }
 
 void ApiWrap::refreshFileReference(
@@ -2810,17 +2984,11 @@ void ApiWrap::refreshFileReference(
 				request(MTPmessages_GetScheduledMessages(
 					item->history()->peer->input,
 					MTP_vector<MTPint>(1, MTP_int(realId))));
-			} else if (const auto channel = item->history()->peer->asChannel()) {
-				request(MTPchannels_GetMessages(
-					channel->inputChannel,
-					MTP_vector<MTPInputMessage>(
-						1,
-						MTP_inputMessageID(MTP_int(item->id)))));
 			} else {
-				request(MTPmessages_GetMessages(
-					MTP_vector<MTPInputMessage>(
-						1,
-						MTP_inputMessageID(MTP_int(item->id)))));
+				requestMessageFileReference(
+					item->history()->peer->asChannel(),
+					data,
+					std::move(handler));
 			}
 		} else {
 			fail();
@@ -4527,6 +4695,46 @@ void ApiWrap::sendMessage(MessageToSend &&message) {
 	auto &histories = history->owner().histories();
 	const auto requestType = Data::Histories::RequestType::Send;
 
+	// Everything except the text is the same for all the parts.
+	auto flags = NewMessageFlags(peer) | MTPDmessage::Flag::f_entities;
+	auto clientFlags = NewMessageClientFlags();
+	auto commonSendFlags = MTPmessages_SendMessage::Flags(0);
+	if (action.replyTo) {
+		flags |= MTPDmessage::Flag::f_reply_to_msg_id;
+		commonSendFlags |= MTPmessages_SendMessage::Flag::f_reply_to_msg_id;
+	}
+	MTPMessageMedia media = MTP_messageMediaEmpty();
+	if (message.webPageId == CancelledWebPageId) {
+		commonSendFlags |= MTPmessages_SendMessage::Flag::f_no_webpage;
+	} else if (message.webPageId) {
+		auto page = _session->data().webpage(message.webPageId);
+		media = MTP_messageMediaWebPage(
+			MTP_webPagePending(
+				MTP_long(page->id),
+				MTP_int(page->pendingTill)));
+		flags |= MTPDmessage::Flag::f_media;
+	}
+	const auto channelPost = peer->isChannel() && !peer->isMegagroup();
+	const auto silentPost = action.options.silent
+		|| (channelPost && _session->data().notifySilentPosts(peer));
+	FillMessagePostFlags(action, peer, flags);
+	if (silentPost) {
+		commonSendFlags |= MTPmessages_SendMessage::Flag::f_silent;
+	}
+	if (action.clearDraft) {
+		commonSendFlags |= MTPmessages_SendMessage::Flag::f_clear_draft;
+	}
+	const auto messageFromId = channelPost ? 0 : _session->userId();
+	const auto messagePostAuthor = channelPost
+		? _session->user()->name
+		: QString();
+	if (action.options.scheduled) {
+		flags |= MTPDmessage::Flag::f_from_scheduled;
+		commonSendFlags |= MTPmessages_SendMessage::Flag::f_schedule_date;
+	} else {
+		clientFlags |= MTPDmessage_ClientFlag::f_local_history_entry;
+	}
+
 	while (TextUtilities::CutPart(sending, left, MaxMessageSize)) {
 		auto newId = FullMsgId(
 			peerToChannel(peer->id),
@@ -4539,31 +4747,7 @@ void ApiWrap::sendMessage(MessageToSend &&message) {
 		_session->data().registerMessageSentData(randomId, peer->id, sending.text);
 
 		MTPstring msgText(MTP_string(sending.text));
-		auto flags = NewMessageFlags(peer) | MTPDmessage::Flag::f_entities;
-		auto clientFlags = NewMessageClientFlags();
-		auto sendFlags = MTPmessages_SendMessage::Flags(0);
-		if (action.replyTo) {
-			flags |= MTPDmessage::Flag::f_reply_to_msg_id;
-			sendFlags |= MTPmessages_SendMessage::Flag::f_reply_to_msg_id;
-		}
-		MTPMessageMedia media = MTP_messageMediaEmpty();
-		if (message.webPageId == CancelledWebPageId) {
-			sendFlags |= MTPmessages_SendMessage::Flag::f_no_webpage;
-		} else if (message.webPageId) {
-			auto page = _session->data().webpage(message.webPageId);
-			media = MTP_messageMediaWebPage(
-				MTP_webPagePending(
-					MTP_long(page->id),
-					MTP_int(page->pendingTill)));
-			flags |= MTPDmessage::Flag::f_media;
-		}
-		const auto channelPost = peer->isChannel() && !peer->isMegagroup();
-		const auto silentPost = action.options.silent
-			|| (channelPost && _session->data().notifySilentPosts(peer));
-		FillMessagePostFlags(action, peer, flags);
-		if (silentPost) {
-			sendFlags |= MTPmessages_SendMessage::Flag::f_silent;
-		}
+		auto sendFlags = commonSendFlags;
 		auto localEntities = Api::EntitiesToMTP(
 			_session,
 			sending.entities);
@@ -4575,20 +4759,9 @@ void ApiWrap::sendMessage(MessageToSend &&message) {
 			sendFlags |= MTPmessages_SendMessage::Flag::f_entities;
 		}
 		if (action.clearDraft) {
-			sendFlags |= MTPmessages_SendMessage::Flag::f_clear_draft;
 			history->clearCloudDraft();
 			history->setSentDraftText(QString());
 		}
-		auto messageFromId = channelPost ? 0 : _session->userId();
-		auto messagePostAuthor = channelPost
-			? _session->user()->name
-			: QString();
-		if (action.options.scheduled) {
-			flags |= MTPDmessage::Flag::f_from_scheduled;
-			sendFlags |= MTPmessages_SendMessage::Flag::f_schedule_date;
-		} else {
-			clientFlags |= MTPDmessage_ClientFlag::f_local_history_entry;
-		}
 		lastMessage = history->addNewMessage(
 			MTP_message(
 				MTP_flags(flags),
@@ -4639,6 +4812,7 @@ void ApiWrap::sendMessage(MessageToSend &&message) {
 			return history->sendRequestId;
 		});
 	}
+	_session->data().sendHistoryChangeNotifications();
 
 	finishForwarding(action);
 }
@@ -524,6 +524,7 @@ private:
 	void saveDraftsToCloud();
 
 	void resolveMessageDatas();
+	void resolvePeers();
 	void gotMessageDatas(ChannelData *channel, const MTPmessages_Messages &result, mtpRequestId requestId);
 	void finalizeMessageDataRequest(
 		ChannelData *channel,
@@ -532,6 +533,11 @@ private:
 	QVector<MTPInputMessage> collectMessageIds(const MessageDataRequests &requests);
 	MessageDataRequests *messageDataRequests(ChannelData *channel, bool onlyExisting = false);
 
+	void sendFullPeerRequest(not_null<PeerData*> peer);
+	void finishFullPeerRequest(
+		not_null<PeerData*> peer,
+		mtpRequestId requestId);
+	void sendQueuedFullPeerRequests();
 	void gotChatFull(
 		not_null<PeerData*> peer,
 		const MTPmessages_ChatFull &result,
@@ -654,6 +660,17 @@ private:
 		Data::FileOrigin origin,
 		FileReferencesHandler &&handler,
 		Request &&data);
+	void requestMessageFileReference(
+		ChannelData *channel,
+		FullMsgId itemId,
+		FileReferencesHandler &&handler);
+	void resolveMessageFileReferences();
+	void requestMessagesFileReferences(
+		ChannelData *channel,
+		std::vector<FullMsgId> ids);
+	void fileReferencesDone(
+		const std::vector<Data::FileOrigin> &origins,
+		const UpdatedFileReferences &data);
 
 	void photoUploadReady(const FullMsgId &msgId, const MTPInputFile &file);
 
@@ -677,8 +694,10 @@ private:
 	SingleQueuedInvokation _messageDataResolveDelayed;
 
 	using PeerRequests = QMap<PeerData*, mtpRequestId>;
-	PeerRequests _fullPeerRequests;
-	PeerRequests _peerRequests;
+	PeerRequests _fullPeerRequests; // 0 - waiting in the queue.
+	std::vector<not_null<PeerData*>> _fullPeerRequestsQueue;
+	PeerRequests _peerRequests; // 0 - waiting for resolvePeers().
+	SingleQueuedInvokation _peerResolveDelayed;
 	base::flat_set<not_null<PeerData*>> _requestedPeerSettings;
 
 	PeerRequests _participantsRequests;
@@ -792,6 +811,10 @@ private:
 	std::map<
 		Data::FileOrigin,
 		std::vector<FileReferencesHandler>> _fileReferenceHandlers;
+	base::flat_map<
+		ChannelData*,
+		std::vector<FullMsgId>> _messageFileReferenceRequests;
+	SingleQueuedInvokation _messageFileReferencesResolveDelayed;
 
 	mtpRequestId _deepLinkInfoRequestId = 0;
 
@@ -386,6 +386,22 @@ namespace App {
 			if (animated) *animated = false;
 			return QImage();
 		}
+		{
+			// Check the header and dimensions straight from the file first,
+			// so that we don't read up to kImageSizeLimit bytes of a file
+			// that can't be decoded as an image anyway.
+			QImageReader probe(&f);
+			const auto readable = probe.canRead();
+			const auto imageSize = readable ? probe.size() : QSize();
+			if (!readable
+				|| (imageSize.isValid()
+					&& (int64(imageSize.width()) * imageSize.height()
+						> kImageAreaLimit))
+				|| !f.seek(0)) {
+				if (animated) *animated = false;
+				return QImage();
+			}
+		}
 		auto imageBytes = f.readAll();
 		auto result = readImage(imageBytes, format, opaque, animated);
 		if (content && !result.isNull()) {
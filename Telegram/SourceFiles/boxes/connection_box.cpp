@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "main/main_account.h"
 #include "mtproto/facade.h"
+#include "mtproto/details/mtproto_rpc_stats.h"
 #include "ui/widgets/checkbox.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/input_fields.h"
@@ -605,6 +606,20 @@ void ProxiesBox::setupContent() {
 		inner,
 		st::proxyRowPadding.bottom()));
 
+	if (Logs::DebugEnabled()) {
+		// Traffic and latencies by dc for diagnosing slow proxies.
+		const auto stats = _controller->rpcStatsText();
+		LOG(("RPC Stats:\n%1").arg(stats));
+		inner->add(
+			object_ptr<Ui::DividerLabel>(
+				inner,
+				object_ptr<Ui::FlatLabel>(
+					inner,
+					stats,
+					st::boxDividerLabel),
+				st::proxyAboutPadding));
+	}
+
 	_proxySettings->setChangedCallback([=](ProxyData::Settings value) {
 		if (!_controller->setProxySettings(value)) {
 			_proxySettings->setValue(Global::ProxySettings());
@@ -1159,6 +1174,10 @@ object_ptr<Ui::BoxContent> ProxiesBoxController::create() {
 	return result;
 }
 
+QString ProxiesBoxController::rpcStatsText() const {
+	return _account->mtp().rpcStats().text();
+}
+
 auto ProxiesBoxController::findById(int id) -> std::vector<Item>::iterator {
 	const auto result = ranges::find(
 		_list,
@@ -43,6 +43,8 @@ public:
 		not_null<Main::Account*> account);
 	object_ptr<Ui::BoxContent> create();
 
+	[[nodiscard]] QString rpcStatsText() const;
+
 	enum class ItemState {
 		Connecting,
 		Online,
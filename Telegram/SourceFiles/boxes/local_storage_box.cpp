@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/emoji_config.h"
 #include "storage/storage_account.h"
 #include "storage/cache/storage_cache_database.h"
+#include "storage/file_download.h"
 #include "data/data_session.h"
 #include "lang/lang_keys.h"
 #include "mainwindow.h"
@@ -124,6 +125,7 @@ class LocalStorageBox::Row : public Ui::RpWidget {
 public:
 	Row(
 		QWidget *parent,
+		uint16 tag,
 		Fn<QString(size_type)> title,
 		rpl::producer<QString> clear,
 		const Database::TaggedSummary &data);
@@ -142,6 +144,7 @@ private:
 	QString sizeText(const Database::TaggedSummary &data) const;
 	void radialAnimationCallback();
 
+	const uint16 _tag = 0;
 	Fn<QString(size_type)> _titleFactory;
 	object_ptr<Ui::FlatLabel> _title;
 	object_ptr<Ui::FlatLabel> _description;
@@ -153,10 +156,12 @@ private:
 
 LocalStorageBox::Row::Row(
 	QWidget *parent,
+	uint16 tag,
 	Fn<QString(size_type)> title,
 	rpl::producer<QString> clear,
 	const Database::TaggedSummary &data)
 : RpWidget(parent)
+, _tag(tag)
 , _titleFactory(std::move(title))
 , _title(
 	this,
@@ -259,9 +264,23 @@ QString LocalStorageBox::Row::titleText(const Database::TaggedSummary &data) con
 }
 
 QString LocalStorageBox::Row::sizeText(const Database::TaggedSummary &data) const {
-	return data.totalSize
-		? formatSizeText(data.totalSize)
-		: tr::lng_local_storage_empty(tr::now);
+	if (!data.totalSize) {
+		return tr::lng_local_storage_empty(tr::now);
+	}
+	const auto size = formatSizeText(data.totalSize);
+	const auto cache = (_tag && _tag != kFakeMediaCacheTag)
+		? FileLoader::CollectCacheHits(uint8(_tag))
+		: FileLoader::CacheHits();
+	const auto reads = cache.hits + cache.misses;
+	if (!reads) {
+		return size;
+	}
+	return tr::lng_local_storage_size_hits(
+		tr::now,
+		lt_size,
+		size,
+		lt_percent,
+		QString::number((cache.hits * 100) / reads));
 }
 
 LocalStorageBox::LocalStorageBox(
@@ -370,6 +389,7 @@ void LocalStorageBox::setupControls() {
 			container,
 			object_ptr<Row>(
 				container,
+				tag,
 				std::move(title),
 				std::move(clear),
 				data)));
@@ -33,6 +33,15 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <rpl/range.h>
 
+namespace {
+
+// Userpic views of rows far from the visible area are released
+// only in long lists and only after scrolling a few screens away.
+constexpr auto kReleaseUserpicsMinRows = 200;
+constexpr auto kReleaseUserpicsScreens = 3;
+
+} // namespace
+
 PaintRoundImageCallback PaintUserpicCallback(
 		not_null<PeerData*> peer,
 		bool respectSavedMessagesChat) {
@@ -491,6 +500,10 @@ std::shared_ptr<Data::CloudImageView> PeerListRow::ensureUserpicView() {
 	return _userpic;
 }
 
+void PeerListRow::releaseUserpicView() {
+	_userpic = nullptr;
+}
+
 PaintRoundImageCallback PeerListRow::generatePaintUserpicCallback() {
 	const auto saved = _isSavedMessagesChat;
 	const auto peer = this->peer();
@@ -1409,6 +1422,40 @@ void PeerListContent::loadProfilePhotos() {
 	}
 }
 
+void PeerListContent::releaseHiddenUserpics() {
+	const auto screen = _visibleBottom - _visibleTop;
+	const auto rowsCount = shownRowsCount();
+	if (screen <= 0
+		|| rowsCount < kReleaseUserpicsMinRows
+		|| std::abs(_visibleTop - _userpicsReleasedTop)
+			< screen * kReleaseUserpicsScreens) {
+		return;
+	}
+	_userpicsReleasedTop = _visibleTop;
+
+	const auto margin = screen * kReleaseUserpicsScreens;
+	const auto from = std::clamp(
+		(_visibleTop - margin) / _rowHeight,
+		0,
+		rowsCount);
+	const auto till = std::clamp(
+		(_visibleBottom + margin) / _rowHeight + 1,
+		from,
+		rowsCount);
+	auto keep = base::flat_set<not_null<PeerListRow*>>();
+	keep.reserve(till - from);
+	for (auto index = from; index != till; ++index) {
+		keep.emplace(getRow(RowIndex(index)));
+	}
+	const auto release = [&](const std::unique_ptr<PeerListRow> &row) {
+		if (!keep.contains(row.get())) {
+			row->releaseUserpicView();
+		}
+	};
+	ranges::for_each(_rows, release);
+	ranges::for_each(_searchRows, release);
+}
+
 void PeerListContent::checkScrollForPreload() {
 	if (_visibleBottom + PreloadHeightsCount * (_visibleBottom - _visibleTop) >= height()) {
 		_controller->loadMoreRows();
@@ -1544,6 +1591,7 @@ void PeerListContent::visibleTopBottomUpdated(
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 	loadProfilePhotos();
+	releaseHiddenUserpics();
 	checkScrollForPreload();
 }
 
@@ -83,6 +83,9 @@ public:
 
 	[[nodiscard]] std::shared_ptr<Data::CloudImageView> ensureUserpicView();
 
+	// Frees the loaded userpic, it is created again on the next paint.
+	void releaseUserpicView();
+
 	[[nodiscard]] virtual QString generateName();
 	[[nodiscard]] virtual QString generateShortName();
 	[[nodiscard]] virtual auto generatePaintUserpicCallback()
@@ -598,6 +601,7 @@ private:
 
 	void selectByMouse(QPoint globalPosition);
 	void loadProfilePhotos();
+	void releaseHiddenUserpics();
 	void checkScrollForPreload();
 
 	void updateRow(not_null<PeerListRow*> row, RowIndex hint);
@@ -640,6 +644,7 @@ private:
 	int _rowHeight = 0;
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
+	int _userpicsReleasedTop = 0;
 
 	Selected _selected;
 	Selected _pressed;
@@ -257,6 +257,8 @@ private:
 	QRect countCurrentGeometry(float64 progress) const;
 	void prepareCache(QSize size, int shrink);
 	void drawSimpleFrame(Painter &p, QRect to, QSize size) const;
+	void validatePhoto();
+	void validateFileThumb();
 
 	Ui::GroupMediaLayout _layout;
 	std::optional<QRect> _animateFromGeometry;
@@ -266,6 +268,7 @@ private:
 	QImage _albumCache;
 	QPoint _albumPosition;
 	RectParts _albumCorners = RectPart::None;
+	QSize _photoSize;
 	QPixmap _photo;
 	QPixmap _fileThumb;
 	QString _name;
@@ -298,35 +301,13 @@ AlbumThumb::AlbumThumb(
 
 	moveToLayout(layout);
 
-	using Option = Images::Option;
-	const auto previewWidth = _fullPreview.width();
-	const auto previewHeight = _fullPreview.height();
-	const auto imageWidth = std::max(
-		previewWidth / cIntRetinaFactor(),
-		st::minPhotoSize);
-	const auto imageHeight = std::max(
-		previewHeight / cIntRetinaFactor(),
-		st::minPhotoSize);
-	_photo = App::pixmapFromImageInPlace(Images::prepare(
-		_fullPreview,
-		previewWidth,
-		previewHeight,
-		Option::RoundedLarge | Option::RoundedAll,
-		imageWidth,
-		imageHeight));
-
-	const auto idealSize = st::sendMediaFileThumbSize * cIntRetinaFactor();
-	const auto fileThumbSize = (previewWidth > previewHeight)
-		? QSize(previewWidth * idealSize / previewHeight, idealSize)
-		: QSize(idealSize, previewHeight * idealSize / previewWidth);
-	_fileThumb = App::pixmapFromImageInPlace(Images::prepare(
-		_fullPreview,
-		fileThumbSize.width(),
-		fileThumbSize.height(),
-		Option::RoundedSmall | Option::RoundedAll,
-		st::sendMediaFileThumbSize,
-		st::sendMediaFileThumbSize
-	));
+	// Only one of the album, photos and files layouts is shown at once,
+	// so the thumbnails for the others are prepared when first painted.
+	_photoSize = QSize(
+		std::max(_fullPreview.width() / cIntRetinaFactor(), st::minPhotoSize),
+		std::max(
+			_fullPreview.height() / cIntRetinaFactor(),
+			st::minPhotoSize));
 
 	const auto availableFileWidth = st::sendMediaPreviewSize
 		- st::sendMediaFileThumbSkip
@@ -450,7 +431,7 @@ void AlbumThumb::moveToLayout(const Ui::GroupMediaLayout &layout) {
 }
 
 int AlbumThumb::photoHeight() const {
-	return _photo.height() / cIntRetinaFactor();
+	return _photoSize.height();
 }
 
 void AlbumThumb::paintInAlbum(
@@ -644,8 +625,45 @@ void AlbumThumb::drawSimpleFrame(Painter &p, QRect to, QSize size) const {
 	}
 }
 
+void AlbumThumb::validatePhoto() {
+	if (!_photo.isNull()) {
+		return;
+	}
+	using Option = Images::Option;
+	_photo = App::pixmapFromImageInPlace(Images::prepare(
+		_fullPreview,
+		_fullPreview.width(),
+		_fullPreview.height(),
+		Option::RoundedLarge | Option::RoundedAll,
+		_photoSize.width(),
+		_photoSize.height()));
+}
+
+void AlbumThumb::validateFileThumb() {
+	if (!_fileThumb.isNull()) {
+		return;
+	}
+	using Option = Images::Option;
+	const auto previewWidth = _fullPreview.width();
+	const auto previewHeight = _fullPreview.height();
+	const auto idealSize = st::sendMediaFileThumbSize * cIntRetinaFactor();
+	const auto fileThumbSize = (previewWidth > previewHeight)
+		? QSize(previewWidth * idealSize / previewHeight, idealSize)
+		: QSize(idealSize, previewHeight * idealSize / previewWidth);
+	_fileThumb = App::pixmapFromImageInPlace(Images::prepare(
+		_fullPreview,
+		fileThumbSize.width(),
+		fileThumbSize.height(),
+		Option::RoundedSmall | Option::RoundedAll,
+		st::sendMediaFileThumbSize,
+		st::sendMediaFileThumbSize
+	));
+}
+
 void AlbumThumb::paintPhoto(Painter &p, int left, int top, int outerWidth) {
-	const auto width = _photo.width() / cIntRetinaFactor();
+	validatePhoto();
+
+	const auto width = _photoSize.width();
 	p.drawPixmapLeft(
 		left + (st::sendMediaPreviewSize - width) / 2,
 		top,
@@ -664,6 +682,7 @@ void AlbumThumb::paintFile(Painter &p, int left, int top, int outerWidth) {
 		+ st::sendMediaFileThumbSize
 		+ st::sendMediaFileThumbSkip;
 
+	validateFileThumb();
 	p.drawPixmap(left, top, _fileThumb);
 	p.setFont(st::semiboldFont);
 	p.setPen(st::historyFileNameInFg);
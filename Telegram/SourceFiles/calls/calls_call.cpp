@@ -32,6 +32,7 @@ namespace {
 constexpr auto kMinLayer = 65;
 constexpr auto kHangupTimeoutMs = 5000;
 constexpr auto kSha256Size = 32;
+constexpr auto kStatsLogTimeout = 10 * crl::time(1000);
 
 void AppendEndpoint(
 		std::vector<TgVoipEndpoint> &list,
@@ -102,6 +103,7 @@ Call::Call(
 , _api(&_user->session().mtp())
 , _type(type) {
 	_discardByTimeoutTimer.setCallback([this] { hangup(); });
+	_statsLogTimer.setCallback([this] { logStats(); });
 
 	if (_type == Type::Outgoing) {
 		setState(State::Requesting);
@@ -624,6 +626,23 @@ void Call::createAndStartController(const MTPDphoneCall &call) {
 	raw->setOutputVolume(settings.callOutputVolume() / 100.0f);
 	raw->setInputVolume(settings.callInputVolume() / 100.0f);
 	raw->setAudioOutputDuckingEnabled(settings.callAudioDuckingEnabled());
+
+	if (Logs::DebugEnabled()) {
+		_statsLogTimer.callEach(kStatsLogTimeout);
+	}
+}
+
+void Call::logStats() {
+	if (!_controller) {
+		_statsLogTimer.cancel();
+		return;
+	}
+	// Debug info has the jitter buffer, packet loss, bitrate and rtt.
+	const auto traffic = _controller->getTrafficStats();
+	DEBUG_LOG(("Call Stats: sent %1, received %2, debug info: %3"
+		).arg(traffic.bytesSentWifi + traffic.bytesSentMobile
+		).arg(traffic.bytesReceivedWifi + traffic.bytesReceivedMobile
+		).arg(QString::fromStdString(_controller->getDebugInfo())));
 }
 
 void Call::handleControllerStateChange(
@@ -874,6 +893,7 @@ void Call::handleControllerError(const QString &error) {
 }
 
 void Call::destroyController() {
+	_statsLogTimer.cancel();
 	if (_controller) {
 		DEBUG_LOG(("Call Info: Destroying call controller.."));
 		_controller.reset();
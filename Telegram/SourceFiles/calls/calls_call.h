@@ -151,6 +151,7 @@ private:
 		TgVoipState state);
 	void handleControllerBarCountChange(int count);
 	void createAndStartController(const MTPDphoneCall &call);
+	void logStats();
 
 	template <typename T>
 	bool checkCallCommonFields(const T &call);
@@ -178,6 +179,7 @@ private:
 	crl::time _startTime = 0;
 	base::DelayedCallTimer _finishByTimeoutTimer;
 	base::Timer _discardByTimeoutTimer;
+	base::Timer _statsLogTimer;
 
 	bool _mute = false;
 	base::Observable<bool> _muteChanged;
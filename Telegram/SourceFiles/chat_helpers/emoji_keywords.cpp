@@ -35,12 +35,55 @@ struct LangPackEmoji {
 	QString text;
 };
 
+using LangPackMap = std::map<QString, std::vector<LangPackEmoji>>;
+
+// Compact read-only form of LangPackMap, searched on each input change.
+// The emoji for keys[i] are emoji[offsets[i]] .. emoji[offsets[i + 1] - 1].
 struct LangPackData {
 	int version = 0;
 	int maxKeyLength = 0;
-	std::map<QString, std::vector<LangPackEmoji>> emoji;
+	std::vector<QString> keys;
+	std::vector<int> offsets;
+	std::vector<LangPackEmoji> emoji;
 };
 
+[[nodiscard]] LangPackMap Expand(const LangPackData &data) {
+	auto result = LangPackMap();
+	for (auto i = 0, count = int(data.keys.size()); i != count; ++i) {
+		result.emplace_hint(
+			end(result),
+			data.keys[i],
+			std::vector<LangPackEmoji>(
+				begin(data.emoji) + data.offsets[i],
+				begin(data.emoji) + data.offsets[i + 1]));
+	}
+	return result;
+}
+
+void Compact(LangPackData &data, LangPackMap &&map) {
+	auto emojiCount = 0;
+	for (const auto &[key, list] : map) {
+		emojiCount += int(list.size());
+	}
+	data.keys.clear();
+	data.offsets.clear();
+	data.emoji.clear();
+	data.keys.reserve(map.size());
+	data.offsets.reserve(map.size() + 1);
+	data.emoji.reserve(emojiCount);
+	data.maxKeyLength = 0;
+	for (auto &[key, list] : map) {
+		data.maxKeyLength = std::max(data.maxKeyLength, key.size());
+		data.keys.push_back(key);
+		data.offsets.push_back(int(data.emoji.size()));
+		data.emoji.insert(
+			end(data.emoji),
+			std::make_move_iterator(begin(list)),
+			std::make_move_iterator(end(list)));
+	}
+	data.offsets.push_back(int(data.emoji.size()));
+}
+
 [[nodiscard]] bool MustAddPostfix(const QString &text) {
 	if (text.size() != 1) {
 		return false;
@@ -96,7 +139,7 @@ void CreateCacheFilePath() {
 	if (!file.open(QIODevice::ReadOnly)) {
 		return {};
 	}
-	auto result = LangPackData();
+	auto map = LangPackMap();
 	auto stream = QDataStream(&file);
 	stream.setVersion(QDataStream::Qt_5_1);
 	auto version = qint32();
@@ -116,7 +159,7 @@ void CreateCacheFilePath() {
 		if (size < 0 || stream.status() != QDataStream::Ok) {
 			return {};
 		}
-		auto &list = result.emoji[key];
+		auto &list = map[key];
 		for (auto j = 0; j != size; ++j) {
 			auto text = QString();
 			stream >> text;
@@ -132,14 +175,15 @@ void CreateCacheFilePath() {
 			}
 			list.push_back(entry);
 		}
-		result.maxKeyLength = std::max(result.maxKeyLength, key.size());
 	}
+	auto result = LangPackData();
 	result.version = version;
+	Compact(result, std::move(map));
 	return result;
 }
 
 void WriteLocalCache(const QString &id, const LangPackData &data) {
-	if (!data.version && data.emoji.empty()) {
+	if (!data.version && data.keys.empty()) {
 		return;
 	}
 	CreateCacheFilePath();
@@ -151,13 +195,15 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 	stream.setVersion(QDataStream::Qt_5_1);
 	stream
 		<< qint32(data.version)
-		<< qint32(data.emoji.size());
-	for (const auto &[key, list] : data.emoji) {
+		<< qint32(data.keys.size());
+	for (auto i = 0, count = int(data.keys.size()); i != count; ++i) {
+		const auto from = data.offsets[i];
+		const auto till = data.offsets[i + 1];
 		stream
-			<< key
-			<< qint32(list.size());
-		for (const auto &emoji : list) {
-			stream << emoji.text;
+			<< data.keys[i]
+			<< qint32(till - from);
+		for (auto j = from; j != till; ++j) {
+			stream << data.emoji[j].text;
 		}
 	}
 }
@@ -173,7 +219,7 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 void AppendFoundEmoji(
 		std::vector<Result> &result,
 		const QString &label,
-		const std::vector<LangPackEmoji> &list) {
+		gsl::span<const LangPackEmoji> list) {
 	// It is important that the 'result' won't relocate while inserting.
 	result.reserve(result.size() + list.size());
 	const auto alreadyBegin = begin(result);
@@ -242,6 +288,7 @@ void ApplyDifference(
 		LangPackData &data,
 		const QVector<MTPEmojiKeyword> &keywords,
 		int version) {
+	auto map = Expand(data);
 	data.version = version;
 	for (const auto &keyword : keywords) {
 		keyword.match([&](const MTPDemojiKeyword &keyword) {
@@ -249,7 +296,7 @@ void ApplyDifference(
 			if (word.isEmpty()) {
 				return;
 			}
-			auto &list = data.emoji[word];
+			auto &list = map[word];
 			auto &&emoji = ranges::view::all(
 				keyword.vemoticons().v
 			) | ranges::view::transform([](const MTPstring &string) {
@@ -272,8 +319,8 @@ void ApplyDifference(
 			if (word.isEmpty()) {
 				return;
 			}
-			const auto i = data.emoji.find(word);
-			if (i == end(data.emoji)) {
+			const auto i = map.find(word);
+			if (i == end(map)) {
 				return;
 			}
 			auto &list = i->second;
@@ -283,20 +330,11 @@ void ApplyDifference(
 					end(list));
 			}
 			if (list.empty()) {
-				data.emoji.erase(i);
+				map.erase(i);
 			}
 		});
 	}
-	if (data.emoji.empty()) {
-		data.maxKeyLength = 0;
-	} else {
-		auto &&lengths = ranges::view::all(
-			data.emoji
-		) | ranges::view::transform([](auto &&pair) {
-			return pair.first.size();
-		});
-		data.maxKeyLength = *ranges::max_element(lengths);
-	}
+	Compact(data, std::move(map));
 }
 
 } // namespace
@@ -470,23 +508,27 @@ std::vector<Result> EmojiKeywords::LangPack::query(
 		const QString &normalized,
 		bool exact) const {
 	if (normalized.size() > _data.maxKeyLength
-		|| _data.emoji.empty()
+		|| _data.keys.empty()
 		|| (exact && SkipExactKeyword(_id, normalized))) {
 		return {};
 	}
 
-	const auto from = _data.emoji.lower_bound(normalized);
-	auto &&chosen = ranges::make_subrange(
-		from,
-		end(_data.emoji)
-	) | ranges::view::take_while([&](const auto &pair) {
-		const auto &key = pair.first;
-		return exact ? (key == normalized) : key.startsWith(normalized);
-	});
-
+	const auto &keys = _data.keys;
+	const auto from = ranges::lower_bound(keys, normalized);
 	auto result = std::vector<Result>();
-	for (const auto &[key, list] : chosen) {
-		AppendFoundEmoji(result, key, list);
+	for (auto i = from; i != end(keys); ++i) {
+		const auto &key = *i;
+		if (exact ? (key != normalized) : !key.startsWith(normalized)) {
+			break;
+		}
+		const auto index = int(i - begin(keys));
+		const auto first = _data.offsets[index];
+		AppendFoundEmoji(
+			result,
+			key,
+			gsl::make_span(_data.emoji).subspan(
+				first,
+				_data.offsets[index + 1] - first));
 	}
 	return result;
 }
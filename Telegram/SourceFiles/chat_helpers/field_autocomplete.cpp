@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_peer_values.h"
 #include "data/data_file_origin.h"
 #include "data/data_session.h"
+#include "data/data_changes.h"
 #include "data/stickers/data_stickers.h"
 #include "chat_helpers/stickers_lottie.h"
 #include "mainwindow.h"
@@ -67,6 +68,17 @@ FieldAutocomplete::FieldAutocomplete(
 	hide();
 
 	connect(_scroll, SIGNAL(geometryChanged()), _inner, SLOT(onParentGeometryChanged()));
+
+	_controller->session().changes().peerUpdates(
+		Data::PeerUpdate::Flag::Members
+		| Data::PeerUpdate::Flag::Name
+		| Data::PeerUpdate::Flag::Username
+	) | rpl::filter([=](const Data::PeerUpdate &update) {
+		return (update.peer.get() == _mentionsFilteredChannel)
+			|| update.peer->isUser();
+	}) | rpl::start_with_next([=] {
+		clearFilteredMentions();
+	}, lifetime());
 }
 
 FieldAutocomplete::~FieldAutocomplete() = default;
@@ -156,6 +168,12 @@ void FieldAutocomplete::showStickers(EmojiPtr emoji) {
 	updateFiltered(resetScroll);
 }
 
+void FieldAutocomplete::clearFilteredMentions() {
+	_mentionsFilteredChannel = nullptr;
+	_mentionsFilteredQuery = QString();
+	_mentionsFiltered = {};
+}
+
 bool FieldAutocomplete::clearFilteredBotCommands() {
 	if (_brows.empty()) {
 		return false;
@@ -167,7 +185,7 @@ bool FieldAutocomplete::clearFilteredBotCommands() {
 namespace {
 template <typename T, typename U>
 inline int indexOfInFirstN(const T &v, const U &elem, int last) {
-	for (auto b = v.cbegin(), i = b, e = b + std::max(int(v.size()), last); i != e; ++i) {
+	for (auto b = v.cbegin(), i = b, e = b + std::min(int(v.size()), last); i != e; ++i) {
 		if (i->user == elem) {
 			return (i - b);
 		}
@@ -241,6 +259,17 @@ void FieldAutocomplete::updateFiltered(bool resetScroll) {
 			}
 			return filterNotPassedByUsername(user);
 		};
+		const auto filterPrefixMatched = [&](not_null<UserData*> user) {
+			if (user->username.startsWith(_filter, Qt::CaseInsensitive)) {
+				return true;
+			}
+			for (const auto &nameWord : user->nameWords()) {
+				if (nameWord.startsWith(_filter, Qt::CaseInsensitive)) {
+					return true;
+				}
+			}
+			return false;
+		};
 
 		bool listAllSuggestions = _filter.isEmpty();
 		if (_addInlineBots) {
@@ -283,13 +312,41 @@ void FieldAutocomplete::updateFiltered(bool resetScroll) {
 			if (_channel->lastParticipantsRequestNeeded()) {
 				_channel->session().api().requestLastParticipants(_channel);
 			} else {
-				mrows.reserve(mrows.size() + _channel->mgInfo->lastParticipants.size());
-				for (const auto user : _channel->mgInfo->lastParticipants) {
+				// Typing one more letter only narrows the previous result,
+				// so we filter it instead of all the participants again.
+				const auto narrow = !listAllSuggestions
+					&& (_mentionsFilteredChannel == _channel)
+					&& _filter.startsWith(
+						_mentionsFilteredQuery,
+						Qt::CaseInsensitive);
+				auto filtered = std::vector<not_null<UserData*>>();
+				const auto collect = [&](const auto &list) {
+					filtered.reserve(list.size());
+					for (const auto user : list) {
+						if (listAllSuggestions || filterPrefixMatched(user)) {
+							filtered.push_back(user);
+						}
+					}
+				};
+				if (narrow) {
+					collect(_mentionsFiltered);
+				} else {
+					collect(_channel->mgInfo->lastParticipants);
+				}
+				mrows.reserve(mrows.size() + filtered.size());
+				for (const auto user : filtered) {
 					if (user->isInaccessible()) continue;
 					if (!listAllSuggestions && filterNotPassedByName(user)) continue;
 					if (indexOfInFirstN(mrows, user, recentInlineBots) >= 0) continue;
 					mrows.push_back({ user });
 				}
+				if (listAllSuggestions) {
+					clearFilteredMentions();
+				} else {
+					_mentionsFilteredChannel = _channel;
+					_mentionsFilteredQuery = _filter;
+					_mentionsFiltered = std::move(filtered);
+				}
 			}
 		}
 	} else if (_type == Type::Hashtags) {
@@ -125,6 +125,7 @@ private:
 	void hideFinish();
 
 	void updateFiltered(bool resetScroll = false);
+	void clearFilteredMentions();
 	void recount(bool resetScroll = false);
 	internal::StickerRows getStickerSuggestions();
 
@@ -161,6 +162,11 @@ private:
 	QRect _boundings;
 	bool _addInlineBots;
 
+	// Megagroup participants matching _mentionsFilteredQuery as a prefix.
+	ChannelData *_mentionsFilteredChannel = nullptr;
+	QString _mentionsFilteredQuery;
+	std::vector<not_null<UserData*>> _mentionsFiltered;
+
 	int32 _width, _height;
 	bool _hiding = false;
 
@@ -40,6 +40,7 @@ constexpr auto kSaveChosenTabTimeout = 1000;
 constexpr auto kSearchRequestDelay = 400;
 constexpr auto kInlineItemsMaxPerRow = 5;
 constexpr auto kSearchBotUsername = "gif"_cs;
+constexpr auto kKeepHeavyScreens = 2;
 
 } // namespace
 
@@ -195,6 +196,30 @@ void GifsListWidget::visibleTopBottomUpdated(
 		_lastScrolled = crl::now();
 	}
 	checkLoadMore();
+	clearHeavyFarFromVisible();
+}
+
+void GifsListWidget::clearHeavyFarFromVisible() {
+	// Clip readers and media of rows scrolled far away are destroyed,
+	// they're created again from the thumbnail when the row is painted.
+	const auto visibleTop = getVisibleTop();
+	const auto visibleBottom = getVisibleBottom();
+	if (visibleBottom <= visibleTop) {
+		return;
+	}
+	const auto distance = (visibleBottom - visibleTop) * kKeepHeavyScreens;
+	const auto keepTop = visibleTop - distance;
+	const auto keepBottom = visibleBottom + distance;
+	auto top = st::stickerPanPadding;
+	for (const auto &row : _rows) {
+		const auto bottom = top + row.height;
+		if (bottom <= keepTop || top >= keepBottom) {
+			for (const auto item : row.items) {
+				item->unloadHeavyPart();
+			}
+		}
+		top = bottom;
+	}
 }
 
 void GifsListWidget::checkLoadMore() {
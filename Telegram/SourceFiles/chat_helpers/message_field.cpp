@@ -23,6 +23,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_session.h"
 #include "data/data_user.h"
 #include "chat_helpers/emoji_suggestions_widget.h"
+#include "chat_helpers/spellchecker_common.h"
 #include "window/window_session_controller.h"
 #include "lang/lang_keys.h"
 #include "mainwindow.h"
@@ -299,6 +300,20 @@ void InitSpellchecker(
 		not_null<Window::SessionController*> controller,
 		not_null<Ui::InputField*> field) {
 #ifndef TDESKTOP_DISABLE_SPELLCHECK
+	// The fields are created at startup, the dictionaries are loaded
+	// only when one of them is focused or edited for the first time.
+	const auto loading = std::make_shared<
+		std::vector<QMetaObject::Connection>>();
+	const auto load = [=] {
+		Spellchecker::LoadLanguages();
+		for (const auto &connection : base::take(*loading)) {
+			QObject::disconnect(connection);
+		}
+	};
+	loading->push_back(
+		QObject::connect(field, &Ui::InputField::focused, load));
+	loading->push_back(
+		QObject::connect(field, &Ui::InputField::changed, load));
 	const auto s = Ui::CreateChild<Spellchecker::SpellingHighlighter>(
 		field.get(),
 		Core::App().settings().spellcheckerEnabledValue(),
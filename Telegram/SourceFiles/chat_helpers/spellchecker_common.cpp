@@ -129,6 +129,19 @@ using DictLoaderPtr = std::shared_ptr<base::unique_qptr<DictLoader>>;
 DictLoaderPtr BackgroundLoader;
 rpl::event_stream<int> BackgroundLoaderChanged;
 
+// Dictionaries are loaded only when the first field with spellchecking
+// is created, until then the last requested languages are kept here.
+bool LanguagesUsed = false;
+std::optional<std::vector<int>> PendingLanguages;
+
+void UpdateLanguages(std::vector<int> languages) {
+	if (!LanguagesUsed) {
+		PendingLanguages = std::move(languages);
+		return;
+	}
+	Platform::Spellchecker::UpdateLanguages(std::move(languages));
+}
+
 void SetBackgroundLoader(DictLoaderPtr loader) {
 	BackgroundLoader = std::move(loader);
 }
@@ -369,6 +382,16 @@ std::vector<int> DefaultLanguages() {
 	return langs;
 }
 
+void LoadLanguages() {
+	if (LanguagesUsed) {
+		return;
+	}
+	LanguagesUsed = true;
+	if (auto languages = base::take(PendingLanguages)) {
+		Platform::Spellchecker::UpdateLanguages(std::move(*languages));
+	}
+}
+
 void Start(not_null<Main::Session*> session) {
 	Spellchecker::SetPhrases({ {
 		{ &ph::lng_spellchecker_submenu, tr::lng_spellchecker_submenu() },
@@ -379,7 +402,7 @@ void Start(not_null<Main::Session*> session) {
 	const auto settings = &Core::App().settings();
 
 	const auto onEnabled = [=](auto enabled) {
-		Platform::Spellchecker::UpdateLanguages(
+		UpdateLanguages(
 			enabled
 				? settings->dictionariesEnabled()
 				: std::vector<int>());
@@ -410,7 +433,7 @@ void Start(not_null<Main::Session*> session) {
 
 	settings->dictionariesEnabledChanges(
 	) | rpl::start_with_next([](auto dictionaries) {
-		Platform::Spellchecker::UpdateLanguages(dictionaries);
+		UpdateLanguages(dictionaries);
 	}, session->lifetime());
 
 	settings->spellcheckerEnabledChanges(
@@ -35,6 +35,9 @@ bool WriteDefaultDictionary();
 std::vector<Dict> Dictionaries();
 
 void Start(not_null<Main::Session*> session);
+
+// Loads the enabled dictionaries, called when they are first needed.
+void LoadLanguages();
 [[nodiscard]] rpl::producer<QString> ButtonManageDictsState(
 	not_null<Main::Session*> session);
 
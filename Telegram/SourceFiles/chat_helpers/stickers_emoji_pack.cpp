@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_file_origin.h"
 #include "data/data_session.h"
 #include "data/data_document.h"
+#include "data/data_document_media.h"
 #include "core/core_settings.h"
 #include "core/application.h"
 #include "base/call_delayed.h"
@@ -132,7 +133,11 @@ EmojiPack::~EmojiPack() = default;
 bool EmojiPack::add(not_null<HistoryItem*> item) {
 	auto length = 0;
 	if (const auto emoji = item->isolatedEmoji()) {
-		_items[emoji].emplace(item);
+		auto &list = _items[emoji];
+		if (list.empty()) {
+			preload(emoji);
+		}
+		list.emplace(item);
 		return true;
 	}
 	return false;
@@ -252,6 +257,9 @@ void EmojiPack::applySet(const MTPDmessages_stickerSet &data) {
 	for (const auto &[emoji, Document] : was) {
 		refreshItems(emoji);
 	}
+	for (const auto &[emoji, list] : _items) {
+		preload(emoji);
+	}
 }
 
 void EmojiPack::refreshAll() {
@@ -275,6 +283,22 @@ void EmojiPack::refreshItems(
 	}
 }
 
+void EmojiPack::preload(const IsolatedEmoji &emoji) {
+	// Start loading the sticker when a message with this emoji is loaded,
+	// so that it is in the cache when the message is shown.
+	if (!Core::App().settings().largeEmoji()) {
+		return;
+	}
+	const auto sticker = stickerForEmoji(emoji);
+	if (!sticker) {
+		return;
+	}
+	const auto document = sticker.document;
+	document->createMediaView()->automaticLoad(
+		document->stickerSetOrigin(),
+		nullptr);
+}
+
 void EmojiPack::applyPack(
 		const MTPDstickerPack &data,
 		const base::flat_map<uint64, not_null<DocumentData*>> &map) {
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_document_media.h"
 #include "data/data_session.h"
 #include "data/data_channel.h"
+#include "core/paint_stats.h"
 #include "data/data_file_origin.h"
 #include "data/data_cloud_file.h"
 #include "data/data_changes.h"
@@ -1491,6 +1492,7 @@ QRect StickersListWidget::stickerRect(int section, int sel) {
 }
 
 void StickersListWidget::paintEvent(QPaintEvent *e) {
+	PAINT_STATS_FRAME("StickersListWidget");
 	Painter p(this);
 	auto clip = e->rect();
 	p.fillRect(clip, st::emojiPanBg);
@@ -1669,15 +1671,48 @@ void StickersListWidget::checkVisibleLottie() {
 		if (destroyBelow <= info.rowsTop
 			|| destroyAbove >= info.rowsBottom) {
 			clearHeavyIn(shownSets()[info.section]);
-		} else if ((visibleTop > info.rowsTop && visibleTop < info.rowsBottom)
-			|| (visibleBottom > info.rowsTop
-				&& visibleBottom < info.rowsBottom)) {
-			pauseInvisibleLottieIn(info);
+		} else {
+			clearHeavyOutside(info, destroyAbove, destroyBelow);
+			if ((visibleTop > info.rowsTop && visibleTop < info.rowsBottom)
+				|| (visibleBottom > info.rowsTop
+					&& visibleBottom < info.rowsBottom)) {
+				pauseInvisibleLottieIn(info);
+			}
 		}
 		return true;
 	});
 }
 
+void StickersListWidget::clearHeavyOutside(
+		const SectionInfo &info,
+		int keepTop,
+		int keepBottom) {
+	// Big sets are cleared row by row, not only when the whole set leaves.
+	auto &set = shownSets()[info.section];
+	const auto rowHeight = _singleSize.height();
+	if (rowHeight <= 0) {
+		return;
+	}
+	const auto keepFrom = std::max(
+		(keepTop - info.rowsTop) / rowHeight,
+		0) * _columnCount;
+	const auto keepTill = std::min(
+		(keepBottom - info.rowsTop + rowHeight - 1) / rowHeight,
+		info.rowsCount) * _columnCount;
+	const auto count = std::min(info.count, int(set.stickers.size()));
+	const auto clear = [&](int from, int till) {
+		for (auto index = from; index < till; ++index) {
+			auto &sticker = set.stickers[index];
+			if (const auto animated = base::take(sticker.animated)) {
+				set.lottiePlayer->remove(animated);
+			}
+			sticker.documentMedia = nullptr;
+		}
+	};
+	clear(0, std::min(keepFrom, count));
+	clear(std::max(keepTill, 0), count);
+}
+
 void StickersListWidget::clearHeavyIn(Set &set, bool clearSavedFrames) {
 	const auto player = base::take(set.lottiePlayer);
 	const auto lifetime = base::take(set.lottieLifetime);
@@ -267,6 +267,10 @@ private:
 	void takeHeavyData(Set &to, Set &from);
 	void takeHeavyData(Sticker &to, Sticker &from);
 	void clearHeavyIn(Set &set, bool clearSavedFrames = true);
+	void clearHeavyOutside(
+		const SectionInfo &info,
+		int keepTop,
+		int keepBottom);
 	void clearHeavyData();
 
 	int stickersRight() const;
@@ -22,29 +22,63 @@ namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
 
+// Document base cache keys leave 16 low bits free, so the frame cache of
+// a document is keyed by the rendered box instead of the place it is shown
+// in. The chat, the stickers panel and the set preview share the frames
+// of the same sticker if they show it in the same box.
+//
+// The box hash takes 12 bits, the emoji color replacements tag (up to 5)
+// takes 3 bits and the quality takes the lowest one.
+[[nodiscard]] uint16 DocumentKeyShift(
+		QSize box,
+		Lottie::Quality quality,
+		uint8 replacementsTag) {
+	Expects(replacementsTag < 8);
+
+	const auto hash = uint32(box.width()) * 0x9E3779B1U
+		+ uint32(box.height()) * 0x85EBCA6BU;
+	return uint16((hash >> 20) << 4)
+		| uint16((replacementsTag & 0x07U) << 1)
+		| uint16((quality == Lottie::Quality::High) ? 1 : 0);
+}
+
 } // namespace
 
 template <typename Method>
 auto LottieCachedFromContent(
 		Method &&method,
 		Storage::Cache::Key baseKey,
-		uint8 keyShift,
+		uint16 keyShift,
 		not_null<Main::Session*> session,
 		const QByteArray &content,
-		QSize box) {
+		QSize box,
+		bool readLegacyCache = false) {
 	const auto key = Storage::Cache::Key{
 		baseKey.high,
 		baseKey.low + keyShift
 	};
+	// Frame caches are kept in the main cache, so that they are not
+	// evicted by streamed videos. Caches written to the big file cache
+	// by the previous versions are still read from there, if they are
+	// stored by the same key.
+	const auto weak = base::make_weak(session.get());
 	const auto get = [=](FnMut<void(QByteArray &&cached)> handler) {
-		session->data().cacheBigFile().get(
-			key,
-			std::move(handler));
+		session->data().cache().get(key, [
+			=,
+			handler = std::move(handler)
+		](QByteArray &&cached) mutable {
+			if (!cached.isEmpty() || !readLegacyCache) {
+				handler(std::move(cached));
+				return;
+			}
+			crl::on_main(weak, [=, handler = std::move(handler)]() mutable {
+				weak->data().cacheBigFile().get(key, std::move(handler));
+			});
+		});
 	};
-	const auto weak = base::make_weak(session.get());
 	const auto put = [=](QByteArray &&cached) {
 		crl::on_main(weak, [=, data = std::move(cached)]() mutable {
-			weak->data().cacheBigFile().put(key, std::move(data));
+			weak->data().cache().put(key, std::move(data));
 		});
 	};
 	return method(
@@ -58,7 +92,7 @@ template <typename Method>
 auto LottieFromDocument(
 		Method &&method,
 		not_null<Data::DocumentMedia*> media,
-		uint8 keyShift,
+		uint16 keyShift,
 		QSize box) {
 	const auto document = media->owner();
 	const auto data = media->bytes();
@@ -113,8 +147,8 @@ std::unique_ptr<Lottie::SinglePlayer> LottiePlayerFromDocument(
 			std::move(renderer));
 	};
 	const auto tag = replacements ? replacements->tag : uint8(0);
-	const auto keyShift = ((tag << 4) & 0xF0) | (uint8(sizeTag) & 0x0F);
-	return LottieFromDocument(method, media, uint8(keyShift), box);
+	const auto keyShift = DocumentKeyShift(box, quality, tag);
+	return LottieFromDocument(method, media, keyShift, box);
 }
 
 not_null<Lottie::Animation*> LottieAnimationFromDocument(
@@ -125,7 +159,9 @@ not_null<Lottie::Animation*> LottieAnimationFromDocument(
 	const auto method = [&](auto &&...args) {
 		return player->append(std::forward<decltype(args)>(args)...);
 	};
-	return LottieFromDocument(method, media, uint8(sizeTag), box);
+	// All the multi players render in the default quality.
+	const auto keyShift = DocumentKeyShift(box, Lottie::Quality::Default, 0);
+	return LottieFromDocument(method, media, keyShift, box);
 }
 
 bool HasLottieThumbnail(
@@ -179,13 +215,20 @@ std::unique_ptr<Lottie::SinglePlayer> LottieThumbnail(
 		: media
 		? &media->owner()->session()
 		: nullptr;
+	// Sticker set thumbnail keys have only 8 free bits, so they are
+	// still keyed by the size tag, like in the previous versions.
+	const auto keyShift = thumb
+		? uint16(sizeTag)
+		: DocumentKeyShift(box, Lottie::Quality::Default, 0);
+	const auto readLegacyCache = (thumb != nullptr);
 	return LottieCachedFromContent(
 		method,
 		baseKey,
-		uint8(sizeTag),
+		keyShift,
 		session,
 		content,
-		box);
+		box,
+		readLegacyCache);
 }
 
 } // namespace ChatHelpers
@@ -36,6 +36,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "lang/lang_hardcoded.h"
 #include "mainwidget.h"
 #include "core/file_utilities.h"
+#include "core/startup_trace.h"
 #include "main/main_account.h"
 #include "main/main_domain.h"
 #include "main/main_session.h"
@@ -176,6 +177,7 @@ Application::~Application() {
 }
 
 void Application::run() {
+	STARTUP_TRACE_SPAN("Core::Application::run");
 	style::internal::StartFonts();
 
 	ThirdParty::start();
@@ -185,7 +187,10 @@ void Application::run() {
 	// Depends on OpenSSL on macOS, so on ThirdParty::start().
 	_notifications = std::make_unique<Window::Notifications::System>();
 
-	startLocalStorage();
+	{
+		STARTUP_TRACE_SPAN("Core::Application::startLocalStorage");
+		startLocalStorage();
+	}
 	ValidateScale();
 
 	if (Local::oldSettingsVersion() < AppVersion) {
@@ -229,7 +234,10 @@ void Application::run() {
 	// Create mime database, so it won't be slow later.
 	QMimeDatabase().mimeTypeForName(qsl("text/plain"));
 
-	_window = std::make_unique<Window::Controller>();
+	{
+		STARTUP_TRACE_SPAN("Window::Controller");
+		_window = std::make_unique<Window::Controller>();
+	}
 	_domain->activeChanges(
 	) | rpl::start_with_next([=](not_null<Main::Account*> account) {
 		_window->showAccount(account);
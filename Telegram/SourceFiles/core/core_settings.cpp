@@ -94,7 +94,9 @@ QByteArray Settings::serialize() const {
 		}
 		stream
 			<< qint32(_autoDownloadDictionaries.current() ? 1 : 0)
-			<< qint32(_mainMenuAccountsShown.current() ? 1 : 0);
+			<< qint32(_mainMenuAccountsShown.current() ? 1 : 0)
+			<< qint32(_historiesMemoryLimit)
+			<< qint32(_hardwareAcceleratedVideo ? 1 : 0);
 	}
 	return result;
 }
@@ -150,6 +152,8 @@ void Settings::addFromSerialized(const QByteArray &serialized) {
 	std::vector<int> dictionariesEnabled;
 	qint32 autoDownloadDictionaries = _autoDownloadDictionaries.current() ? 1 : 0;
 	qint32 mainMenuAccountsShown = _mainMenuAccountsShown.current() ? 1 : 0;
+	qint32 historiesMemoryLimit = _historiesMemoryLimit;
+	qint32 hardwareAcceleratedVideo = _hardwareAcceleratedVideo ? 1 : 0;
 
 	stream >> themesAccentColors;
 	if (!stream.atEnd()) {
@@ -211,6 +215,12 @@ void Settings::addFromSerialized(const QByteArray &serialized) {
 			>> autoDownloadDictionaries
 			>> mainMenuAccountsShown;
 	}
+	if (!stream.atEnd()) {
+		stream >> historiesMemoryLimit;
+	}
+	if (!stream.atEnd()) {
+		stream >> hardwareAcceleratedVideo;
+	}
 	if (stream.status() != QDataStream::Ok) {
 		LOG(("App Error: "
 			"Bad data for Core::Settings::constructFromSerialized()"));
@@ -281,6 +291,8 @@ void Settings::addFromSerialized(const QByteArray &serialized) {
 	_dictionariesEnabled = std::move(dictionariesEnabled);
 	_autoDownloadDictionaries = (autoDownloadDictionaries == 1);
 	_mainMenuAccountsShown = (mainMenuAccountsShown == 1);
+	_historiesMemoryLimit = std::max(historiesMemoryLimit, 0);
+	_hardwareAcceleratedVideo = (hardwareAcceleratedVideo == 1);
 }
 
 bool Settings::chatWide() const {
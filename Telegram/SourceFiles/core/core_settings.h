@@ -363,6 +363,21 @@ public:
 	void setMainMenuAccountsShown(bool value) {
 		_mainMenuAccountsShown = value;
 	}
+
+	// Approximate memory in megabytes for the loaded messages of chats
+	// that are not shown right now, zero means no limit.
+	[[nodiscard]] int historiesMemoryLimit() const {
+		return _historiesMemoryLimit;
+	}
+	void setHistoriesMemoryLimit(int megabytes) {
+		_historiesMemoryLimit = std::max(megabytes, 0);
+	}
+	[[nodiscard]] bool hardwareAcceleratedVideo() const {
+		return _hardwareAcceleratedVideo;
+	}
+	void setHardwareAcceleratedVideo(bool value) {
+		_hardwareAcceleratedVideo = value;
+	}
 	[[nodiscard]] bool tabbedSelectorSectionEnabled() const {
 		return _tabbedSelectorSectionEnabled;
 	}
@@ -417,6 +432,7 @@ private:
 	static constexpr auto kDefaultThirdColumnWidth = 0;
 	static constexpr auto kDefaultDialogsWidthRatio = 5. / 14;
 	static constexpr auto kDefaultBigDialogsWidthRatio = 0.275;
+	static constexpr auto kDefaultHistoriesMemoryLimit = 512;
 
 	bool _adaptiveForWide = true;
 	bool _moderateModeEnabled = false;
@@ -459,6 +475,8 @@ private:
 	rpl::variable<std::vector<int>> _dictionariesEnabled;
 	rpl::variable<bool> _autoDownloadDictionaries = true;
 	rpl::variable<bool> _mainMenuAccountsShown = false;
+	int _historiesMemoryLimit = kDefaultHistoriesMemoryLimit;
+	bool _hardwareAcceleratedVideo = false;
 	bool _tabbedSelectorSectionEnabled = false; // per-window
 	Window::Column _floatPlayerColumn; // per-window
 	RectPart _floatPlayerCorner; // per-window
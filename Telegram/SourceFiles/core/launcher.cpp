@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_reports.h"
 #include "core/update_checker.h"
 #include "core/sandbox.h"
+#include "core/startup_trace.h"
 #include "base/concurrent_timer.h"
 
 namespace Core {
@@ -313,14 +314,31 @@ int Launcher::exec() {
 	}
 
 	// Must be started before Platform is started.
-	Logs::start(this);
+	{
+		STARTUP_TRACE_SPAN("Logs::start");
+		Logs::start(this);
+	}
+
+	// The working dir is chosen in Logs::start, so the running instance
+	// can be found only now, but still before the heavy initialization.
+	if (Logs::started() && Sandbox::ForwardToRunningInstance(_argc, _argv)) {
+		CrashReports::Finish();
+		Logs::finish();
+		return 0;
+	}
 
 	// Must be started before Sandbox is created.
-	Platform::start();
+	{
+		STARTUP_TRACE_SPAN("Platform::start");
+		Platform::start();
+	}
 	Ui::DisableCustomScaling();
 
 	auto result = executeApplication();
 
+	// If we've quit before showing the chats list.
+	STARTUP_TRACE_FINISH("Launcher::exec finished");
+
 	DEBUG_LOG(("Telegram finished, result: %1").arg(result));
 
 	if (!UpdaterDisabled() && cRestartingUpdate()) {
@@ -441,6 +459,7 @@ void Launcher::processArguments() {
 		{ "-workdir"        , KeyFormat::OneValue },
 		{ "--"              , KeyFormat::OneValue },
 		{ "-scale"          , KeyFormat::OneValue },
+		{ "-tracestartup"   , KeyFormat::NoValues },
 	};
 	auto parseResult = QMap<QByteArray, QStringList>();
 	auto parsingKey = QByteArray();
@@ -465,6 +484,12 @@ void Launcher::processArguments() {
 		}
 	}
 
+#ifndef TDESKTOP_DISABLE_STARTUP_TRACE
+	if (parseResult.contains("-tracestartup")) {
+		StartupTrace::Start();
+	}
+#endif // !TDESKTOP_DISABLE_STARTUP_TRACE
+
 	if (parseResult.contains("-externalupdater")) {
 		SetUpdaterDisabledAtStartup();
 	}
@@ -0,0 +1,85 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/main_thread_watchdog.h"
+
+namespace Core {
+namespace {
+
+constexpr auto kHangTimeout = 2 * crl::time(1000);
+constexpr auto kCheckTimeout = crl::time(500);
+
+} // namespace
+
+MainThreadWatchdog::MainThreadWatchdog()
+: _thread([=] { check(); }) {
+}
+
+MainThreadWatchdog::~MainThreadWatchdog() {
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wake.notify_one();
+	_thread.join();
+}
+
+void MainThreadWatchdog::eventStarted(int type, const char *receiver) {
+	const auto now = crl::now();
+	_events.push_back({ type, receiver, now });
+	_type.store(type, std::memory_order_relaxed);
+	_receiver.store(receiver, std::memory_order_relaxed);
+	_reported.store(false, std::memory_order_relaxed);
+	_started.store(now, std::memory_order_release);
+}
+
+void MainThreadWatchdog::eventFinished() {
+	Expects(!_events.empty());
+
+	const auto event = _events.back();
+	_events.pop_back();
+
+	const auto now = crl::now();
+	const auto duration = now - event.started;
+	if (duration >= kHangTimeout) {
+		LOG(("Main Thread Warning: event %1 for %2 finished after %3 ms."
+			).arg(event.type
+			).arg(QString::fromLatin1(event.receiver)
+			).arg(duration));
+	}
+
+	// The outer event runs a nested loop, which has just made progress.
+	// Until it returns to the outer event it may wait for events, so
+	// nothing is checked now and the outer one is measured from here.
+	_started.store(0, std::memory_order_release);
+	if (!_events.empty()) {
+		auto &outer = _events.back();
+		outer.started = now;
+		_type.store(outer.type, std::memory_order_relaxed);
+		_receiver.store(outer.receiver, std::memory_order_relaxed);
+	}
+}
+
+void MainThreadWatchdog::check() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stopping) {
+		_wake.wait_for(lock, std::chrono::milliseconds(kCheckTimeout));
+		const auto started = _started.load(std::memory_order_acquire);
+		const auto now = crl::now();
+		if (!started
+			|| (now - started < kHangTimeout)
+			|| _reported.exchange(true, std::memory_order_relaxed)) {
+			continue;
+		}
+		LOG(("Main Thread Warning: event %1 for %2 is running for %3 ms."
+			).arg(_type.load(std::memory_order_relaxed)
+			).arg(QString::fromLatin1(_receiver.load(std::memory_order_relaxed))
+			).arg(now - started));
+	}
+}
+
+} // namespace Core
@@ -0,0 +1,59 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Core {
+
+// Writes to the log the main thread events that run too long.
+// A separate thread reports the event while it is still running,
+// so even the hangs that end with the app being killed are in the log.
+//
+// Events of nested event loops (modal dialogs, drag and drop, window
+// moving) are tracked on their own. Each of them counts as progress of
+// the outer event, which is not reported while its loop waits for events.
+class MainThreadWatchdog final {
+public:
+	MainThreadWatchdog();
+	MainThreadWatchdog(const MainThreadWatchdog &other) = delete;
+	MainThreadWatchdog &operator=(const MainThreadWatchdog &other) = delete;
+	~MainThreadWatchdog();
+
+	// The receiver class name must outlive the event.
+	void eventStarted(int type, const char *receiver);
+	void eventFinished();
+
+private:
+	struct Event {
+		int type = 0;
+		const char *receiver = nullptr;
+		crl::time started = 0;
+	};
+
+	void check();
+
+	// Accessed only from the main thread.
+	std::vector<Event> _events;
+
+	std::atomic<crl::time> _started = 0;
+	std::atomic<int> _type = 0;
+	std::atomic<const char*> _receiver = nullptr;
+	std::atomic<bool> _reported = false;
+
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	bool _stopping = false;
+	std::thread _thread;
+
+};
+
+} // namespace Core
@@ -9,7 +9,56 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtCore/QMimeDatabase>
 
+#include <string_view>
+
 namespace Core {
+namespace {
+
+struct Signature {
+	int offset = 0;
+	std::string_view bytes;
+	std::string_view mime;
+};
+
+// Formats that can be told by their first bytes whatever the extension is,
+// so the mime database doesn't read and match the file content itself.
+constexpr auto kSignatures = std::array{
+	Signature{ 0, "\x89PNG\r\n\x1A\n", "image/png" },
+	Signature{ 0, "\xFF\xD8\xFF", "image/jpeg" },
+	Signature{ 0, "GIF87a", "image/gif" },
+	Signature{ 0, "GIF89a", "image/gif" },
+};
+constexpr auto kSignaturePrefixSize = 16;
+
+[[nodiscard]] bool IsWebP(const QByteArray &prefix) {
+	return (prefix.size() >= 12)
+		&& !memcmp(prefix.constData(), "RIFF", 4)
+		&& !memcmp(prefix.constData() + 8, "WEBP", 4);
+}
+
+[[nodiscard]] std::optional<MimeType> MimeTypeForPrefix(
+		const QByteArray &prefix) {
+	if (IsWebP(prefix)) {
+		return MimeType(MimeType::Known::WebP);
+	}
+	for (const auto &signature : kSignatures) {
+		const auto till = signature.offset + int(signature.bytes.size());
+		if (prefix.size() < till) {
+			continue;
+		} else if (!memcmp(
+				prefix.constData() + signature.offset,
+				signature.bytes.data(),
+				signature.bytes.size())) {
+			return MimeType(QMimeDatabase().mimeTypeForName(
+				QString::fromLatin1(
+					signature.mime.data(),
+					signature.mime.size())));
+		}
+	}
+	return std::nullopt;
+}
+
+} // namespace
 
 MimeType::MimeType(const QMimeType &type) : _typeStruct(type) {
 }
@@ -81,11 +130,9 @@ MimeType MimeTypeForFile(const QFileInfo &file) {
 	{
 		QFile f(path);
 		if (f.open(QIODevice::ReadOnly)) {
-			QByteArray magic = f.read(12);
-			if (magic.size() >= 12) {
-				if (!memcmp(magic.constData(), "RIFF", 4) && !memcmp(magic.constData() + 8, "WEBP", 4)) {
-					return MimeType(MimeType::Known::WebP);
-				}
+			if (const auto result = MimeTypeForPrefix(
+					f.read(kSignaturePrefixSize))) {
+				return *result;
 			}
 			f.close();
 		}
@@ -94,10 +141,11 @@ MimeType MimeTypeForFile(const QFileInfo &file) {
 }
 
 MimeType MimeTypeForData(const QByteArray &data) {
-	if (data.size() >= 12) {
-		if (!memcmp(data.constData(), "RIFF", 4) && !memcmp(data.constData() + 8, "WEBP", 4)) {
-			return MimeType(MimeType::Known::WebP);
-		}
+	if (const auto result = MimeTypeForPrefix(
+			QByteArray::fromRawData(
+				data.constData(),
+				std::min(data.size(), kSignaturePrefixSize)))) {
+		return *result;
 	}
 	return MimeType(QMimeDatabase().mimeTypeForData(data));
 }
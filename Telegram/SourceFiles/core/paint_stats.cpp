@@ -0,0 +1,134 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/paint_stats.h"
+
+namespace Core {
+namespace PaintStats {
+namespace {
+
+constexpr auto kWriteTimeout = 60 * crl::time(1000);
+constexpr auto kFrameDuration = crl::time(16);
+constexpr auto kBuckets = std::array<crl::time, 6>{ 2, 4, 8, 16, 33, 66 };
+
+struct Histogram {
+	std::array<int, kBuckets.size() + 1> counts = { { 0 } };
+	crl::time total = 0;
+	crl::time max = 0;
+};
+
+struct Stall {
+	int count = 0;
+	crl::time total = 0;
+	crl::time max = 0;
+};
+
+struct State {
+	base::flat_map<const char*, Histogram> frames;
+	base::flat_map<int, Stall> stalls;
+	crl::time nextWrite = 0;
+};
+
+State &Data() {
+	static auto result = State();
+	return result;
+}
+
+[[nodiscard]] QString Serialize(const Histogram &histogram) {
+	auto result = QStringList();
+	auto from = crl::time(0);
+	auto count = 0;
+	auto slow = 0;
+	for (auto i = 0; i != int(kBuckets.size()); ++i) {
+		result.push_back(qsl("%1-%2ms: %3"
+			).arg(from
+			).arg(kBuckets[i]
+			).arg(histogram.counts[i]));
+		count += histogram.counts[i];
+		if (from >= kFrameDuration) {
+			slow += histogram.counts[i];
+		}
+		from = kBuckets[i];
+	}
+	const auto last = histogram.counts.back();
+	result.push_back(qsl("%1ms+: %2").arg(from).arg(last));
+	count += last;
+	slow += last;
+	return qsl("%1 frames, %2 slow, avg %3ms, max %4ms (%5)"
+		).arg(count
+		).arg(slow
+		).arg(count ? (histogram.total / count) : 0
+		).arg(histogram.max
+		).arg(result.join(", "));
+}
+
+void Write(State &data) {
+	for (const auto &[name, histogram] : data.frames) {
+		DEBUG_LOG(("Paint Stats: %1 - %2."
+			).arg(QString::fromLatin1(name)
+			).arg(Serialize(histogram)));
+	}
+	for (const auto &[type, stall] : data.stalls) {
+		DEBUG_LOG(("Paint Stats: event %1 stalled %2 times, avg %3ms, max %4ms."
+			).arg(type
+			).arg(stall.count
+			).arg(stall.total / stall.count
+			).arg(stall.max));
+	}
+	data.frames.clear();
+	data.stalls.clear();
+}
+
+void CheckWrite(State &data, crl::time now) {
+	if (!data.nextWrite) {
+		data.nextWrite = now + kWriteTimeout;
+	} else if (data.nextWrite <= now) {
+		Write(data);
+		data.nextWrite = now + kWriteTimeout;
+	}
+}
+
+} // namespace
+
+bool Enabled() {
+	return Logs::DebugEnabled();
+}
+
+void RecordEvent(int type, crl::time duration) {
+	if (duration <= kFrameDuration) {
+		return;
+	}
+	auto &data = Data();
+	auto &stall = data.stalls[type];
+	++stall.count;
+	stall.total += duration;
+	accumulate_max(stall.max, duration);
+	CheckWrite(data, crl::now());
+}
+
+Frame::Frame(const char *name)
+: _name(name)
+, _start(Enabled() ? crl::now() : -1) {
+}
+
+Frame::~Frame() {
+	if (_start < 0) {
+		return;
+	}
+	const auto now = crl::now();
+	const auto duration = now - _start;
+	auto &data = Data();
+	auto &histogram = data.frames[_name];
+	const auto i = ranges::upper_bound(kBuckets, duration);
+	++histogram.counts[i - begin(kBuckets)];
+	histogram.total += duration;
+	accumulate_max(histogram.max, duration);
+	CheckWrite(data, now);
+}
+
+} // namespace PaintStats
+} // namespace Core
@@ -0,0 +1,42 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Core {
+namespace PaintStats {
+
+// Paint and layout durations of the heavy scrollable widgets, some hot
+// chats list operations and main thread stalls, collected only while
+// the debug logs are enabled and written there as histograms once
+// a minute. Main thread only.
+//
+// Frame names must be string literals, they are stored as pointers.
+
+[[nodiscard]] bool Enabled();
+
+// Top level events that took longer than a frame.
+void RecordEvent(int type, crl::time duration);
+
+class Frame final {
+public:
+	explicit Frame(const char *name);
+	Frame(const Frame &other) = delete;
+	Frame &operator=(const Frame &other) = delete;
+	~Frame();
+
+private:
+	const char *_name = nullptr;
+	crl::time _start = -1;
+
+};
+
+} // namespace PaintStats
+} // namespace Core
+
+#define PAINT_STATS_FRAME(name) const auto paintStatsFrame\
+	= ::Core::PaintStats::Frame(name)
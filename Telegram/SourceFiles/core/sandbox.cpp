@@ -18,6 +18,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/launcher.h"
 #include "core/local_url_handlers.h"
 #include "core/update_checker.h"
+#include "core/paint_stats.h"
+#include "core/main_thread_watchdog.h"
 #include "base/timer.h"
 #include "base/concurrent_timer.h"
 #include "base/invoke_queued.h"
@@ -34,6 +36,8 @@ namespace Core {
 namespace {
 
 constexpr auto kEmptyPidForCommandResponse = 0ULL;
+constexpr auto kForwardConnectTimeout = 1000;
+constexpr auto kForwardResponseTimeout = 10000;
 
 using ErrorSignal = void(QLocalSocket::*)(QLocalSocket::LocalSocketError);
 const auto QLocalSocket_error = ErrorSignal(&QLocalSocket::error);
@@ -76,8 +80,77 @@ QString _escapeFrom7bit(const QString &str) {
 	return result;
 }
 
+[[nodiscard]] QString LocalServerName() {
+	const auto d = QFile::encodeName(QDir(cWorkingDir()).absolutePath());
+	char h[33] = { 0 };
+	hashMd5Hex(d.constData(), d.size(), h);
+	return Platform::SingleInstanceLocalServerName(h);
+}
+
+[[nodiscard]] QByteArray LocalServerCommands() {
+	auto commands = QString();
+	for (const auto &path : cSendPaths()) {
+		commands += qsl("SEND:") + _escapeTo7bit(path) + ';';
+	}
+	if (!cStartUrl().isEmpty()) {
+		commands += qsl("OPEN:") + _escapeTo7bit(cStartUrl()) + ';';
+	} else {
+		commands += qsl("CMD:show;");
+	}
+	DEBUG_LOG(("Sandbox Info: writing commands %1").arg(commands));
+	return commands.toLatin1();
+}
+
+[[nodiscard]] std::optional<uint64> CommandResponsePid(const QString &data) {
+	if (!QRegularExpression("RES:(\\d+);").match(data).hasMatch()) {
+		return std::nullopt;
+	}
+	return data.mid(4, data.length() - 5).toULongLong();
+}
+
 } // namespace
 
+bool Sandbox::ForwardToRunningInstance(int argc, char **argv) {
+#ifndef Q_OS_WINRT
+	if (cManyInstance()) {
+		return false;
+	}
+
+	// QLocalSocket needs an event dispatcher, but QCoreApplication
+	// doesn't load the platform plugins like QApplication does.
+	QCoreApplication application(argc, argv);
+	const auto name = LocalServerName();
+	QLocalSocket socket;
+	socket.connectToServer(name);
+	if (!socket.waitForConnected(kForwardConnectTimeout)) {
+		return false;
+	}
+	LOG(("Socket connected to %1, this is not the first application "
+		"instance, sending commands before the full start...").arg(name));
+
+	socket.write(LocalServerCommands());
+	socket.waitForBytesWritten(kForwardResponseTimeout);
+	auto response = QString();
+	while (true) {
+		if (const auto pid = CommandResponsePid(response)) {
+			if (*pid != kEmptyPidForCommandResponse) {
+				psActivateProcess(*pid);
+			}
+			LOG(("Command response received, pid = %1, quitting..."
+				).arg(*pid));
+			return true;
+		} else if (!socket.waitForReadyRead(kForwardResponseTimeout)) {
+			// The commands could be delivered already, don't send twice.
+			LOG(("Could not get command response, error %1, quitting..."
+				).arg(socket.error()));
+			return true;
+		}
+		response.append(QString::fromLatin1(socket.readAll()));
+	}
+#endif // !Q_OS_WINRT
+	return false;
+}
+
 Sandbox::Sandbox(
 	not_null<Core::Launcher*> launcher,
 	int &argc,
@@ -93,13 +166,12 @@ Sandbox::Sandbox(
 }
 
 int Sandbox::start() {
+	_watchdog = std::make_unique<MainThreadWatchdog>();
+
 	if (!Core::UpdaterDisabled()) {
 		_updateChecker = std::make_unique<Core::UpdateChecker>();
 	}
-	const auto d = QFile::encodeName(QDir(cWorkingDir()).absolutePath());
-	char h[33] = { 0 };
-	hashMd5Hex(d.constData(), d.size(), h);
-	_localServerName = Platform::SingleInstanceLocalServerName(h);
+	_localServerName = LocalServerName();
 
 	connect(
 		&_localSocket,
@@ -226,19 +298,7 @@ void Sandbox::socketConnected() {
 	LOG(("Socket connected, this is not the first application instance, sending show command..."));
 	_secondInstance = true;
 
-	QString commands;
-	const QStringList &lst(cSendPaths());
-	for (QStringList::const_iterator i = lst.cbegin(), e = lst.cend(); i != e; ++i) {
-		commands += qsl("SEND:") + _escapeTo7bit(*i) + ';';
-	}
-	if (!cStartUrl().isEmpty()) {
-		commands += qsl("OPEN:") + _escapeTo7bit(cStartUrl()) + ';';
-	} else {
-		commands += qsl("CMD:show;");
-	}
-
-	DEBUG_LOG(("Sandbox Info: writing commands %1").arg(commands));
-	_localSocket.write(commands.toLatin1());
+	_localSocket.write(LocalServerCommands());
 }
 
 void Sandbox::socketWritten(qint64/* bytes*/) {
@@ -258,12 +318,11 @@ void Sandbox::socketReading() {
 		return;
 	}
 	_localSocketReadData.append(_localSocket.readAll());
-	if (QRegularExpression("RES:(\\d+);").match(_localSocketReadData).hasMatch()) {
-		uint64 pid = _localSocketReadData.mid(4, _localSocketReadData.length() - 5).toULongLong();
-		if (pid != kEmptyPidForCommandResponse) {
-			psActivateProcess(pid);
+	if (const auto pid = CommandResponsePid(_localSocketReadData)) {
+		if (*pid != kEmptyPidForCommandResponse) {
+			psActivateProcess(*pid);
 		}
-		LOG(("Show command response received, pid = %1, activating and quitting...").arg(pid));
+		LOG(("Show command response received, pid = %1, activating and quitting...").arg(*pid));
 		return App::quit();
 	}
 }
@@ -534,7 +593,24 @@ bool Sandbox::notify(QObject *receiver, QEvent *e) {
 			return true;
 		}
 	}
-	return notifyOrInvoke(receiver, e);
+	// Events sent right from other events are a part of them, the ones
+	// dispatched by a nested event loop are watched on their own.
+	const auto fromLoop = (_eventNestingLevel == 1)
+		|| (_eventNestingLevel == _loopNestingLevel + 1);
+	if (!fromLoop || !_watchdog) {
+		return notifyOrInvoke(receiver, e);
+	}
+	const auto type = int(e->type());
+	const auto started = crl::now();
+	_watchdog->eventStarted(
+		type,
+		receiver ? receiver->metaObject()->className() : nullptr);
+	const auto result = notifyOrInvoke(receiver, e);
+	_watchdog->eventFinished();
+	if (_eventNestingLevel == 1 && PaintStats::Enabled()) {
+		PaintStats::RecordEvent(type, crl::now() - started);
+	}
+	return result;
 }
 
 void Sandbox::processPostponedCalls(int level) {
@@ -19,6 +19,7 @@ namespace Core {
 class Launcher;
 class UpdateChecker;
 class Application;
+class MainThreadWatchdog;
 
 class Sandbox final
 	: public QApplication
@@ -37,6 +38,12 @@ public:
 
 	int start();
 
+	// Hands the command line to an already running instance before
+	// QApplication is created, returns false if there is none.
+	[[nodiscard]] static bool ForwardToRunningInstance(
+		int argc,
+		char **argv);
+
 	void refreshGlobalProxy();
 	uint64 installationTag() const;
 
@@ -119,6 +126,7 @@ private:
 	bool _secondInstance = false;
 
 	std::unique_ptr<UpdateChecker> _updateChecker;
+	std::unique_ptr<MainThreadWatchdog> _watchdog;
 
 	QByteArray _lastCrashDump;
 	MTP::ProxyData _sandboxProxy;
@@ -0,0 +1,169 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/startup_trace.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace Core {
+namespace StartupTrace {
+namespace {
+
+constexpr auto kMaxEventsCount = 64 * 1024;
+
+struct Event {
+	const char *name = nullptr;
+	int64 start = 0;
+	int64 duration = -1; // Instant event.
+	int thread = 0;
+};
+
+struct State {
+	std::mutex mutex;
+	std::chrono::steady_clock::time_point started;
+	std::vector<Event> events;
+	std::vector<std::thread::id> threads;
+};
+
+std::atomic<bool> Recording = false;
+std::atomic<bool> Finished = false;
+
+State &Data() {
+	static auto result = State();
+	return result;
+}
+
+[[nodiscard]] int64 Now() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+		steady_clock::now() - Data().started).count();
+}
+
+// Must be called with the mutex locked.
+[[nodiscard]] int ThreadIndex(State &data) {
+	const auto id = std::this_thread::get_id();
+	const auto i = ranges::find(data.threads, id);
+	if (i != end(data.threads)) {
+		return int(i - begin(data.threads)) + 1;
+	}
+	data.threads.push_back(id);
+	return int(data.threads.size());
+}
+
+void Push(const char *name, int64 start, int64 duration) {
+	auto &data = Data();
+	std::unique_lock<std::mutex> lock(data.mutex);
+	if (!Recording || data.events.size() >= kMaxEventsCount) {
+		return;
+	}
+	data.events.push_back({ name, start, duration, ThreadIndex(data) });
+}
+
+void Write(std::vector<Event> &&events) {
+	auto list = QJsonArray();
+	for (const auto &event : events) {
+		auto object = QJsonObject();
+		object.insert("name", QString::fromLatin1(event.name));
+		object.insert("cat", "startup");
+		object.insert("pid", 1);
+		object.insert("tid", event.thread);
+		object.insert("ts", double(event.start));
+		if (event.duration >= 0) {
+			object.insert("ph", "X");
+			object.insert("dur", double(event.duration));
+		} else {
+			object.insert("ph", "i");
+			object.insert("s", "g");
+		}
+		list.append(object);
+	}
+	auto main = QJsonObject();
+	main.insert("name", "thread_name");
+	main.insert("ph", "M");
+	main.insert("pid", 1);
+	main.insert("tid", 1);
+	main.insert("args", QJsonObject{ { "name", "main" } });
+	list.append(main);
+
+	auto document = QJsonObject();
+	document.insert("traceEvents", list);
+	document.insert("displayTimeUnit", "ms");
+
+	const auto path = cWorkingDir() + qsl("startup_trace.json");
+	auto f = QFile(path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("Startup Trace Error: could not open '%1'.").arg(path));
+		return;
+	}
+	f.write(QJsonDocument(document).toJson(QJsonDocument::Compact));
+	LOG(("Startup Trace: %1 events written to '%2'."
+		).arg(events.size()
+		).arg(path));
+}
+
+} // namespace
+
+void Start() {
+	auto &data = Data();
+	std::unique_lock<std::mutex> lock(data.mutex);
+	if (Recording || Finished) {
+		return;
+	}
+	data.started = std::chrono::steady_clock::now();
+	data.events.reserve(1024);
+
+	// The thread calling Start() is the main one, it gets tid 1.
+	[[maybe_unused]] const auto main = ThreadIndex(data);
+	Recording = true;
+}
+
+bool Enabled() {
+	return Recording;
+}
+
+void Finish() {
+	if (Finished.exchange(true)) {
+		return;
+	}
+	auto &data = Data();
+	std::unique_lock<std::mutex> lock(data.mutex);
+	if (!Recording) {
+		return;
+	}
+	Recording = false;
+	auto events = base::take(data.events);
+	lock.unlock();
+
+	Write(std::move(events));
+}
+
+void Mark(const char *name) {
+	if (Recording) {
+		Push(name, Now(), -1);
+	}
+}
+
+Span::Span(const char *name)
+: _name(name)
+, _start(Recording ? Now() : -1) {
+}
+
+Span::~Span() {
+	if (_start >= 0 && Recording) {
+		Push(_name, _start, Now() - _start);
+	}
+}
+
+} // namespace StartupTrace
+} // namespace Core
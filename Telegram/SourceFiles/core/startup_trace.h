@@ -0,0 +1,65 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Core {
+namespace StartupTrace {
+
+// Launch timeline in the Chrome trace event format, enabled by the
+// -tracestartup command line switch and written to startup_trace.json
+// in the working directory, next to log.txt.
+//
+// Event names must be string literals, they are stored as pointers.
+
+void Start();
+[[nodiscard]] bool Enabled();
+
+// Stops tracing and writes the collected events, only the first call works.
+void Finish();
+
+void Mark(const char *name);
+
+class Span final {
+public:
+	explicit Span(const char *name);
+	Span(const Span &other) = delete;
+	Span &operator=(const Span &other) = delete;
+	~Span();
+
+private:
+	const char *_name = nullptr;
+	int64 _start = -1;
+
+};
+
+} // namespace StartupTrace
+} // namespace Core
+
+#ifndef TDESKTOP_DISABLE_STARTUP_TRACE
+
+#define STARTUP_TRACE_CONCAT_INNER(a, b) a##b
+#define STARTUP_TRACE_CONCAT(a, b) STARTUP_TRACE_CONCAT_INNER(a, b)
+
+#define STARTUP_TRACE_SPAN(name) const auto STARTUP_TRACE_CONCAT(\
+	startupTraceSpan, \
+	__LINE__) = ::Core::StartupTrace::Span(name)
+#define STARTUP_TRACE_MARK(name) (::Core::StartupTrace::Mark(name))
+#define STARTUP_TRACE_FINISH(name) {\
+	if (::Core::StartupTrace::Enabled()) {\
+		::Core::StartupTrace::Mark(name);\
+		::Core::StartupTrace::Finish();\
+	}\
+}
+
+#else // !TDESKTOP_DISABLE_STARTUP_TRACE
+
+#define STARTUP_TRACE_SPAN(name) ((void)0)
+#define STARTUP_TRACE_MARK(name) ((void)0)
+#define STARTUP_TRACE_FINISH(name) ((void)0)
+
+#endif // !TDESKTOP_DISABLE_STARTUP_TRACE
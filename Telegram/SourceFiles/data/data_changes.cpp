@@ -23,7 +23,7 @@ void Changes::Manager<DataType, UpdateType>::updated(
 			flags |= i->second;
 			_updates.erase(i);
 		}
-		_stream.fire({ data, flags });
+		fire({ data, flags });
 	} else {
 		_updates[data] |= flags;
 	}
@@ -55,11 +55,61 @@ template <typename DataType, typename UpdateType>
 rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 		not_null<DataType*> data,
 		Flags flags) const {
-	return _stream.events(
-	) | rpl::filter([=](const UpdateType &update) {
-		const auto [updateData, updateFlags] = update;
-		return (updateData == data) && (updateFlags & flags);
-	});
+	const auto weak = std::weak_ptr<DataStreams>(_dataStreams);
+	return [=](auto consumer) {
+		auto result = rpl::lifetime();
+		const auto strong = weak.lock();
+		if (!strong) {
+			return result;
+		}
+		auto &entry = strong->streams[data];
+		if (!entry) {
+			entry = std::make_unique<DataStream>();
+		}
+		++entry->consumers;
+		strong->unused.remove(data);
+		entry->stream.events(
+		) | rpl::filter([=](const UpdateType &update) {
+			return (update.flags & flags);
+		}) | rpl::start_with_next_done([=](const UpdateType &update) {
+			consumer.put_next_copy(update);
+		}, [=] {
+			consumer.put_done();
+		}, result);
+
+		// Streams are destroyed only outside of fire(), see there.
+		result.add([=] {
+			const auto strong = weak.lock();
+			if (!strong) {
+				return;
+			}
+			const auto i = strong->streams.find(data);
+			if (i != end(strong->streams) && !--i->second->consumers) {
+				strong->unused.emplace(data);
+			}
+		});
+		return result;
+	};
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::fire(UpdateType update) {
+	_stream.fire_copy(update);
+
+	const auto streams = _dataStreams.get();
+	const auto [data, flags] = update;
+	const auto i = streams->streams.find(data);
+	if (i != end(streams->streams)) {
+		const auto stream = &i->second->stream;
+		++streams->firing;
+		stream->fire(std::move(update));
+		--streams->firing;
+	}
+	if (!streams->firing && !streams->unused.empty()) {
+		for (const auto unused : base::take(streams->unused)) {
+			streams->streams.remove(unused);
+		}
+	}
 }
 
 template <typename DataType, typename UpdateType>
@@ -80,7 +130,7 @@ rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::flagsValue(
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::sendNotifications() {
 	for (const auto [data, flags] : base::take(_updates)) {
-		_stream.fire({ data, flags });
+		fire({ data, flags });
 	}
 }
 
@@ -256,11 +256,28 @@ private:
 	private:
 		static constexpr auto kCount = details::CountBit<Flag>();
 
+		// Subscriptions to a single object get their own stream,
+		// so an update doesn't go through the filters of all of them.
+		struct DataStream {
+			rpl::event_stream<UpdateType> stream;
+			int consumers = 0;
+		};
+		struct DataStreams {
+			base::flat_map<
+				not_null<DataType*>,
+				std::unique_ptr<DataStream>> streams;
+			base::flat_set<not_null<DataType*>> unused;
+			int firing = 0;
+		};
+
 		void sendRealtimeNotifications(not_null<DataType*> data, Flags flags);
+		void fire(UpdateType update);
 
 		std::array<rpl::event_stream<UpdateType>, kCount> _realtimeStreams;
 		base::flat_map<not_null<DataType*>, Flags> _updates;
 		rpl::event_stream<UpdateType> _stream;
+		const std::shared_ptr<DataStreams> _dataStreams
+			= std::make_shared<DataStreams>();
 
 	};
 
@@ -174,8 +174,8 @@ const base::flat_set<not_null<History*>> &ChatFilter::never() const {
 	return _never;
 }
 
-bool ChatFilter::contains(not_null<History*> history) const {
-	const auto flag = [&] {
+ChatFilter::Flags ChatFilter::HistoryFlags(not_null<History*> history) {
+	const auto type = [&] {
 		const auto peer = history->peer;
 		if (const auto user = peer->asUser()) {
 			return user->isBot()
@@ -192,26 +192,48 @@ bool ChatFilter::contains(not_null<History*> history) const {
 				return Flag::Groups;
 			}
 		} else {
-			Unexpected("Peer type in ChatFilter::contains.");
+			Unexpected("Peer type in ChatFilter::HistoryFlags.");
 		}
 	}();
+	const auto notArchived = history->folderKnown() && !history->folder();
+	const auto notMuted = !history->mute()
+		|| (history->hasUnreadMentions() && notArchived);
+	const auto notRead = history->unreadCount()
+		|| history->unreadMark()
+		|| history->hasUnreadMentions()
+		|| history->fakeUnreadWhileOpened();
+	auto result = Flags(type);
+	if (notMuted) {
+		result |= Flag::NoMuted;
+	}
+	if (notRead) {
+		result |= Flag::NoRead;
+	}
+	if (notArchived) {
+		result |= Flag::NoArchived;
+	}
+	return result;
+}
+
+bool ChatFilter::contains(not_null<History*> history) const {
+	return contains(history, HistoryFlags(history));
+}
+
+bool ChatFilter::contains(
+		not_null<History*> history,
+		Flags historyFlags) const {
+	const auto types = Flag::Contacts
+		| Flag::NonContacts
+		| Flag::Groups
+		| Flag::Channels
+		| Flag::Bots;
+	const auto conditions = _flags
+		& (Flag::NoMuted | Flag::NoRead | Flag::NoArchived);
 	if (_never.contains(history)) {
 		return false;
 	}
-	return false
-		|| ((_flags & flag)
-			&& (!(_flags & Flag::NoMuted)
-				|| !history->mute()
-				|| (history->hasUnreadMentions()
-					&& history->folderKnown()
-					&& !history->folder()))
-			&& (!(_flags & Flag::NoRead)
-				|| history->unreadCount()
-				|| history->unreadMark()
-				|| history->hasUnreadMentions()
-				|| history->fakeUnreadWhileOpened())
-			&& (!(_flags & Flag::NoArchived)
-				|| (history->folderKnown() && !history->folder())))
+	return ((_flags & historyFlags & types)
+			&& ((historyFlags & conditions) == conditions))
 		|| _always.contains(history);
 }
 
@@ -355,8 +377,9 @@ bool ChatFilters::applyChange(ChatFilter &filter, ChatFilter &&updated) {
 	if (rulesChanged) {
 		const auto filterList = _owner->chatsFilters().chatsList(id);
 		const auto feedHistory = [&](not_null<History*> history) {
-			const auto now = updated.contains(history);
-			const auto was = filter.contains(history);
+			const auto flags = ChatFilter::HistoryFlags(history);
+			const auto now = updated.contains(history, flags);
+			const auto was = filter.contains(history, flags);
 			if (now != was) {
 				if (now) {
 					history->addToChatList(id, filterList);
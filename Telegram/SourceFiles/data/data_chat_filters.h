@@ -60,7 +60,15 @@ public:
 	[[nodiscard]] const std::vector<not_null<History*>> &pinned() const;
 	[[nodiscard]] const base::flat_set<not_null<History*>> &never() const;
 
+	// The peer type flag of the history together with those of NoMuted,
+	// NoRead and NoArchived flags which conditions the history satisfies.
+	// Computed once per history it lets check each filter by bit masks.
+	[[nodiscard]] static Flags HistoryFlags(not_null<History*> history);
+
 	[[nodiscard]] bool contains(not_null<History*> history) const;
+	[[nodiscard]] bool contains(
+		not_null<History*> history,
+		Flags historyFlags) const;
 
 private:
 	FilterId _id = 0;
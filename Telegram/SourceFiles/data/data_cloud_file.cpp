@@ -215,6 +215,9 @@ void LoadCloudFile(
 		if (fromCloud == LoadFromCloudOrLocal) {
 			file.loader->permitLoadFromCloud();
 		}
+		if (!autoLoading) {
+			file.loader->stopAutoLoading();
+		}
 		return;
 	} else if ((file.flags & CloudFile::Flag::Failed)
 		|| !file.location.valid()
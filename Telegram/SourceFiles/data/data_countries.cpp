@@ -10,7 +10,20 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Data {
 namespace {
 
-const std::array<CountryInfo, 231> List = { {
+constexpr auto kMaxCodeLength = 4;
+
+// Codes of each length have their own range in the prefix table:
+// 10 one-digit codes, then 100 two-digit codes and so on.
+constexpr auto kPrefixOffsets = std::array<int, kMaxCodeLength + 1>{
+	0,
+	10,
+	110,
+	1110,
+	11110,
+};
+constexpr auto kPrefixesCount = kPrefixOffsets[kMaxCodeLength];
+
+constexpr std::array<CountryInfo, 231> List = { {
 	{ "Afghanistan", "AF", "93" },
 	{ "Albania", "AL", "355" },
 	{ "Algeria", "DZ", "213" },
@@ -244,9 +257,59 @@ const std::array<CountryInfo, 231> List = { {
 	{ "Zimbabwe", "ZW", "263" },
 } };
 
+[[nodiscard]] constexpr int PrefixIndex(const char *code) {
+	auto length = 0;
+	auto value = 0;
+	for (; code[length] != 0; ++length) {
+		if (length == kMaxCodeLength
+			|| code[length] < '0'
+			|| code[length] > '9') {
+			return -1;
+		}
+		value = value * 10 + (code[length] - '0');
+	}
+	return length ? (kPrefixOffsets[length - 1] + value) : -1;
+}
+
+// Index in List plus one for each phone code, zero for unknown codes.
+// For the codes shared by several countries the last one is kept,
+// the same way CountriesByCode() does.
+[[nodiscard]] constexpr std::array<uint8, kPrefixesCount> PreparePrefixes() {
+	static_assert(List.size() < 255);
+
+	auto result = std::array<uint8, kPrefixesCount>{};
+	for (auto i = 0; i != int(List.size()); ++i) {
+		const auto index = PrefixIndex(List[i].code);
+		if (index >= 0) {
+			result[index] = uint8(i + 1);
+		}
+	}
+	return result;
+}
+
+constexpr auto ByPrefix = PreparePrefixes();
+
 QHash<QString, const CountryInfo *> ByCode;
 QHash<QString, const CountryInfo *> ByISO2;
 
+// Country with the longest phone code that the phone starts with.
+[[nodiscard]] const CountryInfo *CountryByPhone(const QString &phone) {
+	auto result = (const CountryInfo*)nullptr;
+	auto value = 0;
+	const auto till = std::min(int(phone.size()), kMaxCodeLength);
+	for (auto length = 0; length != till; ++length) {
+		const auto ch = phone[length].unicode();
+		if (ch < '0' || ch > '9') {
+			break;
+		}
+		value = value * 10 + int(ch - '0');
+		if (const auto index = ByPrefix[kPrefixOffsets[length] + value]) {
+			result = &List[index - 1];
+		}
+	}
+	return result;
+}
+
 } // namespace
 
 const std::array<CountryInfo, 231> &Countries() {
@@ -274,15 +337,8 @@ const QHash<QString, const CountryInfo *> &CountriesByISO2() {
 }
 
 QString ValidPhoneCode(QString fullCode) {
-	const auto &byCode = CountriesByCode();
-	while (fullCode.length()) {
-		const auto i = byCode.constFind(fullCode);
-		if (i != byCode.cend()) {
-			return (*i)->code;
-		}
-		fullCode.chop(1);
-	}
-	return QString();
+	const auto info = CountryByPhone(fullCode);
+	return info ? QString::fromLatin1(info->code) : QString();
 }
 
 QString CountryNameByISO2(const QString &iso) {
@@ -292,10 +348,8 @@ QString CountryNameByISO2(const QString &iso) {
 }
 
 QString CountryISO2ByPhone(const QString &phone) {
-	const auto &byCode = Data::CountriesByCode();
-	const auto code = Data::ValidPhoneCode(phone);
-	const auto i = byCode.find(code);
-	return (i != byCode.cend()) ? QString::fromUtf8((*i)->iso2) : QString();
+	const auto info = CountryByPhone(phone);
+	return info ? QString::fromLatin1(info->iso2) : QString();
 }
 
 } // namespace Data
@@ -22,6 +22,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/core_settings.h"
 #include "core/application.h"
 #include "storage/file_download.h"
+#include "storage/download_manager_mtproto.h"
 #include "ui/image/image.h"
 #include "app.h"
 
@@ -33,9 +34,14 @@ namespace {
 
 constexpr auto kReadAreaLimit = 12'032 * 9'024;
 constexpr auto kWallPaperThumbnailLimit = 960;
+constexpr auto kVideoThumbnailLimit = 1280;
 constexpr auto kMaxVideoFrameArea = 7'680 * 4'320;
 constexpr auto kGoodThumbQuality = 87;
 
+// Don't auto download files that would take longer than that
+// with the bandwidth measured by the downloader.
+constexpr auto kAutoDownloadMaxDuration = 60;
+
 enum class FileType {
 	Video,
 	AnimatedSticker,
@@ -56,7 +62,8 @@ enum class FileType {
 		QByteArray data,
 		FileType type) {
 	if (type == FileType::Video) {
-		return ::Media::Clip::PrepareForSending(path, data).thumbnail;
+		return DocumentMedia::ScaleVideoGoodThumbnail(
+			::Media::Clip::PrepareForSending(path, data).thumbnail);
 	} else if (type == FileType::AnimatedSticker) {
 		return Lottie::ReadThumbnail(Lottie::ReadContent(data, path));
 	} else if (type == FileType::Theme) {
@@ -268,7 +275,14 @@ void DocumentMedia::automaticLoad(
 	const auto filename = toCache
 		? QString()
 		: DocumentFileNameForSave(_owner);
+	const auto tooSlow = [&] {
+		const auto bandwidth = _owner->session().downloader(
+		).measuredBandwidth();
+		return (bandwidth > 0)
+			&& (_owner->size > bandwidth * kAutoDownloadMaxDuration);
+	};
 	const auto shouldLoadFromCloud = !Data::IsExecutableName(filename)
+		&& !tooSlow()
 		&& (item
 			? Data::AutoDownload::Should(
 				_owner->session().settings().autoDownload(),
@@ -426,6 +440,19 @@ void DocumentMedia::GenerateGoodThumbnail(
 	});
 }
 
+QImage DocumentMedia::ScaleVideoGoodThumbnail(QImage frame) {
+	// Larger frames only make the cache entries heavier to read and decode,
+	// history and shared media paint them much smaller anyway.
+	return (frame.width() > kVideoThumbnailLimit
+		|| frame.height() > kVideoThumbnailLimit)
+		? frame.scaled(
+			kVideoThumbnailLimit,
+			kVideoThumbnailLimit,
+			Qt::KeepAspectRatio,
+			Qt::SmoothTransformation)
+		: frame;
+}
+
 void DocumentMedia::CheckGoodThumbnail(not_null<DocumentData*> document) {
 	if (!document->goodThumbnailChecked()) {
 		ReadOrGenerateThumbnail(document);
@@ -82,6 +82,9 @@ public:
 	// For DocumentData.
 	static void CheckGoodThumbnail(not_null<DocumentData*> document);
 
+	// Video frames are stored as good thumbnails at most this large.
+	[[nodiscard]] static QImage ScaleVideoGoodThumbnail(QImage frame);
+
 private:
 	enum class Flag : uchar {
 		GoodThumbnailWanted = 0x01,
@@ -16,18 +16,45 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item.h"
 #include "history/view/history_view_element.h"
 #include "core/application.h"
+#include "core/core_settings.h"
+#include "platform/platform_specific.h"
 #include "apiwrap.h"
 
 namespace Data {
 namespace {
 
 constexpr auto kReadRequestTimeout = 3 * crl::time(1000);
+constexpr auto kIdleHistoriesCheckTimeout = 60 * crl::time(1000);
+constexpr auto kIdleHistoryUnloadTimeout = 15 * 60 * crl::time(1000);
+
+// Chats from the top of the list are preloaded while the user is idle.
+constexpr auto kPreloadCandidatesCount = 10;
+constexpr auto kPreloadPerCheck = 2;
+constexpr auto kPreloadMessagesCount = 30;
+constexpr auto kPreloadIdleTimeout = 10 * crl::time(1000);
+
+// Rough cost of a loaded message: the view, its text layout
+// and the media thumbnails it keeps alive.
+constexpr auto kLoadedMessageMemory = int64(8 * 1024);
+
+// Available physical memory below this part of the total is pressure.
+constexpr auto kMemoryPressurePart = 10;
+
+[[nodiscard]] int LoadedMessagesCount(not_null<History*> history) {
+	auto result = 0;
+	for (const auto &block : history->blocks) {
+		result += int(block->messages.size());
+	}
+	return result;
+}
 
 } // namespace
 
 Histories::Histories(not_null<Session*> owner)
 : _owner(owner)
-, _readRequestsTimer([=] { sendReadRequests(); }) {
+, _readRequestsTimer([=] { sendReadRequests(); })
+, _idleHistoriesTimer([=] { checkIdleHistories(); }) {
+	_idleHistoriesTimer.callEach(kIdleHistoriesCheckTimeout);
 }
 
 Session &Histories::owner() const {
@@ -62,9 +89,214 @@ void Histories::unloadAll() {
 }
 
 void Histories::clearAll() {
+	_shown.clear();
+	_lastShown.clear();
+	_preloaded.clear();
 	_map.clear();
 }
 
+void Histories::historyShown(not_null<History*> history) {
+	_shown.emplace(history);
+	_lastShown.remove(history);
+}
+
+void Histories::historyHidden(not_null<History*> history) {
+	if (_shown.remove(history)) {
+		_lastShown[history] = crl::now();
+	}
+}
+
+QString Histories::memoryStats() const {
+	auto loaded = 0;
+	for (const auto &[peerId, entry] : _map) {
+		loaded += LoadedMessagesCount(entry.get());
+	}
+	return QString("histories %1, loaded messages %2 (~%3 KB)"
+		).arg(int(_map.size())
+		).arg(loaded
+		).arg(loaded * kLoadedMessageMemory / 1024);
+}
+
+void Histories::unloadHidden() {
+	auto unloaded = 0;
+	for (const auto &[peerId, entry] : _map) {
+		const auto history = entry.get();
+		if (_shown.contains(history) || _states.contains(history)) {
+			continue;
+		}
+		const auto count = LoadedMessagesCount(history);
+		if (!count) {
+			continue;
+		}
+		history->clear(History::ClearType::Unload);
+		_lastShown.remove(history);
+		unloaded += count;
+	}
+	if (unloaded) {
+		DEBUG_LOG(("Histories: unloaded %1 messages views in background."
+			).arg(unloaded));
+	}
+}
+
+bool Histories::memoryPressure() const {
+	const auto total = Platform::PhysicalMemorySize();
+	const auto available = Platform::AvailablePhysicalMemory();
+	return total
+		&& available
+		&& (*available < *total / kMemoryPressurePart);
+}
+
+void Histories::checkIdleHistories() {
+	struct Candidate {
+		crl::time lastShown = 0;
+		not_null<History*> history;
+		int loaded = 0;
+	};
+	const auto now = crl::now();
+	auto candidates = std::vector<Candidate>();
+	auto loaded = int64(0);
+	for (const auto &[peerId, entry] : _map) {
+		const auto history = entry.get();
+		const auto count = LoadedMessagesCount(history);
+		if (!count || _shown.contains(history)) {
+			continue;
+		}
+		loaded += count;
+		if (_states.contains(history)) {
+			// Some requests for this history are in flight.
+			continue;
+		}
+		// A history with messages loaded but never shown, for example
+		// from notifications or search, starts its idle time right now.
+		const auto i = _lastShown.emplace(history, now).first;
+		candidates.push_back({ i->second, history, count });
+	}
+	const auto limit = int64(Core::App().settings().historiesMemoryLimit())
+		* 1024 * 1024
+		/ kLoadedMessageMemory;
+	const auto pressure = memoryPressure();
+	const auto preload = [&] {
+		if (!pressure && (limit <= 0 || loaded * 2 < limit)) {
+			preloadLikelyHistories();
+		}
+	};
+	if (candidates.empty()) {
+		preload();
+		return;
+	}
+	ranges::sort(candidates, ranges::less(), &Candidate::lastShown);
+
+	auto unloaded = 0;
+	for (const auto &candidate : candidates) {
+		const auto idle = (now - candidate.lastShown)
+			>= kIdleHistoryUnloadTimeout;
+		const auto over = (limit > 0) && (loaded > limit);
+		if (!idle && !over && !pressure) {
+			continue;
+		}
+		candidate.history->clear(History::ClearType::Unload);
+		_lastShown.remove(candidate.history);
+		loaded -= candidate.loaded;
+		unloaded += candidate.loaded;
+	}
+	if (unloaded) {
+		DEBUG_LOG(("Histories: unloaded %1 messages views, %2 left%3."
+			).arg(unloaded
+			).arg(loaded
+			).arg(pressure ? ", memory pressure" : ""));
+	}
+	preload();
+}
+
+void Histories::preloadLikelyHistories() {
+	if (crl::now() - Core::App().lastNonIdleTime() < kPreloadIdleTimeout) {
+		return;
+	}
+	const auto skip = [&](not_null<History*> history) {
+		return _preloaded.contains(history)
+			|| _shown.contains(history)
+			|| _states.contains(history)
+			|| !history->isEmpty()
+			|| history->loadedAtBottom()
+			|| history->peer->migrateFrom()
+			|| (history->unreadCount() > kPreloadMessagesCount);
+	};
+	auto mentions = std::vector<not_null<History*>>();
+	auto others = std::vector<not_null<History*>>();
+	auto checked = 0;
+	for (const auto row : _owner->chatsList()->indexed()->all()) {
+		if (checked++ == kPreloadCandidatesCount) {
+			break;
+		} else if (const auto history = row->history()) {
+			if (!skip(history)) {
+				(history->hasUnreadMentions() ? mentions : others).push_back(
+					history);
+			}
+		}
+	}
+	auto left = kPreloadPerCheck;
+	for (const auto &list : { mentions, others }) {
+		for (const auto history : list) {
+			if (!left--) {
+				return;
+			}
+			preloadHistory(history);
+		}
+	}
+}
+
+void Histories::preloadHistory(not_null<History*> history) {
+	_preloaded.emplace(history);
+	sendRequest(history, RequestType::History, [=](Fn<void()> finish) {
+		return session().api().request(MTPmessages_GetHistory(
+			history->peer->input,
+			MTP_int(0),  // offset_id
+			MTP_int(0),  // offset_date
+			MTP_int(0),  // add_offset
+			MTP_int(kPreloadMessagesCount),
+			MTP_int(0),  // max_id
+			MTP_int(0),  // min_id
+			MTP_int(0)
+		)).done([=](const MTPmessages_Messages &result) {
+			applyPreloaded(history, result);
+			finish();
+		}).fail([=](const RPCError &error) {
+			finish();
+		}).send();
+	});
+}
+
+void Histories::applyPreloaded(
+		not_null<History*> history,
+		const MTPmessages_Messages &result) {
+	if (!history->isEmpty() || history->loadedAtBottom()) {
+		// The chat was opened and started loading by itself.
+		return;
+	}
+	const auto list = result.match([&](
+			const MTPDmessages_messagesNotModified &) {
+		return (const QVector<MTPMessage>*)nullptr;
+	}, [&](const auto &data) {
+		_owner->processUsers(data.vusers());
+		_owner->processChats(data.vchats());
+		return &data.vmessages().v;
+	});
+	if (!list) {
+		return;
+	}
+	result.match([&](const MTPDmessages_channelMessages &data) {
+		if (const auto channel = history->peer->asChannel()) {
+			channel->ptsReceived(data.vpts().v);
+		}
+	}, [](const auto &) {
+	});
+	history->getReadyFor(ShowAtTheEndMsgId);
+	history->addOlderSlice(*list);
+
+	// Give it the same time before unloading as to a chat just hidden.
+	_lastShown[history] = crl::now();
+}
+
 void Histories::readInbox(not_null<History*> history) {
 	DEBUG_LOG(("Reading: readInbox called."));
 	if (history->lastServerMessageKnown()) {
@@ -44,6 +44,20 @@ public:
 	void unloadAll();
 	void clearAll();
 
+	// Unloads every history that is not shown right now, used when the
+	// account goes to background and only the chats list state is needed.
+	void unloadHidden();
+
+	// Histories count and loaded messages views with their rough memory.
+	[[nodiscard]] QString memoryStats() const;
+
+	// Histories that were not shown for some time or don't fit in
+	// Core::Settings::historiesMemoryLimit() get their messages views
+	// unloaded, leaving only the chat list state. While the user is idle
+	// a few empty chats from the top of the list are preloaded instead.
+	void historyShown(not_null<History*> history);
+	void historyHidden(not_null<History*> history);
+
 	void readInbox(not_null<History*> history);
 	void readInboxTill(not_null<HistoryItem*> item);
 	void readInboxTill(not_null<History*> history, MsgId tillId);
@@ -111,6 +125,15 @@ private:
 
 	void sendDialogRequests();
 
+	void checkIdleHistories();
+	[[nodiscard]] bool memoryPressure() const;
+
+	void preloadLikelyHistories();
+	void preloadHistory(not_null<History*> history);
+	void applyPreloaded(
+		not_null<History*> history,
+		const MTPmessages_Messages &result);
+
 	const not_null<Session*> _owner;
 
 	std::unordered_map<PeerId, std::unique_ptr<History>> _map;
@@ -129,6 +152,13 @@ private:
 
 	base::flat_set<not_null<History*>> _fakeChatListRequests;
 
+	base::flat_set<not_null<History*>> _shown;
+	base::flat_map<not_null<History*>, crl::time> _lastShown;
+	base::Timer _idleHistoriesTimer;
+
+	// Each chat is preloaded at most once, it may be unloaded later.
+	base::flat_set<not_null<History*>> _preloaded;
+
 };
 
 } // namespace Data
@@ -0,0 +1,275 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+
+// Open addressing hash map with linear probing for integer and pointer
+// keys, all the entries are stored in one array without nodes.
+//
+// The zero (or null) key marks empty slots and can't be inserted,
+// finding it always fails. Erasing shifts the following entries back,
+// so no tombstones are left, but it invalidates all the iterators.
+template <typename Key, typename Value>
+class IdMap final {
+	static_assert(
+		std::is_integral_v<Key> || std::is_pointer_v<Key>,
+		"Data::IdMap is made for integer and pointer keys.");
+
+	using Slot = std::pair<Key, Value>;
+
+	template <typename Pointer>
+	class Iterator final {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Slot;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Pointer;
+		using reference = decltype(*std::declval<Pointer>());
+
+		Iterator() = default;
+		Iterator(Pointer slot, Pointer till) : _slot(slot), _till(till) {
+			skipEmpty();
+		}
+		template <
+			typename Other,
+			typename = std::enable_if_t<
+				std::is_convertible_v<Other, Pointer>>>
+		Iterator(const Iterator<Other> &other)
+		: _slot(other._slot)
+		, _till(other._till) {
+		}
+
+		reference operator*() const {
+			return *_slot;
+		}
+		pointer operator->() const {
+			return _slot;
+		}
+		Iterator &operator++() {
+			++_slot;
+			skipEmpty();
+			return *this;
+		}
+		Iterator operator++(int) {
+			auto result = *this;
+			++*this;
+			return result;
+		}
+
+		friend inline bool operator==(Iterator a, Iterator b) {
+			return (a._slot == b._slot);
+		}
+		friend inline bool operator!=(Iterator a, Iterator b) {
+			return (a._slot != b._slot);
+		}
+
+	private:
+		template <typename Other>
+		friend class Iterator;
+		friend class IdMap;
+
+		void skipEmpty() {
+			while (_slot != _till && !_slot->first) {
+				++_slot;
+			}
+		}
+
+		Pointer _slot = nullptr;
+		Pointer _till = nullptr;
+
+	};
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = Slot;
+	using size_type = std::size_t;
+	using iterator = Iterator<Slot*>;
+	using const_iterator = Iterator<const Slot*>;
+
+	[[nodiscard]] size_type size() const {
+		return _size;
+	}
+	[[nodiscard]] bool empty() const {
+		return !_size;
+	}
+
+	[[nodiscard]] iterator begin() {
+		return { _slots.data(), till() };
+	}
+	[[nodiscard]] iterator end() {
+		return { till(), till() };
+	}
+	[[nodiscard]] const_iterator begin() const {
+		return { _slots.data(), till() };
+	}
+	[[nodiscard]] const_iterator end() const {
+		return { till(), till() };
+	}
+
+	// For the unqualified begin(map) / end(map) calls.
+	friend inline iterator begin(IdMap &map) {
+		return map.begin();
+	}
+	friend inline iterator end(IdMap &map) {
+		return map.end();
+	}
+	friend inline const_iterator begin(const IdMap &map) {
+		return map.begin();
+	}
+	friend inline const_iterator end(const IdMap &map) {
+		return map.end();
+	}
+
+	[[nodiscard]] iterator find(Key key) {
+		const auto index = lookup(key);
+		return (index != kNotFound) ? at(index) : end();
+	}
+	[[nodiscard]] const_iterator find(Key key) const {
+		const auto index = lookup(key);
+		return (index != kNotFound) ? at(index) : end();
+	}
+	[[nodiscard]] bool contains(Key key) const {
+		return (lookup(key) != kNotFound);
+	}
+
+	std::pair<iterator, bool> emplace(Key key, Value value) {
+		Expects(key != Key());
+
+		if (const auto index = lookup(key); index != kNotFound) {
+			return { at(index), false };
+		}
+		reserveForInsert();
+		auto index = home(key);
+		while (_slots[index].first) {
+			index = next(index);
+		}
+		_slots[index] = Slot(key, std::move(value));
+		++_size;
+		return { at(index), true };
+	}
+	Value &operator[](Key key) {
+		return emplace(key, Value()).first->second;
+	}
+
+	void erase(const_iterator i) {
+		Expects(i._slot != till());
+
+		eraseAt(size_type(i._slot - _slots.data()));
+	}
+	size_type erase(Key key) {
+		const auto index = lookup(key);
+		if (index == kNotFound) {
+			return 0;
+		}
+		eraseAt(index);
+		return 1;
+	}
+
+	void clear() {
+		_slots = std::vector<Slot>();
+		_size = 0;
+		_shift = 64;
+	}
+
+private:
+	static constexpr auto kNotFound = size_type(-1);
+	static constexpr auto kMinCapacity = size_type(16);
+
+	[[nodiscard]] const Slot *till() const {
+		return _slots.data() + _slots.size();
+	}
+	[[nodiscard]] Slot *till() {
+		return _slots.data() + _slots.size();
+	}
+	[[nodiscard]] iterator at(size_type index) {
+		return { _slots.data() + index, till() };
+	}
+	[[nodiscard]] const_iterator at(size_type index) const {
+		return { _slots.data() + index, till() };
+	}
+
+	[[nodiscard]] static uint64 Integer(Key key) {
+		if constexpr (std::is_pointer_v<Key>) {
+			return uint64(reinterpret_cast<std::uintptr_t>(key));
+		} else {
+			return uint64(key);
+		}
+	}
+	[[nodiscard]] size_type home(Key key) const {
+		// Fibonacci hashing spreads sequential ids and aligned pointers.
+		constexpr auto kMultiplier = 0x9E3779B97F4A7C15ULL;
+		return size_type((Integer(key) * kMultiplier) >> _shift);
+	}
+	[[nodiscard]] size_type next(size_type index) const {
+		return (index + 1) & (_slots.size() - 1);
+	}
+
+	[[nodiscard]] size_type lookup(Key key) const {
+		if (!key || _slots.empty()) {
+			return kNotFound;
+		}
+		for (auto index = home(key);; index = next(index)) {
+			const auto &slot = _slots[index];
+			if (slot.first == key) {
+				return index;
+			} else if (!slot.first) {
+				return kNotFound;
+			}
+		}
+	}
+
+	void reserveForInsert() {
+		// Keep the load factor under 3/4 for short probe sequences.
+		const auto capacity = _slots.size();
+		if ((_size + 1) * 4 > capacity * 3) {
+			rehash(std::max(capacity * 2, kMinCapacity));
+		}
+	}
+
+	void rehash(size_type capacity) {
+		auto was = std::exchange(_slots, std::vector<Slot>(capacity));
+		_shift = 64;
+		for (auto i = capacity; i > 1; i >>= 1) {
+			--_shift;
+		}
+		for (auto &slot : was) {
+			if (slot.first) {
+				auto index = home(slot.first);
+				while (_slots[index].first) {
+					index = next(index);
+				}
+				_slots[index] = std::move(slot);
+			}
+		}
+	}
+
+	void eraseAt(size_type index) {
+		const auto mask = _slots.size() - 1;
+		auto hole = index;
+		for (auto i = next(hole); _slots[i].first; i = next(i)) {
+			// Move back the entries that can't be found through the hole.
+			const auto fromHome = (i - home(_slots[i].first)) & mask;
+			const auto fromHole = (i - hole) & mask;
+			if (fromHome >= fromHole) {
+				_slots[hole] = std::move(_slots[i]);
+				hole = i;
+			}
+		}
+		_slots[hole] = Slot();
+		--_size;
+	}
+
+	std::vector<Slot> _slots;
+	size_type _size = 0;
+	int _shift = 64;
+
+};
+
+} // namespace Data
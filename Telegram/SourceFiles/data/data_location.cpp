@@ -13,11 +13,27 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Data {
 namespace {
 
+constexpr auto kMapTileSize = 256;
+
 [[nodiscard]] QString AsString(float64 value) {
 	constexpr auto kPrecision = 6;
 	return QString::number(value, 'f', kPrecision);
 }
 
+// Points inside one map pixel give the same map image, so they are
+// snapped to the pixel grid of the mercator projection at that zoom.
+[[nodiscard]] float64 SnapLongitude(float64 lon, int zoom) {
+	const auto step = 360. / (kMapTileSize << zoom);
+	return std::round(lon / step) * step;
+}
+
+[[nodiscard]] float64 SnapLatitude(float64 lat, int zoom) {
+	const auto step = 2. * M_PI / (kMapTileSize << zoom);
+	const auto y = std::log(std::tan(M_PI / 4. + lat * M_PI / 360.));
+	const auto snapped = std::round(y / step) * step;
+	return (2. * std::atan(std::exp(snapped)) - M_PI / 2.) * 180. / M_PI;
+}
+
 } // namespace
 
 LocationPoint::LocationPoint(const MTPDgeoPoint &point)
@@ -76,4 +92,12 @@ GeoPointLocation ComputeLocation(const LocationPoint &point) {
 	return result;
 }
 
+GeoPointLocation ComputeSharedLocationKey(const GeoPointLocation &location) {
+	auto result = location;
+	result.lat = SnapLatitude(location.lat, location.zoom);
+	result.lon = SnapLongitude(location.lon, location.zoom);
+	result.access = 0;
+	return result;
+}
+
 } // namespace Data
@@ -47,6 +47,12 @@ private:
 
 [[nodiscard]] GeoPointLocation ComputeLocation(const LocationPoint &point);
 
+// The location requests keep the exact point, as the access hash is
+// given for it, but the points inside one map pixel give the same image.
+// This key is the same for all of them, to share their map images.
+[[nodiscard]] GeoPointLocation ComputeSharedLocationKey(
+	const GeoPointLocation &location);
+
 } // namespace Data
 
 namespace std {
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "data/data_location.h"
+#include "history/history_allocator.h"
 
 class Image;
 class HistoryItem;
@@ -65,6 +66,8 @@ struct Invoice {
 
 class Media {
 public:
+	HISTORY_POOLED_ALLOCATION
+
 	Media(not_null<HistoryItem*> parent);
 	virtual ~Media() = default;
 
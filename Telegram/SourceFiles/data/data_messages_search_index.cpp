@@ -0,0 +1,154 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_messages_search_index.h"
+
+#include "data/data_session.h"
+#include "data/data_changes.h"
+#include "history/history.h"
+#include "history/history_item.h"
+#include "main/main_session.h"
+#include "ui/text/text_utilities.h"
+
+namespace Data {
+
+MessagesSearchIndex::MessagesSearchIndex(not_null<Session*> owner)
+: _owner(owner) {
+	_owner->session().changes().messageUpdates(
+		MessageUpdate::Flag::Edited
+	) | rpl::start_with_next([=](const MessageUpdate &update) {
+		refresh(update.item);
+	}, _lifetime);
+}
+
+void MessagesSearchIndex::add(
+		const std::vector<not_null<HistoryItem*>> &items) {
+	for (const auto item : items) {
+		add(item);
+	}
+}
+
+void MessagesSearchIndex::add(not_null<HistoryItem*> item) {
+	if (!IsServerMsgId(item->id) || !item->isHistoryEntry()) {
+		return;
+	}
+	auto words = TextUtilities::PrepareSearchWords(item->originalText().text);
+	if (words.isEmpty()) {
+		return;
+	}
+	words.removeDuplicates();
+
+	auto &index = _histories[item->history()];
+	const auto i = index.wordsByMessage.find(item->id);
+	if (i != end(index.wordsByMessage)) {
+		if (i->second == words) {
+			return;
+		}
+		remove(item);
+		return add(item);
+	}
+	for (const auto &word : words) {
+		index.words[word].emplace(item->id);
+	}
+	index.wordsByMessage.emplace(item->id, std::move(words));
+}
+
+void MessagesSearchIndex::remove(not_null<HistoryItem*> item) {
+	const auto i = _histories.find(item->history());
+	if (i == end(_histories)) {
+		return;
+	}
+	auto &index = i->second;
+	const auto j = index.wordsByMessage.find(item->id);
+	if (j == end(index.wordsByMessage)) {
+		return;
+	}
+	for (const auto &word : j->second) {
+		const auto k = index.words.find(word);
+		if (k != end(index.words)) {
+			k->second.remove(item->id);
+			if (k->second.empty()) {
+				index.words.erase(k);
+			}
+		}
+	}
+	index.wordsByMessage.erase(j);
+	if (index.wordsByMessage.empty()) {
+		_histories.erase(i);
+	}
+}
+
+void MessagesSearchIndex::refresh(not_null<HistoryItem*> item) {
+	const auto i = _histories.find(item->history());
+	if (i != end(_histories) && i->second.wordsByMessage.contains(item->id)) {
+		remove(item);
+		add(item);
+	}
+}
+
+base::flat_set<MsgId> MessagesSearchIndex::collect(
+		const HistoryIndex &index,
+		const QString &prefix) const {
+	auto result = base::flat_set<MsgId>();
+	for (auto i = index.words.lower_bound(prefix)
+		; (i != end(index.words)) && i->first.startsWith(prefix)
+		; ++i) {
+		for (const auto id : i->second) {
+			result.emplace(id);
+		}
+	}
+	return result;
+}
+
+std::vector<not_null<HistoryItem*>> MessagesSearchIndex::search(
+		not_null<History*> history,
+		const QString &query,
+		int limit) const {
+	auto result = std::vector<not_null<HistoryItem*>>();
+	const auto i = _histories.find(history);
+	if (i == end(_histories) || limit <= 0) {
+		return result;
+	}
+	const auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty()) {
+		return result;
+	}
+
+	auto lists = ranges::view::all(
+		words
+	) | ranges::view::transform([&](const QString &word) {
+		return collect(i->second, word);
+	}) | ranges::to_vector;
+	ranges::sort(lists, ranges::less(), [](const base::flat_set<MsgId> &list) {
+		return list.size();
+	});
+	if (lists.front().empty()) {
+		return result;
+	}
+
+	const auto channelId = peerToChannel(history->peer->id);
+	const auto &smallest = lists.front();
+	for (auto j = smallest.rbegin(); j != smallest.rend(); ++j) {
+		const auto id = *j;
+		const auto inAll = ranges::all_of(
+			lists | ranges::view::drop(1),
+			[&](const base::flat_set<MsgId> &list) {
+				return list.contains(id);
+			});
+		if (!inAll) {
+			continue;
+		} else if (const auto item = _owner->message(channelId, id)) {
+			result.push_back(item);
+			if (int(result.size()) == limit) {
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+} // namespace Data
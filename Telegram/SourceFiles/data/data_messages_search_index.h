@@ -0,0 +1,51 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class History;
+class HistoryItem;
+
+namespace Data {
+
+class Session;
+
+// Word index of the text of messages that are loaded in histories,
+// lets in-chat search show results before the server answers.
+class MessagesSearchIndex final {
+public:
+	explicit MessagesSearchIndex(not_null<Session*> owner);
+
+	void add(const std::vector<not_null<HistoryItem*>> &items);
+	void add(not_null<HistoryItem*> item);
+	void remove(not_null<HistoryItem*> item);
+
+	// Messages having all the query words as word prefixes, newest first.
+	[[nodiscard]] std::vector<not_null<HistoryItem*>> search(
+		not_null<History*> history,
+		const QString &query,
+		int limit) const;
+
+private:
+	struct HistoryIndex {
+		std::map<QString, base::flat_set<MsgId>> words;
+		std::map<MsgId, QStringList> wordsByMessage;
+	};
+
+	void refresh(not_null<HistoryItem*> item);
+	[[nodiscard]] base::flat_set<MsgId> collect(
+		const HistoryIndex &index,
+		const QString &prefix) const;
+
+	const not_null<Session*> _owner;
+	base::flat_map<not_null<History*>, HistoryIndex> _histories;
+
+	rpl::lifetime _lifetime;
+
+};
+
+} // namespace Data
@@ -18,6 +18,7 @@ namespace {
 
 constexpr auto kMinOnlineChangeTimeout = crl::time(1000);
 constexpr auto kMaxOnlineChangeTimeout = 86400 * crl::time(1000);
+constexpr auto kOnlineChangeSlot = crl::time(5000);
 constexpr auto kSecondsInDay = 86400;
 
 int OnlinePhraseChangeInSeconds(TimeId online, TimeId now) {
@@ -43,6 +44,15 @@ int OnlinePhraseChangeInSeconds(TimeId online, TimeId now) {
 	return std::max(static_cast<TimeId>(nowFull.secsTo(tomorrow)), 0);
 }
 
+// All the phrase changes are postponed to the same slots of crl::now(),
+// so the lists and the profiles showing many users wake up together.
+crl::time AlignOnlineChangeTimeout(crl::time timeout) {
+	const auto now = crl::now();
+	const auto slot = (now + timeout + kOnlineChangeSlot - 1)
+		/ kOnlineChangeSlot;
+	return slot * kOnlineChangeSlot - now;
+}
+
 std::optional<QString> OnlineTextSpecial(not_null<UserData*> user) {
 	if (user->isNotificationsUser()) {
 		return tr::lng_status_service_notifications(tr::now);
@@ -279,10 +289,10 @@ TimeId SortByOnlineValue(not_null<UserData*> user, TimeId now) {
 crl::time OnlineChangeTimeout(TimeId online, TimeId now) {
 	const auto result = OnlinePhraseChangeInSeconds(online, now);
 	Assert(result >= 0);
-	return snap(
+	return AlignOnlineChangeTimeout(snap(
 		result * crl::time(1000),
 		kMinOnlineChangeTimeout,
-		kMaxOnlineChangeTimeout);
+		kMaxOnlineChangeTimeout));
 }
 
 crl::time OnlineChangeTimeout(not_null<UserData*> user, TimeId now) {
@@ -131,6 +131,14 @@ void PhotoData::cancel() {
 	}
 }
 
+void PhotoData::stopLoading() {
+	if (loading()) {
+		auto &image = _images[PhotoSizeIndex(PhotoSize::Large)];
+		image.loader->cancel();
+		image.flags &= ~Data::CloudFile::Flag::Cancelled;
+	}
+}
+
 float64 PhotoData::progress() const {
 	if (uploading()) {
 		if (uploadingData->size > 0) {
@@ -257,6 +265,14 @@ void PhotoData::load(
 	};
 	const auto progress = [=] {
 		if (loadingSize == PhotoSize::Large) {
+			const auto active = activeMediaView();
+			const auto &loader = _images[index].loader;
+			if (active
+				&& loader
+				&& active->progressiveBytesWanted(
+					loader->loadedPrefixSize())) {
+				active->setProgressiveBytes(loader->loadedPrefix());
+			}
 			_owner->photoLoadProgress(this);
 		}
 	};
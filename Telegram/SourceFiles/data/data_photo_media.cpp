@@ -17,8 +17,15 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 #include "storage/file_download.h"
 #include "ui/image/image.h"
+#include "app.h"
 
 namespace Data {
+namespace {
+
+// Decode the partially loaded image each time that much more is loaded.
+constexpr auto kProgressiveStep = 96 * 1024;
+
+} // namespace
 
 PhotoMedia::PhotoMedia(not_null<PhotoData*> owner)
 : _owner(owner) {
@@ -82,9 +89,61 @@ void PhotoMedia::set(PhotoSize size, QImage image) {
 			Qt::SmoothTransformation);
 	}
 	_images[index] = std::make_unique<Image>(std::move(image));
+	if (size != PhotoSize::Large && !loaded()) {
+		// Small sizes are painted blurred until the large one is loaded.
+		_images[index]->prepareBlurredAsync();
+	}
+	if (size == PhotoSize::Large) {
+		_progressive = nullptr;
+		_progressiveGuard = base::binary_guard();
+		_progressiveDecoding = false;
+	}
 	_owner->session().downloaderTaskFinished().notify();
 }
 
+void PhotoMedia::wantProgressive() {
+	_progressiveWanted = true;
+}
+
+bool PhotoMedia::progressiveWanted() const {
+	return _progressiveWanted && !loaded();
+}
+
+bool PhotoMedia::progressiveBytesWanted(int size) const {
+	return progressiveWanted()
+		&& !_progressiveDecoding
+		&& (size >= _progressiveBytes + kProgressiveStep);
+}
+
+void PhotoMedia::setProgressiveBytes(QByteArray bytes) {
+	if (!progressiveBytesWanted(bytes.size())) {
+		return;
+	}
+	_progressiveDecoding = true;
+	_progressiveBytes = bytes.size();
+	crl::async([
+		=,
+		guard = _progressiveGuard.make_guard(),
+		bytes = std::move(bytes)
+	]() mutable {
+		// Truncated JPEG files are decoded with the rest filled.
+		auto image = App::readImage(bytes, nullptr, false);
+		crl::on_main(std::move(guard), [
+			=,
+			image = std::move(image)
+		]() mutable {
+			_progressiveDecoding = false;
+			if (!image.isNull() && !loaded()) {
+				_progressive = std::make_unique<Image>(std::move(image));
+			}
+		});
+	});
+}
+
+Image *PhotoMedia::progressive() const {
+	return _progressive.get();
+}
+
 bool PhotoMedia::loaded() const {
 	const auto index = PhotoSizeIndex(PhotoSize::Large);
 	return (_images[index] != nullptr);
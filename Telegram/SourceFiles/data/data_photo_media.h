@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "base/flags.h"
+#include "base/binary_guard.h"
 #include "data/data_photo.h"
 
 class FileLoader;
@@ -28,6 +29,14 @@ public:
 	void wanted(PhotoSize size, Data::FileOrigin origin);
 	void set(PhotoSize size, QImage image);
 
+	// Show the loaded beginning of the large image while it is loading.
+	void wantProgressive();
+	[[nodiscard]] bool progressiveWanted() const;
+	// If the loaded prefix of this size will start a new decode.
+	[[nodiscard]] bool progressiveBytesWanted(int size) const;
+	void setProgressiveBytes(QByteArray bytes);
+	[[nodiscard]] Image *progressive() const;
+
 	[[nodiscard]] bool loaded() const;
 	[[nodiscard]] float64 progress() const;
 
@@ -42,6 +51,11 @@ private:
 	const not_null<PhotoData*> _owner;
 	mutable std::unique_ptr<Image> _inlineThumbnail;
 	std::array<std::unique_ptr<Image>, kPhotoSizeCount>  _images;
+	std::unique_ptr<Image> _progressive;
+	base::binary_guard _progressiveGuard;
+	int _progressiveBytes = 0;
+	bool _progressiveWanted = false;
+	bool _progressiveDecoding = false;
 
 };
 
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 constexpr auto kShortPollTimeout = 30 * crl::time(1000);
+constexpr auto kShortPollTimeoutMax = 5 * 60 * crl::time(1000);
 constexpr auto kReloadAfterAutoCloseDelay = crl::time(1000);
 
 const PollAnswer *AnswerByOption(
@@ -42,7 +43,8 @@ PollAnswer *AnswerByOption(
 
 PollData::PollData(not_null<Data::Session*> owner, PollId id)
 : id(id)
-, _owner(owner) {
+, _owner(owner)
+, _resultsReloadTimeout(kShortPollTimeout) {
 }
 
 Data::Session &PollData::owner() const {
@@ -168,8 +170,13 @@ bool PollData::applyResults(const MTPPollResults &results) {
 			}
 		}
 		if (!changed) {
+			// Polls that stay the same are reloaded less and less often.
+			_resultsReloadTimeout = std::min(
+				_resultsReloadTimeout * 2,
+				kShortPollTimeoutMax);
 			return false;
 		}
+		_resultsReloadTimeout = kShortPollTimeout;
 		totalVoters = newTotalVoters;
 		++version;
 		return changed;
@@ -180,7 +187,7 @@ void PollData::checkResultsReload(
 		not_null<HistoryItem*> item,
 		crl::time now) {
 	if (_lastResultsUpdate > 0
-		&& _lastResultsUpdate + kShortPollTimeout > now) {
+		&& _lastResultsUpdate + _resultsReloadTimeout > now) {
 		return;
 	} else if (closed() && _lastResultsUpdate >= 0) {
 		return;
@@ -85,6 +85,7 @@ private:
 	const not_null<Data::Session*> _owner;
 	Flags _flags = Flags();
 	crl::time _lastResultsUpdate = 0; // < 0 means force reload.
+	crl::time _resultsReloadTimeout = 0;
 
 };
 
@@ -173,15 +173,39 @@ bool PtsWaiter::check(ChannelData *channel, int32 pts, int32 count) {
 		return true;
 	}
 
-	_last = qMax(_last, pts);
-	_count += count;
-	if (_last == _count) {
-		_good = _last;
-		return true;
-	} else if (_last < _count) {
+	// An update that covers the already applied or received pts means
+	// that our state is not what the server thinks it is, request the
+	// difference right away instead of waiting for the skipped updates.
+	const auto overcount = (count > 0)
+		&& ((pts - count < _good) || addReceived(pts - count, pts));
+	if (overcount) {
 		setWaitingForSkipped(channel, 1);
-	} else {
-		setWaitingForSkipped(channel, kWaitForSkippedTimeout);
+		return false;
+	} else if (!count && pts > _good) {
+		addReceived(pts, pts);
+	}
+	const auto first = _received.begin();
+	if (_received.size() == 1 && first->first <= _good) {
+		_good = std::max(_good, first->second);
+		_received.clear();
+		return true;
 	}
+	setWaitingForSkipped(channel, kWaitForSkippedTimeout);
 	return !count;
 }
+
+bool PtsWaiter::addReceived(int32 from, int32 till) {
+	auto overlaps = false;
+	auto i = _received.lower_bound(from);
+	if (i != _received.begin() && std::prev(i)->second >= from) {
+		--i;
+	}
+	while (i != _received.end() && i->first <= till) {
+		overlaps = overlaps || (i->first < till && from < i->second);
+		from = std::min(from, i->first);
+		till = std::max(till, i->second);
+		i = _received.erase(i);
+	}
+	_received.emplace(from, till);
+	return overlaps;
+}
@@ -24,7 +24,8 @@ public:
 	static constexpr auto kWaitForSkippedTimeout = 1000;
 
 	void init(int32 pts) {
-		_good = _last = _count = pts;
+		_good = pts;
+		_received.clear();
 		clearSkippedUpdates();
 	}
 	bool inited() const {
@@ -85,6 +86,9 @@ private:
 	// Return false if need to save that update and apply later.
 	bool check(ChannelData *channel, int32 pts, int32 count);
 
+	// Returns true if the range overlaps the already received ones.
+	bool addReceived(int32 from, int32 till);
+
 	uint64 ptsKey(PtsSkippedQueue queue, int32 pts);
 	void checkForWaiting(ChannelData *channel);
 
@@ -93,8 +97,10 @@ private:
 	base::flat_map<uint64, MTPUpdate> _updateQueue;
 	base::flat_map<uint64, MTPUpdates> _updatesQueue;
 	int32 _good = 0;
-	int32 _last = 0;
-	int32 _count = 0;
+
+	// Ranges (from, till] of pts received after the gaps, not overlapping.
+	base::flat_map<int32, int32> _received;
+
 	int32 _applySkippedLevel = 0;
 	bool _requesting = false;
 	bool _waitingForSkipped = false;
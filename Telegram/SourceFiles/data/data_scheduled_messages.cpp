@@ -383,7 +383,12 @@ void ScheduledMessages::parse(
 		auto clear = base::flat_set<not_null<HistoryItem*>>();
 		auto &list = _data.emplace(history, List()).first->second;
 		for (const auto &message : messages) {
-			if (const auto item = append(history, list, message)) {
+			const auto skipUnchanged = true;
+			if (const auto item = append(
+					history,
+					list,
+					message,
+					skipUnchanged)) {
 				received.emplace(item);
 			}
 		}
@@ -400,7 +405,8 @@ void ScheduledMessages::parse(
 HistoryItem *ScheduledMessages::append(
 		not_null<History*> history,
 		List &list,
-		const MTPMessage &message) {
+		const MTPMessage &message,
+		bool skipUnchanged) {
 	const auto id = message.match([&](const auto &data) {
 		return data.vid().v;
 	});
@@ -408,6 +414,19 @@ HistoryItem *ScheduledMessages::append(
 	if (i != end(list.itemById)) {
 		const auto existing = i->second;
 		message.match([&](const MTPDmessage &data) {
+			// The list hash is made of ids, dates and edit dates, so
+			// the messages with the same dates haven't changed.
+			//
+			// Only for the list, updateNewScheduledMessage always comes
+			// for a locally sent message with its date and no edit date
+			// and it must replace the local media and entities.
+			const auto edited = existing->Get<HistoryMessageEdited>();
+			const auto editDate = edited ? edited->date : TimeId(0);
+			if (skipUnchanged
+				&& existing->date() == data.vdate().v
+				&& editDate == data.vedit_date().value_or_empty()) {
+				return;
+			}
 			existing->updateSentContent({
 				qs(data.vmessage()),
 				Api::EntitiesFromMTP(
@@ -70,7 +70,8 @@ private:
 	HistoryItem *append(
 		not_null<History*> history,
 		List &list,
-		const MTPMessage &message);
+		const MTPMessage &message,
+		bool skipUnchanged = false);
 	void clearNotSending(not_null<History*> history);
 	void updated(
 		not_null<History*> history,
@@ -22,6 +22,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/view/export_view_panel_controller.h"
 #include "mtproto/mtproto_config.h"
 #include "window/notifications_manager.h"
+#include "window/window_controller.h"
+#include "mainwindow.h"
 #include "history/history.h"
 #include "history/history_item_components.h"
 #include "history/view/media/history_view_media.h"
@@ -53,6 +55,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_streaming.h"
 #include "data/data_media_rotation.h"
 #include "data/data_histories.h"
+#include "data/data_messages_search_index.h"
+#include "media/streaming/media_streaming_reader.h"
 #include "base/platform/base_platform_info.h"
 #include "base/unixtime.h"
 #include "base/call_delayed.h"
@@ -65,9 +69,30 @@ namespace {
 
 constexpr auto kMaxNotifyCheckDelay = 24 * 3600 * crl::time(1000);
 constexpr auto kMaxWallpaperSize = 10 * 1024 * 1024;
+constexpr auto kSendActionsInactiveInterval = crl::time(1000) / 15;
+constexpr auto kSendActionsHiddenInterval = crl::time(1000);
+constexpr auto kMemoryStatsTimeout = 60 * crl::time(1000);
+
+[[nodiscard]] uint64 MessageKey(ChannelId channelId, MsgId msgId) {
+	return (uint64(uint32(channelId)) << 32) | uint64(uint32(msgId));
+}
 
 using ViewElement = HistoryView::Element;
 
+// Send actions are shown only in the main window, they don't need
+// the full frame rate while it is in the background or hidden.
+[[nodiscard]] crl::time SendActionsAnimationInterval() {
+	const auto window = Core::App().activeWindow();
+	if (!window
+		|| window->widget()->isHidden()
+		|| window->widget()->isMinimized()) {
+		return kSendActionsHiddenInterval;
+	} else if (!window->widget()->isActive()) {
+		return kSendActionsInactiveInterval;
+	}
+	return 0;
+}
+
 // s: box 100x100
 // m: box 320x320
 // x: box 800x800
@@ -207,6 +232,9 @@ Session::Session(not_null<Main::Session*> session)
 , _contactsList(Dialogs::SortMode::Name)
 , _contactsNoChatsList(Dialogs::SortMode::Name)
 , _selfDestructTimer([=] { checkSelfDestructItems(); })
+, _memoryStatsTimer([=] {
+	DEBUG_LOG(("Memory Stats: %1").arg(memoryStats()));
+})
 , _sendActionsAnimation([=](crl::time now) {
 	return sendActionsAnimationCallback(now);
 })
@@ -218,6 +246,7 @@ Session::Session(not_null<Main::Session*> session)
 , _cloudThemes(std::make_unique<CloudThemes>(session))
 , _streaming(std::make_unique<Streaming>(this))
 , _mediaRotation(std::make_unique<MediaRotation>())
+, _messagesSearchIndex(std::make_unique<MessagesSearchIndex>(this))
 , _histories(std::make_unique<Histories>(this))
 , _stickers(std::make_unique<Stickers>(this)) {
 	_cache->open(_session->local().cacheKey());
@@ -231,6 +260,8 @@ Session::Session(not_null<Main::Session*> session)
 		}
 	}
 
+	_memoryStatsTimer.callEach(kMemoryStatsTimeout);
+
 	setupMigrationViewer();
 	setupChannelLeavingViewer();
 	setupPeerNameViewer();
@@ -262,7 +293,6 @@ void Session::clear() {
 	_scheduledMessages = nullptr;
 	_dependentMessages.clear();
 	base::take(_messages);
-	base::take(_channelMessages);
 	_messageByRandomId.clear();
 	_sentMessagesData.clear();
 	cSetRecentInlineBots(RecentInlineBots());
@@ -277,6 +307,25 @@ void Session::clear() {
 	_photos.clear();
 }
 
+QString Session::memoryStats() const {
+	auto views = 0;
+	for (const auto &[item, list] : _views) {
+		views += int(list.size());
+	}
+	const auto slices = ::Media::Streaming::Reader::CollectSlicesStats();
+	return QString("%1, messages %2, views %3, photos %4, documents %5; "
+		"images %6 KB, pixmaps %7 KB; streaming slices %8 (%9 KB)"
+		).arg(_histories->memoryStats()
+		).arg(int(_messages.size())
+		).arg(views
+		).arg(int(_photos.size())
+		).arg(int(_documents.size())
+		).arg(Image::DataBytesTotal() / 1024
+		).arg(Image::PixmapsBytesTotal() / 1024
+		).arg(slices.inMemory
+		).arg(slices.inMemoryBytes / 1024);
+}
+
 void Session::keepAlive(std::shared_ptr<PhotoMedia> media) {
 	// NB! This allows PhotoMedia to outlive Main::Session!
 	// In case this is a problem this code should be rewritten.
@@ -868,6 +917,11 @@ void Session::registerSendAction(
 }
 
 bool Session::sendActionsAnimationCallback(crl::time now) {
+	const auto interval = SendActionsAnimationInterval();
+	if (interval && now < _sendActionsAnimationLast + interval) {
+		return true;
+	}
+	_sendActionsAnimationLast = now;
 	for (auto i = begin(_sendActions); i != end(_sendActions);) {
 		if (i->first->updateSendActionNeedsAnimating(now)) {
 			++i;
@@ -1208,12 +1262,11 @@ rpl::producer<not_null<HistoryItem*>> Session::unreadItemAdded() const {
 }
 
 void Session::changeMessageId(ChannelId channel, MsgId wasId, MsgId nowId) {
-	const auto list = messagesListForInsert(channel);
-	auto i = list->find(wasId);
-	Assert(i != list->end());
-	auto owned = std::move(i->second);
-	list->erase(i);
-	const auto [j, ok] = list->emplace(nowId, std::move(owned));
+	auto i = _messages.find(MessageKey(channel, wasId));
+	Assert(i != end(_messages));
+	const auto item = i->second;
+	_messages.erase(i);
+	const auto [j, ok] = _messages.emplace(MessageKey(channel, nowId), item);
 
 	Ensures(ok);
 }
@@ -1733,47 +1786,48 @@ void Session::processMessages(
 	processMessages(data.v, type);
 }
 
-const Session::Messages *Session::messagesList(ChannelId channelId) const {
-	if (channelId == NoChannel) {
-		return &_messages;
-	}
-	const auto i = _channelMessages.find(channelId);
-	return (i != end(_channelMessages)) ? &i->second : nullptr;
+void Session::setPreparedMessageTexts(
+		base::flat_map<FullMsgId, TextWithEntities> &&texts) {
+	_preparedMessageTexts = std::move(texts);
 }
 
-auto Session::messagesListForInsert(ChannelId channelId)
--> not_null<Messages*> {
-	return (channelId == NoChannel)
-		? &_messages
-		: &_channelMessages[channelId];
+void Session::clearPreparedMessageTexts() {
+	_preparedMessageTexts.clear();
+}
+
+std::optional<TextWithEntities> Session::takePreparedMessageText(
+		FullMsgId itemId) {
+	const auto i = _preparedMessageTexts.find(itemId);
+	if (i == end(_preparedMessageTexts)) {
+		return std::nullopt;
+	}
+	auto result = std::move(i->second);
+	_preparedMessageTexts.erase(i);
+	Api::ResolveMentionNames(_session, result.entities);
+	return result;
 }
 
 void Session::registerMessage(not_null<HistoryItem*> item) {
-	const auto list = messagesListForInsert(item->channelId());
-	const auto itemId = item->id;
-	const auto i = list->find(itemId);
-	if (i != list->end()) {
+	const auto key = MessageKey(item->channelId(), item->id);
+	const auto i = _messages.find(key);
+	if (i != end(_messages)) {
 		LOG(("App Error: Trying to re-registerMessage()."));
 		i->second->destroy();
 	}
-	list->emplace(itemId, item);
+	_messages.emplace(key, item);
 }
 
 void Session::processMessagesDeleted(
 		ChannelId channelId,
 		const QVector<MTPint> &data) {
-	const auto list = messagesList(channelId);
 	const auto affected = (channelId != NoChannel)
 		? historyLoaded(peerFromChannel(channelId))
 		: nullptr;
-	if (!list && !affected) {
-		return;
-	}
 
 	auto historiesToCheck = base::flat_set<not_null<History*>>();
 	for (const auto messageId : data) {
-		const auto i = list ? list->find(messageId.v) : Messages::iterator();
-		if (list && i != list->end()) {
+		const auto i = _messages.find(MessageKey(channelId, messageId.v));
+		if (i != end(_messages)) {
 			const auto history = i->second->history();
 			i->second->destroy();
 			if (!history->chatListMessageKnown()) {
@@ -1807,9 +1861,10 @@ void Session::unregisterMessage(not_null<HistoryItem*> item) {
 	session().changes().messageUpdated(
 		item,
 		Data::MessageUpdate::Flag::Destroyed);
+	_messagesSearchIndex->remove(item);
 	groups().unregisterMessage(item);
 	removeDependencyMessage(item);
-	messagesListForInsert(peerToChannel(peerId))->erase(item->id);
+	_messages.erase(MessageKey(peerToChannel(peerId), item->id));
 }
 
 MsgId Session::nextLocalMessageId() {
@@ -1823,13 +1878,8 @@ HistoryItem *Session::message(ChannelId channelId, MsgId itemId) const {
 		return nullptr;
 	}
 
-	const auto data = messagesList(channelId);
-	if (!data) {
-		return nullptr;
-	}
-
-	const auto i = data->find(itemId);
-	return (i != data->end()) ? i->second.get() : nullptr;
+	const auto i = _messages.find(MessageKey(channelId, itemId));
+	return (i != end(_messages)) ? i->second : nullptr;
 }
 
 HistoryItem *Session::message(
@@ -2956,11 +3006,12 @@ void Session::applyUpdate(const MTPDupdateChatDefaultBannedRights &update) {
 }
 
 not_null<Data::CloudImage*> Session::location(const LocationPoint &point) {
-	const auto i = _locations.find(point);
+	const auto location = Data::ComputeLocation(point);
+	const auto key = Data::ComputeSharedLocationKey(location);
+	const auto i = _locations.find(key);
 	if (i != _locations.cend()) {
 		return i->second.get();
 	}
-	const auto location = Data::ComputeLocation(point);
 	const auto prepared = ImageWithLocation{
 		.location = ImageLocation(
 			{ location },
@@ -2968,7 +3019,7 @@ not_null<Data::CloudImage*> Session::location(const LocationPoint &point) {
 			location.height)
 	};
 	return _locations.emplace(
-		point,
+		key,
 		std::make_unique<Data::CloudImage>(
 			_session,
 			prepared)).first->second.get();
@@ -3360,12 +3411,33 @@ not_null<Dialogs::IndexedList*> Session::contactsNoChatsList() {
 	return &_contactsNoChatsList;
 }
 
+void Session::startChatListBatch() {
+	++_chatListBatchLevel;
+}
+
+void Session::finishChatListBatch() {
+	Expects(_chatListBatchLevel > 0);
+
+	if (--_chatListBatchLevel > 0) {
+		return;
+	}
+	for (const auto key : base::take(_chatListBatchRefreshes)) {
+		if (key.entry()->inChatList()) {
+			refreshChatListEntry(key);
+		}
+	}
+}
+
 void Session::refreshChatListEntry(Dialogs::Key key) {
 	Expects(key.entry()->folderKnown());
 
 	using namespace Dialogs;
 
 	const auto entry = key.entry();
+	if (_chatListBatchLevel > 0 && entry->inChatList()) {
+		_chatListBatchRefreshes.emplace(key);
+		return;
+	}
 	const auto history = key.history();
 	const auto mainList = chatsList(entry->folder());
 	auto event = ChatListEntryRefresh{ .key = key };
@@ -3382,11 +3454,12 @@ void Session::refreshChatListEntry(Dialogs::Key key) {
 	if (!history) {
 		return;
 	}
+	const auto historyFlags = ChatFilter::HistoryFlags(history);
 	for (const auto &filter : _chatsFilters->list()) {
 		const auto id = filter.id();
 		const auto filterList = chatsFilters().chatsList(id);
 		auto event = ChatListEntryRefresh{ .key = key, .filterId = id };
-		if (filter.contains(history)) {
+		if (filter.contains(history, historyFlags)) {
 			event.existenceChanged = !entry->inChatList(id);
 			if (event.existenceChanged) {
 				entry->addToChatList(id, filterList);
@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_groups.h"
 #include "data/data_cloud_file.h"
 #include "data/data_notify_settings.h"
+#include "data/data_id_map.h"
 #include "history/history_location_manager.h"
 #include "base/timer.h"
 #include "base/flags.h"
@@ -56,6 +57,7 @@ class CloudThemes;
 class Streaming;
 class MediaRotation;
 class Histories;
+class MessagesSearchIndex;
 class DocumentMedia;
 class PhotoMedia;
 class Stickers;
@@ -100,6 +102,9 @@ public:
 	[[nodiscard]] Histories &histories() const {
 		return *_histories;
 	}
+	[[nodiscard]] MessagesSearchIndex &messagesSearchIndex() const {
+		return *_messagesSearchIndex;
+	}
 	[[nodiscard]] Stickers &stickers() const {
 		return *_stickers;
 	}
@@ -109,6 +114,9 @@ public:
 
 	void clear();
 
+	// Rough memory usage by subsystem, logged each minute in debug mode.
+	[[nodiscard]] QString memoryStats() const;
+
 	void keepAlive(std::shared_ptr<PhotoMedia> media);
 	void keepAlive(std::shared_ptr<DocumentMedia> media);
 
@@ -316,6 +324,14 @@ public:
 		ChannelId channelId,
 		const QVector<MTPint> &data);
 
+	// Texts of new messages parsed on a worker thread, the messages
+	// created while they are set take their texts from here.
+	void setPreparedMessageTexts(
+		base::flat_map<FullMsgId, TextWithEntities> &&texts);
+	void clearPreparedMessageTexts();
+	[[nodiscard]] std::optional<TextWithEntities> takePreparedMessageText(
+		FullMsgId itemId);
+
 	[[nodiscard]] MsgId nextLocalMessageId();
 	[[nodiscard]] HistoryItem *message(
 		ChannelId channelId,
@@ -576,6 +592,11 @@ public:
 	};
 	void refreshChatListEntry(Dialogs::Key key);
 	void removeChatListEntry(Dialogs::Key key);
+
+	// While applying a batch of updates the entries that are already in
+	// the chat list are not moved, each one is moved once at the end.
+	void startChatListBatch();
+	void finishChatListBatch();
 	[[nodiscard]] auto chatListEntryRefreshes() const
 		-> rpl::producer<ChatListEntryRefresh>;
 
@@ -629,8 +650,6 @@ public:
 	void clearLocalStorage();
 
 private:
-	using Messages = std::unordered_map<MsgId, not_null<HistoryItem*>>;
-
 	void suggestStartExport();
 
 	void setupMigrationViewer();
@@ -648,8 +667,6 @@ private:
 		Data::Folder *requestFolder,
 		const MTPDdialogFolder &data);
 
-	const Messages *messagesList(ChannelId channelId) const;
-	not_null<Messages*> messagesListForInsert(ChannelId channelId);
 	not_null<HistoryItem*> registerMessage(
 		std::unique_ptr<HistoryItem> item);
 	void changeMessageId(ChannelId channel, MsgId wasId, MsgId nowId);
@@ -794,6 +811,8 @@ private:
 	rpl::event_stream<MegagroupParticipant> _megagroupParticipantAdded;
 	rpl::event_stream<DialogsRowReplacement> _dialogsRowReplacements;
 	rpl::event_stream<ChatListEntryRefresh> _chatListEntryRefreshes;
+	base::flat_set<Dialogs::Key> _chatListBatchRefreshes;
+	int _chatListBatchLevel = 0;
 	rpl::event_stream<> _unreadBadgeChanges;
 
 	Dialogs::MainList _chatsList;
@@ -801,8 +820,10 @@ private:
 	Dialogs::IndexedList _contactsNoChatsList;
 
 	MsgId _localMessageIdCounter = StartClientMsgId;
-	Messages _messages;
-	std::map<ChannelId, Messages> _channelMessages;
+
+	// All the messages of all the channels, by MessageKey(channel, id).
+	IdMap<uint64, HistoryItem*> _messages;
+	base::flat_map<FullMsgId, TextWithEntities> _preparedMessageTexts;
 	std::map<
 		not_null<HistoryItem*>,
 		base::flat_set<not_null<HistoryItem*>>> _dependentMessages;
@@ -811,35 +832,37 @@ private:
 	base::flat_map<uint64, SentData> _sentMessagesData;
 
 	base::Timer _selfDestructTimer;
+	base::Timer _memoryStatsTimer;
 	std::vector<FullMsgId> _selfDestructItems;
 
 	// When typing in this history started.
 	base::flat_map<not_null<History*>, crl::time> _sendActions;
+	crl::time _sendActionsAnimationLast = 0;
 	Ui::Animations::Basic _sendActionsAnimation;
 
 	std::unordered_map<
 		PhotoId,
 		std::unique_ptr<PhotoData>> _photos;
-	std::unordered_map<
-		not_null<const PhotoData*>,
+	IdMap<
+		const PhotoData*,
 		base::flat_set<not_null<HistoryItem*>>> _photoItems;
 	std::unordered_map<
 		DocumentId,
 		std::unique_ptr<DocumentData>> _documents;
-	std::unordered_map<
-		not_null<const DocumentData*>,
+	IdMap<
+		const DocumentData*,
 		base::flat_set<not_null<HistoryItem*>>> _documentItems;
 	std::unordered_map<
 		WebPageId,
 		std::unique_ptr<WebPageData>> _webpages;
-	std::unordered_map<
-		not_null<const WebPageData*>,
+	IdMap<
+		const WebPageData*,
 		base::flat_set<not_null<HistoryItem*>>> _webpageItems;
-	std::unordered_map<
-		not_null<const WebPageData*>,
+	IdMap<
+		const WebPageData*,
 		base::flat_set<not_null<ViewElement*>>> _webpageViews;
-	std::unordered_map<
-		LocationPoint,
+	std::map<
+		GeoPointLocation,
 		std::unique_ptr<Data::CloudImage>> _locations;
 	std::unordered_map<
 		PollId,
@@ -847,16 +870,16 @@ private:
 	std::unordered_map<
 		GameId,
 		std::unique_ptr<GameData>> _games;
-	std::unordered_map<
-		not_null<const GameData*>,
+	IdMap<
+		const GameData*,
 		base::flat_set<not_null<ViewElement*>>> _gameViews;
-	std::unordered_map<
-		not_null<const PollData*>,
+	IdMap<
+		const PollData*,
 		base::flat_set<not_null<ViewElement*>>> _pollViews;
-	std::unordered_map<
+	IdMap<
 		UserId,
 		base::flat_set<not_null<HistoryItem*>>> _contactItems;
-	std::unordered_map<
+	IdMap<
 		UserId,
 		base::flat_set<not_null<ViewElement*>>> _contactViews;
 
@@ -914,6 +937,9 @@ private:
 	std::unique_ptr<CloudThemes> _cloudThemes;
 	std::unique_ptr<Streaming> _streaming;
 	std::unique_ptr<MediaRotation> _mediaRotation;
+
+	// Items unregister from it while _histories are being destroyed.
+	std::unique_ptr<MessagesSearchIndex> _messagesSearchIndex;
 	std::unique_ptr<Histories> _histories;
 	std::unique_ptr<Stickers> _stickers;
 	MsgId _nonHistoryEntryId = ServerMaxMsgId;
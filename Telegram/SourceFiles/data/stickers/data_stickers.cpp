@@ -924,10 +924,11 @@ std::vector<not_null<DocumentData*>> Stickers::getListByEmoji(
 	auto &sets = setsRef();
 	auto setsToRequest = base::flat_map<uint64, uint64>();
 
+	// With hundreds of installed sets there are thousands of stickers
+	// for popular emoji, so the duplicates are checked in a sorted set.
+	auto added = base::flat_set<not_null<DocumentData*>>();
 	const auto add = [&](not_null<DocumentData*> document, TimeId date) {
-		if (ranges::find(result, document, [](const StickerWithDate &data) {
-			return data.document;
-		}) == result.end()) {
+		if (added.emplace(document).second) {
 			result.push_back({ document, date });
 		}
 	};
@@ -985,6 +986,7 @@ std::vector<not_null<DocumentData*>> Stickers::getListByEmoji(
 		auto i = recent->emoji.constFind(original);
 		if (i != recent->emoji.cend()) {
 			result.reserve(i->size());
+			added.reserve(i->size());
 			for (const auto document : *i) {
 				const auto usageDate = [&] {
 					if (recent->dates.empty()) {
@@ -1000,6 +1002,7 @@ std::vector<not_null<DocumentData*>> Stickers::getListByEmoji(
 				const auto date = usageDate
 					? usageDate
 					: InstallDate(document);
+				added.emplace(document);
 				result.push_back({
 					document,
 					date ? date : CreateRecentSortKey(document) });
@@ -1026,6 +1029,7 @@ std::vector<not_null<DocumentData*>> Stickers::getListByEmoji(
 			}
 			const auto my = (set->flags & MTPDstickerSet::Flag::f_installed_date);
 			result.reserve(result.size() + i->size());
+			added.reserve(added.size() + i->size());
 			for (const auto document : *i) {
 				const auto installDate = my ? set->installDate : TimeId(0);
 				const auto date = (installDate > 1)
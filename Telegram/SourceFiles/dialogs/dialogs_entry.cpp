@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "dialogs/dialogs_key.h"
 #include "dialogs/dialogs_indexed_list.h"
+#include "core/paint_stats.h"
 #include "data/data_changes.h"
 #include "data/data_session.h"
 #include "data/data_folder.h"
@@ -208,6 +209,8 @@ Row *Entry::maybeMainChatListLink(FilterId filterId) const {
 PositionChange Entry::adjustByPosInChatList(
 		FilterId filterId,
 		not_null<MainList*> list) {
+	PAINT_STATS_FRAME("Dialogs::IndexedList adjust");
+
 	const auto links = chatListLinks(filterId);
 	Assert(links != nullptr);
 	const auto from = links->main->pos();
@@ -187,6 +187,7 @@ public:
 	}
 
 	mutable const HistoryItem *textCachedFor = nullptr; // cache
+	mutable QString lastItemTextSource;
 	mutable Ui::Text::String lastItemTextCache;
 
 protected:
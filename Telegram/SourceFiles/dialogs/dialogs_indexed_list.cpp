@@ -26,6 +26,10 @@ RowsByLetter IndexedList::addToEnd(Key key) {
 	}
 
 	auto result = RowsByLetter{ _list.addToEnd(key) };
+	if (!searchable()) {
+		return result;
+	}
+	indexWords(key);
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -42,6 +46,10 @@ Row *IndexedList::addByName(Key key) {
 	}
 
 	const auto result = _list.addByName(key);
+	if (!searchable()) {
+		return result;
+	}
+	indexWords(key);
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -119,6 +127,9 @@ void IndexedList::adjustByName(
 	const auto mainRow = _list.adjustByName(key);
 	if (!mainRow) return;
 
+	unindexWords(key);
+	indexWords(key);
+
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
@@ -154,7 +165,10 @@ void IndexedList::adjustNames(
 		const base::flat_set<QChar> &oldLetters) {
 	const auto key = Dialogs::Key(history);
 	auto mainRow = _list.getRow(key);
-	if (!mainRow) return;
+	if (!mainRow || !searchable()) return;
+
+	unindexWords(key);
+	indexWords(key);
 
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
@@ -188,6 +202,7 @@ void IndexedList::adjustNames(
 
 void IndexedList::del(Key key, Row *replacedBy) {
 	if (_list.del(key, replacedBy)) {
+		unindexWords(key);
 		for (const auto ch : key.entry()->chatListFirstLetters()) {
 			if (auto it = _index.find(ch); it != _index.cend()) {
 				it->second.del(key, replacedBy);
@@ -198,55 +213,106 @@ void IndexedList::del(Key key, Row *replacedBy) {
 
 void IndexedList::clear() {
 	_index.clear();
+	_words.clear();
+	_wordsByKey.clear();
+}
+
+bool IndexedList::searchable() const {
+	// Chat filter lists are only shown, never searched, so they don't
+	// keep rows by letters and name words for each of their chats.
+	return !_filterId;
+}
+
+void IndexedList::indexWords(Key key) {
+	const auto &words = key.entry()->chatListNameWords();
+	if (words.empty()) {
+		return;
+	}
+	for (const auto &word : words) {
+		_words[word].emplace(key);
+	}
+	_wordsByKey.emplace(key, words);
+}
+
+void IndexedList::unindexWords(Key key) {
+	const auto i = _wordsByKey.find(key);
+	if (i == _wordsByKey.end()) {
+		return;
+	}
+	for (const auto &word : i->second) {
+		const auto j = _words.find(word);
+		if (j != _words.end()) {
+			j->second.remove(key);
+			if (j->second.empty()) {
+				_words.erase(j);
+			}
+		}
+	}
+	_wordsByKey.erase(i);
 }
 
 std::vector<not_null<Row*>> IndexedList::filtered(
 		const QStringList &words) const {
-	const auto minimal = [&]() -> const Dialogs::List* {
-		if (empty()) {
-			return nullptr;
-		}
-		auto result = (const Dialogs::List*)nullptr;
-		for (const auto &word : words) {
-			if (word.isEmpty()) {
-				continue;
-			}
-			const auto found = filtered(word[0]);
-			if (!found || found->empty()) {
-				return nullptr;
-			} else if (!result || result->size() > found->size()) {
-				result = found;
-			}
+	auto result = std::vector<not_null<Row*>>();
+	if (empty()) {
+		return result;
+	}
+
+	// Look up the longest word, it usually gives the fewest candidates.
+	auto longest = (const QString*)nullptr;
+	for (const auto &word : words) {
+		if (!word.isEmpty() && (!longest || word.size() > longest->size())) {
+			longest = &word;
 		}
+	}
+	if (!longest) {
 		return result;
-	}();
-	auto result = std::vector<not_null<Row*>>();
-	if (!minimal || minimal->empty()) {
+	}
+	const auto letters = filtered((*longest)[0]);
+	if (!letters || letters->empty()) {
 		return result;
 	}
-	result.reserve(minimal->size());
-	for (const auto row : *minimal) {
-		const auto &nameWords = row->entry()->chatListNameWords();
-		const auto found = [&](const QString &word) {
-			for (const auto &name : nameWords) {
-				if (name.startsWith(word)) {
-					return true;
-				}
+
+	auto candidates = std::vector<Key>();
+	for (auto i = _words.lower_bound(*longest)
+		; (i != _words.end()) && i->first.startsWith(*longest)
+		; ++i) {
+		candidates.insert(end(candidates), begin(i->second), end(i->second));
+	}
+	ranges::sort(candidates);
+	candidates.erase(
+		std::unique(begin(candidates), end(candidates)),
+		end(candidates));
+
+	const auto allFound = [&](const base::flat_set<QString> &nameWords) {
+		for (const auto &word : words) {
+			if (&word == longest) {
+				continue;
 			}
-			return false;
-		};
-		const auto allFound = [&] {
-			for (const auto &word : words) {
-				if (!found(word)) {
-					return false;
-				}
+			const auto found = ranges::find_if(nameWords, [&](
+					const QString &name) {
+				return name.startsWith(word);
+			});
+			if (found == end(nameWords)) {
+				return false;
 			}
-			return true;
-		}();
-		if (allFound) {
+		}
+		return true;
+	};
+	result.reserve(candidates.size());
+	for (const auto key : candidates) {
+		const auto i = _wordsByKey.find(key);
+		if (i == _wordsByKey.end() || !allFound(i->second)) {
+			continue;
+		} else if (const auto row = letters->getRow(key)) {
 			result.push_back(row);
 		}
 	}
+
+	// Keep the order of the list, as if we've filtered it row by row.
+	ranges::sort(result, ranges::less(), [](not_null<Row*> row) {
+		return row->pos();
+	});
 	return result;
 }
 
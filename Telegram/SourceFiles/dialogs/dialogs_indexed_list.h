@@ -80,11 +80,19 @@ private:
 		not_null<History*> history,
 		const base::flat_set<QChar> &oldChars);
 
+	[[nodiscard]] bool searchable() const;
+	void indexWords(Key key);
+	void unindexWords(Key key);
+
 	SortMode _sortMode = SortMode();
 	FilterId _filterId = 0;
 	List _list, _empty;
 	base::flat_map<QChar, List> _index;
 
+	// Sorted name words for prefix lookups in filtered(words).
+	std::map<QString, base::flat_set<Key>> _words;
+	std::map<Key, base::flat_set<QString>> _wordsByKey;
+
 };
 
 } // namespace Dialogs
@@ -11,11 +11,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_layout.h"
 #include "dialogs/dialogs_widget.h"
 #include "dialogs/dialogs_search_from_controllers.h"
+#include "core/paint_stats.h"
 //#include "history/feed/history_feed_section.h" // #feed
 #include "history/history.h"
 #include "history/history_item.h"
 #include "core/shortcuts.h"
 #include "core/application.h"
+#include "core/startup_trace.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/popup_menu.h"
 #include "ui/text/text_utilities.h"
@@ -403,12 +405,14 @@ void InnerWidget::changeOpenedFolder(Data::Folder *folder) {
 }
 
 void InnerWidget::paintEvent(QPaintEvent *e) {
+	PAINT_STATS_FRAME("Dialogs::InnerWidget");
 	Painter p(this);
 
 	const auto r = e->rect();
 	if (App::wnd()->contentOverlapped(this, r)) {
 		return;
 	}
+	p.setClipRect(r);
 	const auto activeEntry = _controller->activeChatEntryCurrent();
 	auto fullWidth = width();
 	auto dialogsClip = r;
@@ -418,6 +422,9 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 
 		const auto rows = shownDialogs();
 		const auto &list = rows->all();
+		if (!rows->empty()) {
+			STARTUP_TRACE_FINISH("Dialogs::InnerWidget first paint");
+		}
 		const auto otherStart = std::max(int(rows->size()) - _skipTopDialogs, 0) * st::dialogsRowHeight;
 		const auto active = activeEntry.key;
 		const auto selected = _menuRow.key
@@ -1591,9 +1598,16 @@ void InnerWidget::updateDialogRow(
 	}
 
 	const auto updateRow = [&](int rowTop) {
+		const auto top = rowTop + updateRect.y();
+		const auto bottom = top + updateRect.height();
+		if (_visibleBottom > _visibleTop
+			&& (bottom <= _visibleTop || top >= _visibleBottom)) {
+			// Send action animations of hidden rows come every frame.
+			return;
+		}
 		rtlupdate(
 			updateRect.x(),
-			rowTop + updateRect.y(),
+			top,
 			updateRect.width(),
 			updateRect.height());
 	};
@@ -1856,6 +1870,8 @@ void InnerWidget::applyFilterUpdate(QString newFilter, bool force) {
 		if (_filter.isEmpty() && !_searchFromUser) {
 			clearFilter();
 		} else {
+			PAINT_STATS_FRAME("Dialogs::InnerWidget filter");
+
 			_state = WidgetState::Filtered;
 			_waitingForSearch = true;
 			_filterResults.clear();
@@ -2108,6 +2124,20 @@ bool InnerWidget::searchReceived(
 	return lastDateFound != 0;
 }
 
+void InnerWidget::localSearchReceived(
+		const std::vector<not_null<HistoryItem*>> &items) {
+	if (_state != WidgetState::Filtered || !_searchInChat) {
+		return;
+	}
+	clearSearchResults(false);
+	for (const auto item : items) {
+		_searchResults.push_back(
+			std::make_unique<FakeRow>(_searchInChat, item));
+	}
+	_searchedCount = items.size();
+	refresh();
+}
+
 void InnerWidget::peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
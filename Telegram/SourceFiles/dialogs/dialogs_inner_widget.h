@@ -73,6 +73,10 @@ public:
 		HistoryItem *inject,
 		SearchRequestType type,
 		int fullCount);
+
+	// Shown until the server results for the same query arrive.
+	void localSearchReceived(
+		const std::vector<not_null<HistoryItem*>> &items);
 	void peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -250,35 +250,48 @@ void paintRow(
 	p.fillRect(fullRect, bg);
 	row->paintRipple(p, 0, 0, fullWidth, &ripple->c);
 
-	if (flags & Flag::SavedMessages) {
-		Ui::EmptyUserpic::PaintSavedMessages(
-			p,
-			st::dialogsPadding.x(),
-			st::dialogsPadding.y(),
-			fullWidth,
-			st::dialogsPhotoSize);
-	} else if (from) {
-		row->paintUserpic(
-			p,
-			from,
-			(flags & Flag::AllowUserOnline),
-			active,
-			fullWidth);
-	} else if (hiddenSenderInfo) {
-		hiddenSenderInfo->userpic.paint(
-			p,
-			st::dialogsPadding.x(),
-			st::dialogsPadding.y(),
-			fullWidth,
-			st::dialogsPhotoSize);
-	} else {
-		entry->paintUserpicLeft(
-			p,
-			row->userpicView(),
-			st::dialogsPadding.x(),
-			st::dialogsPadding.y(),
-			fullWidth,
-			st::dialogsPhotoSize);
+	// Send action animations repaint only a part of the text line,
+	// the userpic and the name stay the same and can be skipped.
+	const auto clip = p.hasClipping()
+		? p.clipBoundingRect().toAlignedRect()
+		: fullRect;
+	const auto userpicRect = style::rtlrect(
+		st::dialogsPadding.x(),
+		st::dialogsPadding.y(),
+		st::dialogsPhotoSize,
+		st::dialogsPhotoSize,
+		fullWidth);
+	if (clip.intersects(userpicRect)) {
+		if (flags & Flag::SavedMessages) {
+			Ui::EmptyUserpic::PaintSavedMessages(
+				p,
+				st::dialogsPadding.x(),
+				st::dialogsPadding.y(),
+				fullWidth,
+				st::dialogsPhotoSize);
+		} else if (from) {
+			row->paintUserpic(
+				p,
+				from,
+				(flags & Flag::AllowUserOnline),
+				active,
+				fullWidth);
+		} else if (hiddenSenderInfo) {
+			hiddenSenderInfo->userpic.paint(
+				p,
+				st::dialogsPadding.x(),
+				st::dialogsPadding.y(),
+				fullWidth,
+				st::dialogsPhotoSize);
+		} else {
+			entry->paintUserpicLeft(
+				p,
+				row->userpicView(),
+				st::dialogsPadding.x(),
+				st::dialogsPadding.y(),
+				fullWidth,
+				st::dialogsPhotoSize);
+		}
 	}
 
 	auto nameleft = st::dialogsPadding.x()
@@ -428,7 +441,15 @@ void paintRow(
 		}
 		return nullptr;
 	}();
-	if (sendStateIcon && history) {
+	const auto nameRect = style::rtlrect(
+		rectForName.x(),
+		rectForName.y(),
+		rectForName.width(),
+		rectForName.height(),
+		fullWidth);
+	if (!clip.intersects(nameRect)) {
+		return;
+	} else if (sendStateIcon && history) {
 		rectForName.setWidth(rectForName.width() - st::dialogsSendStateSkip);
 		sendStateIcon->paint(p, rectForName.topLeft() + QPoint(rectForName.width(), 0), fullWidth);
 	}
@@ -748,6 +769,7 @@ void RowPainter::paint(
 				selected,
 				HistoryItem::DrawInDialog::Normal,
 				entry->textCachedFor,
+				entry->lastItemTextSource,
 				entry->lastItemTextCache);
 		}
 	};
@@ -866,6 +888,7 @@ void RowPainter::paint(
 			selected,
 			drawInDialogWay,
 			row->_cacheFor,
+			row->_cacheSource,
 			row->_cache);
 	};
 	const auto paintCounterCallback = [&] {
@@ -133,6 +133,7 @@ public:
 
 	void invalidateCache() {
 		_cacheFor = nullptr;
+		_cacheSource = QString();
 		_cache = Ui::Text::String();
 	}
 
@@ -142,6 +143,7 @@ private:
 	Key _searchInChat;
 	not_null<HistoryItem*> _item;
 	mutable const HistoryItem *_cacheFor = nullptr;
+	mutable QString _cacheSource;
 	mutable Ui::Text::String _cache;
 
 };
@@ -40,6 +40,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_user.h"
 #include "data/data_folder.h"
 #include "data/data_histories.h"
+#include "data/data_messages_search_index.h"
 #include "data/data_changes.h"
 #include "facades.h"
 #include "app.h"
@@ -837,6 +838,13 @@ bool Widget::onSearchMessages(bool searchCache) {
 				_searchQueries.insert(_searchRequest, _searchQuery);
 				return _searchRequest;
 			});
+			if (!_searchQueryFrom) {
+				_inner->localSearchReceived(
+					session().data().messagesSearchIndex().search(
+						history,
+						_searchQuery,
+						SearchPerPage));
+			}
 		//} else if (const auto feed = _searchInChat.feed()) { // #feed
 		//	const auto type = SearchRequestType::FromStart;
 		//	_searchRequest = session().api().request(MTPchannels_SearchFeed(
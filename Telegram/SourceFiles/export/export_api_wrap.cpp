@@ -11,9 +11,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/data/export_data_types.h"
 #include "export/output/export_output_result.h"
 #include "export/output/export_output_file.h"
+#include "export/output/export_output_stats.h"
 #include "mtproto/mtproto_rpc_sender.h"
 #include "base/value_ordering.h"
 #include "base/bytes.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <set>
 #include <deque>
 
@@ -23,12 +28,15 @@ namespace {
 constexpr auto kUserpicsSliceLimit = 100;
 constexpr auto kFileChunkSize = 128 * 1024;
 constexpr auto kFileRequestsCount = 2;
+constexpr auto kFileProcessesCount = 4;
 constexpr auto kFileNextRequestDelay = crl::time(20);
 constexpr auto kChatsSliceLimit = 100;
 constexpr auto kMessagesSliceLimit = 100;
 constexpr auto kTopPeerSliceLimit = 100;
 constexpr auto kFileMaxSize = 1500 * 1024 * 1024;
 constexpr auto kLocationCacheSize = 100'000;
+const auto kCheckpointFileName = qstr(".export_checkpoint");
+const auto kLastMessageIdsFileName = qstr(".export_last_ids");
 
 struct LocationKey {
 	uint64 type;
@@ -37,6 +45,9 @@ struct LocationKey {
 	inline bool operator<(const LocationKey &other) const {
 		return std::tie(type, id) < std::tie(other.type, other.id);
 	}
+	inline bool operator==(const LocationKey &other) const {
+		return std::tie(type, id) == std::tie(other.type, other.id);
+	}
 };
 
 std::tuple<const uint64 &, const uint64 &> value_ordering_helper(const LocationKey &value) {
@@ -113,6 +124,59 @@ Settings::Type SettingsFromDialogsType(Data::DialogInfo::Type type) {
 	return Settings::Type(0);
 }
 
+using LastMessageIds = base::flat_map<Data::PeerId, int32>;
+
+void ReadLastMessageIds(const QString &folder, LastMessageIds &result) {
+	auto file = QFile(folder + kLastMessageIdsFileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+
+	// Each line is "<peer id> <last message id>".
+	while (!file.atEnd()) {
+		const auto line = QString::fromUtf8(file.readLine()).trimmed();
+		auto peerOk = false, idOk = false;
+		const auto peerId = line.section(' ', 0, 0).toULongLong(&peerOk);
+		const auto id = line.section(' ', 1, 1).toInt(&idOk);
+		if (peerOk && idOk && peerId && id > 0) {
+			auto &already = result[peerId];
+			already = std::max(already, int32(id));
+		}
+	}
+}
+
+// Last message ids per chat from the finished exports next to this one.
+LastMessageIds ReadPreviousLastMessageIds(const QString &path) {
+	Expects(path.endsWith('/'));
+
+	auto result = LastMessageIds();
+	auto parent = QDir(path);
+	if (!parent.cdUp()) {
+		return result;
+	}
+	const auto current = QDir(path).absolutePath();
+	const auto mode = QDir::Dirs | QDir::NoDotAndDotDot;
+	for (const auto &info : parent.entryInfoList(mode)) {
+		const auto folder = info.absoluteFilePath();
+		if (folder != current) {
+			ReadLastMessageIds(folder + '/', result);
+		}
+	}
+	return result;
+}
+
+void WriteLastMessageIds(const QString &path, const LastMessageIds &ids) {
+	auto file = QFile(path + kLastMessageIdsFileName);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return;
+	}
+	auto data = QByteArray();
+	for (const auto &[peerId, id] : ids) {
+		data.append(QString("%1 %2\n").arg(peerId).arg(id).toUtf8());
+	}
+	file.write(data);
+}
+
 } // namespace
 
 class ApiWrap::LoadedFileCache {
@@ -131,6 +195,40 @@ private:
 
 };
 
+// The list of files loaded to the export folder, written as they load
+// and removed when the export finishes successfully. When an export is
+// started next to folders of unfinished ones, their loaded files are
+// copied to the new folder instead of being loaded once again.
+class ApiWrap::Checkpoint {
+public:
+	using Location = Data::FileLocation;
+
+	explicit Checkpoint(const QString &path);
+
+	void save(
+		const Location &location,
+		int size,
+		const QString &relativePath);
+	[[nodiscard]] std::optional<QString> takePrevious(
+		const Location &location,
+		const QString &relativePath,
+		Output::Stats *stats);
+	void finish();
+
+private:
+	struct Previous {
+		QString path;
+		int size = 0;
+	};
+
+	void readPrevious(const QString &folder);
+
+	const QString _path;
+	QFile _file;
+	std::map<LocationKey, Previous> _previous;
+
+};
+
 struct ApiWrap::StartProcess {
 	FnMut<void(StartInfo)> done;
 
@@ -174,6 +272,7 @@ struct ApiWrap::OtherDataProcess {
 struct ApiWrap::FileProcess {
 	FileProcess(const QString &path, Output::Stats *stats);
 
+	uint64 id = 0;
 	Output::File file;
 	QString relativePath;
 
@@ -193,6 +292,7 @@ struct ApiWrap::FileProcess {
 };
 
 struct ApiWrap::FileProgress {
+	QString path;
 	int ready = 0;
 	int total = 0;
 };
@@ -227,15 +327,27 @@ struct ApiWrap::ChatProcess {
 	Fn<bool(Data::MessagesSlice&&)> handleSlice;
 	FnMut<void()> done;
 
-	FnMut<void(MTPmessages_Messages&&)> requestDone;
+	base::flat_map<int, FnMut<void(MTPmessages_Messages&&)>> requestDone;
+	int requestId = 0;
+	int countsLoading = 0;
 
 	int localSplitIndex = 0;
 	int32 largestIdPlusOne = 1;
 
+	// In the incremental mode only messages after this one are exported.
+	int32 previousLastId = 0;
+
 	Data::ParseMediaContext context;
 	std::optional<Data::MessagesSlice> slice;
 	bool lastSlice = false;
 	int fileIndex = 0;
+	bool fileIndexThumb = false;
+
+	// The next slice is requested while the files of this one load.
+	std::optional<Data::MessagesSlice> prefetched;
+	bool prefetchedLast = false;
+	bool prefetching = false;
+	bool waitingPrefetched = false;
 };
 
 
@@ -347,6 +459,110 @@ std::optional<QString> ApiWrap::LoadedFileCache::find(
 	return std::nullopt;
 }
 
+ApiWrap::Checkpoint::Checkpoint(const QString &path)
+: _path(path)
+, _file(path + kCheckpointFileName) {
+	Expects(path.endsWith('/'));
+
+	auto parent = QDir(path);
+	if (!parent.cdUp()) {
+		return;
+	}
+	const auto current = QDir(path).absolutePath();
+	const auto mode = QDir::Dirs | QDir::NoDotAndDotDot;
+	for (const auto &info : parent.entryInfoList(mode)) {
+		const auto folder = info.absoluteFilePath();
+		if (folder != current
+			&& QFile::exists(folder + '/' + kCheckpointFileName)) {
+			readPrevious(folder + '/');
+		}
+	}
+}
+
+void ApiWrap::Checkpoint::readPrevious(const QString &folder) {
+	auto file = QFile(folder + kCheckpointFileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+
+	// Each line is "<type> <id> <size> <relative path>".
+	while (!file.atEnd()) {
+		auto line = QString::fromUtf8(file.readLine());
+		if (line.endsWith('\n')) {
+			line.chop(1);
+		}
+		auto key = LocationKey();
+		auto typeOk = false, idOk = false, sizeOk = false;
+		key.type = line.section(' ', 0, 0).toULongLong(&typeOk);
+		key.id = line.section(' ', 1, 1).toULongLong(&idOk);
+		const auto size = line.section(' ', 2, 2).toInt(&sizeOk);
+		const auto relativePath = line.section(' ', 3);
+		const auto pathOk = !relativePath.isEmpty()
+			&& !QDir::isAbsolutePath(relativePath)
+			&& !relativePath.contains(qstr(".."));
+		if (typeOk && idOk && sizeOk && size > 0 && pathOk) {
+			_previous[key] = Previous{ folder + relativePath, size };
+		}
+	}
+}
+
+void ApiWrap::Checkpoint::save(
+		const Location &location,
+		int size,
+		const QString &relativePath) {
+	if (!location || size <= 0) {
+		return;
+	} else if (!_file.isOpen() && !_file.open(QIODevice::Append)) {
+		return;
+	}
+	const auto key = ComputeLocationKey(location);
+	const auto line = QString("%1 %2 %3 %4\n"
+	).arg(key.type
+	).arg(key.id
+	).arg(size
+	).arg(relativePath);
+	_file.write(line.toUtf8());
+	_file.flush();
+}
+
+std::optional<QString> ApiWrap::Checkpoint::takePrevious(
+		const Location &location,
+		const QString &relativePath,
+		Output::Stats *stats) {
+	if (!location || _previous.empty()) {
+		return std::nullopt;
+	}
+	const auto i = _previous.find(ComputeLocationKey(location));
+	if (i == end(_previous)) {
+		return std::nullopt;
+	}
+	const auto previous = i->second;
+	_previous.erase(i);
+
+	// Partially loaded files are never saved, check that this one is there.
+	if (QFileInfo(previous.path).size() != previous.size) {
+		return std::nullopt;
+	}
+	const auto path = _path + relativePath;
+	const auto dir = QFileInfo(path).absoluteDir();
+	if (!dir.exists() && !dir.mkpath(dir.absolutePath())) {
+		return std::nullopt;
+	}
+	// The earlier export keeps its files, it may still be resumed.
+	if (!Output::File::Copy(previous.path, path, stats)) {
+		return std::nullopt;
+	}
+	save(location, previous.size, relativePath);
+	return relativePath;
+}
+
+void ApiWrap::Checkpoint::finish() {
+	if (_file.isOpen()) {
+		_file.close();
+	}
+	_file.remove();
+}
+
 ApiWrap::FileProcess::FileProcess(const QString &path, Output::Stats *stats)
 : file(path, stats) {
 }
@@ -377,11 +593,13 @@ auto ApiWrap::splitRequest(int index, Request &&request) {
 		std::forward<Request>(request)));
 }
 
-auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
+auto ApiWrap::fileRequest(not_null<FileProcess*> process, int offset) {
+	const auto &location = process->location;
 	Expects(location.dcId != 0
 		|| location.data.type() == mtpc_inputTakeoutFileLocation);
 	Expects(_takeoutId.has_value());
 
+	const auto id = process->id;
 	return std::move(_mtp.request(MTPInvokeWithTakeout<MTPupload_GetFile>(
 		MTP_long(*_takeoutId),
 		MTPupload_GetFile(
@@ -390,9 +608,13 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
 			MTP_int(offset),
 			MTP_int(kFileChunkSize))
 	)).fail([=](RPCError &&result) {
-		if (result.type() == qstr("TAKEOUT_FILE_EMPTY")
+		const auto process = fileProcess(id);
+		if (!process) {
+			return;
+		} else if (result.type() == qstr("TAKEOUT_FILE_EMPTY")
 			&& _otherDataProcess != nullptr) {
 			filePartDone(
+				process,
 				0,
 				MTP_upload_file(
 					MTP_storage_filePartial(),
@@ -400,10 +622,10 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
 					MTP_bytes()));
 		} else if (result.type() == qstr("LOCATION_INVALID")
 			|| result.type() == qstr("VERSION_INVALID")) {
-			filePartUnavailable();
+			filePartUnavailable(process);
 		} else if (result.code() == 400
 			&& result.type().startsWith(qstr("FILE_REFERENCE_"))) {
-			filePartRefreshReference(offset);
+			filePartRefreshReference(process, offset);
 		} else {
 			error(std::move(result));
 		}
@@ -432,6 +654,10 @@ void ApiWrap::startExport(
 
 	_settings = std::make_unique<Settings>(settings);
 	_stats = stats;
+	_checkpoint = std::make_unique<Checkpoint>(_settings->path);
+	if (_settings->incremental && !_settings->onlySinglePeer()) {
+		_previousLastIds = ReadPreviousLastMessageIds(_settings->path);
+	}
 	_startProcess = std::make_unique<StartProcess>();
 	_startProcess->done = std::move(done);
 
@@ -823,7 +1049,6 @@ void ApiWrap::finishUserpicsSlice() {
 }
 
 bool ApiWrap::loadUserpicProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
 	Expects(_userpicsProcess != nullptr);
 	Expects(_userpicsProcess->slice.has_value());
 	Expects((_userpicsProcess->fileIndex >= 0)
@@ -831,7 +1056,7 @@ bool ApiWrap::loadUserpicProgress(FileProgress progress) {
 			< _userpicsProcess->slice->list.size()));
 
 	return _userpicsProcess->fileProgress(DownloadProgress{
-		_fileProcess->relativePath,
+		progress.path,
 		_userpicsProcess->fileIndex,
 		progress.ready,
 		progress.total });
@@ -951,13 +1176,34 @@ void ApiWrap::requestMessages(
 	_chatProcess->handleSlice = std::move(slice);
 	_chatProcess->done = std::move(done);
 
-	requestMessagesCount(0);
+	const auto previous = _previousLastIds.find(info.peerId);
+	if (previous != end(_previousLastIds)) {
+		// Keep the last id for the next export if no new messages come.
+		_chatProcess->previousLastId = previous->second;
+		_chatProcess->largestIdPlusOne = previous->second + 1;
+		auto &lastId = _lastIds[info.peerId];
+		lastId = std::max(lastId, previous->second);
+	}
+
+	// Counts in all the splits are requested at once, for the small chats
+	// the latency of these requests takes most of the export time.
+	const auto splits = int(_chatProcess->info.splits.size());
+	_chatProcess->countsLoading = splits;
+	for (auto i = 0; i != splits; ++i) {
+		requestMessagesCount(i);
+	}
 }
 
 void ApiWrap::requestMessagesCount(int localSplitIndex) {
 	Expects(_chatProcess != nullptr);
 	Expects(localSplitIndex < _chatProcess->info.splits.size());
 
+	if (_chatProcess->previousLastId > 0
+		&& _chatProcess->info.splits[localSplitIndex] < 0) {
+		// The migrated group didn't change since the previous export.
+		messagesCountLoaded(localSplitIndex, 0);
+		return;
+	}
 	requestChatMessages(
 		_chatProcess->info.splits[localSplitIndex],
 		0, // offset_id
@@ -1022,8 +1268,8 @@ void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
 	Expects(localSplitIndex < _chatProcess->info.splits.size());
 
 	_chatProcess->info.messagesCountPerSplit[localSplitIndex] = count;
-	if (localSplitIndex + 1 < _chatProcess->info.splits.size()) {
-		requestMessagesCount(localSplitIndex + 1);
+	if (--_chatProcess->countsLoading > 0) {
+		return;
 	} else if (_chatProcess->start(_chatProcess->info)) {
 		requestMessagesSlice();
 	}
@@ -1032,6 +1278,16 @@ void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
 void ApiWrap::finishExport(FnMut<void()> done) {
 	const auto guard = gsl::finally([&] { _takeoutId = std::nullopt; });
 
+	if (_checkpoint) {
+		_checkpoint->finish();
+	}
+	// A partial export can't be continued by an incremental one.
+	const auto partial = _settings->onlySinglePeer()
+		|| (_settings->singlePeerFrom > 0)
+		|| (_settings->singlePeerTill > 0);
+	if (!partial && !_lastIds.empty()) {
+		WriteLastMessageIds(_settings->path, _lastIds);
+	}
 	mainRequest(MTPaccount_FinishTakeoutSession(
 		MTP_flags(MTPaccount_FinishTakeoutSession::Flag::f_success)
 	)).done(std::move(done)).send();
@@ -1357,31 +1613,70 @@ void ApiWrap::requestMessagesSlice() {
 	if (!count) {
 		loadMessagesFiles({});
 		return;
+	} else if (_chatProcess->prefetched) {
+		_chatProcess->lastSlice = _chatProcess->prefetchedLast;
+		loadMessagesFiles(*base::take(_chatProcess->prefetched));
+		return;
+	} else if (_chatProcess->prefetching) {
+		_chatProcess->waitingPrefetched = true;
+		return;
 	}
+	requestMessagesSliceFrom(
+		_chatProcess->largestIdPlusOne,
+		[=](Data::MessagesSlice &&slice, bool last) {
+			_chatProcess->lastSlice = last;
+			loadMessagesFiles(std::move(slice));
+		});
+}
+
+void ApiWrap::requestMessagesSliceFrom(
+		int32 offsetId,
+		FnMut<void(Data::MessagesSlice&&, bool last)> done) {
+	Expects(_chatProcess != nullptr);
+
 	requestChatMessages(
 		_chatProcess->info.splits[_chatProcess->localSplitIndex],
-		_chatProcess->largestIdPlusOne,
+		offsetId,
 		-kMessagesSliceLimit,
 		kMessagesSliceLimit,
-		[=](const MTPmessages_Messages &result) {
+		[=, done = std::move(done)](
+				const MTPmessages_Messages &result) mutable {
 		Expects(_chatProcess != nullptr);
 
 		result.match([&](const MTPDmessages_messagesNotModified &data) {
 			error("Unexpected messagesNotModified received.");
 		}, [&](const auto &data) {
-			if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
-				_chatProcess->lastSlice = true;
-			}
-			loadMessagesFiles(Data::ParseMessagesSlice(
+			constexpr auto last = MTPDmessages_messages::Is<decltype(data)>();
+			done(Data::ParseMessagesSlice(
 				_chatProcess->context,
 				data.vmessages(),
 				data.vusers(),
 				data.vchats(),
-				_chatProcess->info.relativePath));
+				_chatProcess->info.relativePath), last);
 		});
 	});
 }
 
+void ApiWrap::prefetchMessagesSlice(int32 offsetId) {
+	Expects(_chatProcess != nullptr);
+	Expects(!_chatProcess->prefetching);
+	Expects(!_chatProcess->prefetched.has_value());
+
+	_chatProcess->prefetching = true;
+	requestMessagesSliceFrom(
+		offsetId,
+		[=](Data::MessagesSlice &&slice, bool last) {
+			_chatProcess->prefetching = false;
+			if (base::take(_chatProcess->waitingPrefetched)) {
+				_chatProcess->lastSlice = last;
+				loadMessagesFiles(std::move(slice));
+			} else {
+				_chatProcess->prefetched = std::move(slice);
+				_chatProcess->prefetchedLast = last;
+			}
+		});
+}
+
 void ApiWrap::requestChatMessages(
 		int splitIndex,
 		int offsetId,
@@ -1390,11 +1685,14 @@ void ApiWrap::requestChatMessages(
 		FnMut<void(MTPmessages_Messages&&)> done) {
 	Expects(_chatProcess != nullptr);
 
-	_chatProcess->requestDone = std::move(done);
+	const auto requestId = ++_chatProcess->requestId;
+	_chatProcess->requestDone.emplace(requestId, std::move(done));
 	const auto doneHandler = [=](MTPmessages_Messages &&result) {
 		Expects(_chatProcess != nullptr);
 
-		base::take(_chatProcess->requestDone)(std::move(result));
+		auto handler = _chatProcess->requestDone.take(requestId);
+		Assert(handler.has_value());
+		(*handler)(std::move(result));
 	};
 	const auto splitsCount = int(_splits.size());
 	const auto realPeerInput = (splitIndex >= 0)
@@ -1433,18 +1731,21 @@ void ApiWrap::requestChatMessages(
 			Expects(_chatProcess != nullptr);
 
 			if (error.type() == qstr("CHANNEL_PRIVATE")) {
-				if (realPeerInput.type() == mtpc_inputPeerChannel
-					&& !_chatProcess->info.onlyMyMessages) {
+				if (realPeerInput.type() == mtpc_inputPeerChannel) {
 
 					// Perhaps we just left / were kicked from channel.
-					// Just switch to only my messages.
+					// Just switch to only my messages. The requests in
+					// other splits sent before the switch may fail too.
 					_chatProcess->info.onlyMyMessages = true;
+					auto handler = _chatProcess->requestDone.take(
+						requestId);
+					Assert(handler.has_value());
 					requestChatMessages(
 						splitIndex,
 						offsetId,
 						addOffset,
 						limit,
-						base::take(_chatProcess->requestDone));
+						std::move(*handler));
 					return true;
 				}
 			}
@@ -1460,27 +1761,27 @@ void ApiWrap::loadMessagesFiles(Data::MessagesSlice &&slice) {
 	if (slice.list.empty()) {
 		_chatProcess->lastSlice = true;
 	}
+	if (!_chatProcess->lastSlice) {
+		// The offset is taken before the migrated ids are adjusted,
+		// the same way finishMessagesSlice() computes largestIdPlusOne.
+		prefetchMessagesSlice(slice.list.back().id + 1);
+	}
 	_chatProcess->slice = std::move(slice);
 	_chatProcess->fileIndex = 0;
+	_chatProcess->fileIndexThumb = false;
 
 	loadNextMessageFile();
 }
 
-Data::Message *ApiWrap::currentFileMessage() const {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
-
-	return &_chatProcess->slice->list[_chatProcess->fileIndex];
-}
-
-Data::FileOrigin ApiWrap::currentFileMessageOrigin() const {
+Data::FileOrigin ApiWrap::messageFileOrigin(int index) const {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
+	Expects(index >= 0 && index < _chatProcess->slice->list.size());
 
 	const auto splitIndex = _chatProcess->info.splits[
 		_chatProcess->localSplitIndex];
 	auto result = Data::FileOrigin();
-	result.messageId = currentFileMessage()->id;
+	result.messageId = _chatProcess->slice->list[index].id;
 	result.split = (splitIndex >= 0)
 		? splitIndex
 		: (int(_splits.size()) + splitIndex);
@@ -1494,39 +1795,55 @@ void ApiWrap::loadNextMessageFile() {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
 
+	// Files of the slice are loaded in parallel, the slice itself is
+	// passed further only when all of them are ready, so the output
+	// still gets the messages and their files in order.
 	for (auto &list = _chatProcess->slice->list
 		; _chatProcess->fileIndex < list.size()
 		; ++_chatProcess->fileIndex) {
-		const auto &message = list[_chatProcess->fileIndex];
+		const auto index = _chatProcess->fileIndex;
+		auto &message = list[index];
 		if (Data::SkipMessageByDate(message, *_settings)) {
 			continue;
 		}
-		const auto fileProgress = [=](FileProgress value) {
-			return loadMessageFileProgress(value);
-		};
-		const auto ready = processFileLoad(
-			list[_chatProcess->fileIndex].file(),
-			currentFileMessageOrigin(),
-			fileProgress,
-			[=](const QString &path) { loadMessageFileDone(path); },
-			currentFileMessage());
-		if (!ready) {
-			return;
+		// Wait for the same file that is loading for an earlier message,
+		// after that it will be taken from the loaded files cache.
+		if (!_chatProcess->fileIndexThumb) {
+			if (_fileProcesses.size() >= kFileProcessesCount
+				|| fileLoading(message.file().location)) {
+				return;
+			}
+			_chatProcess->fileIndexThumb = true;
+			processFileLoad(
+				message.file(),
+				messageFileOrigin(index),
+				[=](FileProgress value) {
+					return loadMessageFileProgress(index, value);
+				},
+				[=](const QString &path) {
+					loadMessageFileDone(index, path);
+				},
+				&message);
 		}
-		const auto thumbProgress = [=](FileProgress value) {
-			return loadMessageThumbProgress(value);
-		};
-		const auto thumbReady = processFileLoad(
-			list[_chatProcess->fileIndex].thumb().file,
-			currentFileMessageOrigin(),
-			thumbProgress,
-			[=](const QString &path) { loadMessageThumbDone(path); },
-			currentFileMessage());
-		if (!thumbReady) {
+		if (_fileProcesses.size() >= kFileProcessesCount
+			|| fileLoading(message.thumb().file.location)) {
 			return;
 		}
+		_chatProcess->fileIndexThumb = false;
+		processFileLoad(
+			message.thumb().file,
+			messageFileOrigin(index),
+			[=](FileProgress value) {
+				return loadMessageThumbProgress(index, value);
+			},
+			[=](const QString &path) {
+				loadMessageThumbDone(index, path);
+			},
+			&message);
+	}
+	if (_fileProcesses.empty()) {
+		finishMessagesSlice();
 	}
-	finishMessagesSlice();
 }
 
 void ApiWrap::finishMessagesSlice() {
@@ -1540,6 +1857,19 @@ void ApiWrap::finishMessagesSlice() {
 			_chatProcess->localSplitIndex];
 		if (splitIndex < 0) {
 			slice = AdjustMigrateMessageIds(std::move(slice));
+		} else {
+			// Only the messages that the writer gets count as exported.
+			const auto &list = slice.list;
+			const auto exported = std::find_if(
+				list.rbegin(),
+				list.rend(),
+				[&](const Data::Message &message) {
+					return !Data::SkipMessageByDate(message, *_settings);
+				});
+			if (exported != list.rend()) {
+				auto &lastId = _lastIds[_chatProcess->info.peerId];
+				lastId = std::max(lastId, exported->id);
+			}
 		}
 		if (!_chatProcess->handleSlice(std::move(slice))) {
 			return;
@@ -1549,7 +1879,7 @@ void ApiWrap::finishMessagesSlice() {
 		&& (++_chatProcess->localSplitIndex
 			< _chatProcess->info.splits.size())) {
 		_chatProcess->lastSlice = false;
-		_chatProcess->largestIdPlusOne = 1;
+		_chatProcess->largestIdPlusOne = _chatProcess->previousLastId + 1;
 	}
 	if (!_chatProcess->lastSlice) {
 		requestMessagesSlice();
@@ -1558,27 +1888,23 @@ void ApiWrap::finishMessagesSlice() {
 	}
 }
 
-bool ApiWrap::loadMessageFileProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
+bool ApiWrap::loadMessageFileProgress(int index, FileProgress progress) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects(index >= 0 && index < _chatProcess->slice->list.size());
 
 	return _chatProcess->fileProgress(DownloadProgress{
-		_fileProcess->relativePath,
-		_chatProcess->fileIndex,
+		progress.path,
+		index,
 		progress.ready,
 		progress.total });
 }
 
-void ApiWrap::loadMessageFileDone(const QString &relativePath) {
+void ApiWrap::loadMessageFileDone(int index, const QString &relativePath) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects(index >= 0 && index < _chatProcess->slice->list.size());
 
-	const auto index = _chatProcess->fileIndex;
 	auto &file = _chatProcess->slice->list[index].file();
 	file.relativePath = relativePath;
 	if (relativePath.isEmpty()) {
@@ -1587,17 +1913,15 @@ void ApiWrap::loadMessageFileDone(const QString &relativePath) {
 	loadNextMessageFile();
 }
 
-bool ApiWrap::loadMessageThumbProgress(FileProgress progress) {
-	return loadMessageFileProgress(progress);
+bool ApiWrap::loadMessageThumbProgress(int index, FileProgress progress) {
+	return loadMessageFileProgress(index, progress);
 }
 
-void ApiWrap::loadMessageThumbDone(const QString &relativePath) {
+void ApiWrap::loadMessageThumbDone(int index, const QString &relativePath) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects(index >= 0 && index < _chatProcess->slice->list.size());
 
-	const auto index = _chatProcess->fileIndex;
 	auto &file = _chatProcess->slice->list[index].thumb().file;
 	file.relativePath = relativePath;
 	if (relativePath.isEmpty()) {
@@ -1668,6 +1992,22 @@ bool ApiWrap::processFileLoad(
 	return false;
 }
 
+std::optional<QString> ApiWrap::takeCheckpointFile(const Data::File &file) {
+	Expects(_settings != nullptr);
+	Expects(_checkpoint != nullptr);
+
+	if (!file.location) {
+		return std::nullopt;
+	}
+	return _checkpoint->takePrevious(
+		file.location,
+		Output::File::PrepareRelativePath(
+			_settings->path,
+			file.suggestedPath,
+			loadingRelativePaths()),
+		_stats);
+}
+
 bool ApiWrap::writePreloadedFile(
 		Data::File &file,
 		const Data::FileOrigin &origin) {
@@ -1678,9 +2018,17 @@ bool ApiWrap::writePreloadedFile(
 	if (const auto path = _fileCache->find(file.location)) {
 		file.relativePath = *path;
 		return true;
+	} else if (const auto path = takeCheckpointFile(file)) {
+		file.relativePath = *path;
+		_fileCache->save(file.location, file.relativePath);
+		return true;
 	} else if (!file.content.isEmpty()) {
 		const auto process = prepareFileProcess(file, origin);
-		if (const auto result = process->file.writeBlock(file.content)) {
+		auto result = process->file.writeBlock(file.content);
+		if (result) {
+			result = process->file.flush();
+		}
+		if (result) {
 			file.relativePath = process->relativePath;
 			_fileCache->save(file.location, file.relativePath);
 		} else {
@@ -1696,25 +2044,28 @@ void ApiWrap::loadFile(
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done) {
-	Expects(_fileProcess == nullptr);
 	Expects(file.location.dcId != 0
 		|| file.location.data.type() == mtpc_inputTakeoutFileLocation);
 
-	_fileProcess = prepareFileProcess(file, origin);
-	_fileProcess->progress = std::move(progress);
-	_fileProcess->done = std::move(done);
+	auto owned = prepareFileProcess(file, origin);
+	const auto process = owned.get();
+	process->id = ++_fileProcessId;
+	process->progress = std::move(progress);
+	process->done = std::move(done);
+	_fileProcesses.emplace(process->id, std::move(owned));
 
-	if (_fileProcess->progress) {
+	if (process->progress) {
 		const auto progress = FileProgress{
-			_fileProcess->file.size(),
-			_fileProcess->size
+			process->relativePath,
+			process->file.size(),
+			process->size
 		};
-		if (!_fileProcess->progress(progress)) {
+		if (!process->progress(progress)) {
 			return;
 		}
 	}
 
-	loadFilePart();
+	loadFilePart(process);
 }
 
 auto ApiWrap::prepareFileProcess(
@@ -1725,7 +2076,8 @@ auto ApiWrap::prepareFileProcess(
 
 	const auto relativePath = Output::File::PrepareRelativePath(
 		_settings->path,
-		file.suggestedPath);
+		file.suggestedPath,
+		loadingRelativePaths());
 	auto result = std::make_unique<FileProcess>(
 		_settings->path + relativePath,
 		_stats);
@@ -1736,26 +2088,53 @@ auto ApiWrap::prepareFileProcess(
 	return result;
 }
 
-void ApiWrap::loadFilePart() {
-	if (!_fileProcess
-		|| _fileProcess->requests.size() >= kFileRequestsCount
-		|| (_fileProcess->size > 0
-			&& _fileProcess->offset >= _fileProcess->size)) {
+base::flat_set<QString> ApiWrap::loadingRelativePaths() const {
+	// Files that are still loading don't exist yet, reserve their names.
+	auto result = base::flat_set<QString>();
+	for (const auto &[id, process] : _fileProcesses) {
+		result.emplace(process->relativePath);
+	}
+	return result;
+}
+
+bool ApiWrap::fileLoading(const Data::FileLocation &location) const {
+	if (!location) {
+		return false;
+	}
+	const auto key = ComputeLocationKey(location);
+	return ranges::any_of(_fileProcesses, [&](const auto &pair) {
+		return (ComputeLocationKey(pair.second->location) == key);
+	});
+}
+
+auto ApiWrap::fileProcess(uint64 id) const
+-> FileProcess* {
+	const auto i = _fileProcesses.find(id);
+	return (i != end(_fileProcesses)) ? i->second.get() : nullptr;
+}
+
+void ApiWrap::loadFilePart(not_null<FileProcess*> process) {
+	if (process->requests.size() >= kFileRequestsCount
+		|| (process->size > 0
+			&& process->offset >= process->size)) {
 		return;
 	}
 
-	const auto offset = _fileProcess->offset;
-	_fileProcess->requests.push_back({ offset });
+	const auto id = process->id;
+	const auto offset = process->offset;
+	process->requests.push_back({ offset });
 	fileRequest(
-		_fileProcess->location,
-		_fileProcess->offset
+		process,
+		process->offset
 	).done([=](const MTPupload_File &result) {
-		filePartDone(offset, result);
+		if (const auto process = fileProcess(id)) {
+			filePartDone(process, offset, result);
+		}
 	}).send();
-	_fileProcess->offset += kFileChunkSize;
+	process->offset += kFileChunkSize;
 
-	if (_fileProcess->size > 0
-		&& _fileProcess->requests.size() < kFileRequestsCount) {
+	if (process->size > 0
+		&& process->requests.size() < kFileRequestsCount) {
 		//const auto runner = _runner;
 		//crl::on_main([=] {
 		//	QTimer::singleShot(kFileNextRequestDelay, [=] {
@@ -1767,9 +2146,11 @@ void ApiWrap::loadFilePart() {
 	}
 }
 
-void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartDone(
+		not_null<FileProcess*> process,
+		int offset,
+		const MTPupload_File &result) {
+	Expects(!process->requests.empty());
 
 	if (result.type() == mtpc_upload_fileCdnRedirect) {
 		error("Cdn redirect is not supported.");
@@ -1777,18 +2158,18 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 	}
 	const auto &data = result.c_upload_file();
 	if (data.vbytes().v.isEmpty()) {
-		if (_fileProcess->size > 0) {
+		if (process->size > 0) {
 			error("Empty bytes received in file part.");
 			return;
 		}
-		const auto result = _fileProcess->file.writeBlock({});
+		const auto result = process->file.writeBlock({});
 		if (!result) {
 			ioError(result);
 			return;
 		}
 	} else {
 		using Request = FileProcess::Request;
-		auto &requests = _fileProcess->requests;
+		auto &requests = process->requests;
 		const auto i = ranges::find(
 			requests,
 			offset,
@@ -1797,7 +2178,7 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 
 		i->bytes = data.vbytes().v;
 
-		auto &file = _fileProcess->file;
+		auto &file = process->file;
 		while (!requests.empty() && !requests.front().bytes.isEmpty()) {
 			const auto &bytes = requests.front().bytes;
 			if (const auto result = file.writeBlock(bytes); !result) {
@@ -1807,34 +2188,51 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 			requests.pop_front();
 		}
 
-		if (_fileProcess->progress) {
-			_fileProcess->progress(FileProgress{
+		if (process->progress) {
+			process->progress(FileProgress{
+				process->relativePath,
 				file.size(),
-				_fileProcess->size });
+				process->size });
 		}
 
 		if (!requests.empty()
-			|| !_fileProcess->size
-			|| _fileProcess->size > _fileProcess->offset) {
-			loadFilePart();
+			|| !process->size
+			|| process->size > process->offset) {
+			loadFilePart(process);
 			return;
 		}
 	}
 
-	auto process = base::take(_fileProcess);
-	const auto relativePath = process->relativePath;
-	_fileCache->save(process->location, relativePath);
-	process->done(process->relativePath);
+	if (const auto result = process->file.flush(); !result) {
+		ioError(result);
+		return;
+	}
+	_fileCache->save(process->location, process->relativePath);
+	_checkpoint->save(
+		process->location,
+		process->file.size(),
+		process->relativePath);
+	finishFileProcess(process, process->relativePath);
 }
 
-void ApiWrap::filePartRefreshReference(int offset) {
-	Expects(_fileProcess != nullptr);
+void ApiWrap::finishFileProcess(
+		not_null<FileProcess*> process,
+		const QString &relativePath) {
+	auto owned = _fileProcesses.take(process->id);
+	Assert(owned.has_value());
 
-	const auto &origin = _fileProcess->origin;
+	(*owned)->done(relativePath);
+}
+
+void ApiWrap::filePartRefreshReference(
+		not_null<FileProcess*> process,
+		int offset) {
+	const auto &origin = process->origin;
 	if (!origin.messageId) {
 		error("FILE_REFERENCE error for non-message file.");
 		return;
 	}
+	const auto id = process->id;
 	if (origin.peer.type() == mtpc_inputPeerChannel
 		|| origin.peer.type() == mtpc_inputPeerChannelFromMessage) {
 		const auto channel = (origin.peer.type() == mtpc_inputPeerChannel)
@@ -1851,10 +2249,12 @@ void ApiWrap::filePartRefreshReference(int offset) {
 				1,
 				MTP_inputMessageID(MTP_int(origin.messageId)))
 		)).fail([=](const RPCError &error) {
-			filePartUnavailable();
+			if (const auto process = fileProcess(id)) {
+				filePartUnavailable(process);
+			}
 			return true;
 		}).done([=](const MTPmessages_Messages &result) {
-			filePartExtractReference(offset, result);
+			filePartExtractReference(id, offset, result);
 		}).send();
 	} else {
 		splitRequest(origin.split, MTPmessages_GetMessages(
@@ -1862,19 +2262,24 @@ void ApiWrap::filePartRefreshReference(int offset) {
 				1,
 				MTP_inputMessageID(MTP_int(origin.messageId)))
 		)).fail([=](const RPCError &error) {
-			filePartUnavailable();
+			if (const auto process = fileProcess(id)) {
+				filePartUnavailable(process);
+			}
 			return true;
 		}).done([=](const MTPmessages_Messages &result) {
-			filePartExtractReference(offset, result);
+			filePartExtractReference(id, offset, result);
 		}).send();
 	}
 }
 
 void ApiWrap::filePartExtractReference(
+		uint64 processId,
 		int offset,
 		const MTPmessages_Messages &result) {
-	Expects(_fileProcess != nullptr);
-
+	const auto process = fileProcess(processId);
+	if (!process) {
+		return;
+	}
 	result.match([&](const MTPDmessages_messagesNotModified &data) {
 		error("Unexpected messagesNotModified received.");
 	}, [&](const auto &data) {
@@ -1886,35 +2291,36 @@ void ApiWrap::filePartExtractReference(
 			data.vchats(),
 			_chatProcess->info.relativePath);
 		for (const auto &message : messages.list) {
-			if (message.id == _fileProcess->origin.messageId) {
+			if (message.id == process->origin.messageId) {
 				const auto refresh1 = Data::RefreshFileReference(
-					_fileProcess->location,
+					process->location,
 					message.file().location);
 				const auto refresh2 = Data::RefreshFileReference(
-					_fileProcess->location,
+					process->location,
 					message.thumb().file.location);
 				if (refresh1 || refresh2) {
 					fileRequest(
-						_fileProcess->location,
+						process,
 						offset
 					).done([=](const MTPupload_File &result) {
-						filePartDone(offset, result);
+						if (const auto process = fileProcess(processId)) {
+							filePartDone(process, offset, result);
+						}
 					}).send();
 					return;
 				}
 			}
 		}
-		filePartUnavailable();
+		filePartUnavailable(process);
 	});
 }
 
-void ApiWrap::filePartUnavailable() {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartUnavailable(not_null<FileProcess*> process) {
+	Expects(!process->requests.empty());
 
 	LOG(("Export Error: File unavailable."));
 
-	base::take(_fileProcess)->done(QString());
+	finishFileProcess(process, QString());
 }
 
 void ApiWrap::error(RPCError &&error) {
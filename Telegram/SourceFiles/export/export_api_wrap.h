@@ -89,6 +89,7 @@ public:
 
 private:
 	class LoadedFileCache;
+	class Checkpoint;
 	struct StartProcess;
 	struct ContactsProcess;
 	struct UserpicsProcess;
@@ -147,6 +148,10 @@ private:
 	void checkFirstMessageDate(int localSplitIndex, int count);
 	void messagesCountLoaded(int localSplitIndex, int count);
 	void requestMessagesSlice();
+	void requestMessagesSliceFrom(
+		int32 offsetId,
+		FnMut<void(Data::MessagesSlice&&, bool last)> done);
+	void prefetchMessagesSlice(int32 offsetId);
 	void requestChatMessages(
 		int splitIndex,
 		int offsetId,
@@ -155,15 +160,14 @@ private:
 		FnMut<void(MTPmessages_Messages&&)> done);
 	void loadMessagesFiles(Data::MessagesSlice &&slice);
 	void loadNextMessageFile();
-	bool loadMessageFileProgress(FileProgress value);
-	void loadMessageFileDone(const QString &relativePath);
-	bool loadMessageThumbProgress(FileProgress value);
-	void loadMessageThumbDone(const QString &relativePath);
+	bool loadMessageFileProgress(int index, FileProgress value);
+	void loadMessageFileDone(int index, const QString &relativePath);
+	bool loadMessageThumbProgress(int index, FileProgress value);
+	void loadMessageThumbDone(int index, const QString &relativePath);
 	void finishMessagesSlice();
 	void finishMessages();
 
-	[[nodiscard]] Data::Message *currentFileMessage() const;
-	[[nodiscard]] Data::FileOrigin currentFileMessageOrigin() const;
+	[[nodiscard]] Data::FileOrigin messageFileOrigin(int index) const;
 
 	bool processFileLoad(
 		Data::File &file,
@@ -174,6 +178,8 @@ private:
 	std::unique_ptr<FileProcess> prepareFileProcess(
 		const Data::File &file,
 		const Data::FileOrigin &origin) const;
+	[[nodiscard]] std::optional<QString> takeCheckpointFile(
+		const Data::File &file);
 	bool writePreloadedFile(
 		Data::File &file,
 		const Data::FileOrigin &origin);
@@ -182,13 +188,25 @@ private:
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done);
-	void loadFilePart();
-	void filePartDone(int offset, const MTPupload_File &result);
-	void filePartUnavailable();
-	void filePartRefreshReference(int offset);
+	void loadFilePart(not_null<FileProcess*> process);
+	void filePartDone(
+		not_null<FileProcess*> process,
+		int offset,
+		const MTPupload_File &result);
+	void filePartUnavailable(not_null<FileProcess*> process);
+	void filePartRefreshReference(
+		not_null<FileProcess*> process,
+		int offset);
 	void filePartExtractReference(
+		uint64 processId,
 		int offset,
 		const MTPmessages_Messages &result);
+	void finishFileProcess(
+		not_null<FileProcess*> process,
+		const QString &relativePath);
+	[[nodiscard]] FileProcess *fileProcess(uint64 id) const;
+	[[nodiscard]] base::flat_set<QString> loadingRelativePaths() const;
+	[[nodiscard]] bool fileLoading(const Data::FileLocation &location) const;
 
 	template <typename Request>
 	class RequestBuilder;
@@ -200,7 +218,7 @@ private:
 	[[nodiscard]] auto splitRequest(int index, Request &&request);
 
 	[[nodiscard]] auto fileRequest(
-		const Data::FileLocation &location,
+		not_null<FileProcess*> process,
 		int offset);
 
 	void error(RPCError &&error);
@@ -216,15 +234,21 @@ private:
 
 	std::unique_ptr<StartProcess> _startProcess;
 	std::unique_ptr<LoadedFileCache> _fileCache;
+	std::unique_ptr<Checkpoint> _checkpoint;
 	std::unique_ptr<ContactsProcess> _contactsProcess;
 	std::unique_ptr<UserpicsProcess> _userpicsProcess;
 	std::unique_ptr<OtherDataProcess> _otherDataProcess;
-	std::unique_ptr<FileProcess> _fileProcess;
+	base::flat_map<uint64, std::unique_ptr<FileProcess>> _fileProcesses;
+	uint64 _fileProcessId = 0;
 	std::unique_ptr<LeftChannelsProcess> _leftChannelsProcess;
 	std::unique_ptr<DialogsProcess> _dialogsProcess;
 	std::unique_ptr<ChatProcess> _chatProcess;
 	QVector<MTPMessageRange> _splits;
 
+	// Last exported message ids by Data::PeerId.
+	base::flat_map<uint64, int32> _previousLastIds;
+	base::flat_map<uint64, int32> _lastIds;
+
 	rpl::event_stream<RPCError> _errors;
 	rpl::event_stream<Output::Result> _ioErrors;
 
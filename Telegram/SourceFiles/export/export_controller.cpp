@@ -109,6 +109,10 @@ private:
 	int _messagesWritten = 0;
 	int _messagesCount = 0;
 
+	// Time spent in the writer on messages, to log its throughput.
+	crl::time _messagesWriteTime = 0;
+	int64 _messagesWrittenTotal = 0;
+
 	int _userpicsWritten = 0;
 	int _userpicsCount = 0;
 
@@ -457,9 +461,12 @@ void ControllerObject::exportNextDialog() {
 			setState(stateDialogs(progress));
 			return true;
 		}, [=](Data::MessagesSlice &&result) {
+			const auto started = crl::now();
 			if (ioCatchError(_writer->writeDialogSlice(result))) {
 				return false;
 			}
+			_messagesWriteTime += crl::now() - started;
+			_messagesWrittenTotal += result.list.size();
 			_messagesWritten += result.list.size();
 			setState(stateDialogs(DownloadProgress()));
 			return true;
@@ -583,6 +590,14 @@ int ControllerObject::substepsInStep(Step step) const {
 }
 
 void ControllerObject::setFinishedState() {
+	if (_messagesWrittenTotal > 0) {
+		LOG(("Export Info: Wrote %1 messages in %2 ms, "
+			"%3 files of %4 bytes loaded."
+			).arg(_messagesWrittenTotal
+			).arg(_messagesWriteTime
+			).arg(_stats.filesCount()
+			).arg(_stats.bytesCount()));
+	}
 	setState(FinishedState{
 		_writer->mainFilePath(),
 		_stats.filesCount(),
@@ -18,18 +18,39 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Export {
 namespace Output {
 
+namespace {
+
+constexpr auto kBufferSize = 64 * 1024;
+
+} // namespace
+
 File::File(const QString &path, Stats *stats) : _path(path), _stats(stats) {
 }
 
+File::~File() {
+	if (!_buffer.isEmpty() && !flush()) {
+		LOG(("Export Error: Could not flush '%1'.").arg(_path));
+	}
+}
+
 int File::size() const {
-	return _offset;
+	return _offset + _buffer.size();
 }
 
 bool File::empty() const {
-	return !_offset;
+	return !size();
 }
 
 Result File::writeBlock(const QByteArray &block) {
+	// Empty blocks are written right away, they create the file.
+	if (!block.isEmpty() && _buffer.size() + block.size() <= kBufferSize) {
+		if (_buffer.isEmpty()) {
+			_buffer.reserve(kBufferSize);
+		}
+		_buffer.append(block);
+		countBytes(block.size());
+		return Result::Success();
+	}
 	const auto result = writeBlockAttempt(block);
 	if (!result) {
 		_file.reset();
@@ -37,6 +58,29 @@ Result File::writeBlock(const QByteArray &block) {
 	return result;
 }
 
+Result File::flush() {
+	return _buffer.isEmpty() ? Result::Success() : writeBlock(QByteArray());
+}
+
+void File::countBytes(int count) {
+	if (!_stats) {
+		return;
+	} else if (!_inStats) {
+		_inStats = true;
+		_stats->incrementFiles();
+	}
+	_stats->incrementBytes(count);
+}
+
+bool File::writeData(const QByteArray &data) {
+	const auto size = data.size();
+	if (_file->write(data) == size && _file->flush()) {
+		_offset += size;
+		return true;
+	}
+	return false;
+}
+
 Result File::writeBlockAttempt(const QByteArray &block) {
 	if (_stats && !_inStats) {
 		_inStats = true;
@@ -45,18 +89,22 @@ Result File::writeBlockAttempt(const QByteArray &block) {
 	if (const auto result = reopen(); !result) {
 		return result;
 	}
-	const auto size = block.size();
-	if (!size) {
-		return Result::Success();
-	}
-	if (_file->write(block) == size && _file->flush()) {
-		_offset += size;
-		if (_stats) {
-			_stats->incrementBytes(size);
+
+	// The gathered bytes are already counted in stats. If the write
+	// fails they are kept, reopen() drops the partially written part.
+	if (!_buffer.isEmpty()) {
+		if (!writeData(_buffer)) {
+			return error();
 		}
+		_buffer.resize(0);
+	}
+	if (block.isEmpty()) {
 		return Result::Success();
+	} else if (!writeData(block)) {
+		return error();
 	}
-	return error();
+	countBytes(block.size());
+	return Result::Success();
 }
 
 Result File::reopen() {
@@ -95,8 +143,13 @@ Result File::fatalError() const {
 
 QString File::PrepareRelativePath(
 		const QString &folder,
-		const QString &suggested) {
-	if (!QFile::exists(folder + suggested)) {
+		const QString &suggested,
+		const base::flat_set<QString> &reserved) {
+	const auto taken = [&](const QString &relativePath) {
+		return reserved.contains(relativePath)
+			|| QFile::exists(folder + relativePath);
+	};
+	if (!taken(suggested)) {
 		return suggested;
 	}
 
@@ -114,7 +167,7 @@ QString File::PrepareRelativePath(
 	auto attempt = 0;
 	while (true) {
 		const auto relativePath = relativePart(++attempt);
-		if (!QFile::exists(folder + relativePath)) {
+		if (!taken(relativePath)) {
 			return relativePath;
 		}
 	}
@@ -132,7 +185,11 @@ Result File::Copy(
 	if (bytes.size() != f.size()) {
 		return Result(Result::Type::FatalError, source);
 	}
-	return File(path, stats).writeBlock(bytes);
+	auto file = File(path, stats);
+	if (const auto result = file.writeBlock(bytes); !result) {
+		return result;
+	}
+	return file.flush();
 }
 
 } // namespace Output
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "base/optional.h"
+#include "base/flat_set.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QString>
@@ -19,18 +20,27 @@ namespace Output {
 struct Result;
 class Stats;
 
+// Small blocks are gathered in memory and written together, call flush()
+// after the last block to get the write result, the destructor flushes
+// without reporting errors.
 class File {
 public:
 	File(const QString &path, Stats *stats);
+	File(const File &other) = delete;
+	File &operator=(const File &other) = delete;
+	~File();
 
 	[[nodiscard]] int size() const;
 	[[nodiscard]] bool empty() const;
 
 	[[nodiscard]] Result writeBlock(const QByteArray &block);
+	[[nodiscard]] Result flush();
 
+	// Paths in 'reserved' are treated as taken even if there is no file.
 	[[nodiscard]] static QString PrepareRelativePath(
 		const QString &folder,
-		const QString &suggested);
+		const QString &suggested,
+		const base::flat_set<QString> &reserved = {});
 
 	[[nodiscard]] static Result Copy(
 		const QString &source,
@@ -40,6 +50,8 @@ public:
 private:
 	[[nodiscard]] Result reopen();
 	[[nodiscard]] Result writeBlockAttempt(const QByteArray &block);
+	[[nodiscard]] bool writeData(const QByteArray &data);
+	void countBytes(int count);
 
 	[[nodiscard]] Result error() const;
 	[[nodiscard]] Result fatalError() const;
@@ -47,6 +59,7 @@ private:
 	QString _path;
 	int _offset = 0;
 	std::optional<QFile> _file;
+	QByteArray _buffer;
 
 	Stats *_stats = nullptr;
 	bool _inStats = false;
@@ -639,6 +639,12 @@ private:
 
 };
 
+struct HtmlWriter::ChatPage {
+	TimeId from = 0;
+	TimeId till = 0;
+	int count = 0;
+};
+
 struct HtmlWriter::SavedSection {
 	int priority = 0;
 	QByteArray label;
@@ -1780,7 +1786,10 @@ Result HtmlWriter::Wrap::close() {
 		while (!_context.empty()) {
 			block.append(_context.popTag());
 		}
-		return _file.writeBlock(block);
+		if (const auto result = _file.writeBlock(block); !result) {
+			return result;
+		}
+		return _file.flush();
 	}
 	return Result::Success();
 }
@@ -2355,6 +2364,7 @@ Result HtmlWriter::writeDialogStart(const Data::DialogInfo &data) {
 	_dateMessageId = 0;
 	_lastMessageInfo = nullptr;
 	_lastMessageIdsPerFile.clear();
+	_chatPages.clear();
 	_dialog = data;
 	return Result::Success();
 }
@@ -2401,6 +2411,14 @@ Result HtmlWriter::writeDialogSlice(const Data::MessagesSlice &data) {
 			_chatFileEmpty = false;
 		}
 		const auto date = message.date;
+		if (_chatPages.size() <= oldIndex) {
+			_chatPages.resize(oldIndex + 1);
+		}
+		auto &page = _chatPages[oldIndex];
+		if (!page.count++) {
+			page.from = date;
+		}
+		page.till = date;
 		if (DisplayDate(date, previous ? previous->date : 0)) {
 			block.append(_chat->pushServiceMessage(
 				--_dateMessageId,
@@ -2455,6 +2473,8 @@ Result HtmlWriter::writeDialogEnd() {
 
 	if (const auto closed = base::take(_chat)->close(); !closed) {
 		return closed;
+	} else if (const auto pages = writeChatPages(); !pages) {
+		return pages;
 	} else if (_settings.onlySinglePeer()) {
 		return Result::Success();
 	}
@@ -2580,10 +2600,65 @@ Result HtmlWriter::writeDialogOpening(int index) {
 			}));
 		block.append("Previous messages");
 		block.append(_chat->popTag());
+		block.append(pushPagesLink(_chat.get()));
 	}
 	return _chat->writeBlock(block);
 }
 
+QByteArray HtmlWriter::pushPagesLink(not_null<Wrap*> file) const {
+	auto result = file->pushTag("a", {
+		{ "class", "pagination block_link" },
+		{ "href", pagesFile().toUtf8() }
+	});
+	result.append("All pages");
+	result.append(file->popTag());
+	return result;
+}
+
+Result HtmlWriter::writeChatPages() {
+	if (_chatPages.size() < 2) {
+		return Result::Success();
+	}
+
+	// A small page listing all the messages files, so that a huge chat
+	// can be opened at any point without loading all the pages.
+	const auto file = fileWithRelativePath(
+		_dialog.relativePath + pagesFile());
+	const auto name = (_dialog.name.isEmpty()
+		&& _dialog.lastName.isEmpty())
+		? QByteArray("Deleted Account")
+		: (_dialog.name + ' ' + _dialog.lastName);
+	auto block = file->pushHeader(
+		name,
+		_dialog.relativePath + messagesFile(0));
+	block.append(file->pushDiv("page_body chat_page"));
+	block.append(file->pushDiv("history"));
+	auto first = 1;
+	for (auto i = 0, count = int(_chatPages.size()); i != count; ++i) {
+		const auto &page = _chatPages[i];
+		const auto last = first + page.count - 1;
+		const auto from = FormatDateText(page.from);
+		const auto till = FormatDateText(page.till);
+		block.append(file->pushTag("a", {
+			{ "class", "pagination block_link" },
+			{ "href", messagesFile(i).toUtf8() }
+		}));
+		block.append("Messages "
+			+ Data::NumberToString(first)
+			+ " \xE2\x80\x93 "
+			+ Data::NumberToString(last)
+			+ ", "
+			+ from
+			+ (from != till ? (" \xE2\x80\x93 " + till) : QByteArray()));
+		block.append(file->popTag());
+		first = last + 1;
+	}
+	if (const auto result = file->writeBlock(block); !result) {
+		return result;
+	}
+	return file->close();
+}
+
 void HtmlWriter::pushSection(
 		int priority,
 		const QByteArray &label,
@@ -2661,6 +2736,7 @@ Result HtmlWriter::switchToNextChatFile(int index) {
 	});
 	next.append("Next messages");
 	next.append(_chat->popTag());
+	next.append(pushPagesLink(_chat.get()));
 	if (const auto result = _chat->writeBlock(next); !result) {
 		return result;
 	} else if (const auto end = _chat->close(); !end) {
@@ -2725,6 +2801,10 @@ QString HtmlWriter::messagesFile(int index) const {
 		+ ".html";
 }
 
+QString HtmlWriter::pagesFile() const {
+	return "pages.html";
+}
+
 std::unique_ptr<HtmlWriter::Wrap> HtmlWriter::fileWithRelativePath(
 		const QString &path) const {
 	return std::make_unique<Wrap>(
@@ -98,6 +98,7 @@ private:
 	[[nodiscard]] std::unique_ptr<Wrap> fileWithRelativePath(
 		const QString &path) const;
 	[[nodiscard]] QString messagesFile(int index) const;
+	[[nodiscard]] QString pagesFile() const;
 
 	[[nodiscard]] Result writeSavedContacts(const Data::ContactsList &data);
 	[[nodiscard]] Result writeFrequentContacts(const Data::ContactsList &data);
@@ -108,6 +109,8 @@ private:
 	[[nodiscard]] Result validateDialogsMode(bool isLeftChannel);
 	[[nodiscard]] Result writeDialogOpening(int index);
 	[[nodiscard]] Result switchToNextChatFile(int index);
+	[[nodiscard]] Result writeChatPages();
+	[[nodiscard]] QByteArray pushPagesLink(not_null<Wrap*> file) const;
 	[[nodiscard]] Result writeEmptySinglePeer();
 
 	void pushSection(
@@ -161,6 +164,9 @@ private:
 	std::vector<int> _lastMessageIdsPerFile;
 	bool _chatFileEmpty = false;
 
+	struct ChatPage;
+	std::vector<ChatPage> _chatPages;
+
 };
 
 } // namespace Output
@@ -23,16 +23,40 @@ namespace {
 
 using Context = details::JsonContext;
 
+constexpr auto kSliceBlockReserve = 256 * 1024;
+
+// Bytes that need some work in SerializeString, all the others are copied.
+constexpr auto kEscapeTable = [] {
+	auto result = std::array<bool, 256>();
+	for (auto i = 0; i != 32; ++i) {
+		result[i] = true;
+	}
+	result[uchar('"')] = true;
+	result[uchar('\\')] = true;
+	result[0xE2] = true;
+	return result;
+}();
+
 QByteArray SerializeString(const QByteArray &value) {
 	const auto size = value.size();
 	const auto begin = value.data();
 	const auto end = begin + size;
 
 	auto result = QByteArray();
-	result.reserve(2 + size * 4);
+	result.reserve(2 + size + size / 8);
 	result.append('"');
+
+	// Append the runs of bytes that don't need escaping at once.
+	auto from = begin;
 	for (auto p = begin; p != end; ++p) {
 		const auto ch = *p;
+		if (!kEscapeTable[uchar(ch)]) {
+			continue;
+		}
+		if (p != from) {
+			result.append(from, p - from);
+		}
+		from = p + 1;
 		if (ch == '\n') {
 			result.append("\\n", 2);
 		} else if (ch == '\r') {
@@ -65,6 +89,9 @@ QByteArray SerializeString(const QByteArray &value) {
 			result.append(ch);
 		}
 	}
+	if (end != from) {
+		result.append(from, end - from);
+	}
 	result.append('"');
 	return result;
 }
@@ -1059,12 +1086,17 @@ Result JsonWriter::validateDialogsMode(bool isLeftChannel) {
 Result JsonWriter::writeDialogSlice(const Data::MessagesSlice &data) {
 	Expects(_output != nullptr);
 
-	auto block = QByteArray();
+	// The buffer is reused for all the slices, resize(0) keeps the
+	// reserved capacity.
+	auto &block = _sliceBlock;
+	block.resize(0);
+	block.reserve(kSliceBlockReserve);
 	for (const auto &message : data.list) {
 		if (Data::SkipMessageByDate(message, _settings)) {
 			continue;
 		}
-		block.append(prepareArrayItemStart() + SerializeMessage(
+		block.append(prepareArrayItemStart());
+		block.append(SerializeMessage(
 			_context,
 			message,
 			data.peers,
@@ -1077,7 +1109,11 @@ Result JsonWriter::writeDialogEnd() {
 	Expects(_output != nullptr);
 
 	auto block = popNesting();
-	return _output->writeBlock(block + popNesting());
+	block.append(popNesting());
+	if (const auto result = _output->writeBlock(block); !result) {
+		return result;
+	}
+	return _output->flush();
 }
 
 Result JsonWriter::writeDialogsEnd() {
@@ -1116,7 +1152,10 @@ Result JsonWriter::finish() {
 	}
 	auto block = popNesting();
 	Assert(_context.nesting.empty());
-	return _output->writeBlock(block);
+	if (const auto result = _output->writeBlock(block); !result) {
+		return result;
+	}
+	return _output->flush();
 }
 
 QString JsonWriter::mainFilePath() {
@@ -99,6 +99,7 @@ private:
 	DialogsMode _dialogsMode = DialogsMode::None;
 
 	std::unique_ptr<File> _output;
+	QByteArray _sliceBlock;
 
 };
 
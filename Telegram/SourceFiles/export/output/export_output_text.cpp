@@ -557,8 +557,10 @@ Result TextWriter::writeUserpicsSlice(const Data::UserpicsSlice &data) {
 }
 
 Result TextWriter::writeUserpicsEnd() {
-	_userpics = nullptr;
-	return Result::Success();
+	if (!_userpics) {
+		return Result::Success();
+	}
+	return base::take(_userpics)->flush();
 }
 
 Result TextWriter::writeContactsList(const Data::ContactsList &data) {
@@ -605,6 +607,8 @@ Result TextWriter::writeSavedContacts(const Data::ContactsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto result = file->flush(); !result) {
+		return result;
 	}
 
 	const auto header = "Contacts "
@@ -684,6 +688,8 @@ Result TextWriter::writeFrequentContacts(const Data::ContactsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto result = file->flush(); !result) {
+		return result;
 	}
 
 	const auto header = "Frequent contacts "
@@ -740,6 +746,8 @@ Result TextWriter::writeSessions(const Data::SessionsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto result = file->flush(); !result) {
+		return result;
 	}
 
 	const auto header = "Sessions "
@@ -788,6 +796,8 @@ Result TextWriter::writeWebSessions(const Data::SessionsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto result = file->flush(); !result) {
+		return result;
 	}
 
 	const auto header = "Web sessions "
@@ -876,7 +886,9 @@ Result TextWriter::writeDialogEnd() {
 	Expects(_chats != nullptr);
 	Expects(_chat != nullptr);
 
-	_chat = nullptr;
+	if (const auto result = base::take(_chat)->flush(); !result) {
+		return result;
+	}
 
 	using Type = Data::DialogInfo::Type;
 	const auto TypeString = [](Type type) {
@@ -965,12 +977,16 @@ Result TextWriter::writeChatsStart(
 }
 
 Result TextWriter::writeChatsEnd() {
-	_chats = nullptr;
-	return Result::Success();
+	if (!_chats) {
+		return Result::Success();
+	}
+	return base::take(_chats)->flush();
 }
 
 Result TextWriter::finish() {
-	return Result::Success();
+	Expects(_summary != nullptr);
+
+	return _summary->flush();
 }
 
 QString TextWriter::mainFilePath() {
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 extern "C" {
 #include <libavutil/opt.h>
+#include <libavutil/hwcontext.h>
 } // extern "C"
 
 namespace FFmpeg {
@@ -82,6 +83,71 @@ void PremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 #endif // Qt >= 5.12
 }
 
+[[nodiscard]] bool InitHardwareContext(
+		not_null<AVCodecContext*> context,
+		AVHWDeviceType type) {
+	// With frame threading get_format is called for the thread contexts,
+	// so the device is created in the main one that is kept in 'opaque'.
+	const auto parent = static_cast<AVCodecContext*>(context->opaque);
+	auto device = (AVBufferRef*)nullptr;
+	const auto error = AvErrorWrap(av_hwdevice_ctx_create(
+		&device,
+		type,
+		nullptr,
+		nullptr,
+		0));
+	if (error || !device) {
+		LogError(qstr("av_hwdevice_ctx_create"), error);
+		return false;
+	}
+	DEBUG_LOG(("Video Info: Using \"%1\" hardware acceleration."
+		).arg(av_hwdevice_get_type_name(type)));
+	if (parent->hw_device_ctx) {
+		av_buffer_unref(&parent->hw_device_ctx);
+	}
+	parent->hw_device_ctx = av_buffer_ref(device);
+	av_buffer_unref(&device);
+
+	if (context != parent) {
+		if (context->hw_device_ctx) {
+			av_buffer_unref(&context->hw_device_ctx);
+		}
+		context->hw_device_ctx = av_buffer_ref(parent->hw_device_ctx);
+	}
+	return true;
+}
+
+enum AVPixelFormat GetHardwareFormat(
+		AVCodecContext *context,
+		const enum AVPixelFormat *formats) {
+	const auto has = [&](enum AVPixelFormat format) {
+		for (auto i = formats; *i != AV_PIX_FMT_NONE; ++i) {
+			if (*i == format) {
+				return true;
+			}
+		}
+		return false;
+	};
+	const auto list = std::array{
+#ifdef Q_OS_WIN
+		std::pair{ AV_PIX_FMT_D3D11, AV_HWDEVICE_TYPE_D3D11VA },
+		std::pair{ AV_PIX_FMT_DXVA2_VLD, AV_HWDEVICE_TYPE_DXVA2 },
+#elif defined Q_OS_MAC // Q_OS_WIN
+		std::pair{ AV_PIX_FMT_VIDEOTOOLBOX, AV_HWDEVICE_TYPE_VIDEOTOOLBOX },
+#else // Q_OS_WIN || Q_OS_MAC
+		std::pair{ AV_PIX_FMT_VAAPI, AV_HWDEVICE_TYPE_VAAPI },
+		std::pair{ AV_PIX_FMT_VDPAU, AV_HWDEVICE_TYPE_VDPAU },
+#endif // Q_OS_WIN || Q_OS_MAC
+	};
+	for (const auto &[format, type] : list) {
+		if (has(format) && InitHardwareContext(context, type)) {
+			return format;
+		}
+	}
+
+	return avcodec_default_get_format(context, formats);
+}
+
 } // namespace
 
 IOPointer MakeIOPointer(
@@ -160,7 +226,7 @@ void FormatDeleter::operator()(AVFormatContext *value) {
 	}
 }
 
-CodecPointer MakeCodecPointer(not_null<AVStream*> stream) {
+CodecPointer MakeCodecPointer(not_null<AVStream*> stream, bool hwAllowed) {
 	auto error = AvErrorWrap();
 
 	auto result = CodecPointer(avcodec_alloc_context3(nullptr));
@@ -176,6 +242,10 @@ CodecPointer MakeCodecPointer(not_null<AVStream*> stream) {
 	}
 	av_codec_set_pkt_timebase(context, stream->time_base);
 	av_opt_set_int(context, "refcounted_frames", 1, 0);
+	if (hwAllowed) {
+		context->get_format = GetHardwareFormat;
+		context->opaque = context;
+	}
 
 	const auto codec = avcodec_find_decoder(context->codec_id);
 	if (!codec) {
@@ -199,7 +269,11 @@ FramePointer MakeFramePointer() {
 }
 
 bool FrameHasData(AVFrame *frame) {
-	return (frame && frame->data[0] != nullptr);
+	// Hardware frames keep their surface in data[3], not in data[0].
+	return frame
+		&& (frame->data[0] != nullptr
+			|| frame->buf[0] != nullptr
+			|| frame->hw_frames_ctx != nullptr);
 }
 
 void ClearFrameMemory(AVFrame *frame) {
@@ -208,6 +282,29 @@ void ClearFrameMemory(AVFrame *frame) {
 	}
 }
 
+AVFrame *ReadableFrame(not_null<AVFrame*> frame, FramePointer &storage) {
+	if (!frame->hw_frames_ctx) {
+		return frame;
+	} else if (!storage) {
+		storage = MakeFramePointer();
+		if (!storage) {
+			return nullptr;
+		}
+	}
+	ClearFrameMemory(storage.get());
+	const auto error = AvErrorWrap(av_hwframe_transfer_data(
+		storage.get(),
+		frame,
+		0));
+	if (error) {
+		LogError(qstr("av_hwframe_transfer_data"), error);
+		return nullptr;
+	}
+	storage->width = frame->width;
+	storage->height = frame->height;
+	return storage.get();
+}
+
 void FrameDeleter::operator()(AVFrame *value) {
 	av_frame_free(&value);
 }
@@ -237,6 +334,13 @@ SwscalePointer MakeSwscalePointer(
 		return SwscalePointer();
 	}
 
+	// The flags depend only on the sizes, so they take part in caching.
+	// Downscaling a large frame is several times cheaper with the bilinear
+	// filter than with the default bicubic one and looks almost the same,
+	// without the scaling swscale uses the unscaled converters anyway.
+	const auto downscale = (dstSize.width() <= srcSize.width())
+		&& (dstSize.height() <= srcSize.height());
+	const auto flags = downscale ? SWS_BILINEAR : SWS_BICUBIC;
 	const auto result = sws_getCachedContext(
 		existing ? existing->release() : nullptr,
 		srcSize.width(),
@@ -245,7 +349,7 @@ SwscalePointer MakeSwscalePointer(
 		dstSize.width(),
 		dstSize.height(),
 		AVPixelFormat(dstFormat),
-		0,
+		flags,
 		nullptr,
 		nullptr,
 		nullptr);
@@ -136,7 +136,10 @@ struct CodecDeleter {
 	void operator()(AVCodecContext *value);
 };
 using CodecPointer = std::unique_ptr<AVCodecContext, CodecDeleter>;
-[[nodiscard]] CodecPointer MakeCodecPointer(not_null<AVStream*> stream);
+// Hardware decoding is tried only if allowed, software one is the fallback.
+[[nodiscard]] CodecPointer MakeCodecPointer(
+	not_null<AVStream*> stream,
+	bool hwAllowed = false);
 
 struct FrameDeleter {
 	void operator()(AVFrame *value);
@@ -146,6 +149,12 @@ using FramePointer = std::unique_ptr<AVFrame, FrameDeleter>;
 [[nodiscard]] bool FrameHasData(AVFrame *frame);
 void ClearFrameMemory(AVFrame *frame);
 
+// Hardware decoded frames are kept in the video memory, they should be
+// transferred to 'storage' before being read. Returns the readable one.
+[[nodiscard]] AVFrame *ReadableFrame(
+	not_null<AVFrame*> frame,
+	FramePointer &storage);
+
 struct SwscaleDeleter {
 	QSize srcSize;
 	int srcFormat = int(AV_PIX_FMT_NONE);
@@ -63,6 +63,67 @@ constexpr auto kEventsFirstPage = 20;
 constexpr auto kEventsPerPage = 50;
 constexpr auto kClearUserpicsAfter = 50;
 
+using EventsFilterFlags = MTPDchannelAdminLogEventsFilter::Flags;
+
+// The filter box always sets these flags in the same groups.
+[[nodiscard]] EventsFilterFlags ActionFilterFlags(
+		const MTPChannelAdminLogEventAction &action) {
+	using Flag = MTPDchannelAdminLogEventsFilter::Flag;
+	switch (action.type()) {
+	case mtpc_channelAdminLogEventActionChangeTitle:
+	case mtpc_channelAdminLogEventActionChangeAbout:
+	case mtpc_channelAdminLogEventActionChangeUsername:
+	case mtpc_channelAdminLogEventActionChangePhoto:
+	case mtpc_channelAdminLogEventActionToggleInvites:
+	case mtpc_channelAdminLogEventActionToggleSignatures:
+	case mtpc_channelAdminLogEventActionChangeStickerSet:
+	case mtpc_channelAdminLogEventActionTogglePreHistoryHidden:
+	case mtpc_channelAdminLogEventActionDefaultBannedRights:
+	case mtpc_channelAdminLogEventActionChangeLinkedChat:
+	case mtpc_channelAdminLogEventActionChangeLocation:
+	case mtpc_channelAdminLogEventActionToggleSlowMode:
+		return Flag::f_info | Flag::f_settings;
+	case mtpc_channelAdminLogEventActionParticipantJoin:
+	case mtpc_channelAdminLogEventActionParticipantInvite:
+		return Flag::f_join | Flag::f_invite;
+	case mtpc_channelAdminLogEventActionParticipantLeave:
+		return Flag::f_leave;
+	case mtpc_channelAdminLogEventActionParticipantToggleBan:
+		return Flag::f_ban | Flag::f_unban | Flag::f_kick | Flag::f_unkick;
+	case mtpc_channelAdminLogEventActionParticipantToggleAdmin:
+		return Flag::f_promote | Flag::f_demote;
+	case mtpc_channelAdminLogEventActionUpdatePinned:
+		return Flag::f_pinned;
+	case mtpc_channelAdminLogEventActionEditMessage:
+		return Flag::f_edit;
+	case mtpc_channelAdminLogEventActionDeleteMessage:
+		return Flag::f_delete;
+	}
+	return EventsFilterFlags(0);
+}
+
+// Returns std::nullopt if only the server can tell whether it matches.
+[[nodiscard]] std::optional<bool> EventMatchesFilter(
+		const MTPDchannelAdminLogEvent &data,
+		const FilterValue &filter) {
+	if (filter.flags) {
+		const auto flags = ActionFilterFlags(data.vaction());
+		const auto common = (flags & filter.flags);
+		if (!flags || (common && common != flags)) {
+			return std::nullopt;
+		} else if (!common) {
+			return false;
+		}
+	}
+	if (!filter.allUsers) {
+		const auto userId = peerFromUser(data.vuser_id());
+		return ranges::any_of(filter.admins, [&](not_null<UserData*> user) {
+			return (user->id == userId);
+		});
+	}
+	return true;
+}
+
 } // namespace
 
 template <InnerWidget::EnumItemsDirection direction, typename Method>
@@ -403,7 +464,9 @@ void InnerWidget::checkPreloadMore() {
 void InnerWidget::applyFilter(FilterValue &&value) {
 	if (_filter != value) {
 		_filter = value;
-		clearAndRequestLog();
+		if (!applyFilterLocally()) {
+			clearAndRequestLog();
+		}
 	}
 }
 
@@ -482,6 +545,42 @@ void InnerWidget::clearAndRequestLog() {
 	preloadMore(Direction::Up);
 }
 
+bool InnerWidget::applyFilterLocally() {
+	if (!_searchQuery.isEmpty() || _cachedEvents.empty()) {
+		return false;
+	}
+	auto events = QVector<MTPChannelAdminLogEvent>();
+	for (const auto &event : _cachedEvents) {
+		const auto matches = EventMatchesFilter(
+			event.c_channelAdminLogEvent(),
+			_filter);
+		if (!matches) {
+			return false;
+		} else if (*matches) {
+			events.push_back(event);
+		}
+	}
+	if (events.empty() && !_cachedEventsComplete) {
+		return false;
+	}
+
+	// Older events are requested with the filter when scrolled to.
+	_api.request(base::take(_preloadUpRequestId)).cancel();
+	_api.request(base::take(_preloadDownRequestId)).cancel();
+	_filterChanged = true;
+	_upLoaded = _cachedEventsComplete;
+	_downLoaded = true;
+	updateMinMaxIds();
+	addEvents(Direction::Up, events);
+	return true;
+}
+
+uint64 InnerWidget::cachedEventsMinId() const {
+	return _cachedEvents.empty()
+		? 0
+		: _cachedEvents.back().c_channelAdminLogEvent().vid().v;
+}
+
 void InnerWidget::updateEmptyText() {
 	auto options = _defaultOptions;
 	options.flags |= TextParseMarkdown;
@@ -650,6 +749,12 @@ void InnerWidget::preloadMore(Direction direction) {
 	auto maxId = (direction == Direction::Up) ? _minId : 0;
 	auto minId = (direction == Direction::Up) ? 0 : _maxId;
 	auto perPage = _items.empty() ? kEventsFirstPage : kEventsPerPage;
+	const auto cacheEvents = (direction == Direction::Up)
+		&& !_filter.flags
+		&& _filter.allUsers
+		&& _searchQuery.isEmpty()
+		&& !_cachedEventsComplete
+		&& (maxId == cachedEventsMinId());
 	requestId = _api.request(MTPchannels_GetAdminLog(
 		MTP_flags(flags),
 		_channel->inputChannel,
@@ -668,7 +773,16 @@ void InnerWidget::preloadMore(Direction direction) {
 		_channel->owner().processUsers(results.vusers());
 		_channel->owner().processChats(results.vchats());
 		if (!loadedFlag) {
-			addEvents(direction, results.vevents().v);
+			const auto &events = results.vevents().v;
+			if (cacheEvents) {
+				_cachedEvents.insert(
+					end(_cachedEvents),
+					events.begin(),
+					events.end());
+				_cachedEventsComplete = events.empty()
+					|| (cachedEventsMinId() == 1);
+			}
+			addEvents(direction, events);
 		}
 	}).fail([this, &requestId, &loadedFlag](const RPCError &error) {
 		requestId = 0;
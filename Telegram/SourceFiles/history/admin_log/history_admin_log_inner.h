@@ -192,6 +192,8 @@ private:
 	void paintEmpty(Painter &p);
 	void clearAfterFilterChange();
 	void clearAndRequestLog();
+	bool applyFilterLocally();
+	[[nodiscard]] uint64 cachedEventsMinId() const;
 	void addEvents(Direction direction, const QVector<MTPChannelAdminLogEvent> &events);
 	Element *viewForItem(const HistoryItem *item);
 
@@ -267,6 +269,11 @@ private:
 	bool _filterChanged = false;
 	Ui::Text::String _emptyText;
 
+	// Events loaded without filter and search, newest first,
+	// so that filter changes are applied without requesting them again.
+	std::vector<MTPChannelAdminLogEvent> _cachedEvents;
+	bool _cachedEventsComplete = false;
+
 	MouseAction _mouseAction = MouseAction::None;
 	TextSelectType _mouseSelectType = TextSelectType::Letters;
 	QPoint _dragStartPosition;
@@ -27,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_chat.h"
 #include "data/data_user.h"
 #include "data/data_histories.h"
+#include "data/data_messages_search_index.h"
 #include "lang/lang_keys.h"
 #include "apiwrap.h"
 #include "mainwidget.h"
@@ -63,6 +64,7 @@ constexpr auto kStatusShowClientsideChooseContact = 6000;
 constexpr auto kStatusShowClientsidePlayGame = 10000;
 constexpr auto kSetMyActionForMs = 10000;
 constexpr auto kNewBlockEachMessage = 50;
+constexpr auto kLayoutMarginViewports = 2;
 constexpr auto kSkipCloudDraftsFor = TimeId(3);
 
 using UpdateFlag = Data::HistoryUpdate::Flag;
@@ -134,6 +136,61 @@ void History::setHasPendingResizedItems() {
 	_flags |= Flag::f_has_pending_resized_items;
 }
 
+bool History::hasEstimatedHeights() const {
+	return _flags & Flag::f_has_estimated_heights;
+}
+
+bool History::layoutEstimatedHeights(int from, int till, int limit) {
+	if (!hasEstimatedHeights() || !_width) {
+		return false;
+	}
+	auto changed = false;
+	const auto layout = [&](not_null<HistoryBlock*> block) {
+		const auto was = block->height();
+		if (block->resizeGetHeight(_width, true) != was) {
+			changed = true;
+		}
+	};
+	auto rest = std::vector<std::pair<int, not_null<HistoryBlock*>>>();
+	for (const auto &block : blocks) {
+		if (!block->estimatedHeight()) {
+			continue;
+		}
+		const auto top = block->y();
+		const auto bottom = top + block->height();
+		if (top < till && bottom > from) {
+			layout(block.get());
+		} else {
+			const auto distance = (bottom <= from)
+				? (from - bottom)
+				: (top - till);
+			rest.emplace_back(distance, block.get());
+		}
+	}
+	if (limit > 0 && !rest.empty()) {
+		const auto count = std::min(limit, int(rest.size()));
+		const auto by = [](const auto &a, const auto &b) {
+			return a.first < b.first;
+		};
+		std::partial_sort(
+			begin(rest),
+			begin(rest) + count,
+			end(rest),
+			by);
+		for (auto i = 0; i != count; ++i) {
+			layout(rest[i].second);
+		}
+		rest.erase(begin(rest), begin(rest) + count);
+	}
+	if (rest.empty()) {
+		_flags &= ~Flag::f_has_estimated_heights;
+	}
+	if (changed) {
+		recountBlocksPositions();
+	}
+	return changed;
+}
+
 void History::itemRemoved(not_null<HistoryItem*> item) {
 	if (item == _joinedMessage) {
 		_joinedMessage = nullptr;
@@ -698,6 +755,7 @@ not_null<HistoryItem*> History::addNewItem(
 		}
 	} else {
 		addNewToBack(item, unread);
+		owner().messagesSearchIndex().add(item);
 		checkForLoadedAtTop(item);
 		if (!unread) {
 			// When we add just one last item, like we do while loading dialogs,
@@ -1423,6 +1481,7 @@ void History::addOlderSlice(const QVector<MTPMessage> &slice) {
 			addItemsToLists(added);
 		}
 		addToSharedMedia(added);
+		owner().messagesSearchIndex().add(added);
 	} else {
 		// If no items were added it means we've loaded everything old.
 		_loadedAtTop = true;
@@ -1451,6 +1510,7 @@ void History::addNewerSlice(const QVector<MTPMessage> &slice) {
 		}
 
 		addToSharedMedia(added);
+		owner().messagesSearchIndex().add(added);
 	} else {
 		_loadedAtBottom = true;
 		setLastMessage(lastAvailableMessage());
@@ -2915,19 +2975,79 @@ HistoryItem *History::lastSentMessage() const {
 	return nullptr;
 }
 
-void History::resizeToWidth(int newWidth) {
+void History::resizeToWidth(int newWidth, int visibleHeight) {
 	const auto resizeAllItems = (_width != newWidth);
+	const auto layoutEstimated = (visibleHeight <= 0)
+		&& hasEstimatedHeights();
 
-	if (!resizeAllItems && !hasPendingResizedItems()) {
+	if (!resizeAllItems && !hasPendingResizedItems() && !layoutEstimated) {
 		return;
 	}
 	_flags &= ~(Flag::f_has_pending_resized_items);
 
 	_width = newWidth;
-	int y = 0;
+	const auto count = int(blocks.size());
+	if (visibleHeight <= 0 || !count) {
+		_flags &= ~(Flag::f_has_estimated_heights);
+		for (const auto &block : blocks) {
+			block->resizeGetHeight(
+				newWidth,
+				resizeAllItems || block->estimatedHeight());
+		}
+		recountBlocksPositions();
+		return;
+	}
+	const auto layout = [&](int index) {
+		const auto block = blocks[index].get();
+		return block->resizeGetHeight(
+			newWidth,
+			resizeAllItems || block->estimatedHeight());
+	};
+
+	// Lay out the blocks around the visible area, measuring from the
+	// top of the block containing scrollTopItem (or the last block).
+	const auto margin = visibleHeight * kLayoutMarginViewports;
+	const auto anchor = scrollTopItem
+		? scrollTopItem->block()->indexInHistory()
+		: (count - 1);
+	auto visibleTop = scrollTopItem
+		? (scrollTopItem->y() + scrollTopOffset)
+		: 0;
+	auto till = anchor;
+	auto bottom = 0;
+	do {
+		bottom += layout(till++);
+	} while (till < count && bottom < visibleTop + visibleHeight + margin);
+	if (!scrollTopItem) {
+		visibleTop = bottom - visibleHeight;
+	}
+	auto from = anchor;
+	auto top = 0;
+	while (from > 0 && top > visibleTop - margin) {
+		top -= layout(--from);
+	}
+
+	// Far from the visible area even the new messages are not laid out,
+	// a freshly loaded slice gets estimated heights the same way.
+	for (auto i = 0; i != count; ++i) {
+		const auto block = blocks[i].get();
+		if (i >= from && i < till) {
+			continue;
+		} else if (resizeAllItems
+			|| block->estimatedHeight()
+			|| block->hasPendingResize()) {
+			block->estimateGetHeight(newWidth);
+			_flags |= Flag::f_has_estimated_heights;
+		}
+	}
+	recountBlocksPositions();
+}
+
+void History::recountBlocksPositions() {
+	auto y = 0;
 	for (const auto &block : blocks) {
 		block->setY(y);
-		y += block->resizeGetHeight(newWidth, resizeAllItems);
+		y += block->height();
 	}
 	_height = y;
 }
@@ -3318,6 +3438,14 @@ HistoryBlock::HistoryBlock(not_null<History*> history)
 }
 
 int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
+	// Blocks without changed messages keep their layout,
+	// so a single edit doesn't walk all the loaded messages.
+	if (resizeAllItems) {
+		_estimatedHeight = false;
+	} else if (!_hasPendingResize) {
+		return _height;
+	}
+	_hasPendingResize = false;
 	auto y = 0;
 	for (const auto &message : messages) {
 		message->setY(y);
@@ -3331,6 +3459,18 @@ int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
 	return _height;
 }
 
+int HistoryBlock::estimateGetHeight(int newWidth) {
+	_estimatedHeight = true;
+	_hasPendingResize = false;
+	auto y = 0;
+	for (const auto &message : messages) {
+		message->setY(y);
+		y += message->estimateHeight(newWidth);
+	}
+	_height = y;
+	return _height;
+}
+
 void HistoryBlock::remove(not_null<Element*> view) {
 	Expects(view->block() == this);
 
@@ -3341,6 +3481,7 @@ void HistoryBlock::remove(not_null<Element*> view) {
 	const auto item = view->data();
 	item->clearMainView();
 	messages.erase(messages.begin() + itemIndex);
+	_hasPendingResize = true;
 	for (auto i = itemIndex, l = int(messages.size()); i < l; ++i) {
 		messages[i]->setIndexInBlock(i);
 	}
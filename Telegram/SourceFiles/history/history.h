@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_types.h"
 #include "data/data_peer.h"
 #include "dialogs/dialogs_entry.h"
+#include "history/history_allocator.h"
 #include "ui/effects/send_action_animations.h"
 #include "base/observer.h"
 #include "base/timer.h"
@@ -251,7 +252,10 @@ public:
 	MsgId msgIdForRead() const;
 	HistoryItem *lastSentMessage() const;
 
-	void resizeToWidth(int newWidth);
+	// When the width changes only the blocks around scrollTopItem
+	// (or the bottom) covering visibleHeight with some margin are laid
+	// out, others get estimated heights, see layoutEstimatedHeights().
+	void resizeToWidth(int newWidth, int visibleHeight = 0);
 	void forceFullResize();
 	int height() const;
 
@@ -266,6 +270,12 @@ public:
 	bool hasPendingResizedItems() const;
 	void setHasPendingResizedItems();
 
+	// Lays out all the blocks with estimated heights intersecting
+	// [from, till) and up to limit of other such blocks closest to it.
+	// Returns true if the history height or any blocks positions changed.
+	bool hasEstimatedHeights() const;
+	bool layoutEstimatedHeights(int from, int till, int limit);
+
 	bool mySendActionUpdated(SendAction::Type type, bool doing);
 	bool paintSendAction(
 		Painter &p,
@@ -415,6 +425,7 @@ private:
 
 	enum class Flag {
 		f_has_pending_resized_items = (1 << 0),
+		f_has_estimated_heights = (1 << 1),
 	};
 	using Flags = base::flags<Flag>;
 	friend inline constexpr auto is_flag_type(Flag) {
@@ -430,6 +441,8 @@ private:
 	// helper method for countScrollState(int top)
 	void countScrollTopItem(int top);
 
+	void recountBlocksPositions();
+
 	// this method just removes a block from the blocks list
 	// when the last item from this block was detached and
 	// calls the required previousItemChanged()
@@ -585,6 +598,8 @@ private:
 
 class HistoryBlock {
 public:
+	HISTORY_POOLED_ALLOCATION
+
 	using Element = HistoryView::Element;
 
 	HistoryBlock(not_null<History*> history);
@@ -598,6 +613,16 @@ public:
 	void refreshView(not_null<Element*> view);
 
 	int resizeGetHeight(int newWidth, bool resizeAllItems);
+	int estimateGetHeight(int newWidth);
+	bool estimatedHeight() const {
+		return _estimatedHeight;
+	}
+	bool hasPendingResize() const {
+		return _hasPendingResize;
+	}
+	void setHasPendingResize() {
+		_hasPendingResize = true;
+	}
 	int y() const {
 		return _y;
 	}
@@ -642,5 +667,7 @@ protected:
 	int _y = 0;
 	int _height = 0;
 	int _indexInHistory = -1;
+	bool _estimatedHeight = false;
+	bool _hasPendingResize = false;
 
 };
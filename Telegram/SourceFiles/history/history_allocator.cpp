@@ -0,0 +1,96 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "history/history_allocator.h"
+
+namespace HistoryAllocator {
+namespace {
+
+constexpr auto kGranularity = std::size_t(16);
+constexpr auto kMaxPooledSize = std::size_t(1024);
+constexpr auto kChunkSize = std::size_t(64 * 1024);
+
+struct FreeSlot {
+	FreeSlot *next = nullptr;
+};
+
+struct SizeClass {
+	FreeSlot *free = nullptr;
+	std::vector<std::unique_ptr<char[]>> chunks;
+	int alive = 0;
+};
+
+struct Pools {
+	std::array<SizeClass, kMaxPooledSize / kGranularity> classes;
+};
+
+[[nodiscard]] Pools &Instance() {
+	// Never destroyed, some objects may outlive static destructors.
+	static const auto result = new Pools();
+	return *result;
+}
+
+[[nodiscard]] std::size_t SlotSize(std::size_t index) {
+	return (index + 1) * kGranularity;
+}
+
+void FillFreeList(SizeClass &pool, std::size_t slot, char *chunk) {
+	const auto count = kChunkSize / slot;
+	for (auto i = count; i != 0;) {
+		const auto free = reinterpret_cast<FreeSlot*>(chunk + (--i) * slot);
+		free->next = pool.free;
+		pool.free = free;
+	}
+}
+
+void AddChunk(SizeClass &pool, std::size_t slot) {
+	pool.chunks.push_back(std::make_unique<char[]>(kChunkSize));
+	FillFreeList(pool, slot, pool.chunks.back().get());
+}
+
+} // namespace
+
+void *Allocate(std::size_t size) {
+	if (size > kMaxPooledSize) {
+		return ::operator new(size);
+	}
+	const auto index = (std::max(size, std::size_t(1)) - 1) / kGranularity;
+	auto &pool = Instance().classes[index];
+	if (!pool.free) {
+		AddChunk(pool, SlotSize(index));
+	}
+	const auto result = pool.free;
+	pool.free = result->next;
+	++pool.alive;
+	return result;
+}
+
+void Free(void *pointer, std::size_t size) noexcept {
+	if (!pointer) {
+		return;
+	} else if (size > kMaxPooledSize) {
+		::operator delete(pointer);
+		return;
+	}
+	const auto index = (std::max(size, std::size_t(1)) - 1) / kGranularity;
+	auto &pool = Instance().classes[index];
+	Assert(pool.alive > 0);
+
+	if (--pool.alive > 0) {
+		const auto free = static_cast<FreeSlot*>(pointer);
+		free->next = pool.free;
+		pool.free = free;
+		return;
+	}
+
+	// All histories using this size were unloaded, keep one chunk.
+	pool.chunks.resize(1);
+	pool.free = nullptr;
+	FillFreeList(pool, SlotSize(index), pool.chunks.front().get());
+}
+
+} // namespace HistoryAllocator
@@ -0,0 +1,31 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace HistoryAllocator {
+
+// Pools for the objects created for each loaded message: items, their
+// views and history blocks. Objects of the same size share chunks that
+// are reused instead of going to the general purpose heap each time.
+//
+// Main thread only, used through HISTORY_POOLED_ALLOCATION in classes.
+
+[[nodiscard]] void *Allocate(std::size_t size);
+void Free(void *pointer, std::size_t size) noexcept;
+
+} // namespace HistoryAllocator
+
+// Base classes must have a virtual destructor,
+// so that the sized operator delete gets the real object size.
+#define HISTORY_POOLED_ALLOCATION \
+	static void *operator new(std::size_t size) { \
+		return ::HistoryAllocator::Allocate(size); \
+	} \
+	static void operator delete(void *pointer, std::size_t size) noexcept { \
+		::HistoryAllocator::Free(pointer, size); \
+	}
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <rpl/merge.h>
 #include "core/file_utilities.h"
 #include "core/crash_reports.h"
+#include "core/paint_stats.h"
 #include "history/history.h"
 #include "history/history_message.h"
 #include "history/view/media/history_view_media.h"
@@ -571,6 +572,7 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 	if (Ui::skipPaintEvent(this, e)) {
 		return;
 	}
+	PAINT_STATS_FRAME("HistoryInner");
 	if (hasPendingResizedItems()) {
 		return;
 	}
@@ -1974,10 +1976,16 @@ TextForMimeData HistoryInner::getSelectedText() const {
 		return TextForMimeData();
 	}
 
+	// Selected items come ordered by pointer, so the parts are collected
+	// unordered and sorted once instead of inserting each into a flat_map.
 	const auto timeFormat = qsl(", [dd.MM.yy hh:mm]\n");
 	auto groups = base::flat_set<not_null<const Data::Group*>>();
 	auto fullSize = 0;
-	auto texts = base::flat_map<Data::MessagePosition, TextForMimeData>();
+	auto fullEntities = 0;
+	auto texts = std::vector<std::pair<
+		Data::MessagePosition,
+		TextForMimeData>>();
+	texts.reserve(selected.size());
 
 	const auto wrapItem = [&](
 			not_null<HistoryItem*> item,
@@ -1987,11 +1995,13 @@ TextForMimeData HistoryInner::getSelectedText() const {
 		auto size = item->author()->name.size()
 			+ time.size()
 			+ unwrapped.expanded.size();
-		part.reserve(size);
+		const auto entities = unwrapped.rich.entities.size();
+		part.reserve(size, entities);
 		part.append(item->author()->name).append(time);
 		part.append(std::move(unwrapped));
-		texts.emplace(item->position(), part);
+		texts.emplace_back(item->position(), std::move(part));
 		fullSize += size;
+		fullEntities += entities;
 	};
 	const auto addItem = [&](not_null<HistoryItem*> item) {
 		wrapItem(item, HistoryItemText(item));
@@ -2018,9 +2028,15 @@ TextForMimeData HistoryInner::getSelectedText() const {
 		}
 	}
 
+	ranges::sort(texts, ranges::less(), [](const auto &pair) {
+		return pair.first;
+	});
+
 	auto result = TextForMimeData();
 	const auto sep = qstr("\n\n");
-	result.reserve(fullSize + (texts.size() - 1) * sep.size());
+	result.reserve(
+		fullSize + (texts.size() - 1) * sep.size(),
+		fullEntities);
 	for (auto i = texts.begin(), e = texts.end(); i != e;) {
 		result.append(std::move(i->second));
 		if (++i != e) {
@@ -2087,18 +2103,21 @@ void HistoryInner::checkHistoryActivation() {
 	session().data().histories().readInboxTill(view->data());
 }
 
-void HistoryInner::recountHistoryGeometry() {
+void HistoryInner::recountHistoryGeometry(bool lazy) {
+	PAINT_STATS_FRAME("HistoryInner layout");
+
 	_contentWidth = _scroll->width();
 
 	const auto visibleHeight = _scroll->height();
+	const auto layoutHeight = lazy ? visibleHeight : 0;
 	int oldHistoryPaddingTop = qMax(visibleHeight - historyHeight() - st::historyPaddingBottom, 0);
 	if (_botAbout && !_botAbout->info->text.isEmpty()) {
 		accumulate_max(oldHistoryPaddingTop, st::msgMargin.top() + st::msgMargin.bottom() + st::msgPadding.top() + st::msgPadding.bottom() + st::msgNameFont->height + st::botDescSkip + _botAbout->height);
 	}
 
-	_history->resizeToWidth(_contentWidth);
+	_history->resizeToWidth(_contentWidth, layoutHeight);
 	if (_migrated) {
-		_migrated->resizeToWidth(_contentWidth);
+		_migrated->resizeToWidth(_contentWidth, layoutHeight);
 	}
 
 	// With migrated history we perhaps do not need to display
@@ -3132,6 +3151,35 @@ void HistoryInner::deleteItem(not_null<HistoryItem*> item) {
 	Ui::show(Box<DeleteMessagesBox>(item, suggestModerateActions));
 }
 
+bool HistoryInner::hasEstimatedHeights() const {
+	return _history->hasEstimatedHeights()
+		|| (_migrated && _migrated->hasEstimatedHeights());
+}
+
+bool HistoryInner::layoutEstimatedHeights(int limit) {
+	if (!hasEstimatedHeights() || hasPendingResizedItems()) {
+		return false;
+	}
+	const auto margin = _visibleAreaBottom - _visibleAreaTop;
+	const auto from = _visibleAreaTop - margin;
+	const auto till = _visibleAreaBottom + margin;
+	auto changed = false;
+	const auto layout = [&](not_null<History*> history, int top) {
+		if (top >= 0
+			&& history->layoutEstimatedHeights(
+				from - top,
+				till - top,
+				limit)) {
+			changed = true;
+		}
+	};
+	layout(_history, historyTop());
+	if (_migrated) {
+		layout(_migrated, migratedTop());
+	}
+	return changed;
+}
+
 bool HistoryInner::hasPendingResizedItems() const {
 	return _history->hasPendingResizedItems()
 		|| (_migrated && _migrated->hasPendingResizedItems());
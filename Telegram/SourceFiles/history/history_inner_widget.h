@@ -64,7 +64,9 @@ public:
 	void touchScrollUpdated(const QPoint &screenPos);
 
 	void checkHistoryActivation();
-	void recountHistoryGeometry();
+	// With lazy the messages far from the visible area may get
+	// estimated heights instead of being laid out right away.
+	void recountHistoryGeometry(bool lazy = false);
 	void updateSize();
 
 	void repaintItem(const HistoryItem *item);
@@ -101,6 +103,11 @@ public:
 	// updates history->scrollTopItem/scrollTopOffset
 	void visibleAreaUpdated(int top, int bottom);
 
+	// Lays out the messages with estimated heights in the visible area
+	// and up to limit blocks around it, returns true if geometry changed.
+	bool layoutEstimatedHeights(int limit);
+	bool hasEstimatedHeights() const;
+
 	int historyHeight() const;
 	int historyScrollTop() const;
 	int migratedTop() const;
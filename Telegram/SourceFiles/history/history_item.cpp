@@ -854,13 +854,21 @@ void HistoryItem::drawInDialog(
 		bool selected,
 		DrawInDialog way,
 		const HistoryItem *&cacheFor,
+		QString &cacheSource,
 		Ui::Text::String &cache) const {
 	if (r.isEmpty()) {
 		return;
 	}
 	if (cacheFor != this) {
 		cacheFor = this;
-		cache.setText(st::dialogsTextStyle, inDialogsText(way), Ui::DialogTextOptions());
+
+		// Edits and last item changes often keep the same preview,
+		// the text layout is skipped for them.
+		auto text = inDialogsText(way);
+		if (text != cacheSource) {
+			cache.setText(st::dialogsTextStyle, text, Ui::DialogTextOptions());
+			cacheSource = std::move(text);
+		}
 	}
 	p.setTextPalette(active ? st::dialogsTextPaletteActive : (selected ? st::dialogsTextPaletteOver : st::dialogsTextPalette));
 	p.setFont(st::dialogsTextFont);
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/flags.h"
 #include "base/value_ordering.h"
 #include "data/data_media_types.h"
+#include "history/history_allocator.h"
 
 enum class UnreadMentionType;
 struct HistoryMessageReplyMarkup;
@@ -59,6 +60,8 @@ class History;
 
 class HistoryItem : public RuntimeComposer<HistoryItem> {
 public:
+	HISTORY_POOLED_ALLOCATION
+
 	static not_null<HistoryItem*> Create(
 		not_null<History*> history,
 		const MTPMessage &message,
@@ -253,6 +256,7 @@ public:
 		bool selected,
 		DrawInDialog way,
 		const HistoryItem *&cacheFor,
+		QString &cacheSource,
 		Ui::Text::String &cache) const;
 
 	[[nodiscard]] bool emptyText() const {
@@ -220,10 +220,15 @@ bool HistoryMessageReply::updateData(
 	}
 
 	if (replyToMsg) {
-		replyToText.setText(
-			st::messageTextStyle,
-			replyToMsg->inReplyText(),
-			Ui::DialogTextOptions());
+		// Edits of the original message often keep the preview text.
+		auto text = replyToMsg->inReplyText();
+		if (text != replyToTextSource || replyToText.isEmpty()) {
+			replyToText.setText(
+				st::messageTextStyle,
+				text,
+				Ui::DialogTextOptions());
+			replyToTextSource = std::move(text);
+		}
 
 		updateName();
 
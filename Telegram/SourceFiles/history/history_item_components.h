@@ -101,6 +101,7 @@ struct HistoryMessageReply : public RuntimeComponent<HistoryMessageReply, Histor
 		replyToLnk = std::move(other.replyToLnk);
 		replyToName = std::move(other.replyToName);
 		replyToText = std::move(other.replyToText);
+		replyToTextSource = std::move(other.replyToTextSource);
 		replyToVersion = other.replyToVersion;
 		maxReplyWidth = other.maxReplyWidth;
 		replyToVia = std::move(other.replyToVia);
@@ -155,6 +156,7 @@ struct HistoryMessageReply : public RuntimeComponent<HistoryMessageReply, Histor
 	DocumentId replyToDocumentId = 0;
 	ClickHandlerPtr replyToLnk;
 	mutable Ui::Text::String replyToName, replyToText;
+	QString replyToTextSource;
 	mutable int replyToVersion = 0;
 	mutable int maxReplyWidth = 0;
 	std::unique_ptr<HistoryMessageVia> replyToVia;
@@ -91,7 +91,7 @@ TextForMimeData HistoryItemText(not_null<HistoryItem*> item) {
 		titleResult.append('\n').append(std::move(descriptionResult));
 		return titleResult;
 	}();
-	auto result = textResult;
+	auto result = std::move(textResult);
 	if (result.empty()) {
 		result = std::move(mediaResult);
 	} else if (!mediaResult.empty()) {
@@ -109,18 +109,18 @@ TextForMimeData HistoryGroupText(not_null<const Data::Group*> group) {
 	Expects(!group->items.empty());
 
 	auto caption = [&] {
-		auto &&nonempty = ranges::view::all(
-			group->items
-		) | ranges::view::filter([](not_null<HistoryItem*> item) {
-			return !item->clipboardText().empty();
-		}) | ranges::view::take(2);
-		auto first = nonempty.begin();
-		auto end = nonempty.end();
-		if (first == end) {
-			return TextForMimeData();
+		// The caption is kept only if exactly one item in the album has it.
+		auto result = TextForMimeData();
+		for (const auto item : group->items) {
+			auto text = item->clipboardText();
+			if (text.empty()) {
+				continue;
+			} else if (!result.empty()) {
+				return TextForMimeData();
+			}
+			result = std::move(text);
 		}
-		auto result = (*first)->clipboardText();
-		return (++first == end) ? result : TextForMimeData();
+		return result;
 	}();
 	return WrapAsItem(group->items.back(), Data::WithCaptionClipboardText(
 		tr::lng_in_dlg_album(tr::now),
@@ -129,6 +129,25 @@ constexpr auto kPinnedMessageTextLimit = 16;
 	return { QString::fromUtf8(":-("), EntitiesInText() };
 }
 
+[[nodiscard]] bool SameText(
+		const TextWithEntities &a,
+		const TextWithEntities &b) {
+	if (a.text != b.text || a.entities.size() != b.entities.size()) {
+		return false;
+	}
+	for (auto i = 0, count = int(a.entities.size()); i != count; ++i) {
+		const auto &first = a.entities[i];
+		const auto &second = b.entities[i];
+		if (first.type() != second.type()
+			|| first.offset() != second.offset()
+			|| first.length() != second.length()
+			|| first.data() != second.data()) {
+			return false;
+		}
+	}
+	return true;
+}
+
 } // namespace
 
 QString GetErrorTextForSending(
@@ -460,12 +479,15 @@ HistoryMessage::HistoryMessage(
 	if (const auto media = data.vmedia()) {
 		setMedia(*media);
 	}
-	const auto textWithEntities = TextWithEntities{
-		TextUtilities::Clean(qs(data.vmessage())),
-		Api::EntitiesFromMTP(
-			&history->session(),
-			data.ventities().value_or_empty())
-	};
+	auto prepared = history->owner().takePreparedMessageText(fullId());
+	const auto textWithEntities = prepared
+		? std::move(*prepared)
+		: TextWithEntities{
+			TextUtilities::Clean(qs(data.vmessage())),
+			Api::EntitiesFromMTP(
+				&history->session(),
+				data.ventities().value_or_empty())
+		};
 	setText(_media ? textWithEntities : EnsureNonEmpty(textWithEntities));
 	if (const auto groupedId = data.vgrouped_id()) {
 		setGroupId(
@@ -1083,11 +1105,14 @@ void HistoryMessage::applyEdition(const MTPDmessage &message) {
 			message.ventities().value_or_empty())
 	};
 	setReplyMarkup(message.vreply_markup());
+	const auto hadMedia = (_media != nullptr);
 	if (!isLocalUpdateMedia()) {
 		refreshMedia(message.vmedia());
 	}
 	setViewsCount(message.vviews().value_or(-1));
-	setText(_media ? textWithEntities : EnsureNonEmpty(textWithEntities));
+	setTextIfChanged(
+		_media ? textWithEntities : EnsureNonEmpty(textWithEntities),
+		hadMedia);
 
 	finishEdition(keyboardTop);
 }
@@ -1107,7 +1132,7 @@ void HistoryMessage::updateSentContent(
 		const TextWithEntities &textWithEntities,
 		const MTPMessageMedia *media) {
 	const auto isolated = isolatedEmoji();
-	setText(textWithEntities);
+	setTextIfChanged(textWithEntities, (_media != nullptr));
 	if (_clientFlags & MTPDmessage_ClientFlag::f_from_inline_bot) {
 		if (!media || !_media || !_media->updateInlineResultMedia(*media)) {
 			refreshSentMedia(media);
@@ -1247,6 +1272,17 @@ void HistoryMessage::setText(const TextWithEntities &textWithEntities) {
 	_textHeight = 0;
 }
 
+void HistoryMessage::setTextIfChanged(
+		const TextWithEntities &textWithEntities,
+		bool hadMedia) {
+	// The same message often comes again, with new views or markup,
+	// re-parsing the unchanged text is the costly part of applying it.
+	if (hadMedia != (_media != nullptr)
+		|| !SameText(originalText(), textWithEntities)) {
+		setText(textWithEntities);
+	}
+}
+
 void HistoryMessage::reapplyText() {
 	setText(originalText());
 	history()->owner().requestItemResize(this);
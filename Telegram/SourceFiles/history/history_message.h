@@ -175,6 +175,9 @@ public:
 
 private:
 	void setEmptyText();
+	void setTextIfChanged(
+		const TextWithEntities &textWithEntities,
+		bool hadMedia);
 	[[nodiscard]] bool isTooOldForEdit(TimeId now) const;
 	[[nodiscard]] bool isLegacyMessage() const {
 		return _flags & MTPDmessage::Flag::f_legacy;
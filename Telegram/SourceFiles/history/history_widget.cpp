@@ -130,6 +130,10 @@ constexpr auto kSaveDraftAnywayTimeout = 5000;
 constexpr auto kSaveCloudDraftIdleTimeout = 14000;
 constexpr auto kRecordingUpdateDelta = crl::time(100);
 constexpr auto kRefreshSlowmodeLabelTimeout = crl::time(200);
+constexpr auto kLayoutEstimatedHeightsDelay = crl::time(100);
+constexpr auto kLayoutEstimatedBlocksPerStep = 4;
+constexpr auto kPreviewCacheLimit = 256;
+constexpr auto kPreviewEmptyCacheTimeout = 10 * 60 * crl::time(1000);
 constexpr auto kCommonModifiers = 0
 	| Qt::ShiftModifier
 	| Qt::MetaModifier
@@ -352,6 +356,7 @@ HistoryWidget::HistoryWidget(
 	_scrollTimer.setSingleShot(false);
 
 	_highlightTimer.setCallback([this] { updateHighlightedMessage(); });
+	_estimatedHeightsTimer.setCallback([=] { layoutEstimatedHeights(); });
 
 	_membersDropdownShowTimer.setSingleShot(true);
 	connect(&_membersDropdownShowTimer, SIGNAL(timeout()), this, SLOT(onMembersDropdownShow()));
@@ -907,7 +912,7 @@ void HistoryWidget::scrollToCurrentVoiceMessage(FullMsgId fromId, FullMsgId toId
 void HistoryWidget::animatedScrollToItem(MsgId msgId) {
 	Expects(_history != nullptr);
 
-	if (hasPendingResizedItems()) {
+	if (hasPendingResizedItems() || _list->hasEstimatedHeights()) {
 		updateListSize();
 	}
 
@@ -926,7 +931,7 @@ void HistoryWidget::animatedScrollToItem(MsgId msgId) {
 void HistoryWidget::animatedScrollToY(int scrollTo, HistoryItem *attachTo) {
 	Expects(_history != nullptr);
 
-	if (hasPendingResizedItems()) {
+	if (hasPendingResizedItems() || _list->hasEstimatedHeights()) {
 		updateListSize();
 	}
 
@@ -1825,6 +1830,11 @@ void HistoryWidget::showHistory(
 		_scrollToAnimation.stop();
 
 		clearAllLoadRequests();
+		auto &histories = _history->owner().histories();
+		histories.historyHidden(_history);
+		if (_migrated) {
+			histories.historyHidden(_migrated);
+		}
 		_history = _migrated = nullptr;
 		_list = nullptr;
 		_peer = nullptr;
@@ -1843,7 +1853,6 @@ void HistoryWidget::showHistory(
 	_replyEditMsg = nullptr;
 	_editMsgId = _replyToId = 0;
 	_previewData = nullptr;
-	_previewCache.clear();
 	_fieldBarCancel->hide();
 
 	_membersDropdownShowTimer.stop();
@@ -1894,6 +1903,11 @@ void HistoryWidget::showHistory(
 	if (_peer) {
 		_history = _peer->owner().history(_peer);
 		_migrated = _history->migrateFrom();
+		auto &histories = _history->owner().histories();
+		histories.historyShown(_history);
+		if (_migrated) {
+			histories.historyShown(_migrated);
+		}
 		if (_migrated
 			&& !_migrated->isEmpty()
 			&& (!_history->loadedAtTop() || !_migrated->loadedAtBottom())) {
@@ -2858,6 +2872,11 @@ void HistoryWidget::delayedShowAt(MsgId showAtMsgId) {
 void HistoryWidget::onScroll() {
 	preloadHistoryIfNeeded();
 	visibleAreaUpdated();
+	if (_list && _historyInited && _list->layoutEstimatedHeights(0)) {
+		// Keeps the scroll on scrollTopItem, this one is already counted.
+		updateHistoryGeometry();
+		_list->update();
+	}
 	if (!_synteticScrollEvent) {
 		_lastUserScrolled = crl::now();
 	}
@@ -5114,7 +5133,7 @@ void HistoryWidget::updateHistoryGeometry(
 		controller()->floatPlayerAreaUpdated();
 	}
 
-	updateListSize();
+	updateListSize(!initial);
 	_updateHistoryGeometryRequired = false;
 
 	auto newScrollTop = 0;
@@ -5142,10 +5161,26 @@ void HistoryWidget::updateHistoryGeometry(
 	} else {
 		synteticScrollToY(toY);
 	}
+	if (_list->hasEstimatedHeights()) {
+		_estimatedHeightsTimer.callOnce(kLayoutEstimatedHeightsDelay);
+	}
 }
 
-void HistoryWidget::updateListSize() {
-	_list->recountHistoryGeometry();
+void HistoryWidget::layoutEstimatedHeights() {
+	if (!_list || !_historyInited) {
+		return;
+	} else if (hasPendingResizedItems() || _scrollToAnimation.animating()) {
+		_estimatedHeightsTimer.callOnce(kLayoutEstimatedHeightsDelay);
+	} else if (_list->layoutEstimatedHeights(kLayoutEstimatedBlocksPerStep)) {
+		updateHistoryGeometry();
+		_list->update();
+	} else if (_list->hasEstimatedHeights()) {
+		_estimatedHeightsTimer.callOnce(kLayoutEstimatedHeightsDelay);
+	}
+}
+
+void HistoryWidget::updateListSize(bool lazy) {
+	_list->recountHistoryGeometry(lazy);
 	auto washidden = _scroll->isHidden();
 	if (washidden) {
 		_scroll->show();
@@ -5499,6 +5534,9 @@ void HistoryWidget::handlePeerMigration() {
 		channel->session().api().requestParticipantsCountDelayed(channel);
 	} else {
 		_migrated = _history->migrateFrom();
+		if (_migrated) {
+			_history->owner().histories().historyShown(_migrated);
+		}
 		_list->notifyMigrateUpdated();
 		updateHistoryGeometry();
 	}
@@ -6177,8 +6215,16 @@ void HistoryWidget::checkPreview() {
 				previewCancel();
 			}
 		} else {
-			const auto i = _previewCache.constFind(links);
-			if (i == _previewCache.cend()) {
+			// Links without a preview may get one later.
+			auto i = _previewCache.find(links);
+			if (i != end(_previewCache)
+				&& !i->second.id
+				&& (i->second.received + kPreviewEmptyCacheTimeout
+					<= crl::now())) {
+				_previewCache.erase(i);
+				i = end(_previewCache);
+			}
+			if (i == end(_previewCache)) {
 				_previewRequest = session().api().request(MTPmessages_GetWebPagePreview(
 					MTP_flags(0),
 					MTP_string(links),
@@ -6186,8 +6232,8 @@ void HistoryWidget::checkPreview() {
 				)).done([=](const MTPMessageMedia &result, mtpRequestId requestId) {
 					gotPreview(links, result, requestId);
 				}).send();
-			} else if (i.value()) {
-				_previewData = session().data().webpage(i.value());
+			} else if (i->second.id) {
+				_previewData = session().data().webpage(i->second.id);
 				updatePreview();
 			} else if (_previewData && _previewData->pendingTill >= 0) {
 				previewCancel();
@@ -6219,7 +6265,7 @@ void HistoryWidget::gotPreview(QString links, const MTPMessageMedia &result, mtp
 	if (result.type() == mtpc_messageMediaWebPage) {
 		const auto &data = result.c_messageMediaWebPage().vwebpage();
 		const auto page = session().data().processWebpage(data);
-		_previewCache.insert(links, page->id);
+		cachePreview(links, page->id);
 		if (page->pendingTill > 0 && page->pendingTill <= base::unixtime::now()) {
 			page->pendingTill = -1;
 		}
@@ -6231,7 +6277,7 @@ void HistoryWidget::gotPreview(QString links, const MTPMessageMedia &result, mtp
 		}
 		session().data().sendWebPageGamePollNotifications();
 	} else if (result.type() == mtpc_messageMediaEmpty) {
-		_previewCache.insert(links, 0);
+		cachePreview(links, 0);
 		if (links == _previewLinks && !_previewCancelled) {
 			_previewData = nullptr;
 			updatePreview();
@@ -6239,6 +6285,17 @@ void HistoryWidget::gotPreview(QString links, const MTPMessageMedia &result, mtp
 	}
 }
 
+void HistoryWidget::cachePreview(const QString &links, WebPageId id) {
+	if (_previewCache.size() >= kPreviewCacheLimit
+		&& !_previewCache.contains(links)) {
+		_previewCache.erase(ranges::min_element(
+			_previewCache,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.received; }));
+	}
+	_previewCache[links] = { id, crl::now() };
+}
+
 void HistoryWidget::updatePreview() {
 	_previewTimer.cancel();
 	if (_previewData && _previewData->pendingTill >= 0) {
@@ -6879,7 +6936,7 @@ void HistoryWidget::paintEvent(QPaintEvent *e) {
 		return;
 	}
 	if (hasPendingResizedItems()) {
-		updateListSize();
+		updateListSize(true);
 	}
 
 	Window::SectionWidget::PaintBackground(controller(), this, e->rect());
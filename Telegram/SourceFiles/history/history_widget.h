@@ -573,6 +573,7 @@ private:
 	void checkPreview();
 	void requestPreview();
 	void gotPreview(QString links, const MTPMessageMedia &media, mtpRequestId req);
+	void cachePreview(const QString &links, WebPageId id);
 	void messagesReceived(PeerData *peer, const MTPmessages_Messages &messages, int requestId);
 	void messagesFailed(const RPCError &error, int requestId);
 	void addMessagesToFront(PeerData *peer, const QVector<MTPMessage> &messages);
@@ -582,11 +583,15 @@ private:
 	bool botCallbackFail(BotCallbackInfo info, const RPCError &error, mtpRequestId req);
 
 	void updateHistoryGeometry(bool initial = false, bool loadedDown = false, const ScrollChange &change = { ScrollChangeNone, 0 });
-	void updateListSize();
+	void updateListSize(bool lazy = false);
 
 	// Does any of the shown histories has this flag set.
 	bool hasPendingResizedItems() const;
 
+	// Corrects the estimated heights left by a width change, see
+	// History::resizeToWidth(), a few blocks at a time.
+	void layoutEstimatedHeights();
+
 	// Counts scrollTop for placing the scroll right at the unread
 	// messages bar, choosing from _history and _migrated unreadBar.
 	std::optional<int> unreadBarTop() const;
@@ -667,8 +672,11 @@ private:
 	QStringList _parsedLinks;
 	QString _previewLinks;
 	WebPageData *_previewData = nullptr;
-	typedef QMap<QString, WebPageId> PreviewCache;
-	PreviewCache _previewCache;
+	struct PreviewCacheEntry {
+		WebPageId id = 0;
+		crl::time received = 0;
+	};
+	base::flat_map<QString, PreviewCacheEntry> _previewCache;
 	mtpRequestId _previewRequest = 0;
 	Ui::Text::String _previewTitle;
 	Ui::Text::String _previewDescription;
@@ -702,6 +710,7 @@ private:
 	bool _historyInited = false;
 	// If updateListSize() was called without updateHistoryGeometry().
 	bool _updateHistoryGeometryRequired = false;
+	base::Timer _estimatedHeightsTimer;
 	int _addToScroll = 0;
 
 	int _lastScrollTop = 0; // gifs optimization
@@ -308,6 +308,9 @@ void Element::setPendingResize() {
 	_flags |= Flag::NeedsResize;
 	if (_context == Context::History) {
 		data()->_history->setHasPendingResizedItems();
+		if (_block) {
+			_block->setHasPendingResize();
+		}
 	}
 }
 
@@ -502,12 +505,43 @@ QSize Element::countOptimalSize() {
 	return performCountOptimalSize();
 }
 
+int Element::estimateHeight(int newWidth) {
+	if (_flags & Flag::NeedsResize) {
+		_flags &= ~Flag::NeedsResize;
+		_heightCache = {};
+		initDimensions();
+	}
+
+	// Never laid out elements are estimated by their optimal size.
+	auto result = height() ? height() : minHeight();
+	auto distance = std::numeric_limits<int>::max();
+	for (const auto &cached : _heightCache) {
+		if (!cached.width) {
+			continue;
+		} else if (cached.width == newWidth) {
+			result = cached.height;
+			break;
+		} else if (std::abs(cached.width - newWidth) < distance) {
+			distance = std::abs(cached.width - newWidth);
+			result = cached.height;
+		}
+	}
+	setCurrentSize(QSize(width(), result));
+	return result;
+}
+
 QSize Element::countCurrentSize(int newWidth) {
 	if (_flags & Flag::NeedsResize) {
 		_flags &= ~Flag::NeedsResize;
+		_heightCache = {};
 		initDimensions();
 	}
-	return performCountCurrentSize(newWidth);
+	const auto result = performCountCurrentSize(newWidth);
+	if (_heightCache.front().width != newWidth) {
+		_heightCache.back() = _heightCache.front();
+	}
+	_heightCache.front() = { newWidth, result.height() };
+	return result;
 }
 
 void Element::setDisplayDate(bool displayDate) {
@@ -645,6 +679,9 @@ void Element::attachToBlock(not_null<HistoryBlock*> block, int index) {
 
 	_block = block;
 	_indexInBlock = index;
+	if (pendingResize()) {
+		_block->setHasPendingResize();
+	}
 	_data->setMainView(this);
 	previousInBlocksChanged();
 }
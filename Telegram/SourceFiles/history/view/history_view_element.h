@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "history/view/history_view_object.h"
+#include "history/history_allocator.h"
 #include "base/runtime_composer.h"
 #include "base/flags.h"
 
@@ -144,6 +145,8 @@ class Element
 	, public RuntimeComposer<Element>
 	, public ClickHandlerHost {
 public:
+	HISTORY_POOLED_ALLOCATION
+
 	Element(
 		not_null<ElementDelegate*> delegate,
 		not_null<HistoryItem*> data,
@@ -175,6 +178,11 @@ public:
 
 	void setPendingResize();
 	bool pendingResize() const;
+
+	// Applies the height this element would likely have for newWidth
+	// without breaking its text in lines, the real layout is done later
+	// by resizeGetHeight(). Uses the heights cached for recent widths.
+	int estimateHeight(int newWidth);
 	bool isUnderCursor() const;
 
 	bool isLastAndSelfMessage() const;
@@ -325,8 +333,14 @@ private:
 	bool _isScheduledUntilOnline = false;
 	const QDateTime _dateTime;
 
+	struct CachedHeight {
+		int width = 0;
+		int height = 0;
+	};
+
 	int _y = 0;
 	Context _context = Context();
+	std::array<CachedHeight, 2> _heightCache;
 
 	Flags _flags = Flag::NeedsResize;
 
@@ -21,6 +21,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mainwindow.h"
 #include "mainwidget.h"
 #include "core/application.h"
+#include "core/paint_stats.h"
 #include "apiwrap.h"
 #include "layout.h"
 #include "window/window_session_controller.h"
@@ -1217,6 +1218,8 @@ void ListWidget::resizeToWidth(int newWidth, int minHeight) {
 }
 
 int ListWidget::resizeGetHeight(int newWidth) {
+	PAINT_STATS_FRAME("HistoryView::ListWidget layout");
+
 	update();
 
 	const auto resizeAllItems = (_itemsWidth != newWidth);
@@ -1309,6 +1312,7 @@ void ListWidget::paintEvent(QPaintEvent *e) {
 	if (Ui::skipPaintEvent(this, e)) {
 		return;
 	}
+	PAINT_STATS_FRAME("HistoryView::ListWidget");
 
 	const auto guard = gsl::finally([&] {
 		_userpicsCache.clear();
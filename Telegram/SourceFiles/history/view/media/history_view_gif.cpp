@@ -1412,6 +1412,8 @@ void Gif::startStreamedPlayer() const {
 	auto options = ::Media::Streaming::PlaybackOptions();
 	options.audioId = AudioMsgId(_data, _realParent->fullId());
 	options.waitForMarkAsShown = true;
+	options.hwAllowed = _data->isVideoMessage()
+		&& Core::App().settings().hardwareAcceleratedVideo();
 	//if (!_streamed->withSound) {
 	options.mode = ::Media::Streaming::Mode::Video;
 	options.loop = true;
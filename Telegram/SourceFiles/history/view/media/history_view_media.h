@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "history/view/history_view_object.h"
+#include "history/history_allocator.h"
 #include "ui/rect_part.h"
 
 class History;
@@ -54,6 +55,8 @@ enum class MediaInBubbleState {
 
 class Media : public Object {
 public:
+	HISTORY_POOLED_ALLOCATION
+
 	Media(not_null<Element*> parent) : _parent(parent) {
 	}
 
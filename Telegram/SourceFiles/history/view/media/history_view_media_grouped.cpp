@@ -81,21 +81,29 @@ QSize GroupedMedia::countOptimalSize() {
 		sizes.push_back(media->sizeForGrouping());
 	}
 
-	const auto layout = Ui::LayoutMediaGroup(
-		sizes,
-		st::historyGroupWidthMax,
-		st::historyGroupWidthMin,
-		st::historyGroupSkip);
-	Assert(layout.size() == _parts.size());
+	// Edits and view refreshes mostly keep the same media sizes,
+	// then the previous layout of the parts can be used as is.
+	if (sizes != _layoutSizes) {
+		const auto layout = Ui::LayoutMediaGroup(
+			sizes,
+			st::historyGroupWidthMax,
+			st::historyGroupWidthMin,
+			st::historyGroupSkip);
+		Assert(layout.size() == _parts.size());
+
+		for (auto i = 0, count = int(layout.size()); i != count; ++i) {
+			_parts[i].initialGeometry = layout[i].geometry;
+			_parts[i].sides = layout[i].sides;
+		}
+		_layoutSizes = std::move(sizes);
+	}
 
 	auto maxWidth = 0;
 	auto minHeight = 0;
-	for (auto i = 0, count = int(layout.size()); i != count; ++i) {
-		const auto &item = layout[i];
-		accumulate_max(maxWidth, item.geometry.x() + item.geometry.width());
-		accumulate_max(minHeight, item.geometry.y() + item.geometry.height());
-		_parts[i].initialGeometry = item.geometry;
-		_parts[i].sides = item.sides;
+	for (const auto &part : _parts) {
+		const auto &geometry = part.initialGeometry;
+		accumulate_max(maxWidth, geometry.x() + geometry.width());
+		accumulate_max(minHeight, geometry.y() + geometry.height());
 	}
 
 	if (!_caption.isEmpty()) {
@@ -131,6 +131,7 @@ private:
 
 	Ui::Text::String _caption;
 	std::vector<Part> _parts;
+	std::vector<QSize> _layoutSizes;
 	bool _needBubble = false;
 
 };
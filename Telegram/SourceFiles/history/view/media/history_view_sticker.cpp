@@ -35,6 +35,31 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace HistoryView {
 namespace {
 
+// When this many animated stickers already play in chats the new
+// players use the default quality, they are cheaper to render.
+constexpr auto kHighQualityPlayersLimit = 4;
+
+// Main thread.
+int PlayersCount = 0;
+
+// The quality is a part of the frame cache key, so a sticker keeps
+// the quality it got first, otherwise it would miss its frame cache.
+//
+// Main thread.
+base::flat_map<DocumentId, Lottie::Quality> ChosenQualities;
+
+[[nodiscard]] Lottie::Quality ChooseQuality(not_null<DocumentData*> document) {
+	const auto i = ChosenQualities.find(document->id);
+	if (i != end(ChosenQualities)) {
+		return i->second;
+	}
+	const auto result = (PlayersCount < kHighQualityPlayersLimit)
+		? Lottie::Quality::High
+		: Lottie::Quality::Default;
+	ChosenQualities.emplace(document->id, result);
+	return result;
+}
+
 [[nodiscard]] double GetEmojiStickerZoom(not_null<Main::Session*> session) {
 	return session->account().appConfig().get<double>(
 		"emojies_animated_zoom",
@@ -301,13 +326,14 @@ void Sticker::setupLottie() {
 		_replacements,
 		ChatHelpers::StickerLottieSize::MessageHistory,
 		_size * cIntRetinaFactor(),
-		Lottie::Quality::High);
+		ChooseQuality(_data));
 	lottieCreated();
 }
 
 void Sticker::lottieCreated() {
 	Expects(_lottie != nullptr);
 
+	++PlayersCount;
 	_parent->history()->owner().registerHeavyViewPart(_parent);
 
 	_lottie->updates(
@@ -338,10 +364,14 @@ void Sticker::unloadLottie() {
 		_lottieOncePlayed = false;
 	}
 	_lottie = nullptr;
+	--PlayersCount;
 	_parent->checkHeavyPart();
 }
 
 std::unique_ptr< Lottie::SinglePlayer> Sticker::stickerTakeLottie() {
+	if (_lottie) {
+		--PlayersCount;
+	}
 	return std::move(_lottie);
 }
 
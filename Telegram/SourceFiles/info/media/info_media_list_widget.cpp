@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "info/info_controller.h"
 #include "overview/overview_layout.h"
+#include "core/paint_stats.h"
 #include "data/data_media_types.h"
 #include "data/data_photo.h"
 #include "data/data_document.h"
@@ -1186,6 +1187,7 @@ QMargins ListWidget::padding() const {
 }
 
 void ListWidget::paintEvent(QPaintEvent *e) {
+	PAINT_STATS_FRAME("Info::Media::ListWidget");
 	Painter p(this);
 
 	auto outerWidth = width();
@@ -43,6 +43,7 @@ namespace internal {
 namespace {
 
 constexpr auto kInlineBotRequestDelay = 400;
+constexpr auto kInlineBotMinCacheTime = 30 * crl::time(1000);
 
 } // namespace
 
@@ -1033,6 +1034,7 @@ void Widget::inlineBotChanged() {
 	_inlineQuery = _inlineNextQuery = _inlineNextOffset = QString();
 	_inlineBot = nullptr;
 	_inlineCache.clear();
+	_inlineExpiredCache.clear();
 	_inner->inlineBotChanged();
 	_inner->hideInlineRowsPanel();
 
@@ -1056,6 +1058,9 @@ void Widget::inlineResultsDone(const MTPmessages_BotResults &result) {
 			it = _inlineCache.emplace(
 				_inlineQuery,
 				std::make_unique<internal::CacheEntry>()).first;
+			it->second->expires = crl::now() + std::max(
+				d.vcache_time().v * crl::time(1000),
+				internal::kInlineBotMinCacheTime);
 		}
 		auto entry = it->second.get();
 		entry->nextOffset = qs(d.vnext_offset().value_or_empty());
@@ -1109,6 +1114,9 @@ void Widget::queryInlineBot(UserData *bot, PeerData *peer, QString query) {
 			_inlineRequestId = 0;
 			_requesting.fire(false);
 		}
+		if (query != _inlineQuery) {
+			validateInlineCache(query);
+		}
 		if (_inlineCache.find(query) != _inlineCache.cend()) {
 			_inlineRequestTimer.stop();
 			_inlineQuery = _inlineNextQuery = query;
@@ -1120,6 +1128,17 @@ void Widget::queryInlineBot(UserData *bot, PeerData *peer, QString query) {
 	}
 }
 
+void Widget::validateInlineCache(const QString &query) {
+	const auto i = _inlineCache.find(query);
+	if (i == _inlineCache.cend() || i->second->expires > crl::now()) {
+		return;
+	}
+	// Layouts in the inner widget may still point to these results,
+	// so they are destroyed only together with all the other ones.
+	_inlineExpiredCache.push_back(std::move(i->second));
+	_inlineCache.erase(i);
+}
+
 void Widget::onInlineRequest() {
 	if (_inlineRequestId || !_inlineBot || !_inlineQueryPeer) return;
 	_inlineQuery = _inlineNextQuery;
@@ -49,6 +49,7 @@ struct CacheEntry {
 	QString nextOffset;
 	QString switchPmText, switchPmStartToken;
 	Results results;
+	crl::time expires = 0;
 };
 
 class Inner
@@ -249,6 +250,7 @@ private:
 	void recountContentMaxHeight();
 	bool refreshInlineRows(int *added = nullptr);
 	void inlineResultsDone(const MTPmessages_BotResults &result);
+	void validateInlineCache(const QString &query);
 
 	const not_null<Window::SessionController*> _controller;
 	MTP::Sender _api;
@@ -273,6 +275,7 @@ private:
 	QPointer<internal::Inner> _inner;
 
 	std::map<QString, std::unique_ptr<internal::CacheEntry>> _inlineCache;
+	std::vector<std::unique_ptr<internal::CacheEntry>> _inlineExpiredCache;
 	QTimer _inlineRequestTimer;
 
 	UserData *_inlineBot = nullptr;
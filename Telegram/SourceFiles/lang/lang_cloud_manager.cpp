@@ -27,6 +27,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Lang {
 namespace {
 
+// Small cloud updates of the Current and Base packs come close together,
+// they're written in one go. If the app quits before the write happens
+// the cached version is older and the same difference is requested again.
+constexpr auto kWriteLangPackDelay = 10 * crl::time(1000);
+
 class ConfirmSwitchBox : public Ui::BoxContent {
 public:
 	ConfirmSwitchBox(
@@ -157,7 +162,8 @@ Language ParseLanguage(const MTPLangPackLanguage &data) {
 }
 
 CloudManager::CloudManager(Instance &langpack)
-: _langpack(langpack) {
+: _langpack(langpack)
+, _writeLangPackTimer([] { Local::writeLangPack(); }) {
 	Core::App().domain().activeValue(
 	) | rpl::map([=](Main::Account *account) {
 		if (!account) {
@@ -378,8 +384,16 @@ void CloudManager::applyLangPackData(
 		requestLangPackDifference(pack);
 	} else if (!data.vstrings().v.isEmpty()) {
 		_langpack.applyDifference(pack, data);
-		Local::writeLangPack();
+		if (data.vfrom_version().v > 0 && !_restartAfterSwitch) {
+			if (!_writeLangPackTimer.isActive()) {
+				_writeLangPackTimer.callOnce(kWriteLangPackDelay);
+			}
+		} else {
+			_writeLangPackTimer.cancel();
+			Local::writeLangPack();
+		}
 	} else if (_restartAfterSwitch) {
+		_writeLangPackTimer.cancel();
 		Local::writeLangPack();
 	} else {
 		LOG(("Lang Info: Up to date."));
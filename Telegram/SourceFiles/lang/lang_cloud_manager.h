@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "mtproto/sender.h"
 #include "base/weak_ptr.h"
+#include "base/timer.h"
 
 namespace MTP {
 class Instance;
@@ -96,6 +97,8 @@ private:
 
 	mtpRequestId _getKeysForSwitchRequestId = 0;
 
+	base::Timer _writeLangPackTimer;
+
 	rpl::lifetime _lifetime;
 
 };
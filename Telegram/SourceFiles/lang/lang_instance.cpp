@@ -544,8 +544,16 @@ void Instance::fillFromSerialized(
 	_customFilePathRelative = customFilePathRelative;
 	_customFileContent = customFileContent;
 	LOG(("Lang Info: Loaded cached, keys: %1").arg(nonDefaultValuesCount));
+	// Values were serialized from the sorted map, so each of them is
+	// appended at the end instead of searching the tree from the root.
 	for (auto i = 0, count = nonDefaultValuesCount * 2; i != count; i += 2) {
-		applyValue(nonDefaultStrings[i], nonDefaultStrings[i + 1]);
+		const auto &key = nonDefaultStrings[i];
+		const auto &value = nonDefaultStrings[i + 1];
+		_nonDefaultValues.insert_or_assign(
+			end(_nonDefaultValues),
+			key,
+			value);
+		parseAndApplyValue(key, value);
 	}
 	updatePluralRules();
 
@@ -702,6 +710,12 @@ QString Instance::getNonDefaultValue(const QByteArray &key) const {
 
 void Instance::applyValue(const QByteArray &key, const QByteArray &value) {
 	_nonDefaultValues[key] = value;
+	parseAndApplyValue(key, value);
+}
+
+void Instance::parseAndApplyValue(
+		const QByteArray &key,
+		const QByteArray &value) {
 	ParseKeyValue(key, value, [&](ushort key, QString &&value) {
 		_nonDefaultSet[key] = 1;
 		if (!_derived) {
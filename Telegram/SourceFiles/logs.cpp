@@ -11,6 +11,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_reports.h"
 #include "core/launcher.h"
 
+#include <thread>
+#include <condition_variable>
+
 namespace {
 
 std::atomic<int> ThreadCounter/* = 0*/;
@@ -65,6 +68,16 @@ public:
 		for (int32 i = 0; i < LogDataCount; ++i) {
 			files[i].reset(new QFile());
 		}
+		_writer = std::thread([=] { writerLoop(); });
+	}
+
+	~LogsDataFields() {
+		{
+			std::unique_lock<std::mutex> lock(_queueMutex);
+			_finishing = true;
+		}
+		_queueChanged.notify_one();
+		_writer.join();
 	}
 
 	bool openMain() {
@@ -97,10 +110,17 @@ public:
 	}
 
 	void write(LogDataType type, const QString &msg) {
-		QMutexLocker lock(_logsMutex(type));
 		if (type != LogDataMain) {
-			reopenDebug();
+			// Debug logs are written and flushed in batches by the
+			// writer thread, so that the callers don't wait for the disk.
+			{
+				std::unique_lock<std::mutex> lock(_queueMutex);
+				_queue.emplace_back(type, msg);
+			}
+			_queueChanged.notify_one();
+			return;
 		}
+		QMutexLocker lock(_logsMutex(type));
 		const auto file = files[type].get();
 		if (!file || !file->isOpen()) {
 			return;
@@ -110,8 +130,51 @@ public:
 	}
 
 private:
+	void writerLoop() {
+		auto batch = std::vector<std::pair<LogDataType, QString>>();
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(_queueMutex);
+				_queueChanged.wait(lock, [&] {
+					return _finishing || !_queue.empty();
+				});
+				if (_queue.empty()) {
+					return;
+				}
+				std::swap(batch, _queue);
+			}
+			writeBatch(batch);
+			batch.clear();
+		}
+	}
+
+	void writeBatch(const std::vector<std::pair<LogDataType, QString>> &batch) {
+		bool written[LogDataCount] = { false };
+		for (const auto &[type, msg] : batch) {
+			QMutexLocker lock(_logsMutex(type));
+			reopenDebug();
+			const auto file = files[type].get();
+			if (file && file->isOpen()) {
+				file->write(msg.toUtf8());
+				written[type] = true;
+			}
+		}
+		for (auto type = 0; type != LogDataCount; ++type) {
+			if (written[type]) {
+				QMutexLocker lock(_logsMutex(LogDataType(type)));
+				files[type]->flush();
+			}
+		}
+	}
+
 	std::unique_ptr<QFile> files[LogDataCount];
 
+	std::thread _writer;
+	std::mutex _queueMutex;
+	std::condition_variable _queueChanged;
+	std::vector<std::pair<LogDataType, QString>> _queue;
+	bool _finishing = false;
+
 	int32 part = -1;
 
 	bool reopen(LogDataType type, int32 dayIndex, const QString &postfix) {
@@ -9,9 +9,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "core/application.h"
 #include "core/shortcuts.h"
+#include "core/startup_trace.h"
 #include "main/main_account.h"
 #include "main/main_session.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "mtproto/mtproto_config.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "storage/storage_domain.h"
@@ -36,6 +38,7 @@ bool Domain::started() const {
 Storage::StartResult Domain::start(const QByteArray &passcode) {
 	Expects(!started());
 
+	STARTUP_TRACE_SPAN("Main::Domain::start");
 	const auto result = _local->start(passcode);
 	if (result == Storage::StartResult::Success) {
 		activateAfterStarting();
@@ -179,17 +182,25 @@ void Domain::notifyUnreadBadgeChanged() {
 }
 
 void Domain::updateUnreadBadge() {
-	_unreadBadge = 0;
-	_unreadBadgeMuted = true;
+	auto badge = 0;
+	auto muted = true;
 	for (const auto &[index, account] : _accounts) {
 		if (const auto session = account->maybeSession()) {
 			const auto data = &session->data();
-			_unreadBadge += data->unreadBadge();
+			badge += data->unreadBadge();
 			if (!data->unreadBadgeMuted()) {
-				_unreadBadgeMuted = false;
+				muted = false;
 			}
 		}
 	}
+
+	// Most of the unread state changes leave the badge as it was,
+	// no need to repaint the window title and the tray icon then.
+	if (_unreadBadge == badge && _unreadBadgeMuted == muted) {
+		return;
+	}
+	_unreadBadge = badge;
+	_unreadBadgeMuted = muted;
 	_unreadBadgeChanges.fire({});
 }
 
@@ -344,9 +355,16 @@ void Domain::activate(not_null<Main::Account*> account) {
 	auto wasAuthed = false;
 
 	_activeLifetime.destroy();
-	if (_active.current()) {
+	if (const auto was = _active.current()) {
 		_lastActiveIndex = _accountToActivate;
-		wasAuthed = _active.current()->sessionExists();
+		wasAuthed = was->sessionExists();
+		if (wasAuthed) {
+			crl::on_main(&was->session(), [=] {
+				if (_active.current() != was) {
+					was->session().data().histories().unloadHidden();
+				}
+			});
+		}
 	}
 	_accountToActivate = i->index;
 	_active = account.get();
@@ -792,17 +792,40 @@ void MainWidget::cacheBackground() {
 		_cachedX = 0;
 		_cachedY = 0;
 		_cachedBackground = App::pixmapFromImageInPlace(std::move(result));
+		_cachedFor = _willCacheFor;
 	} else {
 		auto &bg = Window::Theme::Background()->pixmap();
 
 		QRect to, from;
 		Window::Theme::ComputeBackgroundRects(_willCacheFor, bg.size(), to, from);
-		_cachedX = to.x();
-		_cachedY = to.y();
-		_cachedBackground = App::pixmapFromImageInPlace(bg.toImage().copy(from).scaled(to.width() * cIntRetinaFactor(), to.height() * cIntRetinaFactor(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-		_cachedBackground.setDevicePixelRatio(cRetinaFactor());
+
+		// Smooth scaling of a large wallpaper takes a while,
+		// so it is done in the background not to block the window.
+		auto image = bg.toImage().copy(from);
+		const auto forRect = _willCacheFor;
+		const auto size = to.size() * cIntRetinaFactor();
+		crl::async([
+			=,
+			image = std::move(image),
+			guard = _cacheBackgroundGuard.make_guard()
+		]() mutable {
+			auto scaled = image.scaled(
+				size,
+				Qt::IgnoreAspectRatio,
+				Qt::SmoothTransformation);
+			crl::on_main(std::move(guard), [
+				=,
+				scaled = std::move(scaled)
+			]() mutable {
+				_cachedX = to.x();
+				_cachedY = to.y();
+				_cachedBackground = App::pixmapFromImageInPlace(
+					std::move(scaled));
+				_cachedBackground.setDevicePixelRatio(cRetinaFactor());
+				_cachedFor = forRect;
+			});
+		});
 	}
-	_cachedFor = _willCacheFor;
 }
 
 crl::time MainWidget::highlightStartTime(not_null<const HistoryItem*> item) const {
@@ -1100,6 +1123,7 @@ void MainWidget::dialogsCancelled() {
 void MainWidget::clearCachedBackground() {
 	_cachedBackground = QPixmap();
 	_cacheBackgroundTimer.cancel();
+	_cacheBackgroundGuard = base::binary_guard();
 	update();
 }
 
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/timer.h"
 #include "base/weak_ptr.h"
+#include "base/binary_guard.h"
 #include "ui/rp_widget.h"
 #include "ui/effects/animations.h"
 #include "media/player/media_player_float.h"
@@ -398,6 +399,7 @@ private:
 	int _cachedX = 0;
 	int _cachedY = 0;
 	base::Timer _cacheBackgroundTimer;
+	base::binary_guard _cacheBackgroundGuard;
 
 	PhotoData *_deletingPhoto = nullptr;
 
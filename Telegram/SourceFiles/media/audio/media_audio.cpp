@@ -1674,14 +1674,9 @@ public:
 
 		auto fmt = format();
 		auto peak = uint16(0);
-		auto callback = [&](uint16 sample) {
-			accumulate_max(peak, sample);
-			sumbytes += Media::Player::kWaveformSamplesCount;
-			if (sumbytes >= countbytes) {
-				sumbytes -= countbytes;
-				peaks.push_back(peak);
-				peak = 0;
-			}
+		const auto step = int64(Media::Player::kWaveformSamplesCount);
+		auto callback = [&](uint16 value) {
+			peaks.push_back(value);
 		};
 		while (processed < countbytes) {
 			buffer.resize(0);
@@ -1697,9 +1692,21 @@ public:
 
 			auto sampleBytes = bytes::make_span(buffer);
 			if (fmt == AL_FORMAT_MONO8 || fmt == AL_FORMAT_STEREO8) {
-				Media::Audio::IterateSamples<uchar>(sampleBytes, callback);
+				Media::Audio::IteratePeaks<uchar>(
+					sampleBytes,
+					step,
+					countbytes,
+					sumbytes,
+					peak,
+					callback);
 			} else if (fmt == AL_FORMAT_MONO16 || fmt == AL_FORMAT_STEREO16) {
-				Media::Audio::IterateSamples<int16>(sampleBytes, callback);
+				Media::Audio::IteratePeaks<int16>(
+					sampleBytes,
+					step,
+					countbytes,
+					sumbytes,
+					peak,
+					callback);
 			}
 			processed += sampleSize() * samples;
 		}
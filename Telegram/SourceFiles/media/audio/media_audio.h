@@ -395,5 +395,44 @@ void IterateSamples(bytes::const_span bytes, Callback &&callback) {
 	}
 }
 
+// A plain loop without side effects, so that compilers vectorize it.
+template <typename SampleType>
+[[nodiscard]] uint16 MaxSampleValue(gsl::span<const SampleType> samples) {
+	auto result = uint16(0);
+	for (const auto sample : samples) {
+		result = std::max(result, ReadOneSample(sample));
+	}
+	return result;
+}
+
+// Each sample adds 'step' to 'sum', when 'sum' reaches 'limit' the peak
+// of the samples so far is passed to the callback and a new one starts.
+// 'sum' and 'peak' keep the unfinished peak between the calls.
+template <typename SampleType, typename Callback>
+void IteratePeaks(
+		bytes::const_span bytes,
+		int64 step,
+		int64 limit,
+		int64 &sum,
+		uint16 &peak,
+		Callback &&callback) {
+	Expects(step > 0 && step <= limit);
+
+	auto samples = gsl::make_span(
+		reinterpret_cast<const SampleType*>(bytes.data()),
+		bytes.size() / sizeof(SampleType));
+	while (!samples.empty()) {
+		const auto tillLimit = (limit - sum + step - 1) / step;
+		const auto count = std::min(int64(samples.size()), tillLimit);
+		accumulate_max(peak, MaxSampleValue(samples.subspan(0, count)));
+		samples = samples.subspan(count);
+		sum += count * step;
+		if (sum >= limit) {
+			sum -= limit;
+			callback(std::exchange(peak, uint16(0)));
+		}
+	}
+}
+
 } // namespace Audio
 } // namespace Media
@@ -567,17 +567,13 @@ void Instance::Inner::processFrame(int32 offset, int32 framesize) {
 	}
 
 	d->waveform.reserve(d->waveform.size() + (samplesCnt / d->waveformEach) + 1);
-	for (short *ptr = srcSamplesDataChannel, *end = ptr + samplesCnt; ptr != end; ++ptr) {
-		uint16 value = qAbs(*ptr);
-		if (d->waveformPeak < value) {
-			d->waveformPeak = value;
-		}
-		if (++d->waveformMod == d->waveformEach) {
-			d->waveformMod -= d->waveformEach;
-			d->waveform.push_back(uchar(d->waveformPeak / 256));
-			d->waveformPeak = 0;
-		}
-	}
+	Audio::IteratePeaks<int16>(
+		bytes::make_span(_captured).subspan(offset, framesize),
+		1,
+		d->waveformEach,
+		d->waveformMod,
+		d->waveformPeak,
+		[&](uint16 value) { d->waveform.push_back(uchar(value / 256)); });
 
 	// Convert to final format
 
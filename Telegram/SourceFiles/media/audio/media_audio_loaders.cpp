@@ -17,6 +17,9 @@ namespace {
 
 constexpr auto kPlaybackBufferSize = 256 * 1024;
 
+// The last decoded frame usually ends past the playback buffer size.
+constexpr auto kPlaybackBufferReserve = kPlaybackBufferSize + 64 * 1024;
+
 } // namespace
 
 Loaders::Loaders(QThread *thread)
@@ -171,6 +174,9 @@ void Loaders::loadData(AudioMsgId audio, crl::time positionMs) {
 	if (l->holdsSavedDecodedSamples()) {
 		l->takeSavedDecodedSamples(&samples, &samplesCount);
 	}
+
+	// Decoded frames are appended one by one, allocate the buffer once.
+	samples.reserve(kPlaybackBufferReserve);
 	while (samples.size() < kPlaybackBufferSize) {
 		auto res = l->readMore(samples, samplesCount);
 		using Result = AudioPlayerLoader::ReadResult;
@@ -200,14 +206,11 @@ void Loaders::loadData(AudioMsgId audio, crl::time positionMs) {
 			}
 			break;
 		}
-
-		QMutexLocker lock(internal::audioPlayerMutex());
-		if (!checkLoader(type)) {
-			clear(type);
-			return;
-		}
 	}
 
+	// The track is checked only once after decoding a whole buffer, so
+	// the decoding doesn't compete with the mixer for the player mutex.
+	// The loader itself is changed only in this thread.
 	QMutexLocker lock(internal::audioPlayerMutex());
 	auto track = checkLoader(type);
 	if (!track) {
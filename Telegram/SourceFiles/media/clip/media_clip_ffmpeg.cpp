@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/audio/media_child_ffmpeg_loader.h"
 #include "storage/file_download.h"
 
+#include <atomic>
+
 namespace Media {
 namespace Clip {
 namespace internal {
@@ -19,6 +21,10 @@ namespace {
 constexpr auto kSkipInvalidDataPackets = 10;
 constexpr auto kMaxInlineArea = 1280 * 720;
 constexpr auto kMaxSendingArea = 3840 * 2160; // usual 4K
+constexpr auto kMaxCacheBytes = int64(64 * 1024 * 1024);
+
+// Cached frames of all the clips, the readers work in several threads.
+std::atomic<int64> CacheBytes = 0;
 
 // See https://github.com/telegramdesktop/tdesktop/issues/7225
 constexpr auto kAlignImageBy = 64;
@@ -58,6 +64,16 @@ FFMpegReaderImplementation::FFMpegReaderImplementation(
 }
 
 ReaderImplementation::ReadResult FFMpegReaderImplementation::readNextFrame() {
+	if (_cacheIndex >= 0) {
+		if (++_cacheIndex < int(_cache.size())) {
+			processCachedFrame();
+			return ReadResult::Success;
+		} else if (replayCachedFrames()) {
+			return ReadResult::Success;
+		}
+		// The cache went stale, the decoder is still at the end of file,
+		// so it will seek to the start below.
+	}
 	do {
 		int res = avcodec_receive_frame(_codecContext, _frame.get());
 		if (res >= 0) {
@@ -79,6 +95,8 @@ ReaderImplementation::ReadResult FFMpegReaderImplementation::readNextFrame() {
 			if (!_hadFrame) {
 				LOG(("Gif Error: Got EOF before a single frame was read!"));
 				return ReadResult::Error;
+			} else if (replayCachedFrames()) {
+				return ReadResult::Success;
 			}
 
 			if ((res = avformat_seek_file(_fmtContext, _streamId, std::numeric_limits<int64_t>::min(), 0, std::numeric_limits<int64_t>::max(), 0)) < 0) {
@@ -152,6 +170,23 @@ void FFMpegReaderImplementation::processReadFrame() {
 	int64 duration = _frame->pkt_duration;
 	int64 framePts = _frame->pts;
 	crl::time frameMs = (framePts * 1000LL * _fmtContext->streams[_streamId]->time_base.num) / _fmtContext->streams[_streamId]->time_base.den;
+	const auto durationMs = (duration == AV_NOPTS_VALUE)
+		? 0
+		: int((duration * 1000LL * _fmtContext->streams[_streamId]->time_base.num) / _fmtContext->streams[_streamId]->time_base.den);
+	if (_mode == Mode::Silent && !_cacheDisabled && !_cacheStale) {
+		if (_frameRead) {
+			// The previous frame was skipped without rendering.
+			_cacheStale = true;
+		} else {
+			_cache.push_back({ QImage(), false, frameMs, durationMs });
+		}
+	}
+	processFrameTiming(frameMs, durationMs);
+}
+
+void FFMpegReaderImplementation::processFrameTiming(
+		crl::time frameMs,
+		int durationMs) {
 	_currentFrameDelay = _nextFrameDelay;
 	if (_frameMs + _currentFrameDelay < frameMs) {
 		_currentFrameDelay = int32(frameMs - _frameMs);
@@ -159,11 +194,7 @@ void FFMpegReaderImplementation::processReadFrame() {
 		frameMs = _frameMs + _currentFrameDelay;
 	}
 
-	if (duration == AV_NOPTS_VALUE) {
-		_nextFrameDelay = 0;
-	} else {
-		_nextFrameDelay = (duration * 1000LL * _fmtContext->streams[_streamId]->time_base.num) / _fmtContext->streams[_streamId]->time_base.den;
-	}
+	_nextFrameDelay = durationMs;
 	_frameMs = frameMs;
 
 	_hadFrame = _frameRead = true;
@@ -224,10 +255,99 @@ crl::time FFMpegReaderImplementation::durationMs() const {
 	return (_fmtContext->streams[_streamId]->duration * 1000LL * _fmtContext->streams[_streamId]->time_base.num) / _fmtContext->streams[_streamId]->time_base.den;
 }
 
+void FFMpegReaderImplementation::cacheRenderedFrame(
+		const QImage &image,
+		bool hasAlpha) {
+	if (_mode != Mode::Silent
+		|| _cacheDisabled
+		|| _cacheStale
+		|| _cache.empty()) {
+		return;
+	}
+	auto &last = _cache.back();
+	if (!last.image.isNull()) {
+		return;
+	} else if (_cache.front().image.isNull()
+		? (_cache.size() > 1)
+		: (_cache.front().image.size() != image.size())) {
+		_cacheStale = true;
+		return;
+	}
+	const auto bytes = image.bytesPerLine() * int64(image.height());
+	_cacheBytes += bytes;
+	if (CacheBytes.fetch_add(bytes) + bytes > kMaxCacheBytes) {
+		_cacheDisabled = true;
+		clearCache();
+		_cache = std::vector<CachedFrame>();
+		return;
+	}
+	last.image = image;
+	last.alpha = hasAlpha;
+}
+
+bool FFMpegReaderImplementation::replayCachedFrames() {
+	const auto complete = !_cacheDisabled
+		&& !_cacheStale
+		&& !_cache.empty()
+		&& ranges::none_of(_cache, [](const CachedFrame &frame) {
+			return frame.image.isNull();
+		});
+	if (!complete) {
+		_cacheIndex = -1;
+		_cacheStale = false;
+		clearCache();
+		return false;
+	}
+	_frameMs = 0;
+	_cacheIndex = 0;
+	processCachedFrame();
+	return true;
+}
+
+void FFMpegReaderImplementation::clearCache() {
+	CacheBytes -= base::take(_cacheBytes);
+	_cache.clear();
+}
+
+void FFMpegReaderImplementation::processCachedFrame() {
+	Expects(_cacheIndex >= 0 && _cacheIndex < int(_cache.size()));
+
+	const auto &frame = _cache[_cacheIndex];
+	processFrameTiming(frame.frameMs, frame.durationMs);
+}
+
+bool FFMpegReaderImplementation::renderCachedFrame(
+		QImage &to,
+		bool &hasAlpha,
+		const QSize &size) {
+	auto &frame = _cache[_cacheIndex];
+	hasAlpha = frame.alpha;
+	if (size.isEmpty() || frame.image.size() != size) {
+		// Decode the clip again starting from the next loop.
+		_cacheStale = true;
+		to = frame.image.scaled(
+			size.isEmpty() ? frame.image.size() : size,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		return true;
+	}
+	// Don't let the reader detach the frame when setting the pixel ratio.
+	if (!to.isNull()
+		&& frame.image.devicePixelRatio() != to.devicePixelRatio()) {
+		frame.image.setDevicePixelRatio(to.devicePixelRatio());
+	}
+	to = frame.image;
+	return true;
+}
+
 bool FFMpegReaderImplementation::renderFrame(QImage &to, bool &hasAlpha, const QSize &size) {
 	Expects(_frameRead);
 	_frameRead = false;
 
+	if (_cacheIndex >= 0) {
+		return renderCachedFrame(to, hasAlpha, size);
+	}
+
 	if (!_width || !_height) {
 		_width = _frame->width;
 		_height = _frame->height;
@@ -290,6 +410,8 @@ bool FFMpegReaderImplementation::renderFrame(QImage &to, bool &hasAlpha, const Q
 
 	FFmpeg::ClearFrameMemory(_frame.get());
 
+	cacheRenderedFrame(to, hasAlpha);
+
 	return true;
 }
 
@@ -408,6 +530,9 @@ bool FFMpegReaderImplementation::start(Mode mode, crl::time &positionMs) {
 		}
 	}
 	if (positionMs > 0) {
+		// The first loop is not complete, don't replay it.
+		_cacheStale = true;
+
 		const auto timeBase = _fmtContext->streams[_streamId]->time_base;
 		const auto timeStamp = (positionMs * timeBase.den)
 			/ (1000LL * timeBase.num);
@@ -480,6 +605,7 @@ QString FFMpegReaderImplementation::logData() const {
 }
 
 FFMpegReaderImplementation::~FFMpegReaderImplementation() {
+	clearCache();
 	if (_codecContext) avcodec_free_context(&_codecContext);
 	if (_swsContext) sws_freeContext(_swsContext);
 	if (_opened) {
@@ -49,6 +49,16 @@ public:
 private:
 	ReadResult readNextFrame();
 	void processReadFrame();
+	void processFrameTiming(crl::time frameMs, int durationMs);
+
+	void cacheRenderedFrame(const QImage &image, bool hasAlpha);
+	[[nodiscard]] bool replayCachedFrames();
+	void clearCache();
+	void processCachedFrame();
+	[[nodiscard]] bool renderCachedFrame(
+		QImage &to,
+		bool &hasAlpha,
+		const QSize &size);
 
 	enum class PacketResult {
 		Ok,
@@ -109,6 +119,20 @@ private:
 	crl::time _frameTime = 0;
 	crl::time _frameTimeCorrection = 0;
 
+	// Rendered frames of a silent looping clip, replayed after the first
+	// complete loop instead of decoding the clip again.
+	struct CachedFrame {
+		QImage image;
+		bool alpha = false;
+		crl::time frameMs = 0;
+		int durationMs = 0;
+	};
+	std::vector<CachedFrame> _cache;
+	int64 _cacheBytes = 0;
+	int _cacheIndex = -1;
+	bool _cacheStale = false;
+	bool _cacheDisabled = false;
+
 };
 
 } // namespace internal
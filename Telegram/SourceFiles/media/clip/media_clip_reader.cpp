@@ -563,6 +563,14 @@ public:
 		_accessed = false;
 	}
 
+	int32 loadLevel() const {
+		// Auto paused GIFs are not decoded, so they don't load the thread.
+		if (_autoPausedGif) {
+			return 0;
+		}
+		return (_width > 0) ? (_width * _height) : AverageGifSize;
+	}
+
 	~ReaderPrivate() {
 		stop(Player::State::Stopped);
 		_data.clear();
@@ -608,6 +616,7 @@ private:
 	crl::time _nextFramePositionMs = 0;
 
 	bool _autoPausedGif = false;
+	bool _visible = true;
 	bool _started = false;
 	crl::time _videoPausedAtMs = 0;
 
@@ -711,8 +720,10 @@ bool Manager::handleProcessResult(ReaderPrivate *reader, ProcessResult result, c
 		int32 ishowing, iprevious;
 		auto showing = it.key()->frameToShow(&ishowing), previous = it.key()->frameToWriteNext(false, &iprevious);
 		Assert(previous != nullptr && showing != nullptr && ishowing >= 0 && iprevious >= 0);
-		if (reader->_frames[ishowing].when > 0 && showing->displayed.loadAcquire() <= 0) { // current frame was not shown
+		reader->_visible = (showing->displayed.loadAcquire() > 0);
+		if (reader->_frames[ishowing].when > 0 && !reader->_visible) { // current frame was not shown
 			if (reader->_frames[ishowing].when + WaitBeforeGifPause < ms || (reader->_frames[iprevious].when && previous->displayed.loadAcquire() <= 0)) {
+				_loadLevel.fetchAndAddRelaxed(-reader->loadLevel());
 				reader->_autoPausedGif = true;
 				it.key()->_autoPausedGif.storeRelease(1);
 				result = ProcessResult::Paused;
@@ -744,7 +755,7 @@ bool Manager::handleProcessResult(ReaderPrivate *reader, ProcessResult result, c
 
 Manager::ResultHandleState Manager::handleResult(ReaderPrivate *reader, ProcessResult result, crl::time ms) {
 	if (!handleProcessResult(reader, result, ms)) {
-		_loadLevel.fetchAndAddRelaxed(-1 * (reader->_width > 0 ? reader->_width * reader->_height : AverageGifSize));
+		_loadLevel.fetchAndAddRelaxed(-reader->loadLevel());
 		delete reader;
 		return ResultHandleRemove;
 	}
@@ -798,6 +809,8 @@ void Manager::process() {
 					i.value() = ms;
 					if (i.key()->_autoPausedGif && !it.key()->_autoPausedGif.loadAcquire()) {
 						i.key()->_autoPausedGif = false;
+						i.key()->_visible = true;
+						_loadLevel.fetchAndAddRelaxed(i.key()->loadLevel());
 					}
 					if (it.key()->_videoPauseRequest.loadAcquire()) {
 						i.key()->pauseVideo(ms);
@@ -813,39 +826,52 @@ void Manager::process() {
 		checkAllReaders = (_readers.size() > _readerPointers.size());
 	}
 
+	auto due = std::vector<ReaderPrivate*>();
 	for (auto i = _readers.begin(), e = _readers.end(); i != e;) {
 		ReaderPrivate *reader = i.key();
 		if (i.value() <= ms) {
-			ResultHandleState state = handleResult(reader, reader->process(ms), ms);
-			if (state == ResultHandleRemove) {
-				i = _readers.erase(i);
-				continue;
-			} else if (state == ResultHandleStop) {
-				_processingInThread = nullptr;
-				return;
-			}
-			ms = crl::now();
-			if (reader->_videoPausedAtMs) {
-				i.value() = ms + 86400 * 1000ULL;
-			} else if (reader->_nextFrameWhen && reader->_started) {
-				i.value() = reader->_nextFrameWhen;
-			} else {
-				i.value() = (ms + 86400 * 1000ULL);
-			}
+			due.push_back(reader);
 		} else if (checkAllReaders) {
 			QMutexLocker lock(&_readerPointersMutex);
 			auto it = constUnsafeFindReaderPointer(reader);
 			if (it == _readerPointers.cend()) {
-				_loadLevel.fetchAndAddRelaxed(-1 * (reader->_width > 0 ? reader->_width * reader->_height : AverageGifSize));
+				_loadLevel.fetchAndAddRelaxed(-reader->loadLevel());
 				delete reader;
 				i = _readers.erase(i);
 				continue;
 			}
 		}
-		if (!reader->_autoPausedGif && i.value() < minms) {
+		++i;
+	}
+
+	// Decode the frames of readers on the screen first, so that they don't
+	// wait for the ones that were scrolled away and will be paused soon.
+	ranges::stable_partition(due, [](not_null<ReaderPrivate*> reader) {
+		return reader->_visible;
+	});
+	for (const auto reader : due) {
+		const auto i = _readers.find(reader);
+		const auto state = handleResult(reader, reader->process(ms), ms);
+		if (state == ResultHandleRemove) {
+			_readers.erase(i);
+			continue;
+		} else if (state == ResultHandleStop) {
+			_processingInThread = nullptr;
+			return;
+		}
+		ms = crl::now();
+		if (reader->_videoPausedAtMs) {
+			i.value() = ms + 86400 * 1000ULL;
+		} else if (reader->_nextFrameWhen && reader->_started) {
+			i.value() = reader->_nextFrameWhen;
+		} else {
+			i.value() = (ms + 86400 * 1000ULL);
+		}
+	}
+	for (auto i = _readers.cbegin(), e = _readers.cend(); i != e; ++i) {
+		if (!i.key()->_autoPausedGif && i.value() < minms) {
 			minms = i.value();
 		}
-		++i;
 	}
 
 	ms = crl::now();
@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/audio/media_audio_capture.h"
 #include "media/streaming/media_streaming_instance.h"
 #include "media/streaming/media_streaming_player.h"
+#include "media/streaming/media_streaming_reader.h"
 #include "media/view/media_view_playback_progress.h"
 #include "calls/calls_instance.h"
 #include "history/history.h"
@@ -45,6 +46,9 @@ constexpr auto kIdsPreloadAfter = 28;
 
 constexpr auto kMinLengthForSavePosition = 20 * TimeId(60); // 20 minutes.
 
+// Start loading the next song if the current one ends in less than that.
+constexpr auto kPreloadNextTrackBefore = 20 * crl::time(1000);
+
 } // namespace
 
 struct Instance::Streamed {
@@ -225,6 +229,8 @@ void Instance::clearStreamed(not_null<Data*> data, bool savePosition) {
 	requestRoundVideoResize();
 	emitUpdate(data->type);
 	data->streamed = nullptr;
+	data->nextDocument = nullptr;
+	data->nextReader = nullptr;
 
 	_roundPlaying = false;
 	if (const auto window = App::wnd()) {
@@ -365,6 +371,38 @@ bool Instance::moveInPlaylist(
 	return false;
 }
 
+void Instance::preloadNextTrack(
+		not_null<Data*> data,
+		const TrackState &state) {
+	if (data->type != AudioMsgId::Type::Song
+		|| data->repeatEnabled
+		|| !data->playlistIndex
+		|| state.state != State::Playing
+		|| state.length <= 0
+		|| state.frequency <= 0
+		|| ((state.length - state.position) * crl::time(1000)
+			> kPreloadNextTrackBefore * state.frequency)) {
+		return;
+	}
+	const auto item = itemByIndex(data, *data->playlistIndex + 1);
+	const auto media = item ? item->media() : nullptr;
+	const auto document = media ? media->document() : nullptr;
+	if (!document
+		|| !document->isAudioFile()
+		|| document == data->current.audio()) {
+		return;
+	} else if (data->nextDocument != document) {
+		data->nextDocument = document;
+		data->nextReader = document->owner().streaming().sharedReader(
+			document,
+			item->fullId());
+	}
+	if (data->nextReader) {
+		// Called on each update, waits for the cache to be checked.
+		data->nextReader->prefetchStart();
+	}
+}
+
 bool Instance::previousAvailable(AudioMsgId::Type type) const {
 	const auto data = getData(type);
 	Assert(data != nullptr);
@@ -690,6 +728,7 @@ void Instance::emitUpdate(AudioMsgId::Type type, CheckCallback check) {
 			}
 		}
 		_updatedNotifier.fire_copy({state});
+		preloadNextTrack(data, state);
 		if (data->isPlaying && state.state == State::StoppedAtEnd) {
 			if (data->repeatEnabled) {
 				play(data->current);
@@ -28,6 +28,7 @@ namespace Media {
 namespace Streaming {
 class Document;
 class Instance;
+class Reader;
 struct PlaybackOptions;
 struct Update;
 enum class Error;
@@ -190,6 +191,8 @@ private:
 		bool isPlaying = false;
 		bool resumeOnCallEnd = false;
 		std::unique_ptr<Streamed> streamed;
+		DocumentData *nextDocument = nullptr;
+		std::shared_ptr<Streaming::Reader> nextReader;
 	};
 
 	Instance();
@@ -220,6 +223,7 @@ private:
 	void playlistUpdated(not_null<Data*> data);
 	bool moveInPlaylist(not_null<Data*> data, int delta, bool autonext);
 	HistoryItem *itemByIndex(not_null<Data*> data, int index);
+	void preloadNextTrack(not_null<Data*> data, const TrackState &state);
 
 	void handleStreamingUpdate(
 		not_null<Data*> data,
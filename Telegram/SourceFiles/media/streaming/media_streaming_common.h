@@ -45,6 +45,7 @@ struct PlaybackOptions {
 	bool syncVideoByAudio = true;
 	bool waitForMarkAsShown = false;
 	bool loop = false;
+	bool hwAllowed = false;
 };
 
 struct TrackState {
@@ -231,7 +231,8 @@ void Document::validateGoodThumbnail() {
 					Qt::IgnoreAspectRatio,
 					Qt::SmoothTransformation);
 			}
-			return result;
+			return Data::DocumentMedia::ScaleVideoGoodThumbnail(
+				std::move(result));
 		}();
 		auto bytes = QByteArray();
 		{
@@ -17,6 +17,8 @@ namespace {
 
 constexpr auto kMaxSingleReadAmount = 8 * 1024 * 1024;
 constexpr auto kMaxQueuedPackets = 1024;
+constexpr auto kPrefetchKeyframesAhead = 4;
+constexpr auto kPrefetchKeyframesBehind = 1;
 
 } // namespace
 
@@ -133,7 +135,8 @@ void File::Context::logFatal(
 
 Stream File::Context::initStream(
 		not_null<AVFormatContext*> format,
-		AVMediaType type) {
+		AVMediaType type,
+		bool hwAllowed) {
 	auto result = Stream();
 	const auto index = result.index = av_find_best_stream(
 		format,
@@ -157,7 +160,9 @@ Stream File::Context::initStream(
 		}
 	}
 
-	result.codec = FFmpeg::MakeCodecPointer(info);
+	result.codec = FFmpeg::MakeCodecPointer(
+		info,
+		hwAllowed && (type == AVMEDIA_TYPE_VIDEO));
 	if (!result.codec) {
 		if (info->codecpar->codec_id == AV_CODEC_ID_MJPEG) {
 			// mp3 files contain such "video stream", just ignore it.
@@ -219,7 +224,10 @@ void File::Context::seekToPosition(
 		format,
 		stream.index,
 		FFmpeg::TimeToPts(
-			std::clamp(position, crl::time(0), stream.duration - 1),
+			std::clamp(
+				position,
+				crl::time(0),
+				std::max(stream.duration - 1, crl::time(0))),
 			stream.timeBase),
 		AVSEEK_FLAG_BACKWARD);
 	if (!error) {
@@ -228,6 +236,54 @@ void File::Context::seekToPosition(
 	return logFatal(qstr("av_seek_frame"), error);
 }
 
+void File::Context::prefetchKeyframes(
+		not_null<AVFormatContext*> format,
+		const Stream &stream,
+		crl::time position) {
+	if (!_reader->isRemoteLoader()
+		|| stream.duration == kDurationUnavailable) {
+		return;
+	}
+	const auto info = format->streams[stream.index];
+	const auto count = info->nb_index_entries;
+	if (count <= 0) {
+		return;
+	}
+	const auto found = av_index_search_timestamp(
+		info,
+		FFmpeg::TimeToPts(
+			std::clamp(
+				position,
+				crl::time(0),
+				std::max(stream.duration - 1, crl::time(0))),
+			stream.timeBase),
+		AVSEEK_FLAG_BACKWARD);
+	const auto current = std::max(found, 0);
+
+	// The keyframe we've seeked to is read right now anyway,
+	// so we prefetch the neighbour keyframes for the next seek.
+	auto offsets = std::vector<int>();
+	const auto collect = [&](int from, int delta, int limit) {
+		auto collected = 0;
+		for (auto i = from; i >= 0 && i < count; i += delta) {
+			const auto &entry = info->index_entries[i];
+			if ((entry.flags & AVINDEX_KEYFRAME)
+				&& entry.pos >= 0
+				&& entry.pos < _size) {
+				offsets.push_back(int(entry.pos));
+				if (++collected == limit) {
+					break;
+				}
+			}
+		}
+	};
+	collect(current + 1, 1, kPrefetchKeyframesAhead);
+	collect(current - 1, -1, kPrefetchKeyframesBehind);
+	if (!offsets.empty()) {
+		_reader->prefetchAround(offsets);
+	}
+}
+
 base::variant<FFmpeg::Packet, FFmpeg::AvErrorWrap> File::Context::readPacket() {
 	auto error = FFmpeg::AvErrorWrap();
 
@@ -243,7 +299,7 @@ base::variant<FFmpeg::Packet, FFmpeg::AvErrorWrap> File::Context::readPacket() {
 	return error;
 }
 
-void File::Context::start(crl::time position) {
+void File::Context::start(crl::time position, bool hwAllowed) {
 	auto error = FFmpeg::AvErrorWrap();
 
 	if (unroll()) {
@@ -262,12 +318,12 @@ void File::Context::start(crl::time position) {
 		return logFatal(qstr("avformat_find_stream_info"), error);
 	}
 
-	auto video = initStream(format.get(), AVMEDIA_TYPE_VIDEO);
+	auto video = initStream(format.get(), AVMEDIA_TYPE_VIDEO, hwAllowed);
 	if (unroll()) {
 		return;
 	}
 
-	auto audio = initStream(format.get(), AVMEDIA_TYPE_AUDIO);
+	auto audio = initStream(format.get(), AVMEDIA_TYPE_AUDIO, false);
 	if (unroll()) {
 		return;
 	}
@@ -282,6 +338,9 @@ void File::Context::start(crl::time position) {
 	if (unroll()) {
 		return;
 	}
+	if (video.codec) {
+		prefetchKeyframes(format.get(), video, position);
+	}
 
 	if (video.codec) {
 		_queuedPackets[video.index].reserve(kMaxQueuedPackets);
@@ -407,13 +466,16 @@ File::File(std::shared_ptr<Reader> reader)
 : _reader(std::move(reader)) {
 }
 
-void File::start(not_null<FileDelegate*> delegate, crl::time position) {
+void File::start(
+		not_null<FileDelegate*> delegate,
+		crl::time position,
+		bool hwAllowed) {
 	stop(true);
 
 	_reader->startStreaming();
 	_context.emplace(delegate, _reader.get());
 	_thread = std::thread([=, context = &*_context] {
-		context->start(position);
+		context->start(position, hwAllowed);
 		while (!context->finished()) {
 			context->readNextPacket();
 		}
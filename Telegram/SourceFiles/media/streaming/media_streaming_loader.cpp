@@ -41,6 +41,15 @@ bool PriorityQueue::add(int value) {
 	return false;
 }
 
+bool PriorityQueue::addLowPriority(int value) {
+	const auto i = ranges::find(_data, value, &Entry::value);
+	if (i != end(_data)) {
+		return false;
+	}
+	_data.insert({ value, _priority - 1 });
+	return true;
+}
+
 bool PriorityQueue::remove(int value) {
 	const auto i = ranges::find(_data, value, &Entry::value);
 	if (i == end(_data)) {
@@ -14,6 +14,8 @@ class StreamedFileDownloader;
 namespace Media {
 namespace Streaming {
 
+// Part bytes are implicitly shared between the loader, the reader, its
+// slices and the attached downloader, none of them modifies the bytes.
 struct LoadedPart {
 	int offset = 0;
 	QByteArray bytes;
@@ -31,6 +33,10 @@ public:
 	[[nodiscard]] virtual int size() const = 0;
 
 	virtual void load(int offset) = 0;
+
+	// Request a part after all the parts requested by load() so far.
+	virtual void prefetch(int offset) = 0;
+
 	virtual void cancel(int offset) = 0;
 	virtual void resetPriorities() = 0;
 	virtual void setPriority(int priority) = 0;
@@ -53,6 +59,7 @@ public:
 class PriorityQueue {
 public:
 	bool add(int value);
+	bool addLowPriority(int value);
 	bool remove(int value);
 	void resetPriorities();
 	[[nodiscard]] bool empty() const;
@@ -59,6 +59,9 @@ void LoaderLocal::load(int offset) {
 	});
 }
 
+void LoaderLocal::prefetch(int offset) {
+}
+
 void LoaderLocal::fail() {
 	crl::on_main(this, [=] {
 		_parts.fire({ LoadedPart::kFailedOffset });
@@ -24,6 +24,7 @@ public:
 	[[nodiscard]] int size() const override;
 
 	void load(int offset) override;
+	void prefetch(int offset) override;
 	void cancel(int offset) override;
 	void resetPriorities() override;
 	void setPriority(int priority) override;
@@ -56,6 +56,16 @@ void LoaderMtproto::load(int offset) {
 	});
 }
 
+void LoaderMtproto::prefetch(int offset) {
+	crl::on_main(this, [=] {
+		if (haveSentRequestForOffset(offset)) {
+			return;
+		} else if (_requested.addLowPriority(offset)) {
+			addToQueueWithPriority();
+		}
+	});
+}
+
 void LoaderMtproto::addToQueueWithPriority() {
 	addToQueue(_priority);
 }
@@ -19,6 +19,7 @@ namespace Streaming {
 namespace {
 
 constexpr auto kBufferFor = 3 * crl::time(1000);
+constexpr auto kBufferForMax = 24 * crl::time(1000);
 constexpr auto kLoadInAdvanceForRemote = 32 * crl::time(1000);
 constexpr auto kLoadInAdvanceForLocal = 5 * crl::time(1000);
 constexpr auto kMsFrequency = 1000; // 1000 ms per second.
@@ -27,6 +28,10 @@ constexpr auto kMsFrequency = 1000; // 1000 ms per second.
 // slower than we're playing, so load full file in that case.
 constexpr auto kLoadFullIfStuckAfterPlayback = 3 * crl::time(1000);
 
+// If we played that long without getting stuck the link got better,
+// so start again from the smallest buffer on the next stall.
+constexpr auto kResetBufferAfterPlayback = 60 * crl::time(1000);
+
 [[nodiscard]] bool FullTrackReceived(const TrackState &state) {
 	return (state.duration != kTimeUnknown)
 		&& (state.receivedTill == state.duration);
@@ -82,6 +87,7 @@ void SaveValidStartInformation(Information &to, Information &&from) {
 Player::Player(std::shared_ptr<Reader> reader)
 : _file(std::make_unique<File>(std::move(reader)))
 , _remoteLoader(_file->isRemoteLoader())
+, _bufferFor(kBufferFor)
 , _renderFrameTimer([=] { checkNextFrameRender(); }) {
 }
 
@@ -541,7 +547,7 @@ void Player::play(const PlaybackOptions &options) {
 		_options.speed = 1.;
 	}
 	_stage = Stage::Initializing;
-	_file->start(delegate(), _options.position);
+	_file->start(delegate(), _options.position, _options.hwAllowed);
 }
 
 void Player::savePreviousReceivedTill(
@@ -559,6 +565,21 @@ crl::time Player::loadInAdvanceFor() const {
 	return _remoteLoader ? kLoadInAdvanceForRemote : kLoadInAdvanceForLocal;
 }
 
+void Player::increaseBufferFor() {
+	// Each stall means we load slower than we play, so wait for more
+	// data before resuming, trading a longer pause for fewer of them.
+	const auto now = crl::now();
+	const auto played = (!_paused && _startedTime != kTimeUnknown)
+		? (now - _startedTime)
+		: 0;
+	_bufferFor = (played > kResetBufferAfterPlayback)
+		? kBufferFor
+		: std::min({
+			_bufferFor * 2,
+			kBufferForMax,
+			loadInAdvanceFor() });
+}
+
 crl::time Player::computeTotalDuration() const {
 	if (_totalDuration != kDurationUnavailable) {
 		return _totalDuration;
@@ -690,7 +711,7 @@ bool Player::receivedTillEnd() const {
 }
 
 void Player::checkResumeFromWaitingForData() {
-	if (_pausedByWaitingForData && bothReceivedEnough(kBufferFor)) {
+	if (_pausedByWaitingForData && bothReceivedEnough(_bufferFor)) {
 		_pausedByWaitingForData = false;
 		updatePausedState();
 		_updates.fire({ WaitingForData{ false } });
@@ -709,6 +730,7 @@ void Player::start() {
 	) | rpl::filter([=] {
 		return !bothReceivedEnough(kBufferFor);
 	}) | rpl::start_with_next([=] {
+		increaseBufferFor();
 		_pausedByWaitingForData = true;
 		updatePausedState();
 		_updates.fire({ WaitingForData{ true } });
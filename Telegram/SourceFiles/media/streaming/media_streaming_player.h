@@ -128,6 +128,7 @@ private:
 		const PlaybackOptions &options,
 		crl::time previousReceivedTill);
 	[[nodiscard]] crl::time loadInAdvanceFor() const;
+	void increaseBufferFor();
 
 	template <typename Track>
 	int durationByPacket(const Track &track, const FFmpeg::Packet &packet);
@@ -188,6 +189,7 @@ private:
 
 	crl::time _startedTime = kTimeUnknown;
 	crl::time _pausedTime = kTimeUnknown;
+	crl::time _bufferFor = 0;
 	crl::time _currentFrameTime = kTimeUnknown;
 	crl::time _nextFrameTime = kTimeUnknown;
 	base::Timer _renderFrameTimer;
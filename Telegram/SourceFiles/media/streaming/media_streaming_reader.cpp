@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_common.h"
 #include "media/streaming/media_streaming_loader.h"
 #include "storage/cache/storage_cache_database.h"
+#include "platform/platform_specific.h"
 
 namespace Media {
 namespace Streaming {
@@ -20,15 +21,35 @@ constexpr auto kPartsInSlice = 64;
 constexpr auto kInSlice = kPartsInSlice * kPartSize;
 constexpr auto kMaxPartsInHeader = 64;
 constexpr auto kMaxOnlyInHeader = 80 * kPartSize;
+constexpr auto kPrefetchStartParts = 8;
 constexpr auto kPartsOutsideFirstSliceGood = 8;
-constexpr auto kSlicesInMemory = 2;
+
+// Each reader may always keep at least this many slices in memory.
+// Beyond that the slices of all the readers share one memory limit.
+constexpr auto kSlicesInMemoryMin = 2;
+
+// The shared limit is a part of physical memory within these bounds.
+constexpr auto kPhysicalMemoryPartForSlices = 32;
+constexpr auto kSlicesMemoryLimitMin = int64(4 * kInSlice);
+constexpr auto kSlicesMemoryLimitMax = int64(64 * kInSlice);
+
+// Access count is halved on each eviction so old popularity fades away.
+constexpr auto kSliceAccessCountMax = 16;
 
 // 1 MB of parts are requested from cloud ahead of reading demand.
 constexpr auto kPreloadPartsAhead = 8;
+
+// 256 KB of parts are prefetched at each of the keyframes around seek.
+constexpr auto kPrefetchPartsAround = 2;
 constexpr auto kDownloaderRequestsLimit = 4;
 
 using PartsMap = base::flat_map<int, QByteArray>;
 
+std::atomic<int> SlicesInMemory = 0;
+std::atomic<int64> SlicesHits = 0;
+std::atomic<int64> SlicesMisses = 0;
+std::atomic<int64> SlicesEvictions = 0;
+
 struct ParsedCacheEntry {
 	PartsMap parts;
 	std::optional<PartsMap> included;
@@ -55,6 +76,18 @@ bool ComputeIsGoodHeader(int size, const PartsMap &header) {
 	return (outsideFirstSlice <= kPartsOutsideFirstSliceGood);
 }
 
+int SlicesInMemoryLimit() {
+	static const auto result = [] {
+		const auto physical = Platform::PhysicalMemorySize().value_or(0);
+		const auto limit = std::clamp(
+			physical / kPhysicalMemoryPartForSlices,
+			kSlicesMemoryLimitMin,
+			kSlicesMemoryLimitMax);
+		return int(limit / kInSlice);
+	}();
+	return result;
+}
+
 int SlicesCount(int size) {
 	return (size + kInSlice - 1) / kInSlice;
 }
@@ -346,6 +379,12 @@ Reader::Slices::Slices(int size, bool useCache)
 	}
 }
 
+Reader::Slices::~Slices() {
+	SlicesInMemory.fetch_sub(
+		int(_usedSlices.size()),
+		std::memory_order_relaxed);
+}
+
 bool Reader::Slices::headerModeUnknown() const {
 	return (_headerMode == HeaderMode::Unknown);
 }
@@ -410,9 +449,8 @@ void Reader::Slices::applyHeaderCacheData() {
 			if (!predicate(index)) {
 				break;
 			}
-			_data[index].addPart(
-				offset - index * kInSlice,
-				base::duplicate(part));
+			// Parts are never changed, so the slice shares the bytes.
+			_data[index].addPart(offset - index * kInSlice, part);
 		}
 	};
 	if (_header.parts.empty()) {
@@ -525,7 +563,7 @@ void Reader::Slices::processPart(
 	Expects(isFullInHeader() || (offset / kInSlice < _data.size()));
 
 	if (isFullInHeader()) {
-		_header.addPart(offset, bytes);
+		_header.addPart(offset, std::move(bytes));
 		checkSliceFullLoaded(0);
 		return;
 	} else if (_headerMode == HeaderMode::Unknown) {
@@ -621,11 +659,15 @@ auto Reader::Slices::fill(int offset, bytes::span buffer) -> FillResult {
 		}
 		result.toCache = serializeAndUnloadUnused();
 		result.state = FillState::Success;
+		SlicesHits.fetch_add(1, std::memory_order_relaxed);
 	} else {
 		handleReadFromCache(fromSlice);
 		if (fromSlice + 1 < tillSlice) {
 			handleReadFromCache(fromSlice + 1);
 		}
+		if (!result.sliceNumbersFromCache.values().empty()) {
+			SlicesMisses.fetch_add(1, std::memory_order_relaxed);
+		}
 	}
 	return result;
 }
@@ -653,6 +695,23 @@ auto Reader::Slices::fillFromHeader(int offset, bytes::span buffer)
 	return result;
 }
 
+bool Reader::Slices::prefetchRequired(int offset) const {
+	Expects(offset < _size);
+
+	using Flag = Slice::Flag;
+	if (_headerMode == HeaderMode::Unknown || isFullInHeader()) {
+		return false;
+	}
+	const auto index = offset / kInSlice;
+	const auto &slice = _data[index];
+	if (_headerMode != HeaderMode::NoCache
+		&& !(slice.flags & Flag::LoadedFromCache)) {
+		// Don't read slices from cache only to check what to prefetch.
+		return false;
+	}
+	return !slice.parts.contains(offset - index * kInSlice);
+}
+
 QByteArray Reader::Slices::partForDownloader(int offset) const {
 	Expects(offset < _size);
 
@@ -684,16 +743,61 @@ bool Reader::Slices::readCacheForDownloaderRequired(int offset) {
 }
 
 void Reader::Slices::markSliceUsed(int sliceIndex) {
-	const auto i = ranges::find(_usedSlices, sliceIndex);
-	const auto end = _usedSlices.end();
-	if (i == end) {
-		_usedSlices.push_back(sliceIndex);
-	} else {
-		const auto next = i + 1;
-		if (next != end) {
-			std::rotate(i, next, end);
+	const auto previous = _accessCounter++;
+	const auto i = ranges::find(_usedSlices, sliceIndex, &UsedSlice::index);
+	if (i == end(_usedSlices)) {
+		_usedSlices.push_back({ sliceIndex, 1, _accessCounter });
+		SlicesInMemory.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	// Count only returns to the slice, not sequential reads inside it.
+	if (i->lastAccess != previous
+		&& i->accessCount < kSliceAccessCountMax) {
+		++i->accessCount;
+	}
+	i->lastAccess = _accessCounter;
+}
+
+bool Reader::Slices::shouldUnloadUsedSlice() const {
+	const auto count = int(_usedSlices.size());
+	if (count <= kSlicesInMemoryMin) {
+		return false;
+	}
+	const auto limit = SlicesInMemoryLimit();
+	return (count > limit)
+		|| (SlicesInMemory.load(std::memory_order_relaxed) > limit);
+}
+
+int Reader::Slices::chooseUsedSliceToUnload() const {
+	Expects(_usedSlices.size() > kSlicesInMemoryMin);
+
+	// The most recently used slices are never unloaded,
+	// from the rest we choose the least often used one.
+	auto accesses = _usedSlices
+		| ranges::view::transform(&UsedSlice::lastAccess)
+		| ranges::to_vector;
+	const auto recentStart = end(accesses) - kSlicesInMemoryMin;
+	ranges::nth_element(accesses, recentStart);
+	const auto recentFrom = *recentStart;
+
+	auto result = -1;
+	for (auto i = 0, count = int(_usedSlices.size()); i != count; ++i) {
+		const auto &slice = _usedSlices[i];
+		if (slice.lastAccess >= recentFrom) {
+			continue;
+		} else if (result < 0) {
+			result = i;
+			continue;
+		}
+		const auto &chosen = _usedSlices[result];
+		if ((slice.accessCount < chosen.accessCount)
+			|| (slice.accessCount == chosen.accessCount
+				&& slice.lastAccess < chosen.lastAccess)) {
+			result = i;
 		}
 	}
+	Ensures(result >= 0);
+	return result;
 }
 
 int Reader::Slices::maxSliceSize(int sliceNumber) const {
@@ -703,12 +807,17 @@ int Reader::Slices::maxSliceSize(int sliceNumber) const {
 Reader::SerializedSlice Reader::Slices::serializeAndUnloadUnused() {
 	using Flag = Slice::Flag;
 
-	if (_headerMode == HeaderMode::Unknown
-		|| _usedSlices.size() <= kSlicesInMemory) {
+	if (_headerMode == HeaderMode::Unknown || !shouldUnloadUsedSlice()) {
 		return {};
 	}
-	const auto purgeSlice = _usedSlices.front();
-	_usedSlices.pop_front();
+	const auto purge = begin(_usedSlices) + chooseUsedSliceToUnload();
+	const auto purgeSlice = purge->index;
+	_usedSlices.erase(purge);
+	for (auto &used : _usedSlices) {
+		used.accessCount /= 2;
+	}
+	SlicesInMemory.fetch_sub(1, std::memory_order_relaxed);
+	SlicesEvictions.fetch_add(1, std::memory_order_relaxed);
 	if (!(_data[purgeSlice].flags & Flag::LoadedFromCache)) {
 		// If the only data in this slice was from _header, just leave it.
 		return {};
@@ -857,7 +966,7 @@ Reader::Reader(
 		if (_attachedDownloader) {
 			_partsForDownloader.fire_copy(part);
 		}
-		if (_streamingActive) {
+		if (_streamingActive || _prefetchingStart) {
 			_loadedParts.emplace(std::move(part));
 		}
 		if (const auto waiting = _waiting.load(std::memory_order_acquire)) {
@@ -871,6 +980,17 @@ Reader::Reader(
 	}
 }
 
+Reader::SlicesStats Reader::CollectSlicesStats() {
+	auto result = SlicesStats();
+	result.hits = SlicesHits.load(std::memory_order_relaxed);
+	result.misses = SlicesMisses.load(std::memory_order_relaxed);
+	result.evictions = SlicesEvictions.load(std::memory_order_relaxed);
+	result.inMemory = SlicesInMemory.load(std::memory_order_relaxed);
+	result.limit = SlicesInMemoryLimit();
+	result.inMemoryBytes = int64(result.inMemory) * kInSlice;
+	return result;
+}
+
 void Reader::startSleep(not_null<crl::semaphore*> wake) {
 	_sleeping.store(wake, std::memory_order_release);
 	processDownloaderRequests();
@@ -902,6 +1022,7 @@ void Reader::tryRemoveLoaderAsync() {
 
 void Reader::startStreaming() {
 	_streamingActive = true;
+	_prefetchingStart = false;
 	refreshLoaderPriority();
 }
 
@@ -912,12 +1033,34 @@ void Reader::stopStreaming(bool stillActive) {
 	_waiting.store(nullptr, std::memory_order_release);
 	if (!stillActive) {
 		_streamingActive = false;
+		_prefetchingStart = false;
 		refreshLoaderPriority();
 		_loadingOffsets.clear();
 		processDownloaderRequests();
 	}
 }
 
+void Reader::prefetchStart() {
+	if (_streamingActive
+		|| _prefetchingStart
+		|| _streamingError
+		|| !isRemoteLoader()) {
+		return;
+	} else if (_cacheHelper) {
+		QMutexLocker lock(&_cacheHelper->mutex);
+		const auto i = _cacheHelper->results.find(0);
+		if (i == end(_cacheHelper->results) || !i->second.empty()) {
+			// Header is still being read from cache or was found there.
+			return;
+		}
+	}
+	_prefetchingStart = true;
+	const auto till = std::min(kPrefetchStartParts * kPartSize, size());
+	for (auto offset = 0; offset < till; offset += kPartSize) {
+		loadAtOffset(offset);
+	}
+}
+
 rpl::producer<LoadedPart> Reader::partsForDownloader() const {
 	return _partsForDownloader.events();
 }
@@ -1211,6 +1354,24 @@ bool Reader::fullInCache() const {
 	return _slices.fullInCache();
 }
 
+void Reader::prefetchAround(const std::vector<int> &offsets) {
+	if (!isRemoteLoader() || _streamingError) {
+		return;
+	}
+	checkForSomethingMoreReceived();
+	for (const auto offset : offsets) {
+		const auto from = (offset / kPartSize) * kPartSize;
+		const auto till = std::min(
+			from + kPrefetchPartsAround * kPartSize,
+			size());
+		for (auto part = from; part < till; part += kPartSize) {
+			if (_slices.prefetchRequired(part)) {
+				prefetchAtOffset(part);
+			}
+		}
+	}
+}
+
 Reader::FillState Reader::fill(
 		int offset,
 		bytes::span buffer,
@@ -1375,6 +1536,12 @@ void Reader::loadAtOffset(int offset) {
 	}
 }
 
+void Reader::prefetchAtOffset(int offset) {
+	if (_loadingOffsets.addLowPriority(offset)) {
+		_loader->prefetch(offset);
+	}
+}
+
 void Reader::finalizeCache() {
 	if (!_cacheHelper) {
 		return;
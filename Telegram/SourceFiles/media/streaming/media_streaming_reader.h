@@ -39,6 +39,15 @@ public:
 		Failed,
 	};
 
+	struct SlicesStats {
+		int64 hits = 0;
+		int64 misses = 0;
+		int64 evictions = 0;
+		int inMemory = 0;
+		int limit = 0;
+		int64 inMemoryBytes = 0;
+	};
+
 	// Main thread.
 	explicit Reader(
 		std::unique_ptr<Loader> loader,
@@ -60,6 +69,9 @@ public:
 	[[nodiscard]] int headerSize() const;
 	[[nodiscard]] bool fullInCache() const;
 
+	// Request parts around given offsets after all the required parts.
+	void prefetchAround(const std::vector<int> &offsets);
+
 	// Thread safe.
 	void startSleep(not_null<crl::semaphore*> wake);
 	void wakeFromSleep();
@@ -70,6 +82,9 @@ public:
 	// Main thread.
 	void startStreaming();
 	void stopStreaming(bool stillActive = false);
+
+	// Load the first parts before streaming, like for the next track.
+	void prefetchStart();
 	[[nodiscard]] rpl::producer<LoadedPart> partsForDownloader() const;
 	void loadForDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader,
@@ -78,6 +93,9 @@ public:
 	void cancelForDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader);
 
+	// Any thread, shared by all the readers.
+	[[nodiscard]] static SlicesStats CollectSlicesStats();
+
 	~Reader();
 
 private:
@@ -144,6 +162,9 @@ private:
 	class Slices {
 	public:
 		Slices(int size, bool useCache);
+		Slices(const Slices &other) = delete;
+		Slices &operator=(const Slices &other) = delete;
+		~Slices();
 
 		void headerDone(bool fromCache);
 		[[nodiscard]] int headerSize() const;
@@ -163,6 +184,8 @@ private:
 		[[nodiscard]] FillResult fill(int offset, bytes::span buffer);
 		[[nodiscard]] SerializedSlice unloadToCache();
 
+		[[nodiscard]] bool prefetchRequired(int offset) const;
+
 		[[nodiscard]] QByteArray partForDownloader(int offset) const;
 		[[nodiscard]] bool readCacheForDownloaderRequired(int offset);
 
@@ -174,6 +197,11 @@ private:
 			Full,
 			NoCache,
 		};
+		struct UsedSlice {
+			int index = 0;
+			int accessCount = 0;
+			int lastAccess = 0;
+		};
 
 		void applyHeaderCacheData();
 		[[nodiscard]] int maxSliceSize(int sliceNumber) const;
@@ -184,6 +212,8 @@ private:
 			const Slice &slice) const;
 		[[nodiscard]] QByteArray serializeAndUnloadFirstSliceNoHeader();
 		void markSliceUsed(int sliceIndex);
+		[[nodiscard]] bool shouldUnloadUsedSlice() const;
+		[[nodiscard]] int chooseUsedSliceToUnload() const;
 		[[nodiscard]] bool computeIsGoodHeader() const;
 		[[nodiscard]] FillResult fillFromHeader(
 			int offset,
@@ -194,7 +224,8 @@ private:
 
 		std::vector<Slice> _data;
 		Slice _header;
-		std::deque<int> _usedSlices;
+		std::vector<UsedSlice> _usedSlices;
+		int _accessCounter = 0;
 		int _size = 0;
 		HeaderMode _headerMode = HeaderMode::Unknown;
 		bool _fullInCache = false;
@@ -210,6 +241,7 @@ private:
 
 	void cancelLoadInRange(int from, int till);
 	void loadAtOffset(int offset);
+	void prefetchAtOffset(int offset);
 	void checkLoadWillBeFirst(int offset);
 	bool processLoadedParts();
 
@@ -259,6 +291,7 @@ private:
 	rpl::event_stream<LoadedPart> _partsForDownloader;
 	int _realPriority = 1;
 	bool _streamingActive = false;
+	bool _prefetchingStart = false;
 
 	// Streaming thread.
 	std::deque<int> _offsetsForDownloader;
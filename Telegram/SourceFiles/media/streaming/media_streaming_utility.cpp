@@ -101,13 +101,12 @@ bool GoodForRequest(
 		&& (request.resize == image.size());
 }
 
-QImage ConvertFrame(
-		Stream &stream,
-		AVFrame *frame,
+QImage ConvertReadableFrame(
+		not_null<AVFrame*> frame,
+		int rotation,
 		QSize resize,
-		QImage storage) {
-	Expects(frame != nullptr);
-
+		QImage storage,
+		FFmpeg::SwscalePointer &swscale) {
 	const auto frameSize = QSize(frame->width, frame->height);
 	if (frameSize.isEmpty()) {
 		LOG(("Streaming Error: Bad frame size %1,%2"
@@ -120,7 +119,7 @@ QImage ConvertFrame(
 	}
 	if (resize.isEmpty()) {
 		resize = frameSize;
-	} else if (FFmpeg::RotationSwapWidthHeight(stream.rotation)) {
+	} else if (FFmpeg::RotationSwapWidthHeight(rotation)) {
 		resize.transpose();
 	}
 
@@ -146,11 +145,8 @@ QImage ConvertFrame(
 			from += deltaFrom;
 		}
 	} else {
-		stream.swscale = MakeSwscalePointer(
-			frame,
-			resize,
-			&stream.swscale);
-		if (!stream.swscale) {
+		swscale = MakeSwscalePointer(frame, resize, &swscale);
+		if (!swscale) {
 			return QImage();
 		}
 
@@ -159,7 +155,7 @@ QImage ConvertFrame(
 		int linesize[AV_NUM_DATA_POINTERS] = { storage.bytesPerLine(), 0 };
 
 		const auto lines = sws_scale(
-			stream.swscale.get(),
+			swscale.get(),
 			frame->data,
 			frame->linesize,
 			0,
@@ -175,10 +171,33 @@ QImage ConvertFrame(
 		}
 	}
 
-	FFmpeg::ClearFrameMemory(frame);
 	return storage;
 }
 
+QImage ConvertFrame(
+		Stream &stream,
+		AVFrame *frame,
+		QSize resize,
+		QImage storage) {
+	Expects(frame != nullptr);
+
+	const auto readable = FFmpeg::ReadableFrame(frame, stream.transferred);
+	const auto guard = gsl::finally([&] {
+		FFmpeg::ClearFrameMemory(frame);
+		if (readable != frame) {
+			FFmpeg::ClearFrameMemory(readable);
+		}
+	});
+	return readable
+		? ConvertReadableFrame(
+			readable,
+			stream.rotation,
+			resize,
+			std::move(storage),
+			stream.swscale)
+		: QImage();
+}
+
 void PaintFrameOuter(QPainter &p, const QRect &inner, QSize outer) {
 	const auto left = inner.x();
 	const auto right = outer.width() - inner.width() - left;
@@ -299,5 +318,34 @@ QImage PrepareByRequest(
 	return storage;
 }
 
+bool GoodForDirectConversion(
+		bool alpha,
+		int rotation,
+		const FrameRequest &request) {
+	return !alpha
+		&& !rotation
+		&& !request.resize.isEmpty()
+		&& (request.resize == request.outer);
+}
+
+QImage PrepareDirectlyByRequest(
+		not_null<AVFrame*> frame,
+		const FrameRequest &request,
+		QImage storage,
+		FFmpeg::SwscalePointer &swscale) {
+	Expects(GoodForDirectConversion(false, 0, request));
+
+	auto result = ConvertReadableFrame(
+		frame,
+		0,
+		request.resize,
+		std::move(storage),
+		swscale);
+	if (!result.isNull()) {
+		ApplyFrameRounding(result, request);
+	}
+	return result;
+}
+
 } // namespace Streaming
 } // namespace Media
@@ -41,6 +41,7 @@ struct Stream {
 	int rotation = 0;
 	AVRational aspect = FFmpeg::kNormalAspect;
 	FFmpeg::SwscalePointer swscale;
+	FFmpeg::FramePointer transferred;
 };
 
 [[nodiscard]] crl::time FramePosition(const Stream &stream);
@@ -53,6 +54,13 @@ struct Stream {
 	const QImage &image,
 	int rotation,
 	const FrameRequest &request);
+// Doesn't clear the frame memory, so it can be converted several times.
+[[nodiscard]] QImage ConvertReadableFrame(
+	not_null<AVFrame*> frame,
+	int rotation,
+	QSize resize,
+	QImage storage,
+	FFmpeg::SwscalePointer &swscale);
 [[nodiscard]] QImage ConvertFrame(
 	Stream &stream,
 	AVFrame *frame,
@@ -65,5 +73,17 @@ struct Stream {
 	const FrameRequest &request,
 	QImage storage);
 
+// Requests without rotation and padding can be converted right from
+// the decoded frame, without scaling the ARGB original once again.
+[[nodiscard]] bool GoodForDirectConversion(
+	bool alpha,
+	int rotation,
+	const FrameRequest &request);
+[[nodiscard]] QImage PrepareDirectlyByRequest(
+	not_null<AVFrame*> frame,
+	const FrameRequest &request,
+	QImage storage,
+	FFmpeg::SwscalePointer &swscale);
+
 } // namespace Streaming
 } // namespace Media
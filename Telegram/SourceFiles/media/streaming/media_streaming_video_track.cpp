@@ -75,6 +75,9 @@ private:
 	[[nodiscard]] FrameResult readFrame(not_null<Frame*> frame);
 	void fillRequests(not_null<Frame*> frame) const;
 	[[nodiscard]] QSize chooseOriginalResize() const;
+	void prepareDirectly(
+		not_null<Frame*> frame,
+		not_null<AVFrame*> readable);
 	void presentFrameIfNeeded();
 	void callReady();
 	[[nodiscard]] bool loopAround();
@@ -106,6 +109,7 @@ private:
 	rpl::event_stream<> _checkNextFrame;
 	rpl::event_stream<> _waitingForData;
 	base::flat_map<const Instance*, FrameRequest> _requests;
+	std::vector<FFmpeg::SwscalePointer> _directScalers;
 
 	bool _queued = false;
 	base::ConcurrentTimer _readFramesTimer;
@@ -354,6 +358,46 @@ QSize VideoTrackObject::chooseOriginalResize() const {
 	return chosen;
 }
 
+void VideoTrackObject::prepareDirectly(
+		not_null<Frame*> frame,
+		not_null<AVFrame*> readable) {
+	// Each request of a different size gets its own scaler, so that
+	// they are not recreated on every frame.
+	auto scalers = 0;
+	const auto from = begin(frame->prepared);
+	for (auto i = from, till = end(frame->prepared); i != till; ++i) {
+		auto &prepared = i->second;
+		const auto &request = prepared.request;
+		prepared.direct = false;
+		if (!GoodForDirectConversion(
+				frame->alpha,
+				_stream.rotation,
+				request)
+			|| (request.resize == frame->original.size())) {
+			continue;
+		}
+		prepared.direct = true;
+		const auto same = std::find_if(from, i, [&](const auto &pair) {
+			return pair.second.direct && (pair.second.request == request);
+		});
+		if (same != i) {
+			prepared.image = QImage();
+			continue;
+		} else if (scalers == int(_directScalers.size())) {
+			_directScalers.emplace_back();
+		}
+		prepared.image = PrepareDirectlyByRequest(
+			readable,
+			request,
+			std::move(prepared.image),
+			_directScalers[scalers++]);
+		if (prepared.image.isNull()) {
+			// Try to prepare it from the original.
+			prepared.direct = false;
+		}
+	}
+}
+
 void VideoTrackObject::presentFrameIfNeeded() {
 	if (_pausedTime != kTimeUnknown || _resumedTime == kTimeUnknown) {
 		return;
@@ -363,17 +407,31 @@ void VideoTrackObject::presentFrameIfNeeded() {
 
 		fillRequests(frame);
 		frame->alpha = (frame->decoded->format == AV_PIX_FMT_BGRA);
-		frame->original = ConvertFrame(
-			_stream,
-			frame->decoded.get(),
-			chooseOriginalResize(),
-			std::move(frame->original));
+		const auto decoded = frame->decoded.get();
+		const auto readable = FFmpeg::ReadableFrame(
+			decoded,
+			_stream.transferred);
+		const auto guard = gsl::finally([&] {
+			FFmpeg::ClearFrameMemory(decoded);
+			if (readable != decoded) {
+				FFmpeg::ClearFrameMemory(readable);
+			}
+		});
+		frame->original = readable
+			? ConvertReadableFrame(
+				readable,
+				_stream.rotation,
+				chooseOriginalResize(),
+				std::move(frame->original),
+				_stream.swscale)
+			: QImage();
 		if (frame->original.isNull()) {
 			frame->prepared.clear();
 			fail(Error::InvalidData);
 			return;
 		}
 
+		prepareDirectly(frame, readable);
 		VideoTrack::PrepareFrameByRequests(frame, _stream.rotation);
 
 		Ensures(VideoTrack::IsRasterized(frame));
@@ -1032,7 +1090,9 @@ void VideoTrack::PrepareFrameByRequests(
 	const auto end = frame->prepared.end();
 	for (auto i = begin; i != end; ++i) {
 		auto &prepared = i->second;
-		if (frame->alpha
+		if (prepared.direct) {
+			continue;
+		} else if (frame->alpha
 			|| !GoodForRequest(frame->original, rotation, prepared.request)) {
 			auto j = begin;
 			for (; j != i; ++j) {
@@ -74,6 +74,7 @@ private:
 
 		FrameRequest request = FrameRequest::NonStrict();
 		QImage image;
+		bool direct = false;
 	};
 	struct Frame {
 		FFmpeg::FramePointer decoded = FFmpeg::MakeFramePointer();
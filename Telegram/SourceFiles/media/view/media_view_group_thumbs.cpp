@@ -29,6 +29,7 @@ namespace View {
 namespace {
 
 constexpr auto kThumbDuration = crl::time(150);
+constexpr auto kRemovedPixmapsLimit = 16;
 
 int Round(float64 value) {
 	return int(std::round(value));
@@ -139,16 +140,20 @@ public:
 		Dying,
 	};
 
-	Thumb(Key key, Fn<void()> handler);
+	// The full pixmap may be the one kept from a removed thumb,
+	// then validateImage() doesn't scale the image again.
+	Thumb(Key key, QPixmap full, Fn<void()> handler);
 	Thumb(
 		Key key,
 		not_null<PhotoData*> photo,
 		Data::FileOrigin origin,
+		QPixmap full,
 		Fn<void()> handler);
 	Thumb(
 		Key key,
 		not_null<DocumentData*> document,
 		Data::FileOrigin origin,
+		QPixmap full,
 		Fn<void()> handler);
 
 	int leftToUpdate() const;
@@ -164,6 +169,8 @@ public:
 	void paint(Painter &p, int x, int y, int outerWidth, float64 progress);
 	ClickHandlerPtr getState(QPoint point) const;
 
+	[[nodiscard]] QPixmap takeFull();
+
 private:
 	QSize wantedPixSize() const;
 	void validateImage();
@@ -190,8 +197,9 @@ private:
 
 };
 
-GroupThumbs::Thumb::Thumb(Key key, Fn<void()> handler)
-: _key(key) {
+GroupThumbs::Thumb::Thumb(Key key, QPixmap full, Fn<void()> handler)
+: _key(key)
+, _full(std::move(full)) {
 	_link = std::make_shared<LambdaClickHandler>(std::move(handler));
 	_fullWidth = std::min(
 		wantedPixSize().width(),
@@ -203,10 +211,12 @@ GroupThumbs::Thumb::Thumb(
 	Key key,
 	not_null<PhotoData*> photo,
 	Data::FileOrigin origin,
+	QPixmap full,
 	Fn<void()> handler)
 : _key(key)
 , _photoMedia(photo->createMediaView())
-, _origin(origin) {
+, _origin(origin)
+, _full(std::move(full)) {
 	_link = std::make_shared<LambdaClickHandler>(std::move(handler));
 	_fullWidth = std::min(
 		wantedPixSize().width(),
@@ -219,10 +229,12 @@ GroupThumbs::Thumb::Thumb(
 	Key key,
 	not_null<DocumentData*> document,
 	Data::FileOrigin origin,
+	QPixmap full,
 	Fn<void()> handler)
 : _key(key)
 , _documentMedia(document->createMediaView())
-, _origin(origin) {
+, _origin(origin)
+, _full(std::move(full)) {
 	_link = std::make_shared<LambdaClickHandler>(std::move(handler));
 	_fullWidth = std::min(
 		wantedPixSize().width(),
@@ -276,6 +288,10 @@ void GroupThumbs::Thumb::validateImage() {
 	}
 }
 
+QPixmap GroupThumbs::Thumb::takeFull() {
+	return base::take(_full);
+}
+
 int GroupThumbs::Thumb::leftToUpdate() const {
 	return Round(std::min(_left.from(), _left.to()));
 }
@@ -428,6 +444,9 @@ void GroupThumbs::updateContext(Context context) {
 	if (_context != context) {
 		clear();
 		_context = context;
+
+		// Collage keys are indices, they mean other thumbs in a new context.
+		_removedPixmaps.clear();
 	}
 }
 
@@ -617,7 +636,7 @@ auto GroupThumbs::createThumb(Key key, std::nullptr_t)
 -> std::unique_ptr<Thumb> {
 	const auto weak = base::make_weak(this);
 	const auto origin = ComputeFileOrigin(key, _context);
-	return std::make_unique<Thumb>(key, [=] {
+	return std::make_unique<Thumb>(key, takeRemovedPixmap(key), [=] {
 		if (const auto strong = weak.get()) {
 			strong->_activateStream.fire_copy(key);
 		}
@@ -628,29 +647,64 @@ auto GroupThumbs::createThumb(Key key, not_null<PhotoData*> photo)
 -> std::unique_ptr<Thumb> {
 	const auto weak = base::make_weak(this);
 	const auto origin = ComputeFileOrigin(key, _context);
-	return std::make_unique<Thumb>(key, photo, origin, [=] {
-		if (const auto strong = weak.get()) {
-			strong->_activateStream.fire_copy(key);
-		}
-	});
+	return std::make_unique<Thumb>(
+		key,
+		photo,
+		origin,
+		takeRemovedPixmap(key),
+		[=] {
+			if (const auto strong = weak.get()) {
+				strong->_activateStream.fire_copy(key);
+			}
+		});
 }
 
 auto GroupThumbs::createThumb(Key key, not_null<DocumentData*> document)
 -> std::unique_ptr<Thumb> {
 	const auto weak = base::make_weak(this);
 	const auto origin = ComputeFileOrigin(key, _context);
-	return std::make_unique<Thumb>(key, document, origin, [=] {
-		if (const auto strong = weak.get()) {
-			strong->_activateStream.fire_copy(key);
-		}
-	});
+	return std::make_unique<Thumb>(
+		key,
+		document,
+		origin,
+		takeRemovedPixmap(key),
+		[=] {
+			if (const auto strong = weak.get()) {
+				strong->_activateStream.fire_copy(key);
+			}
+		});
 }
 
 auto GroupThumbs::validateCacheEntry(Key key) -> not_null<Thumb*> {
 	const auto i = _cache.find(key);
-	return (i != _cache.end())
-		? i->second.get()
-		: _cache.emplace(key, createThumb(key)).first->second.get();
+	if (i != _cache.end()) {
+		return i->second.get();
+	}
+	return _cache.emplace(key, createThumb(key)).first->second.get();
+}
+
+void GroupThumbs::rememberRemovedPixmap(Key key, QPixmap pixmap) {
+	// Keep the scaled pixmaps of the thumbs that went out of the strip,
+	// so that navigating back and forth doesn't scale them again.
+	if (pixmap.isNull()) {
+		return;
+	} else if (_removedPixmaps.size() == kRemovedPixmapsLimit) {
+		_removedPixmaps.erase(_removedPixmaps.begin());
+	}
+	_removedPixmaps.emplace_back(key, std::move(pixmap));
+}
+
+QPixmap GroupThumbs::takeRemovedPixmap(Key key) {
+	const auto i = ranges::find(
+		_removedPixmaps,
+		key,
+		&std::pair<Key, QPixmap>::first);
+	if (i == end(_removedPixmaps)) {
+		return QPixmap();
+	}
+	auto result = std::move(i->second);
+	_removedPixmaps.erase(i);
+	return result;
 }
 
 void GroupThumbs::markCacheStale() {
@@ -752,6 +806,7 @@ void GroupThumbs::paint(Painter &p, int x, int y, int outerWidth) {
 					thumb.get(),
 					[](not_null<Thumb*> thumb) { return thumb.get(); }),
 				_dying.end());
+			rememberRemovedPixmap(i->first, thumb->takeFull());
 			i = _cache.erase(i);
 		} else {
 			++i;
@@ -103,6 +103,8 @@ private:
 	void updateContext(Context context);
 	void markCacheStale();
 	not_null<Thumb*> validateCacheEntry(Key key);
+	void rememberRemovedPixmap(Key key, QPixmap pixmap);
+	[[nodiscard]] QPixmap takeRemovedPixmap(Key key);
 	std::unique_ptr<Thumb> createThumb(Key key);
 	std::unique_ptr<Thumb> createThumb(
 		Key key,
@@ -130,6 +132,7 @@ private:
 	std::vector<not_null<Thumb*>> _items;
 	std::vector<not_null<Thumb*>> _dying;
 	base::flat_map<Key, std::unique_ptr<Thumb>> _cache;
+	std::vector<std::pair<Key, QPixmap>> _removedPixmaps;
 	int _width = 0;
 	QRect _updatedRect;
 
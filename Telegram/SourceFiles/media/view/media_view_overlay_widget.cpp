@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "lang/lang_keys.h"
 #include "mainwidget.h"
 #include "mainwindow.h"
+#include "core/paint_stats.h"
 #include "core/application.h"
 #include "core/file_utilities.h"
 #include "core/mime_type.h"
@@ -75,6 +76,8 @@ namespace View {
 namespace {
 
 constexpr auto kPreloadCount = 3;
+constexpr auto kPreloadFastCount = 12;
+constexpr auto kFastFlipTimeout = crl::time(500);
 constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
@@ -83,6 +86,10 @@ constexpr auto kOverlayLoaderPriority = 2;
 // even though it reports that max texture size is 16384.
 constexpr auto kMaxDisplayImageSize = 4096;
 
+// Static content larger than that many times the painted size is drawn
+// from a copy scaled for the current zoom instead of the full image.
+constexpr auto kScaledStaticContentRatio = 2;
+
 // Preload X message ids before and after current.
 constexpr auto kIdsLimit = 48;
 
@@ -969,6 +976,12 @@ bool OverlayWidget::radialAnimationCallback(crl::time now) {
 		&& (!anim::Disabled() || updated)) {
 		update(radialRect());
 	}
+	if (_photo
+		&& _blurred
+		&& _photoMedia->progressive()
+		&& _photoMedia->progressive() != _progressiveShown) {
+		update(contentRect());
+	}
 	const auto ready = _document && _documentMedia->loaded();
 	const auto streamVideo = ready && _documentMedia->canBePlayed();
 	const auto tryOpenImage = ready && (_document->size < App::kImageSizeLimit);
@@ -1113,6 +1126,7 @@ void OverlayWidget::assignMediaPointer(not_null<PhotoData*> photo) {
 		_photo = photo;
 		_photoMedia = _photo->createMediaView();
 		_photoMedia->wanted(Data::PhotoSize::Small, fileOrigin());
+		_photoMedia->wantProgressive();
 		_photo->load(fileOrigin(), LoadFromCloudOrLocal, true);
 	}
 }
@@ -2030,6 +2044,7 @@ void OverlayWidget::displayPhoto(not_null<PhotoData*> photo, HistoryItem *item)
 	_zoomToScreen = _zoomToDefault = 0;
 	_blurred = true;
 	_staticContent = QPixmap();
+	_progressiveShown = nullptr;
 	_down = OverNone;
 	const auto size = style::ConvertScale(flipSizeByRotation(QSize(
 		photo->width(),
@@ -2073,6 +2088,7 @@ void OverlayWidget::displayDocument(
 	}
 	_fullScreenVideo = false;
 	_staticContent = QPixmap();
+	_progressiveShown = nullptr;
 	clearStreaming(_document != doc);
 	destroyThemePreview();
 	assignMediaPointer(doc);
@@ -2613,6 +2629,7 @@ void OverlayWidget::restartAtSeekPosition(crl::time position) {
 	auto options = Streaming::PlaybackOptions();
 	options.position = position;
 	options.audioId = AudioMsgId(_document, _msgid);
+	options.hwAllowed = Core::App().settings().hardwareAcceleratedVideo();
 	if (!_streamed->withSound) {
 		options.mode = Streaming::Mode::Video;
 		options.loop = true;
@@ -2798,8 +2815,28 @@ void OverlayWidget::validatePhotoImage(Image *image, bool blurred) {
 	_blurred = blurred;
 }
 
+void OverlayWidget::validatePhotoProgressiveImage() {
+	const auto image = _photoMedia->progressive();
+	if (!image
+		|| !_blurred
+		|| (image == _progressiveShown && !_staticContent.isNull())) {
+		return;
+	}
+	const auto use = flipSizeByRotation({ _width, _height })
+		* cIntRetinaFactor();
+	_staticContent = image->pixNoCache(
+		use.width(),
+		use.height(),
+		Images::Option::Smooth);
+	_staticContent.setDevicePixelRatio(cRetinaFactor());
+
+	// Keep _blurred, so that the full image replaces this one.
+	_progressiveShown = image;
+}
+
 void OverlayWidget::validatePhotoCurrentImage() {
 	validatePhotoImage(_photoMedia->image(Data::PhotoSize::Large), false);
+	validatePhotoProgressiveImage();
 	validatePhotoImage(_photoMedia->image(Data::PhotoSize::Thumbnail), true);
 	validatePhotoImage(_photoMedia->image(Data::PhotoSize::Small), true);
 	validatePhotoImage(_photoMedia->thumbnailInline(), true);
@@ -2817,6 +2854,7 @@ void OverlayWidget::validatePhotoCurrentImage() {
 }
 
 void OverlayWidget::paintEvent(QPaintEvent *e) {
+	PAINT_STATS_FRAME("MediaView::OverlayWidget");
 	const auto r = e->rect();
 	const auto &region = e->region();
 	const auto rects = region.rects();
@@ -3123,7 +3161,8 @@ void OverlayWidget::paintTransformedStaticContent(Painter &p) {
 			p.save();
 			p.rotate(rotation);
 		}
-		p.drawPixmap(RotatedRect(rect, rotation), _staticContent);
+		const auto target = RotatedRect(rect, rotation);
+		p.drawPixmap(target, staticContentForPaint(target.size()));
 		if (rotation) {
 			p.restore();
 		}
@@ -3132,6 +3171,30 @@ void OverlayWidget::paintTransformedStaticContent(Painter &p) {
 	}
 }
 
+const QPixmap &OverlayWidget::staticContentForPaint(QSize size) {
+	// Smooth scaling of the whole huge image on each paint makes panning
+	// and controls animations slow, so keep one copy for the zoom level.
+	const auto pixels = size * cIntRetinaFactor();
+	const auto full = _staticContent.size();
+	if (pixels.isEmpty()
+		|| (full.width() <= pixels.width() * kScaledStaticContentRatio
+			&& full.height() <= pixels.height() * kScaledStaticContentRatio)) {
+		_staticContentScaled = QPixmap();
+		return _staticContent;
+	}
+	const auto key = _staticContent.cacheKey();
+	if (_staticContentScaled.size() != pixels
+		|| _staticContentScaledKey != key) {
+		_staticContentScaled = _staticContent.scaled(
+			pixels,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		_staticContentScaled.setDevicePixelRatio(cRetinaFactor());
+		_staticContentScaledKey = key;
+	}
+	return _staticContentScaled;
+}
+
 void OverlayWidget::paintRadialLoading(
 		Painter &p,
 		bool radial,
@@ -3595,28 +3658,69 @@ void OverlayWidget::preloadData(int delta) {
 	if (!_index) {
 		return;
 	}
+	if (delta) {
+		// Look further ahead while the user flips fast in one direction.
+		const auto now = crl::now();
+		const auto direction = (delta > 0) ? 1 : -1;
+		_preloadFastFlips = (direction == _preloadDirection
+			&& now - _preloadLastFlip < kFastFlipTimeout)
+			? std::min(_preloadFastFlips + 1, kPreloadFastCount)
+			: 0;
+		_preloadDirection = direction;
+		_preloadLastFlip = now;
+	}
+	const auto count = std::min(
+		kPreloadCount + _preloadFastFlips,
+		kPreloadFastCount);
 	auto from = *_index + (delta ? delta : -1);
-	auto till = *_index + (delta ? delta * kPreloadCount : 1);
+	auto till = *_index + (delta ? delta * count : 1);
 	if (from > till) std::swap(from, till);
 
+	// Thumbnails are small, they are loaded twice as far.
+	const auto far = *_index + (delta ? 2 * delta * count : 1);
+	const auto thumbnailsFrom = std::min(from, far);
+	const auto thumbnailsTill = std::max(till, far);
+
 	auto photos = base::flat_set<std::shared_ptr<Data::PhotoMedia>>();
 	auto documents = base::flat_set<std::shared_ptr<Data::DocumentMedia>>();
-	for (auto index = from; index != till + 1; ++index) {
+	auto started = base::flat_set<std::shared_ptr<Data::PhotoMedia>>();
+	for (auto index = thumbnailsFrom; index != thumbnailsTill + 1; ++index) {
+		const auto full = (index >= from && index <= till);
 		auto entity = entityByIndex(index);
 		if (auto photo = base::get_if<not_null<PhotoData*>>(&entity.data)) {
 			const auto [i, ok] = photos.emplace((*photo)->createMediaView());
 			(*i)->wanted(Data::PhotoSize::Small, fileOrigin(entity));
+			if (!full) {
+				continue;
+			}
+			const auto wasLoading = (*photo)->loading();
 			(*photo)->load(fileOrigin(entity), LoadFromCloudOrLocal, true);
+			if ((!wasLoading && (*photo)->loading())
+				|| _preloadStarted.contains(*i)) {
+				started.emplace(*i);
+			}
 		} else if (auto document = base::get_if<not_null<DocumentData*>>(
 				&entity.data)) {
 			const auto [i, ok] = documents.emplace(
 				(*document)->createMediaView());
 			(*i)->thumbnailWanted(fileOrigin(entity));
-			if (!(*i)->canBePlayed()) {
+			if (full && !(*i)->canBePlayed()) {
 				(*i)->automaticLoad(fileOrigin(entity), entity.item);
 			}
 		}
 	}
+
+	// Cancel the photos preloaded for the direction the user has left.
+	for (const auto &media : _preloadStarted) {
+		const auto photo = media->owner();
+		if (!started.contains(media)
+			&& photo != _photo
+			&& !media->loaded()
+			&& photo->loading()) {
+			photo->stopLoading();
+		}
+	}
+	_preloadStarted = std::move(started);
 	_preloadPhotos = std::move(photos);
 	_preloadDocuments = std::move(documents);
 }
@@ -4083,7 +4187,7 @@ void OverlayWidget::setVisibleHook(bool visible) {
 		clearStreaming();
 		destroyThemePreview();
 		_radial.stop();
-		_staticContent = QPixmap();
+		_staticContent = _staticContentScaled = QPixmap();
 		_themePreview = nullptr;
 		_themeApply.destroyDelayed();
 		_themeCancel.destroyDelayed();
@@ -333,6 +333,7 @@ private:
 	void initGroupThumbs();
 
 	void validatePhotoImage(Image *image, bool blurred);
+	void validatePhotoProgressiveImage();
 	void validatePhotoCurrentImage();
 
 	[[nodiscard]] QSize flipSizeByRotation(QSize size) const;
@@ -349,6 +350,7 @@ private:
 	[[nodiscard]] bool documentBubbleShown() const;
 	void paintTransformedVideoFrame(Painter &p);
 	void paintTransformedStaticContent(Painter &p);
+	[[nodiscard]] const QPixmap &staticContentForPaint(QSize size);
 	void clearStreaming(bool savePosition = true);
 
 	QBrush _transparentBrush;
@@ -361,6 +363,10 @@ private:
 	std::shared_ptr<Data::DocumentMedia> _documentMedia;
 	base::flat_set<std::shared_ptr<Data::PhotoMedia>> _preloadPhotos;
 	base::flat_set<std::shared_ptr<Data::DocumentMedia>> _preloadDocuments;
+	base::flat_set<std::shared_ptr<Data::PhotoMedia>> _preloadStarted;
+	crl::time _preloadLastFlip = 0;
+	int _preloadDirection = 0;
+	int _preloadFastFlips = 0;
 	int _rotation = 0;
 	std::unique_ptr<SharedMedia> _sharedMedia;
 	std::optional<SharedMediaWithLastSlice> _sharedMediaData;
@@ -405,7 +411,10 @@ private:
 	bool _pressed = false;
 	int32 _dragging = 0;
 	QPixmap _staticContent;
+	QPixmap _staticContentScaled;
+	qint64 _staticContentScaledKey = 0;
 	bool _blurred = true;
+	Image *_progressiveShown = nullptr;
 
 	std::unique_ptr<Streamed> _streamed;
 	std::unique_ptr<PipWrap> _pip;
@@ -591,7 +591,17 @@ void PipPanel::paintEvent(QPaintEvent *e) {
 		const auto sides = RectPart::AllSides & ~_attached;
 		Ui::Shadow::paint(p, inner, width(), st::callShadow);
 	}
-	_paint(p, request);
+
+	// While resizing paint the frames prepared for the size it had
+	// when the resize started, scaled by the painter. Otherwise each
+	// mouse move makes the video track prepare frames for a new size.
+	const auto resizing = _dragState && (*_dragState != RectPart::Center);
+	if (!resizing) {
+		_resizeRequest = FrameRequest();
+	} else if (_resizeRequest.outer.isEmpty()) {
+		_resizeRequest = request;
+	}
+	_paint(p, resizing ? _resizeRequest : request);
 }
 
 void PipPanel::mousePressEvent(QMouseEvent *e) {
@@ -609,6 +619,7 @@ void PipPanel::mouseReleaseEvent(QMouseEvent *e) {
 		//playbackPauseResume();
 	} else {
 		finishDrag(e->globalPos());
+		update();
 	}
 }
 
@@ -1180,11 +1191,7 @@ void Pip::setupStreaming() {
 void Pip::paint(QPainter &p, FrameRequest request) {
 	const auto image = videoFrameForDirectPaint(
 		UnrotateRequest(request, _rotation));
-	const auto inner = _panel.inner();
-	const auto rect = QRect{
-		inner.topLeft(),
-		request.outer / style::DevicePixelRatio()
-	};
+	const auto rect = _panel.inner();
 	if (UsePainterRotation(_rotation)) {
 		if (_rotation) {
 			p.save();
@@ -1414,6 +1421,7 @@ void Pip::restartAtSeekPosition(crl::time position) {
 	options.position = position;
 	options.audioId = _instance.player().prepareLegacyState().id;
 	options.speed = _delegate->pipPlaybackSpeed();
+	options.hwAllowed = Core::App().settings().hardwareAcceleratedVideo();
 	_instance.play(options);
 	if (_startPaused) {
 		_instance.pause();
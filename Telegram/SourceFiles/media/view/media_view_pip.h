@@ -105,6 +105,7 @@ private:
 	QPoint _pressPoint;
 	QRect _dragStartGeometry;
 	std::optional<RectPart> _dragState;
+	FrameRequest _resizeRequest;
 	rpl::event_stream<> _saveGeometryRequests;
 
 	QPoint _positionAnimationFrom;
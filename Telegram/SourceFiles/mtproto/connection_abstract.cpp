@@ -16,6 +16,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace MTP {
 namespace details {
+namespace {
+
+// Enough to keep the buffers of a few file parts being downloaded.
+constexpr auto kMaxFreeBuffers = 4;
+constexpr auto kMaxFreeBufferInts = 1024 * 1024 / int(sizeof(mtpPrime));
+
+} // namespace
 
 ConnectionPointer::ConnectionPointer() = default;
 
@@ -188,6 +195,30 @@ ConnectionPointer AbstractConnection::Create(
 	return result;
 }
 
+void AbstractConnection::releaseReceived(mtpBuffer &&buffer) {
+	if (int(_freeBuffers.size()) < kMaxFreeBuffers
+		&& buffer.capacity() <= kMaxFreeBufferInts) {
+		_freeBuffers.push_back(std::move(buffer));
+	}
+}
+
+mtpBuffer AbstractConnection::takeReceivedBuffer(int size) {
+	auto result = mtpBuffer();
+	if (!_freeBuffers.empty()) {
+		const auto i = ranges::find_if(_freeBuffers, [&](
+				const mtpBuffer &buffer) {
+			return (buffer.capacity() >= size);
+		});
+		const auto j = (i != end(_freeBuffers))
+			? i
+			: (end(_freeBuffers) - 1);
+		result = std::move(*j);
+		_freeBuffers.erase(j);
+	}
+	result.resize(size);
+	return result;
+}
+
 uint32 AbstractConnection::extendedNotSecurePadding() const {
 	return requiresExtendedPadding()
 		? uint32(openssl::RandomValue<uchar>() & 0x3F)
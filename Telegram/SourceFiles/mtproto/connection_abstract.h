@@ -112,6 +112,9 @@ public:
 		return _receivedQueue;
 	}
 
+	// Lets the next received packets reuse the memory of processed ones.
+	void releaseReceived(mtpBuffer &&buffer);
+
 	template <typename Request>
 	[[nodiscard]] mtpBuffer prepareNotSecurePacket(
 		const Request &request,
@@ -149,9 +152,12 @@ protected:
 	[[nodiscard]] std::optional<MTPResPQ> readPQFakeReply(
 		const mtpBuffer &buffer) const;
 
+	[[nodiscard]] mtpBuffer takeReceivedBuffer(int size);
+
 private:
 	[[nodiscard]] uint32 extendedNotSecurePadding() const;
 
+	std::vector<mtpBuffer> _freeBuffers;
 	uint64 _sentEncryptedWithKeyId = 0;
 
 };
@@ -42,6 +42,14 @@ void HttpConnection::sendData(mtpBuffer &&buffer) {
 	request.setHeader(QNetworkRequest::ContentLengthHeader, QVariant(requestSize));
 	request.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(qsl("application/x-www-form-urlencoded")));
 
+	// Each request holds an http_wait long poll, so they are not
+	// pipelined: a request queued behind a held one would wait for it.
+	// Instead the connections are kept alive and reused in parallel.
+	request.setRawHeader("Connection", "keep-alive");
+	request.setAttribute(
+		QNetworkRequest::HttpPipeliningAllowedAttribute,
+		QVariant(false));
+
 	TCP_LOG(("HTTP Info: sending %1 len request").arg(requestSize));
 	_requests.insert(_manager.post(request, QByteArray((const char*)(&buffer[2]), requestSize)));
 }
@@ -0,0 +1,219 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_aes_ige.h"
+
+#if defined _M_X64 || defined _M_IX86 || defined __x86_64__ || defined __i386__
+#define MTP_AES_IGE_HARDWARE
+#endif // _M_X64 || _M_IX86 || __x86_64__ || __i386__
+
+#ifdef MTP_AES_IGE_HARDWARE
+
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MTP_AES_IGE_TARGET
+#else // _MSC_VER
+#include <cpuid.h>
+#define MTP_AES_IGE_TARGET __attribute__((target("aes,sse2")))
+#endif // _MSC_VER
+
+#endif // MTP_AES_IGE_HARDWARE
+
+namespace MTP::details {
+namespace {
+
+#ifdef MTP_AES_IGE_HARDWARE
+
+constexpr auto kRoundKeys = 15;
+constexpr auto kBlockSize = 16;
+
+// Plain struct, std::array would drop the alignment attributes of __m128i.
+struct RoundKeys {
+	__m128i k[kRoundKeys];
+};
+
+[[nodiscard]] bool HasHardwareAes() {
+	static const auto result = [] {
+		auto ecx = 0U, edx = 0U;
+#ifdef _MSC_VER
+		int info[4] = { 0 };
+		__cpuid(info, 1);
+		ecx = uint32(info[2]);
+		edx = uint32(info[3]);
+#else // _MSC_VER
+		auto eax = 0U, ebx = 0U;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+			return false;
+		}
+#endif // _MSC_VER
+		constexpr auto kSse2 = (1U << 26); // edx
+		constexpr auto kAes = (1U << 25); // ecx
+		return ((edx & kSse2) != 0) && ((ecx & kAes) != 0);
+	}();
+	return result;
+}
+
+MTP_AES_IGE_TARGET __m128i ExpandEven(__m128i key, __m128i assist) {
+	assist = _mm_shuffle_epi32(assist, 0xFF);
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	return _mm_xor_si128(key, assist);
+}
+
+MTP_AES_IGE_TARGET __m128i ExpandOdd(__m128i key, __m128i previous) {
+	const auto assist = _mm_shuffle_epi32(
+		_mm_aeskeygenassist_si128(previous, 0x00),
+		0xAA);
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	return _mm_xor_si128(key, assist);
+}
+
+MTP_AES_IGE_TARGET RoundKeys EncryptKeys(const void *key) {
+	const auto bytes = static_cast<const uchar*>(key);
+	auto result = RoundKeys();
+	const auto k = result.k;
+	k[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+	k[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 16));
+
+	// The round constant must be an immediate value.
+	k[2] = ExpandEven(k[0], _mm_aeskeygenassist_si128(k[1], 0x01));
+	k[3] = ExpandOdd(k[1], k[2]);
+	k[4] = ExpandEven(k[2], _mm_aeskeygenassist_si128(k[3], 0x02));
+	k[5] = ExpandOdd(k[3], k[4]);
+	k[6] = ExpandEven(k[4], _mm_aeskeygenassist_si128(k[5], 0x04));
+	k[7] = ExpandOdd(k[5], k[6]);
+	k[8] = ExpandEven(k[6], _mm_aeskeygenassist_si128(k[7], 0x08));
+	k[9] = ExpandOdd(k[7], k[8]);
+	k[10] = ExpandEven(k[8], _mm_aeskeygenassist_si128(k[9], 0x10));
+	k[11] = ExpandOdd(k[9], k[10]);
+	k[12] = ExpandEven(k[10], _mm_aeskeygenassist_si128(k[11], 0x20));
+	k[13] = ExpandOdd(k[11], k[12]);
+	k[14] = ExpandEven(k[12], _mm_aeskeygenassist_si128(k[13], 0x40));
+	return result;
+}
+
+MTP_AES_IGE_TARGET RoundKeys DecryptKeys(const void *key) {
+	const auto keys = EncryptKeys(key);
+	const auto k = keys.k;
+	auto result = RoundKeys();
+	result.k[0] = k[kRoundKeys - 1];
+	for (auto i = 1; i != kRoundKeys - 1; ++i) {
+		result.k[i] = _mm_aesimc_si128(k[kRoundKeys - 1 - i]);
+	}
+	result.k[kRoundKeys - 1] = k[0];
+	return result;
+}
+
+MTP_AES_IGE_TARGET void Encrypt(
+		const uchar *src,
+		uchar *dst,
+		uint32 len,
+		const RoundKeys &keys,
+		const uchar *iv) {
+	const auto k = keys.k;
+	auto previousOut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+	auto previousIn = _mm_loadu_si128(
+		reinterpret_cast<const __m128i*>(iv + kBlockSize));
+	for (auto till = src + len; src != till; src += kBlockSize) {
+		const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		auto block = _mm_xor_si128(in, previousOut);
+		block = _mm_xor_si128(block, k[0]);
+		for (auto i = 1; i != kRoundKeys - 1; ++i) {
+			block = _mm_aesenc_si128(block, k[i]);
+		}
+		block = _mm_aesenclast_si128(block, k[kRoundKeys - 1]);
+		previousOut = _mm_xor_si128(block, previousIn);
+		previousIn = in;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), previousOut);
+		dst += kBlockSize;
+	}
+}
+
+MTP_AES_IGE_TARGET void Decrypt(
+		const uchar *src,
+		uchar *dst,
+		uint32 len,
+		const RoundKeys &keys,
+		const uchar *iv) {
+	const auto k = keys.k;
+	auto previousIn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+	auto previousOut = _mm_loadu_si128(
+		reinterpret_cast<const __m128i*>(iv + kBlockSize));
+	for (auto till = src + len; src != till; src += kBlockSize) {
+		const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		auto block = _mm_xor_si128(in, previousOut);
+		block = _mm_xor_si128(block, k[0]);
+		for (auto i = 1; i != kRoundKeys - 1; ++i) {
+			block = _mm_aesdec_si128(block, k[i]);
+		}
+		block = _mm_aesdeclast_si128(block, k[kRoundKeys - 1]);
+		previousOut = _mm_xor_si128(block, previousIn);
+		previousIn = in;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), previousOut);
+		dst += kBlockSize;
+	}
+}
+
+#endif // MTP_AES_IGE_HARDWARE
+
+} // namespace
+
+bool AesIgeEncryptHardware(
+		const void *src,
+		void *dst,
+		uint32 len,
+		const void *key,
+		const void *iv) {
+#ifdef MTP_AES_IGE_HARDWARE
+	if (!HasHardwareAes()) {
+		return false;
+	}
+	Expects(!(len % kBlockSize));
+
+	Encrypt(
+		static_cast<const uchar*>(src),
+		static_cast<uchar*>(dst),
+		len,
+		EncryptKeys(key),
+		static_cast<const uchar*>(iv));
+	return true;
+#else // MTP_AES_IGE_HARDWARE
+	return false;
+#endif // MTP_AES_IGE_HARDWARE
+}
+
+bool AesIgeDecryptHardware(
+		const void *src,
+		void *dst,
+		uint32 len,
+		const void *key,
+		const void *iv) {
+#ifdef MTP_AES_IGE_HARDWARE
+	if (!HasHardwareAes()) {
+		return false;
+	}
+	Expects(!(len % kBlockSize));
+
+	Decrypt(
+		static_cast<const uchar*>(src),
+		static_cast<uchar*>(dst),
+		len,
+		DecryptKeys(key),
+		static_cast<const uchar*>(iv));
+	return true;
+#else // MTP_AES_IGE_HARDWARE
+	return false;
+#endif // MTP_AES_IGE_HARDWARE
+}
+
+} // namespace MTP::details
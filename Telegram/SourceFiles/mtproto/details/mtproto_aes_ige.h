@@ -0,0 +1,31 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace MTP::details {
+
+// AES-256-IGE with the hardware AES instructions when the CPU has them.
+// The key is 32 bytes, the iv is 32 bytes like in OpenSSL AES_ige_encrypt,
+// len is a multiple of 16 and src may be equal to dst.
+//
+// Both return false if the instructions are not available, then nothing
+// is done and the OpenSSL implementation should be used instead.
+[[nodiscard]] bool AesIgeEncryptHardware(
+	const void *src,
+	void *dst,
+	uint32 len,
+	const void *key,
+	const void *iv);
+[[nodiscard]] bool AesIgeDecryptHardware(
+	const void *src,
+	void *dst,
+	uint32 len,
+	const void *key,
+	const void *iv);
+
+} // namespace MTP::details
@@ -486,9 +486,7 @@ void DcKeyCreator::dhClientParamsSend(not_null<Attempt*> attempt) {
 	}
 
 	// gen rand 'b'
-	auto randomSeed = bytes::vector(ModExpFirst::kRandomPowerSize);
-	bytes::set_random(randomSeed);
-	auto g_b_data = CreateModExp(attempt->data.g, attempt->dhPrime, randomSeed);
+	auto g_b_data = TakePreparedModExp(attempt->data.g, attempt->dhPrime);
 	if (g_b_data.modexp.empty()) {
 		LOG(("AuthKey Error: could not generate good g_b."));
 		return failed();
@@ -315,6 +315,7 @@ void DomainResolver::requestFinished(
 	const auto result = finalizeRequest(key, reply);
 	const auto response = ParseDnsResponse(result);
 	if (response.empty()) {
+		requestFailed(key);
 		return;
 	}
 	_requests.erase(key);
@@ -335,6 +336,23 @@ void DomainResolver::requestFinished(
 	checkExpireAndPushResult(key.domain);
 }
 
+void DomainResolver::requestFailed(const AttemptKey &key) {
+	if (_requests.find(key) != end(_requests)) {
+		return;
+	}
+	const auto i = _attempts.find(key);
+	if (i == end(_attempts)) {
+		return;
+	} else if (i->second.list.empty()) {
+		// All the providers failed, allow the next resolve() to try again.
+		_attempts.erase(i);
+		return;
+	}
+	// Nothing else is in flight, don't wait for the timeout to try next.
+	invalidate_weak_ptrs(&i->second.guard);
+	sendNextRequest(key);
+}
+
 QByteArray DomainResolver::finalizeRequest(
 		const AttemptKey &key,
 		not_null<QNetworkReply*> reply) {
@@ -86,6 +86,7 @@ private:
 	void requestFinished(
 		const AttemptKey &key,
 		not_null<QNetworkReply*> reply);
+	void requestFailed(const AttemptKey &key);
 	QByteArray finalizeRequest(
 		const AttemptKey &key,
 		not_null<QNetworkReply*> reply);
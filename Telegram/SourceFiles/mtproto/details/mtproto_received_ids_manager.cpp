@@ -10,10 +10,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace MTP::details {
 
 bool ReceivedIdsManager::registerMsgId(mtpMsgId msgId, bool needAck) {
-	const auto i = _idsNeedAck.find(msgId);
-	if (i == _idsNeedAck.end()) {
-		if (_idsNeedAck.size() < kIdsBufferSize || msgId > min()) {
-			_idsNeedAck.emplace(msgId, needAck);
+	const auto i = find(msgId);
+	if (i == _ids.end() || i->msgId != msgId) {
+		if (_ids.size() < kIdsBufferSize || msgId > min()) {
+			_ids.insert(i, Received{ msgId, needAck });
 			return true;
 		}
 		MTP_LOG(-1, ("No need to handle - %1 < min = %2").arg(msgId).arg(min()));
@@ -24,31 +24,38 @@ bool ReceivedIdsManager::registerMsgId(mtpMsgId msgId, bool needAck) {
 }
 
 mtpMsgId ReceivedIdsManager::min() const {
-	return _idsNeedAck.empty() ? 0 : _idsNeedAck.begin()->first;
+	return _ids.empty() ? 0 : _ids.front().msgId;
 }
 
 mtpMsgId ReceivedIdsManager::max() const {
-	auto end = _idsNeedAck.end();
-	return _idsNeedAck.empty() ? 0 : (--end)->first;
+	return _ids.empty() ? 0 : _ids.back().msgId;
 }
 
 ReceivedIdsManager::State ReceivedIdsManager::lookup(mtpMsgId msgId) const {
-	auto i = _idsNeedAck.find(msgId);
-	if (i == _idsNeedAck.end()) {
+	const auto i = find(msgId);
+	if (i == _ids.end() || i->msgId != msgId) {
 		return State::NotFound;
 	}
-	return i->second ? State::NeedsAck : State::NoAckNeeded;
+	return i->needAck ? State::NeedsAck : State::NoAckNeeded;
+}
+
+auto ReceivedIdsManager::find(mtpMsgId msgId) const
+-> std::deque<Received>::const_iterator {
+	// The newest ids are checked most often, look at the end first.
+	if (_ids.empty() || _ids.back().msgId < msgId) {
+		return _ids.end();
+	}
+	return ranges::lower_bound(_ids, msgId, ranges::less(), &Received::msgId);
 }
 
 void ReceivedIdsManager::shrink() {
-	auto size = _idsNeedAck.size();
-	while (size-- > kIdsBufferSize) {
-		_idsNeedAck.erase(_idsNeedAck.begin());
+	while (_ids.size() > kIdsBufferSize) {
+		_ids.pop_front();
 	}
 }
 
 void ReceivedIdsManager::clear() {
-	_idsNeedAck.clear();
+	_ids.clear();
 }
 
 } // namespace MTP::details
@@ -7,7 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
-#include "base/flat_map.h"
+#include <deque>
 
 namespace MTP::details {
 
@@ -31,7 +31,16 @@ public:
 	void clear();
 
 private:
-	base::flat_map<mtpMsgId, bool> _idsNeedAck;
+	struct Received {
+		mtpMsgId msgId = 0;
+		bool needAck = false;
+	};
+	[[nodiscard]] std::deque<Received>::const_iterator find(
+		mtpMsgId msgId) const;
+
+	// Sorted by msgId. Ids come almost in order, so new ones are inserted
+	// near the end and old ones are dropped from the front in O(1).
+	std::deque<Received> _ids;
 
 };
 
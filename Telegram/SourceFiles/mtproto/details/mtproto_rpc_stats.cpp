@@ -0,0 +1,140 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_rpc_stats.h"
+
+namespace MTP::details {
+namespace {
+
+// Upper bounds of the latency histogram buckets, the last one is open.
+constexpr auto kLatencyBounds = std::array<crl::time, 8>{ {
+	50,
+	100,
+	250,
+	500,
+	1000,
+	2500,
+	5000,
+	10000,
+} };
+
+static_assert(kLatencyBounds.size() == RpcStats::kLatencyBuckets);
+
+// Only the most used methods are listed in the text.
+constexpr auto kMethodsInText = 20;
+
+} // namespace
+
+void RpcStats::requestSent(
+		mtpRequestId requestId,
+		DcId dcId,
+		mtpTypeId type) {
+	QMutexLocker lock(&_mutex);
+	_started[requestId] = Started{ crl::now(), dcId, type };
+}
+
+void RpcStats::requestDone(mtpRequestId requestId) {
+	QMutexLocker lock(&_mutex);
+	const auto i = _started.find(requestId);
+	if (i == end(_started)) {
+		return;
+	}
+	const auto duration = crl::now() - i->second.at;
+	Add(_dcs[i->second.dcId].latency, duration);
+	Add(_methods[i->second.type], duration);
+	_started.erase(i);
+}
+
+void RpcStats::requestFloodWait(mtpRequestId requestId) {
+	QMutexLocker lock(&_mutex);
+	const auto i = _started.find(requestId);
+	if (i != end(_started)) {
+		++_dcs[i->second.dcId].floodWaits;
+	}
+}
+
+void RpcStats::requestForgotten(mtpRequestId requestId) {
+	QMutexLocker lock(&_mutex);
+	_started.erase(requestId);
+}
+
+void RpcStats::bytesSent(DcId dcId, int64 bytes) {
+	QMutexLocker lock(&_mutex);
+	_dcs[dcId].sent += bytes;
+}
+
+void RpcStats::bytesReceived(DcId dcId, int64 bytes) {
+	QMutexLocker lock(&_mutex);
+	_dcs[dcId].received += bytes;
+}
+
+void RpcStats::connectionRestarted(DcId dcId) {
+	QMutexLocker lock(&_mutex);
+	++_dcs[dcId].restarts;
+}
+
+void RpcStats::Add(Latency &latency, crl::time duration) {
+	const auto bucket = ranges::upper_bound(kLatencyBounds, duration)
+		- begin(kLatencyBounds);
+	++latency.buckets[bucket];
+	++latency.count;
+	latency.total += duration;
+	accumulate_max(latency.max, duration);
+}
+
+QString RpcStats::LatencyText(const Latency &latency) {
+	if (!latency.count) {
+		return "no requests";
+	}
+	auto buckets = QStringList();
+	for (auto i = 0; i != kLatencyBuckets + 1; ++i) {
+		buckets.push_back((i < kLatencyBuckets)
+			? QString("<%1:%2").arg(kLatencyBounds[i]).arg(latency.buckets[i])
+			: QString(">=%1:%2"
+			).arg(kLatencyBounds.back()
+			).arg(latency.buckets[i]));
+	}
+	return QString("%1 requests, avg %2 ms, max %3 ms [%4]"
+		).arg(latency.count
+		).arg(latency.total / latency.count
+		).arg(latency.max
+		).arg(buckets.join(' '));
+}
+
+QString RpcStats::text() const {
+	QMutexLocker lock(&_mutex);
+	auto lines = QStringList();
+	for (const auto &[dcId, stats] : _dcs) {
+		lines.push_back(QString("DC %1: sent %2 KB, received %3 KB, "
+			"restarts %4, flood waits %5, %6"
+			).arg(dcId
+			).arg(stats.sent / 1024
+			).arg(stats.received / 1024
+			).arg(stats.restarts
+			).arg(stats.floodWaits
+			).arg(LatencyText(stats.latency)));
+	}
+	auto methods = std::vector<std::pair<mtpTypeId, const Latency*>>();
+	methods.reserve(_methods.size());
+	for (const auto &[type, latency] : _methods) {
+		methods.emplace_back(type, &latency);
+	}
+	ranges::sort(methods, ranges::greater(), [](const auto &method) {
+		return method.second->count;
+	});
+	if (int(methods.size()) > kMethodsInText) {
+		methods.resize(kMethodsInText);
+	}
+	for (const auto &[type, latency] : methods) {
+		lines.push_back(QString("Method 0x%1: %2"
+			).arg(type, 8, 16, QChar('0')
+			).arg(LatencyText(*latency)));
+	}
+	return lines.join('\n');
+}
+
+} // namespace MTP::details
@@ -0,0 +1,63 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <QtCore/QMutex>
+
+namespace MTP {
+namespace details {
+
+// Traffic, connection restarts, flood waits and RPC latencies
+// aggregated by dc and by method since the instance was started.
+class RpcStats final {
+public:
+	// Thread-safe.
+	void requestSent(mtpRequestId requestId, DcId dcId, mtpTypeId type);
+	void requestDone(mtpRequestId requestId);
+	void requestFloodWait(mtpRequestId requestId);
+	void requestForgotten(mtpRequestId requestId);
+	void bytesSent(DcId dcId, int64 bytes);
+	void bytesReceived(DcId dcId, int64 bytes);
+	void connectionRestarted(DcId dcId);
+
+	[[nodiscard]] QString text() const;
+
+	static constexpr auto kLatencyBuckets = 8;
+
+private:
+	struct Latency {
+		std::array<int, kLatencyBuckets + 1> buckets = { { 0 } };
+		int count = 0;
+		crl::time total = 0;
+		crl::time max = 0;
+	};
+	struct DcStats {
+		int64 sent = 0;
+		int64 received = 0;
+		int restarts = 0;
+		int floodWaits = 0;
+		Latency latency;
+	};
+	struct Started {
+		crl::time at = 0;
+		DcId dcId = 0;
+		mtpTypeId type = 0;
+	};
+
+	static void Add(Latency &latency, crl::time duration);
+	[[nodiscard]] static QString LatencyText(const Latency &latency);
+
+	mutable QMutex _mutex;
+	std::map<mtpRequestId, Started> _started;
+	base::flat_map<DcId, DcStats> _dcs;
+	base::flat_map<mtpTypeId, Latency> _methods;
+
+};
+
+} // namespace details
+} // namespace MTP
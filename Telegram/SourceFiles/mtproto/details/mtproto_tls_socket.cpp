@@ -28,6 +28,7 @@ const auto kServerHelloPart3 = qstr("\x14\x03\x03\x00\x01\x01\x17\x03\x03");
 constexpr auto kServerHelloDigestPosition = 11;
 const auto kServerHeader = qstr("\x17\x03\x03");
 constexpr auto kClientPartSize = 2878;
+constexpr auto kMaxOutgoingSize = 16 * kClientPartSize;
 const auto kClientPrefix = qstr("\x14\x03\x03\x00\x01\x01");
 const auto kClientHeader = qstr("\x17\x03\x03");
 
@@ -511,6 +512,7 @@ void TlsSocket::plainConnected() {
 void TlsSocket::plainDisconnected() {
 	_state = State::NotConnected;
 	_incoming = QByteArray();
+	_outgoing = QByteArray();
 	_serverHelloLength = 0;
 	_incomingGoodDataOffset = 0;
 	_incomingGoodDataLimit = 0;
@@ -740,26 +742,52 @@ void TlsSocket::write(bytes::const_span prefix, bytes::const_span buffer) {
 		return;
 	}
 	if (!prefix.empty()) {
+		flushOutgoing();
 		_socket.write(kClientPrefix.data(), kClientPrefix.size());
+		_outgoing.append(
+			reinterpret_cast<const char*>(prefix.data()),
+			prefix.size());
+	}
+	_outgoing.append(
+		reinterpret_cast<const char*>(buffer.data()),
+		buffer.size());
+
+	// Small packets sent in one event loop iteration share the records.
+	if (_outgoing.size() >= kMaxOutgoingSize) {
+		flushOutgoing();
+	} else if (!_flushOutgoingQueued) {
+		_flushOutgoingQueued = true;
+		InvokeQueued(this, [=] {
+			_flushOutgoingQueued = false;
+			flushOutgoing();
+		});
 	}
-	while (!buffer.empty()) {
+}
+
+void TlsSocket::flushOutgoing() {
+	if (_outgoing.isEmpty() || !isConnected()) {
+		_outgoing.clear();
+		return;
+	}
+	const auto payload = base::take(_outgoing);
+	const auto records = (payload.size() + kClientPartSize - 1)
+		/ kClientPartSize;
+	const auto recordHeaderSize = kClientHeader.size() + kLengthSize;
+
+	// Write all the records at once instead of four writes per record.
+	auto data = QByteArray();
+	data.reserve(payload.size() + records * recordHeaderSize);
+	for (auto offset = 0; offset < payload.size();) {
 		const auto write = std::min(
-			kClientPartSize - prefix.size(),
-			buffer.size());
-		_socket.write(kClientHeader.data(), kClientHeader.size());
-		const auto size = qToBigEndian(uint16(prefix.size() + write));
-		_socket.write(reinterpret_cast<const char*>(&size), sizeof(size));
-		if (!prefix.empty()) {
-			_socket.write(
-				reinterpret_cast<const char*>(prefix.data()),
-				prefix.size());
-			prefix = bytes::const_span();
-		}
-		_socket.write(
-			reinterpret_cast<const char*>(buffer.data()),
-			write);
-		buffer = buffer.subspan(write);
+			int(kClientPartSize),
+			payload.size() - offset);
+		const auto size = qToBigEndian(uint16(write));
+		data.append(kClientHeader.data(), kClientHeader.size());
+		data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+		data.append(payload.constData() + offset, write);
+		offset += write;
 	}
+	_socket.write(data);
 }
 
 int32 TlsSocket::debugState() {
@@ -774,6 +802,7 @@ void TlsSocket::handleError(int errorCode) {
 		TcpSocket::LogError(errorCode, _socket.errorString());
 	}
 	_state = State::Error;
+	_outgoing = QByteArray();
 	_error.fire({});
 }
 
@@ -52,6 +52,7 @@ private:
 	void readData();
 	[[nodiscard]] bool checkNextPacket();
 	void shiftIncomingBy(int amount);
+	void flushOutgoing();
 
 	const bytes::vector _secret;
 	QTcpSocket _socket;
@@ -61,6 +62,10 @@ private:
 	int _incomingGoodDataLimit = 0;
 	int16 _serverHelloLength = 0;
 
+	// Packets are gathered here and sent in full-size records.
+	QByteArray _outgoing;
+	bool _flushOutgoingQueued = false;
+
 };
 
 } // namespace MTP::details
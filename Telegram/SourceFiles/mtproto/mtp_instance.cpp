@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtp_instance.h"
 
 #include "mtproto/details/mtproto_dcenter.h"
+#include "mtproto/details/mtproto_rpc_stats.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
 #include "mtproto/special_config_request.h"
 #include "mtproto/session.h"
@@ -33,6 +34,8 @@ namespace {
 constexpr auto kConfigBecomesOldIn = 2 * 60 * crl::time(1000);
 constexpr auto kConfigBecomesOldForBlockedIn = 8 * crl::time(1000);
 constexpr auto kCheckKeyEach = 60 * crl::time(1000);
+constexpr auto kLogRpcStatsEach = 60 * crl::time(1000);
+constexpr auto kWarmUpTimeout = 60 * crl::time(1000);
 
 using namespace details;
 
@@ -66,6 +69,7 @@ public:
 	[[nodiscard]] DcOptions &dcOptions() const;
 	[[nodiscard]] Environment environment() const;
 	[[nodiscard]] bool isTestMode() const;
+	[[nodiscard]] RpcStats &rpcStats() const;
 
 	void resolveProxyDomain(const QString &host);
 	void setGoodProxyDomain(const QString &host, const QString &ip);
@@ -183,6 +187,11 @@ private:
 	Session *removeSession(ShiftedDcId shiftedDcId);
 	[[nodiscard]] not_null<QThread*> getThreadForDc(ShiftedDcId shiftedDcId);
 
+	// Download and upload sessions share a fixed pool of threads,
+	// each new one goes to the thread with the fewest sessions.
+	[[nodiscard]] int chooseFileSessionThread(ShiftedDcId shiftedDcId);
+	void releaseFileSessionThread(ShiftedDcId shiftedDcId);
+
 	void applyDomainIps(
 		const QString &host,
 		const QStringList &ips,
@@ -195,6 +204,10 @@ private:
 	void configLoadDone(const MTPConfig &result);
 	bool configLoadFail(const RPCError &error);
 
+	// Creates the auth keys of the other dcs before they are needed.
+	void warmUpDcKeys();
+	void finishWarmUp(DcId dcId);
+
 	std::optional<ShiftedDcId> queryRequestByDc(
 		mtpRequestId requestId) const;
 	std::optional<ShiftedDcId> changeRequestByDc(
@@ -209,6 +222,8 @@ private:
 	std::unique_ptr<QThread> _mainSessionThread;
 	std::unique_ptr<QThread> _otherSessionsThread;
 	std::vector<std::unique_ptr<QThread>> _fileSessionThreads;
+	std::vector<int> _fileSessionThreadLoads;
+	base::flat_map<ShiftedDcId, int> _fileSessionThreadIndices;
 
 	QString _deviceModel;
 	QString _systemVersion;
@@ -265,6 +280,13 @@ private:
 
 	base::Timer _checkDelayedTimer;
 
+	mutable RpcStats _rpcStats;
+	base::Timer _logRpcStatsTimer;
+
+	base::flat_set<ShiftedDcId> _warmUpSessions;
+	base::Timer _warmUpTimer;
+	bool _warmUpStarted = false;
+
 	rpl::lifetime _lifetime;
 
 };
@@ -289,6 +311,7 @@ Instance::Private::Private(
 
 	const auto idealThreadPoolSize = QThread::idealThreadCount();
 	_fileSessionThreads.resize(2 * std::max(idealThreadPoolSize / 2, 1));
+	_fileSessionThreadLoads.resize(_fileSessionThreads.size());
 
 	details::unpaused(
 	) | rpl::start_with_next([=] {
@@ -331,6 +354,13 @@ void Instance::Private::start() {
 
 	_checkDelayedTimer.setCallback([this] { checkDelayedRequests(); });
 
+	_logRpcStatsTimer.setCallback([=] {
+		DEBUG_LOG(("RPC Stats:\n%1").arg(_rpcStats.text()));
+	});
+	_logRpcStatsTimer.callEach(kLogRpcStatsEach);
+
+	_warmUpTimer.setCallback([=] { finishWarmUp(0); });
+
 	Assert((_mainDcId == Fields::kNoneMainDc) == isKeysDestroyer());
 	requestConfig();
 }
@@ -761,6 +791,9 @@ void Instance::Private::dcPersistentKeyChanged(
 }
 
 void Instance::Private::dcTemporaryKeyChanged(DcId dcId) {
+	if (!_warmUpSessions.empty()) {
+		finishWarmUp(dcId);
+	}
 	_dcTemporaryKeyChanged.fire_copy(dcId);
 }
 
@@ -817,6 +850,10 @@ DcOptions &Instance::Private::dcOptions() const {
 	return _config->dcOptions();
 }
 
+RpcStats &Instance::Private::rpcStats() const {
+	return _rpcStats;
+}
+
 Environment Instance::Private::environment() const {
 	return _config->environment();
 }
@@ -860,6 +897,48 @@ void Instance::Private::configLoadDone(const MTPConfig &result) {
 	_configExpiresAt = crl::now()
 		+ (data.vexpires().v - base::unixtime::now()) * crl::time(1000);
 	requestConfigIfExpired();
+
+	warmUpDcKeys();
+}
+
+void Instance::Private::warmUpDcKeys() {
+	if (_warmUpStarted || isKeysDestroyer()) {
+		return;
+	}
+	_warmUpStarted = true;
+
+	// Persistent keys are written with the other keys, so only the dcs
+	// that were never used get the key exchange, once, right after the
+	// first config. Later requests to them skip the key creation wait.
+	for (const auto dcId : _config->dcOptions().configEnumDcIds()) {
+		if (dcId == _mainDcId || getDcById(dcId)->getPersistentKey()) {
+			continue;
+		}
+		const auto shiftedDcId = ShiftDcId(dcId, kWarmUpDcShift);
+		DEBUG_LOG(("MTP Info: warming up dcWithShift %1").arg(shiftedDcId));
+		_warmUpSessions.emplace(shiftedDcId);
+		getSession(shiftedDcId);
+	}
+	if (!_warmUpSessions.empty()) {
+		_warmUpTimer.callOnce(kWarmUpTimeout);
+	}
+}
+
+void Instance::Private::finishWarmUp(DcId dcId) {
+	// Zero dcId stops all the warm up sessions that are still working.
+	auto finished = std::vector<ShiftedDcId>();
+	for (const auto shiftedDcId : _warmUpSessions) {
+		if (!dcId || BareDcId(shiftedDcId) == dcId) {
+			finished.push_back(shiftedDcId);
+		}
+	}
+	for (const auto shiftedDcId : finished) {
+		_warmUpSessions.remove(shiftedDcId);
+		killSession(shiftedDcId);
+	}
+	if (_warmUpSessions.empty()) {
+		_warmUpTimer.cancel();
+	}
 }
 
 bool Instance::Private::configLoadFail(const RPCError &error) {
@@ -946,6 +1025,10 @@ void Instance::Private::sendRequest(
 	const auto realShiftedDcId = session->getDcWithShift();
 	const auto signedDcId = toMainDc ? -realShiftedDcId : realShiftedDcId;
 	registerRequest(requestId, signedDcId);
+	_rpcStats.requestSent(
+		requestId,
+		BareDcId(realShiftedDcId),
+		mtpTypeId((*request)[SerializedRequest::kMessageBodyPosition]));
 
 	if (afterRequestId) {
 		request->after = getRequest(afterRequestId);
@@ -967,6 +1050,7 @@ void Instance::Private::unregisterRequest(mtpRequestId requestId) {
 	DEBUG_LOG(("MTP Info: unregistering request %1.").arg(requestId));
 
 	_requestsDelays.erase(requestId);
+	_rpcStats.requestForgotten(requestId);
 
 	{
 		QWriteLocker locker(&_requestMapLock);
@@ -1027,6 +1111,7 @@ void Instance::Private::execCallback(
 				).arg(error.type()
 				).arg(error.description()));
 			if (rpcErrorOccured(requestId, h, error)) {
+				_rpcStats.requestDone(requestId);
 				unregisterRequest(requestId);
 			} else {
 				QMutexLocker locker(&_parserMapLock);
@@ -1051,10 +1136,12 @@ void Instance::Private::execCallback(
 						"Response parse failed."));
 				}
 			}
+			_rpcStats.requestDone(requestId);
 			unregisterRequest(requestId);
 		}
 	} else {
 		DEBUG_LOG(("RPC Info: parser not found for %1").arg(requestId));
+		_rpcStats.requestDone(requestId);
 		unregisterRequest(requestId);
 	}
 }
@@ -1273,6 +1360,7 @@ bool Instance::Private::onErrorDefault(mtpRequestId requestId, const RPCError &e
 			}
 		} else {
 			secs = m.captured(1).toInt();
+			_rpcStats.requestFloodWait(requestId);
 //			if (secs >= 60) return false;
 		}
 		auto sendAt = crl::now() + secs * 1000 + 10;
@@ -1452,6 +1540,7 @@ Session *Instance::Private::removeSession(ShiftedDcId shiftedDcId) {
 		return nullptr;
 	}
 	i->second->kill();
+	releaseFileSessionThread(shiftedDcId);
 	_sessionsToDestroy.push_back(std::move(i->second));
 	_sessions.erase(i);
 	return _sessionsToDestroy.back().get();
@@ -1470,44 +1559,55 @@ not_null<QThread*> Instance::Private::getThreadForDc(
 		}
 		return thread.get();
 	};
-	static const auto FindOne = [](
-			std::vector<std::unique_ptr<QThread>> &threads,
-			const char *prefix,
-			int index,
-			bool shift) {
-		Expects(!threads.empty());
-		Expects(!(threads.size() % 2));
-
-		const auto count = int(threads.size());
-		index %= count;
-		if (index >= count / 2) {
-			index = (count - 1) - (index - count / 2);
-		}
-		if (shift) {
-			index = (index + count / 2) % count;
-		}
-		return EnsureStarted(threads[index], [=] {
-			return QString("MTP %1 Session (%2)").arg(prefix).arg(index);
-		});
-	};
 	if (shiftedDcId == BareDcId(shiftedDcId)) {
 		return EnsureStarted(_mainSessionThread, [] {
 			return QString("MTP Main Session");
 		});
-	} else if (isDownloadDcId(shiftedDcId)) {
-		const auto index = GetDcIdShift(shiftedDcId) - kBaseDownloadDcShift;
-		const auto composed = index + BareDcId(shiftedDcId);
-		return FindOne(_fileSessionThreads, "Download", composed, false);
-	} else if (isUploadDcId(shiftedDcId)) {
-		const auto index = GetDcIdShift(shiftedDcId) - kBaseUploadDcShift;
-		const auto composed = index + BareDcId(shiftedDcId);
-		return FindOne(_fileSessionThreads, "Upload", composed, true);
+	} else if (isDownloadDcId(shiftedDcId) || isUploadDcId(shiftedDcId)) {
+		const auto index = chooseFileSessionThread(shiftedDcId);
+		return EnsureStarted(_fileSessionThreads[index], [=] {
+			return QString("MTP File Session (%1)").arg(index);
+		});
 	}
 	return EnsureStarted(_otherSessionsThread, [] {
 		return QString("MTP Other Session");
 	});
 }
 
+int Instance::Private::chooseFileSessionThread(ShiftedDcId shiftedDcId) {
+	Expects(!_fileSessionThreads.empty());
+	Expects(_fileSessionThreadLoads.size() == _fileSessionThreads.size());
+
+	const auto i = _fileSessionThreadIndices.find(shiftedDcId);
+	if (i != end(_fileSessionThreadIndices)) {
+		return i->second;
+	}
+
+	// The least loaded thread, the already started ones are preferred.
+	auto result = 0;
+	for (auto index = 1; index != int(_fileSessionThreads.size()); ++index) {
+		const auto load = _fileSessionThreadLoads[index];
+		const auto best = _fileSessionThreadLoads[result];
+		if (load < best
+			|| (load == best
+				&& _fileSessionThreads[index]
+				&& !_fileSessionThreads[result])) {
+			result = index;
+		}
+	}
+	++_fileSessionThreadLoads[result];
+	_fileSessionThreadIndices.emplace(shiftedDcId, result);
+	return result;
+}
+
+void Instance::Private::releaseFileSessionThread(ShiftedDcId shiftedDcId) {
+	const auto i = _fileSessionThreadIndices.find(shiftedDcId);
+	if (i != end(_fileSessionThreadIndices)) {
+		--_fileSessionThreadLoads[i->second];
+		_fileSessionThreadIndices.erase(i);
+	}
+}
+
 void Instance::Private::scheduleKeyDestroy(ShiftedDcId shiftedDcId) {
 	Expects(isKeysDestroyer());
 
@@ -1790,6 +1890,10 @@ DcOptions &Instance::dcOptions() const {
 	return _private->dcOptions();
 }
 
+RpcStats &Instance::rpcStats() const {
+	return _private->rpcStats();
+}
+
 Environment Instance::environment() const {
 	return _private->environment();
 }
@@ -15,6 +15,7 @@ namespace details {
 
 class Dcenter;
 class Session;
+class RpcStats;
 
 [[nodiscard]] int GetNextRequestId();
 
@@ -80,6 +81,7 @@ public:
 	[[nodiscard]] bool isTestMode() const;
 	[[nodiscard]] QString deviceModel() const;
 	[[nodiscard]] QString systemVersion() const;
+	[[nodiscard]] details::RpcStats &rpcStats() const;
 
 	// Main thread.
 	void dcPersistentKeyChanged(DcId dcId, const AuthKeyPtr &persistentKey);
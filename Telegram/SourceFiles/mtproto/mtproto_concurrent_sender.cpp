@@ -11,13 +11,32 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_rpc_sender.h"
 #include "mtproto/facade.h"
 
+#include <QtCore/QMutex>
+
 namespace MTP {
 
+class ConcurrentSender::Queue final {
+public:
+	// Runs the callback on the thread, waking it only if it was idle.
+	void push(
+		FnMut<void()> callback,
+		const std::shared_ptr<Queue> &self,
+		const Fn<void(FnMut<void()>)> &runner);
+
+private:
+	void run();
+
+	QMutex _mutex;
+	std::vector<FnMut<void()>> _callbacks;
+
+};
+
 class ConcurrentSender::RPCDoneHandler : public RPCAbstractDoneHandler {
 public:
 	RPCDoneHandler(
 		not_null<ConcurrentSender*> sender,
-		Fn<void(FnMut<void()>)> runner);
+		Fn<void(FnMut<void()>)> runner,
+		std::shared_ptr<Queue> queue);
 
 	bool operator()(
 		mtpRequestId requestId,
@@ -27,6 +46,7 @@ public:
 private:
 	base::weak_ptr<ConcurrentSender> _weak;
 	Fn<void(FnMut<void()>)> _runner;
+	std::shared_ptr<Queue> _queue;
 
 };
 
@@ -35,6 +55,7 @@ public:
 	RPCFailHandler(
 		not_null<ConcurrentSender*> sender,
 		Fn<void(FnMut<void()>)> runner,
+		std::shared_ptr<Queue> queue,
 		FailSkipPolicy skipPolicy);
 
 	bool operator()(
@@ -44,15 +65,44 @@ public:
 private:
 	base::weak_ptr<ConcurrentSender> _weak;
 	Fn<void(FnMut<void()>)> _runner;
+	std::shared_ptr<Queue> _queue;
 	FailSkipPolicy _skipPolicy = FailSkipPolicy::Simple;
 
 };
 
+void ConcurrentSender::Queue::push(
+		FnMut<void()> callback,
+		const std::shared_ptr<Queue> &self,
+		const Fn<void(FnMut<void()>)> &runner) {
+	Expects(self.get() == this);
+
+	QMutexLocker lock(&_mutex);
+	const auto wake = _callbacks.empty();
+	_callbacks.push_back(std::move(callback));
+	lock.unlock();
+
+	if (wake) {
+		runner([=] { self->run(); });
+	}
+}
+
+void ConcurrentSender::Queue::run() {
+	QMutexLocker lock(&_mutex);
+	auto callbacks = base::take(_callbacks);
+	lock.unlock();
+
+	for (auto &callback : callbacks) {
+		std::move(callback)();
+	}
+}
+
 ConcurrentSender::RPCDoneHandler::RPCDoneHandler(
 	not_null<ConcurrentSender*> sender,
-	Fn<void(FnMut<void()>)> runner)
+	Fn<void(FnMut<void()>)> runner,
+	std::shared_ptr<Queue> queue)
 : _weak(sender)
-, _runner(std::move(runner)) {
+, _runner(std::move(runner))
+, _queue(std::move(queue)) {
 }
 
 bool ConcurrentSender::RPCDoneHandler::operator()(
@@ -62,20 +112,22 @@ bool ConcurrentSender::RPCDoneHandler::operator()(
 	auto response = gsl::make_span(
 		from,
 		end - from);
-	_runner([=, weak = _weak, moved = bytes::make_vector(response)]() mutable {
+	_queue->push([=, weak = _weak, moved = bytes::make_vector(response)]() mutable {
 		if (const auto strong = weak.get()) {
 			strong->senderRequestDone(requestId, std::move(moved));
 		}
-	});
+	}, _queue, _runner);
 	return true;
 }
 
 ConcurrentSender::RPCFailHandler::RPCFailHandler(
 	not_null<ConcurrentSender*> sender,
 	Fn<void(FnMut<void()>)> runner,
+	std::shared_ptr<Queue> queue,
 	FailSkipPolicy skipPolicy)
 : _weak(sender)
 , _runner(std::move(runner))
+, _queue(std::move(queue))
 , _skipPolicy(skipPolicy) {
 }
 
@@ -91,25 +143,29 @@ bool ConcurrentSender::RPCFailHandler::operator()(
 			return false;
 		}
 	}
-	_runner([=, weak = _weak, error = error]() mutable {
+	_queue->push([=, weak = _weak, error = error]() mutable {
 		if (const auto strong = weak.get()) {
 			strong->senderRequestFail(requestId, std::move(error));
 		}
-	});
+	}, _queue, _runner);
 	return true;
 }
 
 template <typename Method>
 auto ConcurrentSender::with_instance(Method &&method)
 -> std::enable_if_t<is_callable_v<Method, not_null<Instance*>>> {
-	crl::on_main([
+	static const auto runner = Fn<void(FnMut<void()>)>([](
+			FnMut<void()> callback) {
+		crl::on_main(std::move(callback));
+	});
+	_toMain->push([
 		weak = _weak,
 		method = std::forward<Method>(method)
 	]() mutable {
 		if (const auto instance = weak.data()) {
 			std::move(method)(instance);
 		}
-	});
+	}, _toMain, runner);
 }
 
 ConcurrentSender::RequestBuilder::RequestBuilder(
@@ -147,10 +203,14 @@ mtpRequestId ConcurrentSender::RequestBuilder::send() {
 	_sender->with_instance([
 		=,
 		request = std::move(_serialized),
-		done = std::make_shared<RPCDoneHandler>(_sender, _sender->_runner),
+		done = std::make_shared<RPCDoneHandler>(
+			_sender,
+			_sender->_runner,
+			_sender->_fromMain),
 		fail = std::make_shared<RPCFailHandler>(
 			_sender,
 			_sender->_runner,
+			_sender->_fromMain,
 			_failSkipPolicy)
 	](not_null<Instance*> instance) mutable {
 		instance->sendSerialized(
@@ -169,7 +229,9 @@ ConcurrentSender::ConcurrentSender(
 	QPointer<Instance> weak,
 	Fn<void(FnMut<void()>)> runner)
 : _weak(weak)
-, _runner(runner) {
+, _runner(runner)
+, _toMain(std::make_shared<Queue>())
+, _fromMain(std::make_shared<Queue>()) {
 }
 
 ConcurrentSender::~ConcurrentSender() {
@@ -178,6 +178,7 @@ public:
 	~ConcurrentSender();
 
 private:
+	class Queue;
 	class RPCDoneHandler;
 	friend class RPCDoneHandler;
 	class RPCFailHandler;
@@ -200,6 +201,11 @@ private:
 	const Fn<void(FnMut<void()>)> _runner;
 	base::flat_map<mtpRequestId, Handlers> _requests;
 
+	// Requests and responses are passed between the threads in batches,
+	// all the ones queued before the other thread wakes up at once.
+	const std::shared_ptr<Queue> _toMain;
+	const std::shared_ptr<Queue> _fromMain;
+
 };
 
 template <typename Response, typename InvokeFullDone>
@@ -150,6 +150,7 @@ DcOptions::DcOptions(const DcOptions &other)
 , _cdnDcIds(other._cdnDcIds)
 , _publicKeys(other._publicKeys)
 , _cdnPublicKeys(other._cdnPublicKeys)
+, _preferredEndpoints(other._preferredEndpoints)
 , _immutable(other._immutable) {
 }
 
@@ -459,6 +460,14 @@ QByteArray DcOptions::serialize() const {
 		}
 	}
 
+	// Preferred endpoints.
+	size += sizeof(qint32);
+	for (const auto &[dcId, endpoint] : _preferredEndpoints) {
+		// dcId + protocol + port
+		size += sizeof(qint32) + sizeof(qint32) + sizeof(qint32);
+		size += sizeof(qint32) + endpoint.ip.size();
+	}
+
 	constexpr auto kVersion = 1;
 
 	auto result = QByteArray();
@@ -494,6 +503,16 @@ QByteArray DcOptions::serialize() const {
 				<< Serialize::bytes(key.n)
 				<< Serialize::bytes(key.e);
 		}
+
+		// Preferred endpoints.
+		stream << qint32(_preferredEndpoints.size());
+		for (const auto &[dcId, endpoint] : _preferredEndpoints) {
+			stream << qint32(dcId)
+				<< qint32(endpoint.protocol)
+				<< qint32(endpoint.port)
+				<< qint32(endpoint.ip.size());
+			stream.writeRawData(endpoint.ip.data(), endpoint.ip.size());
+		}
 	}
 	return result;
 }
@@ -589,6 +608,43 @@ bool DcOptions::constructFromSerialized(const QByteArray &serialized) {
 			}
 		}
 	}
+
+	// Read preferred endpoints
+	_preferredEndpoints.clear();
+	if (!stream.atEnd()) {
+		auto count = qint32(0);
+		stream >> count;
+		if (stream.status() != QDataStream::Ok) {
+			LOG(("MTP Error: Bad data for preferred endpoints in DcOptions::constructFromSerialized()"));
+			return false;
+		}
+
+		for (auto i = 0; i != count; ++i) {
+			qint32 dcId = 0, protocol = 0, port = 0, ipSize = 0;
+			stream >> dcId >> protocol >> port >> ipSize;
+
+			constexpr auto kMaxIpSize = 45;
+			if (ipSize <= 0
+				|| ipSize > kMaxIpSize
+				|| protocol < 0
+				|| protocol >= Variants::ProtocolCount) {
+				LOG(("MTP Error: Bad data for preferred endpoints inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+
+			auto ip = std::string(ipSize, ' ');
+			stream.readRawData(ip.data(), ipSize);
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("MTP Error: Bad data for preferred endpoints inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+			_preferredEndpoints.emplace(DcId(dcId), PreferredEndpoint{
+				std::move(ip),
+				port,
+				Variants::Protocol(protocol),
+			});
+		}
+	}
 	return true;
 }
 
@@ -600,6 +656,10 @@ rpl::producer<> DcOptions::cdnConfigChanged() const {
 	return _cdnConfigChanged.events();
 }
 
+rpl::producer<> DcOptions::preferredEndpointsChanged() const {
+	return _preferredEndpointsChanged.events();
+}
+
 std::vector<DcId> DcOptions::configEnumDcIds() const {
 	auto result = std::vector<DcId>();
 	{
@@ -655,6 +715,35 @@ void DcOptions::setCDNConfig(const MTPDcdnConfig &config) {
 	_cdnConfigChanged.fire({});
 }
 
+auto DcOptions::preferredEndpoint(DcId dcId) const
+-> std::optional<PreferredEndpoint> {
+	ReadLocker lock(this);
+	const auto i = _preferredEndpoints.find(dcId);
+	if (i == end(_preferredEndpoints)) {
+		return std::nullopt;
+	}
+	return i->second;
+}
+
+void DcOptions::setPreferredEndpoint(
+		DcId dcId,
+		PreferredEndpoint endpoint) {
+	Expects(!isTemporaryDcId(dcId));
+
+	WriteLocker lock(this);
+	const auto i = _preferredEndpoints.find(dcId);
+	if (i != end(_preferredEndpoints)
+		&& i->second.ip == endpoint.ip
+		&& i->second.port == endpoint.port
+		&& i->second.protocol == endpoint.protocol) {
+		return;
+	}
+	_preferredEndpoints[dcId] = std::move(endpoint);
+	lock.unlock();
+
+	_preferredEndpointsChanged.fire({});
+}
+
 bool DcOptions::hasCDNKeysForDc(DcId dcId) const {
 	ReadLocker lock(this);
 	return _cdnPublicKeys.find(dcId) != _cdnPublicKeys.cend();
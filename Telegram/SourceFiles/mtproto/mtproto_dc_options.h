@@ -81,6 +81,7 @@ public:
 
 	[[nodiscard]] rpl::producer<DcId> changed() const;
 	[[nodiscard]] rpl::producer<> cdnConfigChanged() const;
+	[[nodiscard]] rpl::producer<> preferredEndpointsChanged() const;
 	void setFromList(const MTPVector<MTPDcOption> &options);
 	void addFromList(const MTPVector<MTPDcOption> &options);
 	void addFromOther(DcOptions &&options);
@@ -106,6 +107,17 @@ public:
 		bool throughProxy) const;
 	[[nodiscard]] DcType dcType(ShiftedDcId shiftedDcId) const;
 
+	// The endpoint that won the last connection race to the dc,
+	// it is tried with the highest priority next time.
+	struct PreferredEndpoint {
+		std::string ip;
+		int port = 0;
+		Variants::Protocol protocol = Variants::Tcp;
+	};
+	[[nodiscard]] std::optional<PreferredEndpoint> preferredEndpoint(
+		DcId dcId) const;
+	void setPreferredEndpoint(DcId dcId, PreferredEndpoint endpoint);
+
 	void setCDNConfig(const MTPDcdnConfig &config);
 	[[nodiscard]] bool hasCDNKeysForDc(DcId dcId) const;
 	[[nodiscard]] details::RSAPublicKey getDcRSAKey(
@@ -155,10 +167,12 @@ private:
 	base::flat_map<
 		DcId,
 		base::flat_map<uint64, details::RSAPublicKey>> _cdnPublicKeys;
+	base::flat_map<DcId, PreferredEndpoint> _preferredEndpoints;
 	mutable QReadWriteLock _useThroughLockers;
 
 	rpl::event_stream<DcId> _changed;
 	rpl::event_stream<> _cdnConfigChanged;
+	rpl::event_stream<> _preferredEndpointsChanged;
 
 	// True when we have overriden options from a .tdesktop-endpoints file.
 	bool _immutable = false;
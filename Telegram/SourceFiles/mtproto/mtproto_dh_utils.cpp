@@ -7,10 +7,54 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "mtproto/mtproto_dh_utils.h"
 
+#include <QtCore/QMutex>
+
 namespace MTP {
 namespace {
 
 constexpr auto kMaxModExpSize = 256;
+constexpr auto kPreparedModExpsCount = 4;
+
+// The servers send the same g and prime in all the key exchanges,
+// so the g_b values for the next temporary keys are prepared ahead.
+struct PreparedModExps {
+	QMutex mutex;
+	int g = 0;
+	bytes::vector prime;
+	std::vector<ModExpFirst> list;
+	bool generating = false;
+};
+
+[[nodiscard]] PreparedModExps &Prepared() {
+	static auto result = PreparedModExps();
+	return result;
+}
+
+[[nodiscard]] ModExpFirst GenerateModExp(
+		int g,
+		bytes::const_span primeBytes) {
+	auto randomSeed = bytes::vector(ModExpFirst::kRandomPowerSize);
+	bytes::set_random(randomSeed);
+	return CreateModExp(g, primeBytes, randomSeed);
+}
+
+void FillPreparedModExps(int g, bytes::vector prime) {
+	auto &prepared = Prepared();
+	while (true) {
+		auto modexp = GenerateModExp(g, prime);
+
+		QMutexLocker lock(&prepared.mutex);
+		if (prepared.g != g || prepared.prime != prime) {
+			prepared.generating = false;
+			return;
+		}
+		prepared.list.push_back(std::move(modexp));
+		if (prepared.list.size() >= kPreparedModExpsCount) {
+			prepared.generating = false;
+			return;
+		}
+	}
+}
 
 bool IsPrimeAndGoodCheck(const openssl::BigNum &prime, int g) {
 	constexpr auto kGoodPrimeBitsCount = 2048;
@@ -155,6 +199,35 @@ ModExpFirst CreateModExp(
 	}
 }
 
+ModExpFirst TakePreparedModExp(int g, bytes::const_span primeBytes) {
+	auto &prepared = Prepared();
+	auto result = ModExpFirst();
+	auto startGenerating = false;
+	{
+		QMutexLocker lock(&prepared.mutex);
+		if (prepared.g != g
+			|| bytes::compare(prepared.prime, primeBytes) != 0) {
+			prepared.g = g;
+			prepared.prime = bytes::make_vector(primeBytes);
+			prepared.list.clear();
+		} else if (!prepared.list.empty()) {
+			result = std::move(prepared.list.back());
+			prepared.list.pop_back();
+		}
+		if (!prepared.generating) {
+			prepared.generating = startGenerating = true;
+		}
+	}
+	if (startGenerating) {
+		crl::async([=, prime = bytes::make_vector(primeBytes)]() mutable {
+			FillPreparedModExps(g, std::move(prime));
+		});
+	}
+	return result.modexp.empty()
+		? GenerateModExp(g, primeBytes)
+		: result;
+}
+
 bytes::vector CreateAuthKey(
 		bytes::const_span firstBytes,
 		bytes::const_span randomBytes,
@@ -27,6 +27,13 @@ struct ModExpFirst {
 	int g,
 	bytes::const_span primeBytes,
 	bytes::const_span randomSeed);
+
+// Returns a g_b value prepared in the background or generates it now.
+// Each prepared value is given out only once.
+[[nodiscard]] ModExpFirst TakePreparedModExp(
+	int g,
+	bytes::const_span primeBytes);
+
 [[nodiscard]] bytes::vector CreateAuthKey(
 	bytes::const_span firstBytes,
 	bytes::const_span randomBytes,
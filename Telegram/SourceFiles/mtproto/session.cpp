@@ -16,6 +16,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace MTP {
 namespace details {
+namespace {
+
+// Requests that can wait are sent right away when that much is queued,
+// a packet of this size is already full enough to be worth encrypting.
+constexpr auto kSendWaitingTargetSize = 16 * 1024;
+
+} // namespace
 
 SessionOptions::SessionOptions(
 	const QString &systemLangCode,
@@ -337,6 +344,7 @@ void Session::needToResumeAndSend() {
 		DEBUG_LOG(("Session Info: resuming session dcWithShift %1").arg(_shiftedDcId));
 		start();
 	}
+	_waitingSize = 0;
 	const auto captured = _private;
 	const auto ping = base::take(_ping);
 	InvokeQueued(captured, [=] {
@@ -443,8 +451,12 @@ void Session::sendPrepared(
 
 	DEBUG_LOG(("MTP Info: added, requestId %1").arg(request->requestId));
 	if (msCanWait >= 0) {
+		const auto size = int(request->size() * sizeof(mtpPrime));
 		InvokeQueued(this, [=] {
-			sendAnything(msCanWait);
+			_waitingSize += size;
+			sendAnything((_waitingSize >= kSendWaitingTargetSize)
+				? 0
+				: msCanWait);
 		});
 	}
 }
@@ -562,6 +574,7 @@ void Session::tryToReceive() {
 		auto lock = QWriteLocker(_data->haveReceivedMutex());
 		const auto responses = base::take(_data->haveReceivedResponses());
 		const auto updates = base::take(_data->haveReceivedUpdates());
+		_data->haveReceivedCollapsible().clear();
 		lock.unlock();
 		if (responses.empty() && updates.empty()) {
 			break;
@@ -576,6 +589,10 @@ void Session::tryToReceive() {
 		// Call globalCallback only in main session.
 		if (_shiftedDcId == BareDcId(_shiftedDcId)) {
 			for (const auto &update : updates) {
+				if (update.empty()) {
+					// Replaced by a newer update with the same key.
+					continue;
+				}
 				_instance->globalCallback(
 					update.constData(),
 					update.constData() + update.size());
@@ -53,6 +53,20 @@ struct SessionOptions {
 };
 
 class Session;
+// Key of a short update that only carries the latest state of something.
+struct CollapsibleUpdateKey {
+	mtpTypeId type = 0;
+	mtpPrime first = 0;
+	mtpPrime second = 0;
+
+	friend inline bool operator<(
+			const CollapsibleUpdateKey &a,
+			const CollapsibleUpdateKey &b) {
+		return std::tie(a.type, a.first, a.second)
+			< std::tie(b.type, b.first, b.second);
+	}
+};
+
 class SessionData final {
 public:
 	explicit SessionData(not_null<Session*> creator) : _owner(creator) {
@@ -91,6 +105,12 @@ public:
 		return _receivedUpdates;
 	}
 
+	// Indices in haveReceivedUpdates() of the collapsible updates,
+	// the older ones replaced by newer are left there empty.
+	base::flat_map<CollapsibleUpdateKey, int> &haveReceivedCollapsible() {
+		return _receivedCollapsible;
+	}
+
 	// SessionPrivate -> Session interface.
 	void queueTryToReceive();
 	void queueNeedToResumeAndSend();
@@ -130,6 +150,7 @@ private:
 
 	base::flat_map<mtpRequestId, mtpBuffer> _receivedResponses; // map of request_id -> response that should be processed in the main thread
 	std::vector<mtpBuffer> _receivedUpdates; // list of updates that should be processed in the main thread
+	base::flat_map<CollapsibleUpdateKey, int> _receivedCollapsible;
 	QReadWriteLock _haveReceivedLock;
 
 };
@@ -217,6 +238,7 @@ private:
 
 	crl::time _msSendCall = 0;
 	crl::time _msWait = 0;
+	int _waitingSize = 0;
 
 	bool _ping = false;
 
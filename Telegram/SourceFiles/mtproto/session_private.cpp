@@ -10,11 +10,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/details/mtproto_bound_key_creator.h"
 #include "mtproto/details/mtproto_dcenter.h"
 #include "mtproto/details/mtproto_dump_to_text.h"
+#include "mtproto/details/mtproto_rpc_stats.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
 #include "mtproto/session.h"
 #include "mtproto/mtproto_rpc_sender.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "mtproto/connection_abstract.h"
+#include "core/startup_trace.h"
 #include "base/openssl_help.h"
 #include "base/qthelp_url.h"
 #include "base/unixtime.h"
@@ -80,6 +82,29 @@ using namespace details;
 	return idsStr + "]";
 }
 
+// Some short updates only carry the latest state of something, so
+// an older one that still waits for the main thread can be dropped
+// when a newer one about the same user, chat or message arrives.
+[[nodiscard]] std::optional<CollapsibleUpdateKey> LookupCollapsibleKey(
+		const mtpBuffer &update) {
+	if (update.size() < 4 || mtpTypeId(update[0]) != mtpc_updateShort) {
+		return std::nullopt;
+	}
+	const auto type = mtpTypeId(update[1]);
+	switch (type) {
+	case mtpc_updateUserStatus: // user_id, status
+	case mtpc_updateUserTyping: // user_id, action
+		return CollapsibleUpdateKey{ type, update[2] };
+	case mtpc_updateChatUserTyping: // chat_id, user_id, action
+	case mtpc_updateChannelMessageViews: // channel_id, id, views
+		if (update.size() > 4) {
+			return CollapsibleUpdateKey{ type, update[2], update[3] };
+		}
+		break;
+	}
+	return std::nullopt;
+}
+
 void WrapInvokeAfter(
 		SerializedRequest &to,
 		const SerializedRequest &from,
@@ -152,12 +177,18 @@ void SessionPrivate::appendTestConnection(
 		DcOptions::Variants::Protocol protocol,
 		const QString &ip,
 		int port,
-		const bytes::vector &protocolSecret) {
+		const bytes::vector &protocolSecret,
+		bool preferred) {
 	QWriteLocker lock(&_stateMutex);
 
-	const auto priority = (qthelp::is_ipv6(ip) ? 0 : 1)
-		+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
-		+ (protocolSecret.empty() ? 0 : 1);
+	// The endpoint that connected first last time is used right away,
+	// without waiting for the other ones that have higher priority.
+	constexpr auto kPreferredPriority = 4;
+	const auto priority = preferred
+		? kPreferredPriority
+		: ((qthelp::is_ipv6(ip) ? 0 : 1)
+			+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
+			+ (protocolSecret.empty() ? 0 : 1));
 	_testConnections.push_back({
 		AbstractConnection::Create(
 			_instance,
@@ -165,7 +196,10 @@ void SessionPrivate::appendTestConnection(
 			thread(),
 			protocolSecret,
 			_options->proxy),
-		priority
+		priority,
+		protocol,
+		ip,
+		port,
 	});
 	const auto weak = _testConnections.back().data.get();
 	connect(weak, &AbstractConnection::error, [=](int errorCode) {
@@ -329,6 +363,9 @@ bool SessionPrivate::setState(int state, int ifState) {
 		return false;
 	}
 	_state = state;
+	if (state == ConnectedState) {
+		STARTUP_TRACE_MARK("MTP::SessionPrivate connected");
+	}
 	if (state < 0) {
 		_retryTimeout = -state;
 		_retryTimer.callOnce(_retryTimeout);
@@ -895,6 +932,11 @@ void SessionPrivate::tryToSend() {
 				toSendRequest,
 				bigMsgId,
 				forceNewMsgId);
+			DEBUG_LOG(("MTP Info: sending container of %1 messages, "
+				"%2 bytes in dc %3."
+				).arg(toSendCount
+				).arg(toSendRequest->size() * sizeof(mtpPrime)
+				).arg(_shiftedDcId));
 			_sentContainers.emplace(containerMsgId, std::move(sentIdsWrap));
 		}
 	}
@@ -965,6 +1007,16 @@ void SessionPrivate::connectToServer(bool afterConfig) {
 			: !useHttp
 			? Variants::Http
 			: Variants::ProtocolCount;
+		const auto preferred = (_options->proxy.type == ProxyData::Type::None
+			&& !isTemporaryDcId(bareDc))
+			? _instance->dcOptions().preferredEndpoint(bareDc)
+			: std::nullopt;
+		const auto isPreferred = [&](int protocol, const auto &endpoint) {
+			return preferred
+				&& (preferred->protocol == protocol)
+				&& (preferred->port == endpoint.port)
+				&& (preferred->ip == endpoint.ip);
+		};
 		for (auto address = 0; address != Variants::AddressTypeCount; ++address) {
 			if (address == skipAddress) {
 				continue;
@@ -978,7 +1030,8 @@ void SessionPrivate::connectToServer(bool afterConfig) {
 						static_cast<Variants::Protocol>(protocol),
 						QString::fromStdString(endpoint.ip),
 						endpoint.port,
-						endpoint.secret);
+						endpoint.secret,
+						isPreferred(protocol, endpoint));
 				}
 			}
 		}
@@ -1025,6 +1078,8 @@ void SessionPrivate::connectToServer(bool afterConfig) {
 void SessionPrivate::restart() {
 	DEBUG_LOG(("MTP Info: restarting Connection"));
 
+	_instance->rpcStats().connectionRestarted(BareDcId(_shiftedDcId));
+
 	_waitForReceivedTimer.cancel();
 	_waitForConnectedTimer.cancel();
 
@@ -1043,6 +1098,7 @@ void SessionPrivate::restart() {
 }
 
 void SessionPrivate::onSentSome(uint64 size) {
+	_instance->rpcStats().bytesSent(BareDcId(_shiftedDcId), int64(size));
 	if (!_waitForReceivedTimer.isActive()) {
 		auto remain = static_cast<uint64>(_waitForReceived);
 		if (!_oldConnection) {
@@ -1186,13 +1242,16 @@ void SessionPrivate::handleReceived() {
 	while (!_connection->received().empty()) {
 		auto intsBuffer = std::move(_connection->received().front());
 		_connection->received().pop_front();
+		_instance->rpcStats().bytesReceived(
+			BareDcId(_shiftedDcId),
+			int64(intsBuffer.size() * sizeof(mtpPrime)));
 
 		constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
 		constexpr auto kEncryptedHeaderIntsCount = 8U; // 2 salt, 2 session, 2 msg_id, 1 seq_no, 1 length
 		constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
 		constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
 		auto intsCount = uint32(intsBuffer.size());
-		auto ints = intsBuffer.constData();
+		auto ints = intsBuffer.data();
 		if ((intsCount < kMinimalIntsCount) || (intsCount > kMaxMessageLength / kIntSize)) {
 			LOG(("TCP Error: bad message received, len %1").arg(intsCount * kIntSize));
 			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(ints, intsCount * kIntSize).str()));
@@ -1209,16 +1268,16 @@ void SessionPrivate::handleReceived() {
 		auto encryptedInts = ints + kExternalHeaderIntsCount;
 		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
 		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
 		auto msgKey = *(MTPint128*)(ints + 2);
 
+		// Decrypt in place, the received packet is not needed after that.
 #ifdef TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt_oldmtp(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		aesIgeDecrypt_oldmtp(encryptedInts, encryptedInts, encryptedBytesCount, _encryptionKey, msgKey);
 #else // TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		aesIgeDecrypt(encryptedInts, encryptedInts, encryptedBytesCount, _encryptionKey, msgKey);
 #endif // TDESKTOP_MTPROTO_OLD
 
-		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
+		const auto decryptedInts = static_cast<const mtpPrime*>(encryptedInts);
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
 		auto msgId = *(uint64*)&decryptedInts[4];
@@ -1339,6 +1398,11 @@ void SessionPrivate::handleReceived() {
 		}
 		_receivedMessageIds.shrink();
 
+		// Everything needed was copied from the packet by now.
+		if (_connection) {
+			_connection->releaseReceived(std::move(intsBuffer));
+		}
+
 		// send acks
 		if (const auto toAckSize = _ackRequestData.size()) {
 			DEBUG_LOG(("MTP Info: will send %1 acks, ids: %2").arg(toAckSize).arg(LogIdsVector(_ackRequestData)));
@@ -1872,7 +1936,18 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 
 		// Notify main process about the new updates.
 		QWriteLocker locker(_sessionData->haveReceivedMutex());
-		_sessionData->haveReceivedUpdates().push_back(mtpBuffer(update));
+		auto &updates = _sessionData->haveReceivedUpdates();
+		if (const auto key = LookupCollapsibleKey(update)) {
+			auto &collapsible = _sessionData->haveReceivedCollapsible();
+			const auto index = int(updates.size());
+			const auto [i, ok] = collapsible.emplace(*key, index);
+			if (!ok) {
+				// Clear the older one in place to keep the other indices.
+				updates[i->second] = mtpBuffer();
+				i->second = index;
+			}
+		}
+		updates.push_back(std::move(update));
 	} else {
 		LOG(("Message Error: unexpected updates in dcType: %1"
 			).arg(static_cast<int>(_currentDcType)));
@@ -2231,6 +2306,7 @@ void SessionPrivate::onConnected(
 	} else {
 		DEBUG_LOG(("MTP Info: connection through IPv4 succeed."));
 		_waitForBetterTimer.cancel();
+		rememberPreferredEndpoint(*i);
 		_connection = std::move(i->data);
 		_testConnections.clear();
 		checkAuthKey();
@@ -2267,12 +2343,32 @@ void SessionPrivate::confirmBestConnection() {
 	DEBUG_LOG(("MTP Info: can't connect through better, using %1."
 		).arg(i->data->tag()));
 
+	rememberPreferredEndpoint(*i);
 	_connection = std::move(i->data);
 	_testConnections.clear();
 
 	checkAuthKey();
 }
 
+void SessionPrivate::rememberPreferredEndpoint(const TestConnection &test) {
+	const auto bareDc = BareDcId(_shiftedDcId);
+	if (_options->proxy.type != ProxyData::Type::None
+		|| isTemporaryDcId(bareDc)
+		|| test.ip.isEmpty()) {
+		return;
+	}
+	auto endpoint = DcOptions::PreferredEndpoint{
+		test.ip.toStdString(),
+		test.port,
+		test.protocol,
+	};
+	InvokeQueued(_instance, [=, instance = _instance]() mutable {
+		instance->dcOptions().setPreferredEndpoint(
+			bareDc,
+			std::move(endpoint));
+	});
+}
+
 void SessionPrivate::removeTestConnection(
 		not_null<AbstractConnection*> connection) {
 	_testConnections.erase(
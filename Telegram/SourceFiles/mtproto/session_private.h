@@ -57,6 +57,9 @@ private:
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
+		DcOptions::Variants::Protocol protocol = DcOptions::Variants::Tcp;
+		QString ip;
+		int port = 0;
 	};
 	struct SentContainer {
 		crl::time sent = 0;
@@ -134,7 +137,9 @@ private:
 		DcOptions::Variants::Protocol protocol,
 		const QString &ip,
 		int port,
-		const bytes::vector &protocolSecret);
+		const bytes::vector &protocolSecret,
+		bool preferred = false);
+	void rememberPreferredEndpoint(const TestConnection &test);
 
 	// if badTime received - search for ids in sessionData->haveSent and sessionData->wereAcked and sync time/salt, return true if found
 	bool requestsFixTimeSalt(const QVector<MTPlong> &ids, int32 serverTime, uint64 serverSalt);
@@ -52,6 +52,20 @@ TextParseOptions _documentNameOptions = {
 	Qt::LayoutDirectionAuto, // dir
 };
 
+// Text after the links or before all of them is not shown in the preview
+// if it has only punctuation. The expressions are compiled only once.
+[[nodiscard]] bool IsLinksSeparator(const QStringRef &text) {
+	static const auto expression = QRegularExpression(
+		"^[,.\\s_=+\\-;:`'\"\\(\\)\\[\\]\\{\\}<>*&^%\\$#@!\\\\/]+$");
+	return expression.match(text).hasMatch();
+}
+
+[[nodiscard]] bool IsLinksPrefix(const QStringRef &text) {
+	static const auto expression = QRegularExpression(
+		"^[,.\\s\\-;:`'\"\\(\\)\\[\\]\\{\\}<>*&^%\\$#@!\\\\/]+$");
+	return expression.match(text).hasMatch();
+}
+
 TextWithEntities ComposeNameWithEntities(DocumentData *document) {
 	TextWithEntities result;
 	const auto song = document->song();
@@ -1421,7 +1435,7 @@ Link::Link(
 		}
 		int32 afterLinkStart = entity.offset() + entity.length();
 		if (till > afterLinkStart) {
-			if (!QRegularExpression(qsl("^[,.\\s_=+\\-;:`'\"\\(\\)\\[\\]\\{\\}<>*&^%\\$#@!\\\\/]+$")).match(text.mid(afterLinkStart, till - afterLinkStart)).hasMatch()) {
+			if (!IsLinksSeparator(text.midRef(afterLinkStart, till - afterLinkStart))) {
 				++lnk;
 				break;
 			}
@@ -1429,7 +1443,7 @@ Link::Link(
 		till = entity.offset();
 	}
 	if (!lnk) {
-		if (QRegularExpression(qsl("^[,.\\s\\-;:`'\"\\(\\)\\[\\]\\{\\}<>*&^%\\$#@!\\\\/]+$")).match(text.mid(from, till - from)).hasMatch()) {
+		if (IsLinksPrefix(text.midRef(from, till - from))) {
 			till = from;
 		}
 	}
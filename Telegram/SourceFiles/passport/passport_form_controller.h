@@ -473,7 +473,7 @@ private:
 	void encryptFile(
 		EditFile &file,
 		QByteArray &&content,
-		Fn<void(UploadScanData &&result)> callback);
+		Fn<void(UploadScanData &&result, QImage &&image)> callback);
 	void prepareFile(
 		EditFile &file,
 		const QByteArray &content);
@@ -36,6 +36,13 @@ constexpr auto kObjectPath = "/org/freedesktop/Notifications"_cs;
 constexpr auto kInterface = kService;
 constexpr auto kPropertiesInterface = "org.freedesktop.DBus.Properties"_cs;
 
+// A burst of notifications asks for the inhibition state each time,
+// reuse the answer for a while instead of a blocking call per message.
+constexpr auto kInhibitedCacheTimeout = crl::time(1000);
+
+// Cached decoded userpics, they are reused while the peer keeps writing.
+constexpr auto kImageDataCacheLimit = 32;
+
 bool NotificationsSupported = false;
 bool InhibitedNotSupported = false;
 
@@ -138,7 +145,7 @@ QStringList GetCapabilities() {
 	return Result;
 }
 
-bool Inhibited() {
+bool ComputeInhibited() {
 	auto message = QDBusMessage::createMethodCall(
 		kService.utf16(),
 		kObjectPath.utf16(),
@@ -173,6 +180,18 @@ bool Inhibited() {
 	return false;
 }
 
+bool Inhibited() {
+	static auto Result = false;
+	static auto CheckedAt = crl::time(0);
+
+	const auto now = crl::now();
+	if (!CheckedAt || now - CheckedAt >= kInhibitedCacheTimeout) {
+		Result = ComputeInhibited();
+		CheckedAt = now;
+	}
+	return Result;
+}
+
 QVersionNumber ParseSpecificationVersion(
 		const std::vector<QString> &serverInformation) {
 	if (serverInformation.size() >= 4) {
@@ -297,7 +316,7 @@ NotificationData::NotificationData(
 		SLOT(notificationClosed(uint)));
 }
 
-bool NotificationData::show() {
+void NotificationData::show(uint replacesId) {
 	const auto iconName = _imageKey.isEmpty() || !_hints.contains(_imageKey)
 		? GetIconName()
 		: QString();
@@ -310,7 +329,7 @@ bool NotificationData::show() {
 
 	message.setArguments({
 		AppName.utf16(),
-		uint(0),
+		replacesId,
 		iconName,
 		_title,
 		_body,
@@ -319,19 +338,51 @@ bool NotificationData::show() {
 		-1
 	});
 
-	const QDBusReply<uint> reply = _dbusConnection.call(
-		message);
+	// Don't block the main thread by waiting for the daemon to reply.
+	const auto watcher = new QDBusPendingCallWatcher(
+		_dbusConnection.asyncCall(message));
+	const auto connection = _dbusConnection;
+	const auto closeWhenShown = _closeWhenShown;
+	const auto guard = QPointer<NotificationData>(this);
+	const auto manager = _manager;
+	const auto my = _id;
 
-	if (reply.isValid()) {
-		_notificationId = reply.value();
-	} else {
-		LOG(("Native notification error: %1").arg(reply.error().message()));
-	}
+	QObject::connect(
+		watcher,
+		&QDBusPendingCallWatcher::finished,
+		[=](QDBusPendingCallWatcher *call) {
+			const QDBusPendingReply<uint> reply = *call;
+			call->deleteLater();
+
+			if (reply.isError()) {
+				LOG(("Native notification error: %1"
+					).arg(reply.error().message()));
+				if (guard) {
+					crl::on_main(manager, [=] {
+						manager->clearNotification(my);
+					});
+				}
+			} else if (*closeWhenShown) {
+				Close(connection, reply.value());
+			} else if (guard) {
+				guard->_notificationId = reply.value();
+			}
+		});
+}
 
-	return reply.isValid();
+uint NotificationData::notificationId() const {
+	return _notificationId;
 }
 
 void NotificationData::close() {
+	if (!_notificationId) {
+		*_closeWhenShown = true;
+		return;
+	}
+	Close(_dbusConnection, _notificationId);
+}
+
+void NotificationData::Close(QDBusConnection connection, uint id) {
 	auto message = QDBusMessage::createMethodCall(
 		kService.utf16(),
 		kObjectPath.utf16(),
@@ -339,17 +390,20 @@ void NotificationData::close() {
 		qsl("CloseNotification"));
 
 	message.setArguments({
-		_notificationId
+		id
 	});
 
-	_dbusConnection.send(message);
+	connection.send(message);
 }
 
-void NotificationData::setImage(const QString &imagePath) {
-	if (_imageKey.isEmpty()) {
+void NotificationData::setImage(const QVariant &imageData) {
+	if (_imageKey.isEmpty() || !imageData.isValid()) {
 		return;
 	}
+	_hints[_imageKey] = imageData;
+}
 
+QVariant NotificationData::PrepareImage(const QString &imagePath) {
 	const auto image = QImage(imagePath)
 		.convertToFormat(QImage::Format_RGBA8888);
 
@@ -371,7 +425,7 @@ void NotificationData::setImage(const QString &imagePath) {
 		imageBytes
 	};
 
-	_hints[_imageKey] = QVariant::fromValue(imageData);
+	return QVariant::fromValue(imageData);
 }
 
 void NotificationData::notificationClosed(uint id) {
@@ -533,9 +587,12 @@ public:
 	~Private();
 
 private:
+	[[nodiscard]] QVariant imageData(const QString &imagePath);
+
 	base::flat_map<
 		FullPeer,
 		base::flat_map<MsgId, Notification>> _notifications;
+	base::flat_map<QString, QVariant> _imageData;
 
 	Window::Notifications::CachedUserpics _cachedUserpics;
 	base::weak_ptr<Manager> _manager;
@@ -598,17 +655,22 @@ void Manager::Private::showNotification(
 
 	if (!hideNameAndPhoto) {
 		const auto userpicKey = peer->userpicUniqueKey(userpicView);
-		notification->setImage(
-			_cachedUserpics.get(userpicKey, peer, userpicView));
+		notification->setImage(imageData(
+			_cachedUserpics.get(userpicKey, peer, userpicView)));
 	}
 
+	// Update the shown notification in place when the daemon knows it.
+	auto replacesId = uint(0);
 	auto i = _notifications.find(key);
 	if (i != _notifications.cend()) {
 		auto j = i->second.find(msgId);
 		if (j != i->second.end()) {
 			auto oldNotification = j->second;
 			i->second.erase(j);
-			oldNotification->close();
+			replacesId = oldNotification->notificationId();
+			if (!replacesId) {
+				oldNotification->close();
+			}
 			i = _notifications.find(key);
 		}
 	}
@@ -618,15 +680,20 @@ void Manager::Private::showNotification(
 			base::flat_map<MsgId, Notification>()).first;
 	}
 	i->second.emplace(msgId, notification);
-	if (!notification->show()) {
-		i = _notifications.find(key);
-		if (i != _notifications.cend()) {
-			i->second.remove(msgId);
-			if (i->second.empty()) {
-				_notifications.erase(i);
-			}
-		}
+	notification->show(replacesId);
+}
+
+QVariant Manager::Private::imageData(const QString &imagePath) {
+	const auto i = _imageData.find(imagePath);
+	if (i != end(_imageData)) {
+		return i->second;
+	}
+	if (_imageData.size() >= kImageDataCacheLimit) {
+		_imageData.clear();
 	}
+	return _imageData.emplace(
+		imagePath,
+		NotificationData::PrepareImage(imagePath)).first->second;
 }
 
 void Manager::Private::clearAll() {
@@ -38,9 +38,13 @@ public:
 	NotificationData(NotificationData &&other) = delete;
 	NotificationData &operator=(NotificationData &&other) = delete;
 
-	bool show();
+	// The id stays zero until the notification daemon replies.
+	void show(uint replacesId = 0);
+	[[nodiscard]] uint notificationId() const;
 	void close();
-	void setImage(const QString &imagePath);
+	void setImage(const QVariant &imageData);
+
+	[[nodiscard]] static QVariant PrepareImage(const QString &imagePath);
 
 	struct ImageData {
 		int width, height, rowStride;
@@ -61,6 +65,9 @@ private:
 
 	uint _notificationId = 0;
 	NotificationId _id;
+	std::shared_ptr<bool> _closeWhenShown = std::make_shared<bool>(false);
+
+	static void Close(QDBusConnection connection, uint id);
 
 private slots:
 	void notificationClosed(uint id);
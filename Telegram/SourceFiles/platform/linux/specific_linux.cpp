@@ -618,6 +618,38 @@ std::optional<crl::time> LastUserInputTime() {
 	return std::nullopt;
 }
 
+std::optional<int64> PhysicalMemorySize() {
+	const auto pages = sysconf(_SC_PHYS_PAGES);
+	const auto pageSize = sysconf(_SC_PAGESIZE);
+	if (pages <= 0 || pageSize <= 0) {
+		return std::nullopt;
+	}
+	return int64(pages) * int64(pageSize);
+}
+
+std::optional<int64> AvailablePhysicalMemory() {
+	// MemAvailable counts the page cache that can be reclaimed,
+	// unlike _SC_AVPHYS_PAGES that has only the free pages.
+	auto f = QFile(qsl("/proc/meminfo"));
+	if (!f.open(QIODevice::ReadOnly)) {
+		return std::nullopt;
+	}
+	const auto prefix = QByteArray("MemAvailable:");
+	while (!f.atEnd()) {
+		const auto line = f.readLine();
+		if (line.startsWith(prefix)) {
+			auto ok = false;
+			const auto kilobytes = line.mid(prefix.size()).trimmed().split(
+				' ').front().toLongLong(&ok);
+			if (ok) {
+				return int64(kilobytes) * 1024;
+			}
+			break;
+		}
+	}
+	return std::nullopt;
+}
+
 bool AutostartSupported() {
 	// snap sandbox doesn't allow creating files in folders with names started with a dot
 	// and doesn't provide any api to add an app to autostart
@@ -33,6 +33,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <IOKit/hidsystem/ev_keymap.h>
 #include <SPMediaKeyTap.h>
 #include <mach-o/dyld.h>
+#include <mach/mach.h>
 #include <AVFoundation/AVFoundation.h>
 
 namespace {
@@ -263,6 +264,33 @@ void IgnoreApplicationActivationRightNow() {
 	objc_ignoreApplicationActivationRightNow();
 }
 
+std::optional<int64> PhysicalMemorySize() {
+	const auto result = [[NSProcessInfo processInfo] physicalMemory];
+	if (!result) {
+		return std::nullopt;
+	}
+	return int64(result);
+}
+
+std::optional<int64> AvailablePhysicalMemory() {
+	auto statistics = vm_statistics64_data_t();
+	auto count = mach_msg_type_number_t(HOST_VM_INFO64_COUNT);
+	const auto host = mach_host_self();
+	const auto result = host_statistics64(
+		host,
+		HOST_VM_INFO64,
+		reinterpret_cast<host_info64_t>(&statistics),
+		&count);
+	mach_port_deallocate(mach_task_self(), host);
+	if (result != KERN_SUCCESS) {
+		return std::nullopt;
+	}
+	const auto pages = int64(statistics.free_count)
+		+ int64(statistics.inactive_count)
+		+ int64(statistics.purgeable_count);
+	return pages * int64(vm_kernel_page_size);
+}
+
 bool AutostartSupported() {
 	return false;
 }
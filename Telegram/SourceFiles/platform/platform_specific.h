@@ -41,6 +41,12 @@ bool OpenSystemSettings(SystemSettingsType type);
 	return LastUserInputTime().has_value();
 }
 
+// Total size of the physical memory in bytes, if it can be determined.
+[[nodiscard]] std::optional<int64> PhysicalMemorySize();
+
+// Physical memory in bytes that can be used without swapping.
+[[nodiscard]] std::optional<int64> AvailablePhysicalMemory();
+
 void IgnoreApplicationActivationRightNow();
 bool AutostartSupported();
 QImage GetImageFromClipboard();
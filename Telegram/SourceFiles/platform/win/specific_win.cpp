@@ -382,6 +382,24 @@ std::optional<crl::time> LastUserInputTime() {
 	return LastTrackedWhen;
 }
 
+std::optional<int64> PhysicalMemorySize() {
+	auto status = MEMORYSTATUSEX{ 0 };
+	status.dwLength = sizeof(MEMORYSTATUSEX);
+	if (!GlobalMemoryStatusEx(&status)) {
+		return std::nullopt;
+	}
+	return int64(status.ullTotalPhys);
+}
+
+std::optional<int64> AvailablePhysicalMemory() {
+	auto status = MEMORYSTATUSEX{ 0 };
+	status.dwLength = sizeof(MEMORYSTATUSEX);
+	if (!GlobalMemoryStatusEx(&status)) {
+		return std::nullopt;
+	}
+	return int64(status.ullAvailPhys);
+}
+
 bool AutostartSupported() {
 	return !IsWindowsStoreBuild();
 }
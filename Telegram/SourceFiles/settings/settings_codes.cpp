@@ -73,6 +73,13 @@ auto GenerateCodes() {
 			window->session().updates().getDifference();
 		}
 	});
+	codes.emplace(qsl("memorystats"), [](SessionController *window) {
+		if (window) {
+			const auto stats = window->session().data().memoryStats();
+			LOG(("Memory Stats: %1").arg(stats));
+			Ui::show(Box<InformBox>(stats));
+		}
+	});
 	codes.emplace(qsl("loadcolors"), [](SessionController *window) {
 		FileDialog::GetOpenPath(Core::App().getFileDialogParent(), "Open palette file", "Palette (*.tdesktop-palette)", [](const FileDialog::OpenResult &result) {
 			if (!result.paths.isEmpty()) {
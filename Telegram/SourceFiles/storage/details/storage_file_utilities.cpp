@@ -14,6 +14,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtCore/QtEndian>
 #include <QtCore/QSaveFile>
 
+#include <mutex>
+#include <condition_variable>
+
 namespace Storage {
 namespace details {
 namespace {
@@ -21,8 +24,15 @@ namespace {
 constexpr char TdfMagic[] = { 'T', 'D', 'F', '$' };
 constexpr auto TdfMagicLen = int(sizeof(TdfMagic));
 
+constexpr char TdjMagic[] = { 'T', 'D', 'J', '$' };
+constexpr auto TdjMagicLen = int(sizeof(TdjMagic));
+
 constexpr auto kStrongIterationsCount = 100'000;
 
+[[nodiscard]] QString JournalPath(const FileKey &key, const QString &basePath) {
+	return basePath + ToFilePart(key) + 'j';
+}
+
 } // namespace
 
 QString ToFilePart(FileKey val) {
@@ -75,6 +85,8 @@ void ClearKey(const FileKey &key, const QString &basePath) {
 	QFile::remove(name);
 	name[name.size() - 1] = 's';
 	QFile::remove(name);
+	name[name.size() - 1] = 'j';
+	QFile::remove(name);
 }
 
 bool CheckStreamStatus(QDataStream &stream) {
@@ -303,6 +315,86 @@ void FileWriteDescriptor::finish() {
 	return encrypted;
 }
 
+qint64 AppendEncryptedJournal(
+		const FileKey &fkey,
+		const QString &basePath,
+		EncryptedDescriptor &data,
+		const MTP::AuthKeyPtr &key) {
+	const auto name = JournalPath(fkey, basePath);
+	QFile f(name);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		LOG(("Storage Error: Could not open '%1' for appending.").arg(name));
+		return -1;
+	}
+	if (!f.size()) {
+		f.write(TdjMagic, TdjMagicLen);
+		const auto version = qint32(AppVersion);
+		f.write((const char*)&version, sizeof(version));
+	}
+	{
+		QDataStream stream(&f);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << PrepareEncrypted(data, key);
+		if (!CheckStreamStatus(stream)) {
+			return -1;
+		}
+	}
+	base::Platform::FlushFileData(f);
+	return f.size();
+}
+
+bool ReadEncryptedJournal(
+		const FileKey &fkey,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key,
+		Fn<bool(QDataStream &stream)> record) {
+	const auto name = JournalPath(fkey, basePath);
+	QFile f(name);
+	if (!f.exists()) {
+		return true;
+	} else if (!f.open(QIODevice::ReadOnly)) {
+		DEBUG_LOG(("App Info: failed to open '%1' for reading").arg(name));
+		return false;
+	}
+
+	char magic[TdjMagicLen];
+	qint32 version = 0;
+	if (f.read(magic, TdjMagicLen) != TdjMagicLen
+		|| memcmp(magic, TdjMagic, TdjMagicLen)
+		|| f.read((char*)&version, sizeof(version)) != sizeof(version)
+		|| version > AppVersion) {
+		DEBUG_LOG(("App Info: bad journal header in '%1'").arg(name));
+		return false;
+	}
+
+	QDataStream stream(&f);
+	stream.setVersion(QDataStream::Qt_5_1);
+	while (!stream.atEnd()) {
+		QByteArray encrypted;
+		stream >> encrypted;
+		if (stream.status() != QDataStream::Ok) {
+			DEBUG_LOG(("App Info: torn record at the end of '%1'"
+				).arg(name));
+			return false;
+		}
+		EncryptedDescriptor data;
+		if (!DecryptLocal(data, encrypted, key)
+			|| !record(data.stream)
+			|| !CheckStreamStatus(data.stream)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+qint64 JournalSize(const FileKey &fkey, const QString &basePath) {
+	return QFileInfo(JournalPath(fkey, basePath)).size();
+}
+
+void ClearJournal(const FileKey &fkey, const QString &basePath) {
+	QFile::remove(JournalPath(fkey, basePath));
+}
+
 bool ReadFile(
 		FileReadDescriptor &result,
 		const QString &name,
@@ -497,5 +589,53 @@ bool ReadEncryptedFile(
 	return ReadEncryptedFile(result, ToFilePart(fkey), basePath, key);
 }
 
+struct EncryptedFilePrefetch::State {
+	std::mutex mutex;
+	std::condition_variable finished;
+	bool ready = false;
+	bool success = false;
+	int32 version = 0;
+	qint64 position = 0;
+	QByteArray data;
+};
+
+EncryptedFilePrefetch::EncryptedFilePrefetch(
+	const FileKey &fkey,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key)
+: _state(std::make_shared<State>()) {
+	crl::async([=, state = _state] {
+		FileReadDescriptor file;
+		const auto success = ReadEncryptedFile(file, fkey, basePath, key);
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+		if (success) {
+			state->success = true;
+			state->version = file.version;
+			state->position = file.buffer.pos();
+			state->data = file.data;
+		}
+		state->ready = true;
+		lock.unlock();
+		state->finished.notify_one();
+	});
+}
+
+bool EncryptedFilePrefetch::take(FileReadDescriptor &result) {
+	std::unique_lock<std::mutex> lock(_state->mutex);
+	_state->finished.wait(lock, [&] { return _state->ready; });
+	if (!_state->success) {
+		return false;
+	}
+	result.version = _state->version;
+	result.data = base::take(_state->data);
+	result.buffer.setBuffer(&result.data);
+	result.buffer.open(QIODevice::ReadOnly);
+	result.buffer.seek(_state->position);
+	result.stream.setDevice(&result.buffer);
+	result.stream.setVersion(QDataStream::Qt_5_1);
+	return true;
+}
+
 } // namespace details
 } // namespace Storage
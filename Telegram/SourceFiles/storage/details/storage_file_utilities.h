@@ -86,6 +86,26 @@ private:
 
 };
 
+// Append-only log kept next to a FileWriteDescriptor file of the same key.
+// Each record is encrypted separately, so appending one doesn't require
+// rewriting (or even reading) the whole file.
+[[nodiscard]] qint64 AppendEncryptedJournal(
+	const FileKey &fkey,
+	const QString &basePath,
+	EncryptedDescriptor &data,
+	const MTP::AuthKeyPtr &key);
+
+// Returns false if the log ended with a torn or bad record,
+// all the records before it are still passed to the callback.
+bool ReadEncryptedJournal(
+	const FileKey &fkey,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key,
+	Fn<bool(QDataStream &stream)> record);
+
+[[nodiscard]] qint64 JournalSize(const FileKey &fkey, const QString &basePath);
+void ClearJournal(const FileKey &fkey, const QString &basePath);
+
 bool ReadFile(
 	FileReadDescriptor &result,
 	const QString &name,
@@ -108,5 +128,24 @@ bool ReadEncryptedFile(
 	const QString &basePath,
 	const MTP::AuthKeyPtr &key);
 
+// Reads and decrypts a file on a background thread, so that the main
+// thread needs only to parse it when (and if) the data is needed.
+class EncryptedFilePrefetch final {
+public:
+	EncryptedFilePrefetch(
+		const FileKey &fkey,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key);
+
+	// Waits for the background read if it is not finished yet.
+	[[nodiscard]] bool take(FileReadDescriptor &result);
+
+private:
+	struct State;
+
+	const std::shared_ptr<State> _state;
+
+};
+
 } // namespace details
 } // namespace Storage
@@ -19,6 +19,7 @@ namespace {
 
 constexpr auto kKillSessionTimeout = 15 * crl::time(1000);
 constexpr auto kStartWaitedInSession = 4 * kDownloadPartSize;
+constexpr auto kMinWaitedInSession = 2 * kDownloadPartSize;
 constexpr auto kMaxWaitedInSession = 16 * kDownloadPartSize;
 constexpr auto kStartSessionsCount = 1;
 constexpr auto kMaxSessionsCount = 8;
@@ -31,6 +32,13 @@ constexpr auto kRemoveSessionAfterTimeouts = 4;
 constexpr auto kResetDownloadPrioritiesTimeout = crl::time(200);
 constexpr auto kBadRequestDurationThreshold = 8 * crl::time(1000);
 
+// We keep in flight twice the estimated bandwidth-delay product,
+// so that the session bandwidth estimate can grow if the link allows.
+constexpr auto kBandwidthDelayProductGain = 2;
+constexpr auto kBandwidthSmoothing = 4;
+constexpr auto kRttWindow = 10 * crl::time(1000);
+constexpr auto kBandwidthActualTimeout = 60 * crl::time(1000);
+
 // Each (session remove by timeouts) we wait for time:
 // kRetryAddSessionTimeout * max(removesCount, kMaxTrackedSessionRemoves)
 // and for successes in all remaining sessions:
@@ -66,13 +74,16 @@ void DownloadManagerMtproto::Queue::remove(not_null<Task*> task) {
 }
 
 void DownloadManagerMtproto::Queue::resetGeneration() {
-	const auto from = ranges::find(_tasks, 0, &Enqueued::priority);
+	const auto from = ranges::find(
+		_tasks,
+		kDownloadPriorityDefault,
+		&Enqueued::priority);
 	for (auto &task : ranges::make_subrange(from, end(_tasks))) {
-		if (task.priority) {
-			Assert(task.priority == -1);
+		if (task.priority != kDownloadPriorityDefault) {
+			Assert(task.priority < kDownloadPriorityDefault);
 			break;
 		}
-		task.priority = -1;
+		task.priority = kDownloadPriorityPreviousGeneration;
 	}
 }
 
@@ -111,6 +122,38 @@ DownloadManagerMtproto::DcSessionBalanceData::DcSessionBalanceData()
 : maxWaitedAmount(kStartWaitedInSession) {
 }
 
+void DownloadManagerMtproto::DcSessionBalanceData::addSample(
+		int amount,
+		crl::time duration,
+		crl::time now) {
+	// All the parts that were in flight when the request was sent
+	// were received in about the time the request took to finish.
+	const auto sample = int64(amount) * 1000
+		/ std::max(duration, crl::time(1));
+	bandwidth = bandwidth
+		? ((bandwidth * (kBandwidthSmoothing - 1) + sample)
+			/ kBandwidthSmoothing)
+		: sample;
+	bandwidthReceived = now;
+
+	// Request duration includes queueing, so the minimal one is used.
+	if (!rtt || duration <= rtt || now - rttReceived > kRttWindow) {
+		rtt = duration;
+		rttReceived = now;
+	}
+}
+
+int DownloadManagerMtproto::DcSessionBalanceData::computeMaxWaitedAmount(
+) const {
+	const auto product = bandwidth * rtt / 1000;
+	const auto wanted = product * kBandwidthDelayProductGain;
+	const auto parts = (wanted + kDownloadPartSize - 1) / kDownloadPartSize;
+	return int(std::clamp(
+		parts * kDownloadPartSize,
+		int64(kMinWaitedInSession),
+		int64(kMaxWaitedInSession)));
+}
+
 DownloadManagerMtproto::DcBalanceData::DcBalanceData()
 : sessions(kStartSessionsCount) {
 }
@@ -257,15 +300,17 @@ void DownloadManagerMtproto::requestSucceeded(
 		});
 		return;
 	}
-	if (amountAtRequestStart == data.maxWaitedAmount
-		&& data.maxWaitedAmount < kMaxWaitedInSession) {
-		data.maxWaitedAmount = std::min(
-			data.maxWaitedAmount + kDownloadPartSize,
-			kMaxWaitedInSession);
-		DEBUG_LOG(("Download (%1,%2) increased max waited amount %3."
+	data.addSample(amountAtRequestStart, duration, crl::now());
+	const auto maxWaitedAmount = data.computeMaxWaitedAmount();
+	if (data.maxWaitedAmount != maxWaitedAmount) {
+		data.maxWaitedAmount = maxWaitedAmount;
+		DEBUG_LOG(("Download (%1,%2) changed max waited amount %3, "
+			"bandwidth: %4, rtt: %5."
 			).arg(dcId
 			).arg(index
-			).arg(data.maxWaitedAmount));
+			).arg(data.maxWaitedAmount
+			).arg(data.bandwidth
+			).arg(data.rtt));
 	}
 	data.successes = std::min(data.successes + 1, kMaxTrackedSuccesses);
 	const auto notEnough = ranges::any_of(
@@ -275,6 +320,16 @@ void DownloadManagerMtproto::requestSucceeded(
 	if (notEnough) {
 		return;
 	}
+
+	// Another session helps only if the bandwidth-delay product
+	// doesn't fit into the amount we can have in flight in each session.
+	const auto saturated = ranges::all_of(
+		dc.sessions,
+		_1 == kMaxWaitedInSession,
+		&DcSessionBalanceData::maxWaitedAmount);
+	if (!saturated) {
+		return;
+	}
 	for (auto &session : dc.sessions) {
 		session.successes = 0;
 	}
@@ -307,6 +362,22 @@ int DownloadManagerMtproto::chooseSessionIndex(MTP::DcId dcId) const {
 	return (j - begin(sessions));
 }
 
+int64 DownloadManagerMtproto::measuredBandwidth() const {
+	const auto now = crl::now();
+	auto result = int64(0);
+	for (const auto &[dcId, data] : _balanceData) {
+		auto sum = int64(0);
+		for (const auto &session : data.sessions) {
+			if (session.bandwidthReceived
+				&& now - session.bandwidthReceived < kBandwidthActualTimeout) {
+				sum += session.bandwidth;
+			}
+		}
+		result = std::max(result, sum);
+	}
+	return result;
+}
+
 void DownloadManagerMtproto::sessionTimedOut(MTP::DcId dcId, int index) {
 	const auto i = _balanceData.find(dcId);
 	if (i == end(_balanceData)) {
@@ -666,7 +737,9 @@ void DownloadMtprotoTask::cdnPartLoaded(const MTPupload_CdnFile &result, mtpRequ
 
 		switch (checkCdnFileHash(requestData.offset, buffer)) {
 		case CheckCdnHashResult::NoHash: {
-			_cdnUncheckedParts.emplace(requestData, decryptInPlace);
+			_cdnUncheckedParts.emplace(
+				requestData,
+				std::move(decryptInPlace));
 			requestMoreCdnFileHashes();
 		} return;
 
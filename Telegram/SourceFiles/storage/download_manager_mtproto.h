@@ -22,6 +22,14 @@ namespace Storage {
 // fixed part size download for hash checking.
 constexpr auto kDownloadPartSize = 128 * 1024;
 
+// Streaming loaders enqueue with positive priorities, growing for each
+// newly started stream. Requested files start at the default priority,
+// that becomes the previous generation one after a short timeout.
+// Automatic downloads go after all of them.
+constexpr auto kDownloadPriorityDefault = 0;
+constexpr auto kDownloadPriorityPreviousGeneration = -1;
+constexpr auto kDownloadPriorityAutoLoading = -2;
+
 class DownloadMtprotoTask;
 
 class DownloadManagerMtproto final : public base::has_weak_ptr {
@@ -50,6 +58,9 @@ public:
 		crl::time timeAtRequestStart);
 	[[nodiscard]] int chooseSessionIndex(MTP::DcId dcId) const;
 
+	// Bytes per second in the fastest dc measured recently, zero if unknown.
+	[[nodiscard]] int64 measuredBandwidth() const;
+
 private:
 	class Queue final {
 	public:
@@ -71,9 +82,17 @@ private:
 	struct DcSessionBalanceData {
 		DcSessionBalanceData();
 
+		void addSample(int amount, crl::time duration, crl::time now);
+		[[nodiscard]] int computeMaxWaitedAmount() const;
+
 		int requested = 0;
 		int successes = 0; // Since last timeout in this dc in any session.
 		int maxWaitedAmount = 0;
+
+		int64 bandwidth = 0; // Bytes per second, smoothed.
+		crl::time bandwidthReceived = 0;
+		crl::time rtt = 0; // Minimal request duration in a window.
+		crl::time rttReceived = 0;
 	};
 	struct DcBalanceData {
 		DcBalanceData();
@@ -153,7 +172,7 @@ protected:
 	void cancelAllRequests();
 	void cancelRequestForOffset(int offset);
 
-	void addToQueue(int priority = 0);
+	void addToQueue(int priority = kDownloadPriorityDefault);
 	void removeFromQueue();
 
 	[[nodiscard]] ApiWrap &api() const {
@@ -18,6 +18,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/file_download_web.h"
 #include "platform/platform_file_utilities.h"
 #include "main/main_session.h"
+#include "main/main_account.h"
+#include "main/main_domain.h"
 #include "apiwrap.h"
 #include "core/crash_reports.h"
 #include "base/bytes.h"
@@ -26,6 +28,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
+base::flat_map<uint8, FileLoader::CacheHits> CacheHitsByTag;
+
 class FromMemoryLoader final : public FileLoader {
 public:
 	FromMemoryLoader(
@@ -86,6 +90,66 @@ void FromMemoryLoader::startLoading() {
 	finishWithBytes(_data);
 }
 
+struct SharedRead {
+	Storage::Cache::Key key;
+	uint8 cacheTag = 0;
+	std::vector<base::weak_ptr<Main::Session>> sessions;
+	FnMut<void(QByteArray &&value)> done;
+};
+
+void ReadSharedFrom(std::shared_ptr<SharedRead> read, int index) {
+	const auto count = int(read->sessions.size());
+	for (; index != count; ++index) {
+		if (read->sessions[index]) {
+			break;
+		}
+	}
+	if (index == count) {
+		read->done(QByteArray());
+		return;
+	}
+	const auto session = read->sessions[index].get();
+	session->data().cache().get(read->key, [=](QByteArray &&value) {
+		if (value.isEmpty()) {
+			crl::on_main([=] {
+				ReadSharedFrom(read, index + 1);
+			});
+			return;
+		} else if (index > 0) {
+			crl::on_main([=, copy = value] {
+				if (const auto strong = read->sessions.front().get()) {
+					strong->data().cache().putIfEmpty(
+						read->key,
+						Storage::Cache::Database::TaggedValue(
+							base::duplicate(copy),
+							read->cacheTag));
+				}
+			});
+		}
+		read->done(std::move(value));
+	});
+}
+
+// Stickers are the same for all the accounts, so if another account
+// already has a sticker in its cache, it is copied instead of loaded.
+void ReadShared(
+		not_null<Main::Session*> session,
+		const Storage::Cache::Key &key,
+		uint8 cacheTag,
+		FnMut<void(QByteArray &&value)> done) {
+	auto read = std::make_shared<SharedRead>();
+	read->key = key;
+	read->cacheTag = cacheTag;
+	read->done = std::move(done);
+	read->sessions.push_back(base::make_weak(session.get()));
+	for (const auto &[index, account] : Core::App().domain().accounts()) {
+		if (account->sessionExists() && &account->session() != session) {
+			read->sessions.push_back(base::make_weak(&account->session()));
+		}
+	}
+	ReadSharedFrom(std::move(read), 0);
+}
+
 } // namespace
 
 FileLoader::FileLoader(
@@ -140,8 +204,41 @@ void FileLoader::finishWithBytes(const QByteArray &data) {
 		Platform::File::PostprocessDownloaded(
 			QFileInfo(_file).absoluteFilePath());
 	}
-	_session->downloaderTaskFinished().notify();
-	_updates.fire_done();
+	notifyFinished();
+}
+
+void FileLoader::notifyFinished() {
+	if (_locationType != UnknownFileLocation || !_imageData.isNull()) {
+		_session->downloaderTaskFinished().notify();
+		_updates.fire_done();
+		return;
+	}
+	// Decode the image here, so that imageData() doesn't do it on main.
+	crl::async([
+		=,
+		guard = _imageReading.make_guard(),
+		data = _data
+	]() mutable {
+		auto format = QByteArray();
+		auto image = App::readImage(data, &format, false);
+		crl::on_main(std::move(guard), [
+			=,
+			image = std::move(image),
+			format = std::move(format)
+		]() mutable {
+			if (!image.isNull()) {
+				_imageData = std::move(image);
+				_imageFormat = std::move(format);
+			}
+			_session->downloaderTaskFinished().notify();
+			_updates.fire_done();
+		});
+	});
+}
+
+FileLoader::CacheHits FileLoader::CollectCacheHits(uint8 cacheTag) {
+	const auto i = CacheHitsByTag.find(cacheTag);
+	return (i != end(CacheHitsByTag)) ? i->second : CacheHits();
 }
 
 QByteArray FileLoader::imageFormat(const QSize &shrinkBox) const {
@@ -198,6 +295,16 @@ void FileLoader::permitLoadFromCloud() {
 	_fromCloud = LoadFromCloudOrLocal;
 }
 
+void FileLoader::stopAutoLoading() {
+	if (!_autoLoading) {
+		return;
+	}
+	_autoLoading = false;
+	if (!_finished) {
+		autoLoadingStoppedHook();
+	}
+}
+
 void FileLoader::notifyAboutProgress() {
 	_updates.fire({});
 }
@@ -207,6 +314,8 @@ void FileLoader::localLoaded(
 		const QByteArray &imageFormat,
 		const QImage &imageData) {
 	_localLoading = nullptr;
+	auto &hits = CacheHitsByTag[_cacheTag];
+	++(result.data.isEmpty() ? hits.misses : hits.hits);
 	if (result.data.isEmpty()) {
 		_localStatus = LocalStatus::NotFound;
 		start();
@@ -254,7 +363,7 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 				std::move(image));
 		});
 	};
-	_session->data().cache().get(key, [=, callback = std::move(done)](
+	auto read = [=, callback = std::move(done)](
 			QByteArray &&value) mutable {
 		if (readImage) {
 			crl::async([
@@ -275,7 +384,12 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 		} else {
 			callback(std::move(value), {}, {});
 		}
-	});
+	};
+	if (_cacheTag == Data::kStickerCacheTag) {
+		ReadShared(_session, key, _cacheTag, std::move(read));
+	} else {
+		_session->data().cache().get(key, std::move(read));
+	}
 }
 
 bool FileLoader::tryLoadLocal() {
@@ -374,6 +488,16 @@ bool FileLoader::writeResultPart(int offset, bytes::const_span buffer) {
 			buffer.size());
 		bytes::copy(dst, buffer);
 	}
+	if (offset > _loadedPrefix) {
+		_loadedAfterPrefix.emplace(offset, int(buffer.size()));
+	} else {
+		_loadedPrefix = std::max(_loadedPrefix, int(offset + buffer.size()));
+		auto i = begin(_loadedAfterPrefix);
+		for (; i != end(_loadedAfterPrefix) && i->first <= _loadedPrefix; ++i) {
+			_loadedPrefix = std::max(_loadedPrefix, i->first + i->second);
+		}
+		_loadedAfterPrefix.erase(begin(_loadedAfterPrefix), i);
+	}
 	return true;
 }
 
@@ -440,8 +564,7 @@ bool FileLoader::finalizeResult() {
 					_cacheTag));
 		}
 	}
-	_session->downloaderTaskFinished().notify();
-	_updates.fire_done();
+	notifyFinished();
 	return true;
 }
 
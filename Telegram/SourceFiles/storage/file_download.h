@@ -54,6 +54,11 @@ struct StorageImageSaved {
 
 class FileLoader : public base::has_weak_ptr {
 public:
+	struct CacheHits {
+		int64 hits = 0;
+		int64 misses = 0;
+	};
+
 	FileLoader(
 		not_null<Main::Session*> session,
 		const QString &toFile,
@@ -77,6 +82,14 @@ public:
 	[[nodiscard]] const QByteArray &bytes() const {
 		return _data;
 	}
+	// Bytes from the start of the file without holes, while loading.
+	// The prefix is a copy, check the size before taking it.
+	[[nodiscard]] int loadedPrefixSize() const {
+		return _loadedPrefix;
+	}
+	[[nodiscard]] QByteArray loadedPrefix() const {
+		return _data.left(_loadedPrefix);
+	}
 	[[nodiscard]] virtual uint64 objId() const {
 		return 0;
 	}
@@ -95,6 +108,10 @@ public:
 	bool setFileName(const QString &filename); // set filename for loaders to cache
 	void permitLoadFromCloud();
 
+	// The file was requested by the user after it started loading
+	// automatically, it should not wait for other automatic downloads.
+	void stopAutoLoading();
+
 	void start();
 	void cancel();
 
@@ -118,6 +135,9 @@ public:
 		return _lifetime;
 	}
 
+	// Main thread, local cache reads of all the loaders by cache tag.
+	[[nodiscard]] static CacheHits CollectCacheHits(uint8 cacheTag);
+
 protected:
 	enum class LocalStatus {
 		NotTried,
@@ -134,10 +154,13 @@ protected:
 	virtual std::optional<MediaKey> fileLocationKey() const = 0;
 	virtual void cancelHook() = 0;
 	virtual void startLoading() = 0;
+	virtual void autoLoadingStoppedHook() {
+	}
 
 	void cancel(bool failed);
 
 	void notifyAboutProgress();
+	void notifyFinished();
 
 	bool writeResultPart(int offset, bytes::const_span buffer);
 	bool finalizeResult();
@@ -159,12 +182,15 @@ protected:
 	LoadFromCloudSetting _fromCloud;
 
 	QByteArray _data;
+	int _loadedPrefix = 0;
+	base::flat_map<int, int> _loadedAfterPrefix;
 
 	int _size = 0;
 	int _skippedBytes = 0;
 	LocationType _locationType = LocationType();
 
 	base::binary_guard _localLoading;
+	base::binary_guard _imageReading;
 	mutable QByteArray _imageFormat;
 	mutable QImage _imageData;
 
@@ -152,7 +152,15 @@ bool mtpFileLoader::setWebFileSizeHook(int size) {
 }
 
 void mtpFileLoader::startLoading() {
-	addToQueue();
+	addToQueue(_autoLoading
+		? Storage::kDownloadPriorityAutoLoading
+		: Storage::kDownloadPriorityDefault);
+}
+
+void mtpFileLoader::autoLoadingStoppedHook() {
+	if (_localStatus == LocalStatus::NotFound) {
+		startLoading();
+	}
 }
 
 void mtpFileLoader::cancelHook() {
@@ -49,6 +49,7 @@ private:
 	std::optional<MediaKey> fileLocationKey() const override;
 	void startLoading() override;
 	void cancelHook() override;
+	void autoLoadingStoppedHook() override;
 
 	bool readyToRequest() const override;
 	int takeNextRequestOffset() override;
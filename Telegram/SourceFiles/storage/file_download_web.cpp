@@ -262,7 +262,14 @@ void WebLoadManager::removeSent(int id) {
 }
 
 not_null<QNetworkReply*> WebLoadManager::send(int id, const QString &url) {
-	const auto result = _network.get(QNetworkRequest(url));
+	auto request = QNetworkRequest(url);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+	// Many previews and inline results come from the same hosts,
+	// HTTP/2 multiplexes them over one connection instead of queueing
+	// them in the six HTTP/1.1 connections per host.
+	request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#endif // Qt >= 5.10
+	const auto result = _network.get(request);
 	const auto handleProgress = [=](qint64 ready, qint64 total) {
 		progress(id, result, ready, total);
 	};
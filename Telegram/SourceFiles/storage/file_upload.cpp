@@ -18,11 +18,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "apiwrap.h"
 
+#include <crl/crl_object_on_queue.h>
+
 namespace Storage {
 namespace {
 
-// max 512kb uploaded at the same time in each session
-constexpr auto kMaxUploadFileParallelSize = MTP::kUploadSessionsCount * 512 * 1024;
+// Each session starts with 512kb uploaded at the same time, this amount
+// grows with acknowledgements while they are fast and drops if they're slow.
+constexpr auto kUploadSessionStartWindow = uint32(512 * 1024);
+constexpr auto kUploadSessionMinWindow = uint32(128 * 1024);
+constexpr auto kUploadSessionMaxWindow = uint32(2 * 1024 * 1024);
+constexpr auto kUploadPartSlowDuration = 4 * crl::time(1000);
 
 constexpr auto kDocumentMaxPartsCount = 3000;
 
@@ -51,6 +57,158 @@ constexpr auto kKillSessionTimeout = 15 * crl::time(000);
 	return Core::IsMimeSticker(mime) ? "WEBP" : "JPG";
 }
 
+// Reads document parts on a background queue ahead of sending them.
+// The md5 hash is computed there as well, in the reading order.
+class DocumentPartsReader final : public base::has_weak_ptr {
+public:
+	DocumentPartsReader(
+		const QString &path,
+		int partSize,
+		int partsCount,
+		bool computeMd5,
+		Fn<void()> ready);
+
+	void readAhead(int count);
+	[[nodiscard]] std::optional<QByteArray> take();
+	[[nodiscard]] bool failed() const;
+
+	// Available after the last part was read.
+	[[nodiscard]] QByteArray md5Hex() const;
+
+private:
+	class Implementation;
+
+	void partRead(QByteArray &&bytes, QByteArray &&md5Hex);
+
+	const int _partsCount = 0;
+	const Fn<void()> _ready;
+	std::deque<QByteArray> _parts;
+	QByteArray _md5Hex;
+	int _requested = 0;
+	int _taken = 0;
+	bool _failed = false;
+
+	crl::object_on_queue<Implementation> _wrapped;
+
+};
+
+class DocumentPartsReader::Implementation final {
+public:
+	Implementation(
+		crl::weak_on_queue<Implementation> weak,
+		const QString &path,
+		int partSize,
+		bool computeMd5);
+
+	[[nodiscard]] QByteArray read();
+	[[nodiscard]] QByteArray md5Hex();
+
+private:
+	QFile _file;
+	HashMd5 _md5;
+	const int _partSize = 0;
+	const bool _computeMd5 = false;
+	bool _failed = false;
+
+};
+
+DocumentPartsReader::Implementation::Implementation(
+	crl::weak_on_queue<Implementation> weak,
+	const QString &path,
+	int partSize,
+	bool computeMd5)
+: _file(path)
+, _partSize(partSize)
+, _computeMd5(computeMd5)
+, _failed(!_file.open(QIODevice::ReadOnly)) {
+}
+
+QByteArray DocumentPartsReader::Implementation::read() {
+	if (_failed) {
+		return QByteArray();
+	}
+	auto result = _file.read(_partSize);
+	if (result.isEmpty()) {
+		_failed = true;
+	} else if (_computeMd5) {
+		_md5.feed(result.constData(), result.size());
+	}
+	return result;
+}
+
+QByteArray DocumentPartsReader::Implementation::md5Hex() {
+	if (!_computeMd5) {
+		return QByteArray();
+	}
+	auto result = QByteArray(32, Qt::Uninitialized);
+	hashMd5Hex(_md5.result(), result.data());
+	return result;
+}
+
+DocumentPartsReader::DocumentPartsReader(
+	const QString &path,
+	int partSize,
+	int partsCount,
+	bool computeMd5,
+	Fn<void()> ready)
+: _partsCount(partsCount)
+, _ready(std::move(ready))
+, _wrapped(path, partSize, computeMd5) {
+}
+
+void DocumentPartsReader::readAhead(int count) {
+	const auto till = std::min(_partsCount, _taken + std::max(count, 1));
+	const auto weak = base::make_weak(this);
+	while (_requested < till) {
+		const auto last = (++_requested == _partsCount);
+		_wrapped.with([=](Implementation &unwrapped) {
+			auto bytes = unwrapped.read();
+			auto md5Hex = (last && !bytes.isEmpty())
+				? unwrapped.md5Hex()
+				: QByteArray();
+			crl::on_main(weak, [
+				=,
+				bytes = std::move(bytes),
+				md5Hex = std::move(md5Hex)
+			]() mutable {
+				partRead(std::move(bytes), std::move(md5Hex));
+			});
+		});
+	}
+}
+
+void DocumentPartsReader::partRead(QByteArray &&bytes, QByteArray &&md5Hex) {
+	if (_failed) {
+		return;
+	} else if (bytes.isEmpty()) {
+		_failed = true;
+	} else {
+		_parts.push_back(std::move(bytes));
+		if (!md5Hex.isEmpty()) {
+			_md5Hex = std::move(md5Hex);
+		}
+	}
+	_ready();
+}
+
+std::optional<QByteArray> DocumentPartsReader::take() {
+	if (_parts.empty()) {
+		return std::nullopt;
+	}
+	auto result = std::move(_parts.front());
+	_parts.pop_front();
+	++_taken;
+	return result;
+}
+
+bool DocumentPartsReader::failed() const {
+	return _failed;
+}
+
+QByteArray DocumentPartsReader::md5Hex() const {
+	return _md5Hex;
+}
+
 } // namespace
 
 struct Uploader::File {
@@ -72,7 +230,7 @@ struct Uploader::File {
 
 	HashMd5 md5Hash;
 
-	std::unique_ptr<QFile> docFile;
+	std::unique_ptr<DocumentPartsReader> docReader;
 	int32 docSentParts = 0;
 	int32 docSize = 0;
 	int32 docPartSize = 0;
@@ -149,6 +307,7 @@ const QString &Uploader::File::filename() const {
 
 Uploader::Uploader(not_null<ApiWrap*> api)
 : _api(api) {
+	_sessionWindows.fill(kUploadSessionStartWindow);
 	nextTimer.setSingleShot(true);
 	connect(&nextTimer, SIGNAL(timeout()), this, SLOT(sendNext()));
 	stopSessionsTimer.setSingleShot(true);
@@ -266,8 +425,8 @@ void Uploader::currentFailed() {
 	requestsSent.clear();
 	docRequestsSent.clear();
 	dcMap.clear();
+	_requestsSentAt.clear();
 	uploadingId = FullMsgId();
-	sentSize = 0;
 	for (int i = 0; i < MTP::kUploadSessionsCount; ++i) {
 		sentSizes[i] = 0;
 	}
@@ -282,14 +441,21 @@ void Uploader::stopSessions() {
 }
 
 void Uploader::sendNext() {
-	if (sentSize >= kMaxUploadFileParallelSize || _pausedId.msg) return;
+	while (sendNextPart()) {
+	}
+}
+
+bool Uploader::sendNextPart() {
+	if (_pausedId.msg) {
+		return false;
+	}
 
 	bool stopping = stopSessionsTimer.isActive();
 	if (queue.empty()) {
 		if (!stopping) {
 			stopSessionsTimer.start(kKillSessionTimeout);
 		}
-		return;
+		return false;
 	}
 
 	if (stopping) {
@@ -310,6 +476,9 @@ void Uploader::sendNext() {
 			todc = dc;
 		}
 	}
+	if (sentSizes[todc] >= _sessionWindows[todc]) {
+		return false;
+	}
 
 	auto &parts = uploadingData.file
 		? ((uploadingData.type() == SendMediaType::Photo
@@ -351,8 +520,15 @@ void Uploader::sendNext() {
 				} else if (uploadingData.type() == SendMediaType::File
 					|| uploadingData.type() == SendMediaType::ThemeFile
 					|| uploadingData.type() == SendMediaType::Audio) {
-					QByteArray docMd5(32, Qt::Uninitialized);
-					hashMd5Hex(uploadingData.md5Hash.result(), docMd5.data());
+					auto docMd5 = uploadingData.docReader
+						? uploadingData.docReader->md5Hex()
+						: QByteArray();
+					if (docMd5.isEmpty()) {
+						docMd5 = QByteArray(32, Qt::Uninitialized);
+						hashMd5Hex(
+							uploadingData.md5Hash.result(),
+							docMd5.data());
+					}
 
 					const auto file = (uploadingData.docSize > kUseBigFilesFrom)
 						? MTP_inputFileBig(
@@ -397,9 +573,9 @@ void Uploader::sendNext() {
 				}
 				queue.erase(uploadingId);
 				uploadingId = FullMsgId();
-				sendNext();
+				return true;
 			}
-			return;
+			return false;
 		}
 
 		auto &content = uploadingData.file
@@ -407,20 +583,30 @@ void Uploader::sendNext() {
 			: uploadingData.media.data;
 		QByteArray toSend;
 		if (content.isEmpty()) {
-			if (!uploadingData.docFile) {
+			if (!uploadingData.docReader) {
 				const auto filepath = uploadingData.file
 					? uploadingData.file->filepath
 					: uploadingData.media.file;
-				uploadingData.docFile = std::make_unique<QFile>(filepath);
-				if (!uploadingData.docFile->open(QIODevice::ReadOnly)) {
-					currentFailed();
-					return;
-				}
+				uploadingData.docReader = std::make_unique<DocumentPartsReader>(
+					filepath,
+					uploadingData.docPartSize,
+					uploadingData.docPartsCount,
+					(uploadingData.docSize <= kUseBigFilesFrom),
+					[=] { sendNext(); });
 			}
-			toSend = uploadingData.docFile->read(uploadingData.docPartSize);
-			if (uploadingData.docSize <= kUseBigFilesFrom) {
-				uploadingData.md5Hash.feed(toSend.constData(), toSend.size());
+			const auto reader = uploadingData.docReader.get();
+			const auto windows = ranges::accumulate(_sessionWindows, 0U);
+			reader->readAhead(int(windows) / uploadingData.docPartSize);
+			if (reader->failed()) {
+				currentFailed();
+				return false;
+			}
+			auto part = reader->take();
+			if (!part) {
+				// sendNext() will be called when the part is read.
+				return false;
 			}
+			toSend = std::move(*part);
 		} else {
 			const auto offset = uploadingData.docSentParts
 				* uploadingData.docPartSize;
@@ -436,7 +622,7 @@ void Uploader::sendNext() {
 			|| ((toSend.size() < uploadingData.docPartSize
 				&& uploadingData.docSentParts + 1 != uploadingData.docPartsCount))) {
 			currentFailed();
-			return;
+			return false;
 		}
 		mtpRequestId requestId;
 		if (uploadingData.docSize > kUseBigFilesFrom) {
@@ -463,7 +649,7 @@ void Uploader::sendNext() {
 		}
 		docRequestsSent.emplace(requestId, uploadingData.docSentParts);
 		dcMap.emplace(requestId, todc);
-		sentSize += uploadingData.docPartSize;
+		_requestsSentAt.emplace(requestId, crl::now());
 		sentSizes[todc] += uploadingData.docPartSize;
 
 		uploadingData.docSentParts++;
@@ -481,12 +667,13 @@ void Uploader::sendNext() {
 		}).toDC(MTP::uploadDcId(todc)).send();
 		requestsSent.emplace(requestId, part.value());
 		dcMap.emplace(requestId, todc);
-		sentSize += part.value().size();
+		_requestsSentAt.emplace(requestId, crl::now());
 		sentSizes[todc] += part.value().size();
 
 		parts.erase(part);
 	}
 	nextTimer.start(kUploadRequestInterval);
+	return true;
 }
 
 void Uploader::cancel(const FullMsgId &msgId) {
@@ -522,7 +709,7 @@ void Uploader::clear() {
 	}
 	docRequestsSent.clear();
 	dcMap.clear();
-	sentSize = 0;
+	_requestsSentAt.clear();
 	for (int i = 0; i < MTP::kUploadSessionsCount; ++i) {
 		_api->instance().stopSession(MTP::uploadDcId(i));
 		sentSizes[i] = 0;
@@ -560,7 +747,20 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 				sentPartSize = file.docPartSize;
 				docRequestsSent.erase(j);
 			}
-			sentSize -= sentPartSize;
+			const auto sentAt = _requestsSentAt.find(requestId);
+			if (sentAt != end(_requestsSentAt)) {
+				const auto duration = crl::now() - sentAt->second;
+				_requestsSentAt.erase(sentAt);
+
+				auto &window = _sessionWindows[dc];
+				if (duration > kUploadPartSlowDuration) {
+					window = std::max(window / 2, kUploadSessionMinWindow);
+				} else if (sentSizes[dc] >= window) {
+					window = std::min(
+						window + sentPartSize,
+						kUploadSessionMaxWindow);
+				}
+			}
 			sentSizes[dc] -= sentPartSize;
 			if (file.type() == SendMediaType::Photo) {
 				file.fileSentSize += sentPartSize;
@@ -118,6 +118,7 @@ public slots:
 private:
 	struct File;
 
+	bool sendNextPart();
 	void partLoaded(const MTPBool &result, mtpRequestId requestId);
 	void partFailed(const RPCError &error, mtpRequestId requestId);
 
@@ -127,8 +128,9 @@ private:
 	base::flat_map<mtpRequestId, QByteArray> requestsSent;
 	base::flat_map<mtpRequestId, int32> docRequestsSent;
 	base::flat_map<mtpRequestId, int32> dcMap;
-	uint32 sentSize = 0;
+	base::flat_map<mtpRequestId, crl::time> _requestsSentAt;
 	uint32 sentSizes[MTP::kUploadSessionsCount] = { 0 };
+	std::array<uint32, MTP::kUploadSessionsCount> _sessionWindows = { { 0 } };
 
 	FullMsgId uploadingId;
 	FullMsgId _pausedId;
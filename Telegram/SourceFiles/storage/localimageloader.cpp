@@ -245,7 +245,8 @@ SendMediaReady PreparePeerPhoto(MTP::DcId dcId, PeerId peerId, QImage &&image) {
 		0);
 }
 
-TaskQueue::TaskQueue(crl::time stopTimeoutMs) {
+TaskQueue::TaskQueue(crl::time stopTimeoutMs, int workersCount)
+: _workersCount(std::max(workersCount, 1)) {
 	if (stopTimeoutMs > 0) {
 		_stopTimer = new QTimer(this);
 		connect(_stopTimer, SIGNAL(timeout()), this, SLOT(stop()));
@@ -258,10 +259,10 @@ TaskId TaskQueue::addTask(std::unique_ptr<Task> &&task) {
 	const auto result = task->id();
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
-		_tasksToProcess.push_back(std::move(task));
+		pushToProcess(std::move(task));
 	}
 
-	wakeThread();
+	wakeThreads();
 
 	return result;
 }
@@ -270,24 +271,57 @@ void TaskQueue::addTasks(std::vector<std::unique_ptr<Task>> &&tasks) {
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		for (auto &task : tasks) {
-			_tasksToProcess.push_back(std::move(task));
+			pushToProcess(std::move(task));
 		}
 	}
 
-	wakeThread();
+	wakeThreads();
 }
 
-void TaskQueue::wakeThread() {
-	if (!_thread) {
-		_thread = new QThread();
+void TaskQueue::pushToProcess(std::unique_ptr<Task> &&task) {
+	task->_order = ++_lastOrder;
+	_tasksToProcess.push_back(std::move(task));
+}
+
+void TaskQueue::pushToFinish(std::unique_ptr<Task> &&task) {
+	const auto i = ranges::upper_bound(
+		_tasksToFinish,
+		task->_order,
+		ranges::less(),
+		[](const std::unique_ptr<Task> &task) { return task->_order; });
+	_tasksToFinish.insert(i, std::move(task));
+}
+
+bool TaskQueue::canFinishFront() const {
+	// Both mutexes should be locked.
+	if (_tasksToFinish.empty()) {
+		return false;
+	}
+	// All the tasks waiting in _tasksToProcess were added later.
+	const auto order = _tasksToFinish.front()->_order;
+	return ranges::none_of(_tasksInProcess, [&](not_null<Task*> task) {
+		return (task->_order < order);
+	});
+}
 
-		_worker = new TaskQueueWorker(this);
-		_worker->moveToThread(_thread);
+void TaskQueue::wakeThreads() {
+	const auto wanted = [&] {
+		QMutexLocker lock(&_tasksToProcessMutex);
+		return std::min(
+			_workersCount,
+			int(_tasksToProcess.size() + _tasksInProcess.size()));
+	}();
+	while (int(_threads.size()) < wanted) {
+		const auto thread = new QThread();
+		const auto worker = new TaskQueueWorker(this);
+		worker->moveToThread(thread);
 
-		connect(this, SIGNAL(taskAdded()), _worker, SLOT(onTaskAdded()));
-		connect(_worker, SIGNAL(taskProcessed()), this, SLOT(onTaskProcessed()));
+		connect(this, SIGNAL(taskAdded()), worker, SLOT(onTaskAdded()));
+		connect(worker, SIGNAL(taskProcessed()), this, SLOT(onTaskProcessed()));
 
-		_thread->start();
+		thread->start();
+		_threads.push_back(thread);
+		_workers.push_back(worker);
 	}
 	if (_stopTimer) _stopTimer->stop();
 	emit taskAdded();
@@ -306,8 +340,12 @@ void TaskQueue::cancelTask(TaskId id) {
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		removeFrom(_tasksToProcess);
-		if (_taskInProcessId == id) {
-			_taskInProcessId = TaskId();
+		const auto i = ranges::find(
+			_tasksInProcess,
+			id,
+			[](not_null<Task*> task) { return task->id(); });
+		if (i != end(_tasksInProcess)) {
+			(*i)->_cancelled.store(true, std::memory_order_release);
 		}
 	}
 	QMutexLocker lock(&_tasksToFinishMutex);
@@ -318,8 +356,9 @@ void TaskQueue::onTaskProcessed() {
 	do {
 		auto task = std::unique_ptr<Task>();
 		{
-			QMutexLocker lock(&_tasksToFinishMutex);
-			if (_tasksToFinish.empty()) break;
+			QMutexLocker lockToProcess(&_tasksToProcessMutex);
+			QMutexLocker lockToFinish(&_tasksToFinishMutex);
+			if (!canFinishFront()) break;
 			task = std::move(_tasksToFinish.front());
 			_tasksToFinish.pop_front();
 		}
@@ -328,24 +367,32 @@ void TaskQueue::onTaskProcessed() {
 
 	if (_stopTimer) {
 		QMutexLocker lock(&_tasksToProcessMutex);
-		if (_tasksToProcess.empty() && !_taskInProcessId) {
+		if (_tasksToProcess.empty() && _tasksInProcess.empty()) {
 			_stopTimer->start();
 		}
 	}
 }
 
 void TaskQueue::stop() {
-	if (_thread) {
-		_thread->requestInterruption();
-		_thread->quit();
+	for (const auto thread : _threads) {
+		thread->requestInterruption();
+		thread->quit();
+	}
+	if (!_threads.empty()) {
 		DEBUG_LOG(("Waiting for taskThread to finish"));
-		_thread->wait();
-		delete base::take(_worker);
-		delete base::take(_thread);
+	}
+	for (const auto thread : _threads) {
+		thread->wait();
+	}
+	for (const auto worker : base::take(_workers)) {
+		delete worker;
+	}
+	for (const auto thread : base::take(_threads)) {
+		delete thread;
 	}
 	_tasksToProcess.clear();
 	_tasksToFinish.clear();
-	_taskInProcessId = TaskId();
+	_tasksInProcess.clear();
 }
 
 TaskQueue::~TaskQueue() {
@@ -365,23 +412,28 @@ void TaskQueueWorker::onTaskAdded() {
 			if (!_queue->_tasksToProcess.empty()) {
 				task = std::move(_queue->_tasksToProcess.front());
 				_queue->_tasksToProcess.pop_front();
-				_queue->_taskInProcessId = task->id();
+				_queue->_tasksInProcess.push_back(task.get());
 			}
 		}
 
 		if (task) {
-			task->process();
+			if (!task->cancelled()) {
+				task->process();
+			}
 			bool emitTaskProcessed = false;
 			{
 				QMutexLocker lockToProcess(&_queue->_tasksToProcessMutex);
-				if (_queue->_taskInProcessId == task->id()) {
-					_queue->_taskInProcessId = TaskId();
-					someTasksLeft = !_queue->_tasksToProcess.empty();
-
-					QMutexLocker lockToFinish(&_queue->_tasksToFinishMutex);
-					emitTaskProcessed = _queue->_tasksToFinish.empty();
-					_queue->_tasksToFinish.push_back(std::move(task));
+				auto &inProcess = _queue->_tasksInProcess;
+				inProcess.erase(
+					ranges::remove(inProcess, not_null<Task*>(task.get())),
+					end(inProcess));
+				someTasksLeft = !_queue->_tasksToProcess.empty();
+
+				QMutexLocker lockToFinish(&_queue->_tasksToFinishMutex);
+				if (!task->cancelled()) {
+					_queue->pushToFinish(std::move(task));
 				}
+				emitTaskProcessed = _queue->canFinishFront();
 			}
 			if (emitTaskProcessed) {
 				emit taskProcessed();
@@ -776,7 +828,7 @@ void FileLoadTask::process() {
 	}
 	_result->filesize = (int32)qMin(filesize, qint64(INT_MAX));
 
-	if (!filesize || filesize > App::kFileSizeLimit) {
+	if (!filesize || filesize > App::kFileSizeLimit || cancelled()) {
 		return;
 	}
 
@@ -98,6 +98,18 @@ public:
 		return static_cast<TaskId>(const_cast<Task*>(this));
 	}
 
+	// May be checked in process() to stop early, finish() won't be called.
+	[[nodiscard]] bool cancelled() const {
+		return _cancelled.load(std::memory_order_acquire);
+	}
+
+private:
+	friend class TaskQueue;
+	friend class TaskQueueWorker;
+
+	std::atomic<bool> _cancelled = false;
+	uint64 _order = 0;
+
 };
 
 class TaskQueueWorker;
@@ -105,7 +117,10 @@ class TaskQueue : public QObject {
 	Q_OBJECT
 
 public:
-	explicit TaskQueue(crl::time stopTimeoutMs = 0); // <= 0 - never stop worker
+	// stopTimeoutMs <= 0 - never stop workers.
+	// Tasks are processed by workersCount threads in parallel,
+	// but finish() is always called in the order the tasks were added.
+	explicit TaskQueue(crl::time stopTimeoutMs = 0, int workersCount = 1);
 
 	TaskId addTask(std::unique_ptr<Task> &&task);
 	void addTasks(std::vector<std::unique_ptr<Task>> &&tasks);
@@ -123,14 +138,19 @@ public slots:
 private:
 	friend class TaskQueueWorker;
 
-	void wakeThread();
+	void wakeThreads();
+	void pushToProcess(std::unique_ptr<Task> &&task);
+	void pushToFinish(std::unique_ptr<Task> &&task);
+	[[nodiscard]] bool canFinishFront() const;
 
+	const int _workersCount = 1;
 	std::deque<std::unique_ptr<Task>> _tasksToProcess;
-	std::deque<std::unique_ptr<Task>> _tasksToFinish;
-	TaskId _taskInProcessId = TaskId();
+	std::deque<std::unique_ptr<Task>> _tasksToFinish; // Sorted by _order.
+	std::vector<not_null<Task*>> _tasksInProcess;
+	uint64 _lastOrder = 0;
 	QMutex _tasksToProcessMutex, _tasksToFinishMutex;
-	QThread *_thread = nullptr;
-	TaskQueueWorker *_worker = nullptr;
+	std::vector<QThread*> _threads;
+	std::vector<TaskQueueWorker*> _workers;
 	QTimer *_stopTimer = nullptr;
 
 };
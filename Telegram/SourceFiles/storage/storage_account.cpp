@@ -24,6 +24,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtp_instance.h"
 #include "history/history.h"
 #include "core/application.h"
+#include "core/startup_trace.h"
 #include "data/stickers/data_stickers.h"
 #include "data/data_session.h"
 #include "data/data_document.h"
@@ -31,6 +32,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_drafts.h"
 #include "export/export_settings.h"
 #include "window/themes/window_theme.h"
+#include "base/openssl_help.h"
 
 namespace Storage {
 namespace {
@@ -51,6 +53,17 @@ constexpr auto kSinglePeerTypeChannel = qint32(3);
 constexpr auto kSinglePeerTypeSelf = qint32(4);
 constexpr auto kSinglePeerTypeEmpty = qint32(0);
 
+// Compact the locations journal into a full rewrite when it gets bigger
+// than the locations file itself, but not before it reaches this size.
+constexpr auto kLocationsJournalMinCompactSize = qint64(64 * 1024);
+
+enum class LocationsJournalRecord : quint32 {
+	Insert = 0x01, // data: MediaKey key, FileLocation location
+	Erase = 0x02, // data: MediaKey key, FileLocation location
+	EraseAll = 0x03, // data: MediaKey key
+	Alias = 0x04, // data: MediaKey key, MediaKey value
+};
+
 enum { // Local Storage Keys
 	lskUserMap = 0x00,
 	lskDraft = 0x01, // data: PeerId peer
@@ -102,6 +115,60 @@ enum { // Local Storage Keys
 	return cWorkingDir() + qsl("tdata/tdld/");
 }
 
+template <typename Callback>
+void AppendLocationsJournal(QByteArray &pending, Callback &&callback) {
+	QBuffer buffer(&pending);
+	buffer.open(QIODevice::WriteOnly | QIODevice::Append);
+	QDataStream stream(&buffer);
+	stream.setVersion(QDataStream::Qt_5_1);
+	callback(stream);
+}
+
+void WriteJournalKey(QDataStream &stream, MediaKey key) {
+	stream << quint64(key.first) << quint64(key.second);
+}
+
+void WriteJournalLocation(QDataStream &stream, const FileLocation &location) {
+	stream
+		<< location.name()
+		<< location.bookmark()
+		<< location.modified
+		<< quint32(location.size);
+}
+
+void JournalLocation(
+		QByteArray &pending,
+		LocationsJournalRecord type,
+		MediaKey key,
+		const FileLocation &location) {
+	AppendLocationsJournal(pending, [&](QDataStream &stream) {
+		stream << quint32(type);
+		WriteJournalKey(stream, key);
+		WriteJournalLocation(stream, location);
+	});
+}
+
+void JournalLocationsErased(QByteArray &pending, MediaKey key) {
+	AppendLocationsJournal(pending, [&](QDataStream &stream) {
+		stream << quint32(LocationsJournalRecord::EraseAll);
+		WriteJournalKey(stream, key);
+	});
+}
+
+void JournalLocationAlias(QByteArray &pending, MediaKey key, MediaKey value) {
+	AppendLocationsJournal(pending, [&](QDataStream &stream) {
+		stream << quint32(LocationsJournalRecord::Alias);
+		WriteJournalKey(stream, key);
+		WriteJournalKey(stream, value);
+	});
+}
+
+[[nodiscard]] bool SameDraft(const MessageDraft &a, const MessageDraft &b) {
+	return (a.msgId == b.msgId)
+		&& (a.textWithTags == b.textWithTags)
+		&& (a.previewCancelled == b.previewCancelled);
+}
+
 } // namespace
 
 Account::Account(not_null<Main::Account*> owner, const QString &dataName)
@@ -143,6 +210,7 @@ StartResult Account::legacyStart(const QByteArray &passcode) {
 std::unique_ptr<MTP::Config> Account::start(MTP::AuthKeyPtr localKey) {
 	Expects(localKey != nullptr);
 
+	STARTUP_TRACE_SPAN("Storage::Account::start");
 	_localKey = std::move(localKey);
 	readMapWith(_localKey);
 	clearLegacyFiles();
@@ -199,6 +267,8 @@ base::flat_set<QString> Account::collectGoodNames() const {
 		result.emplace(name);
 		name[name.size() - 1] = 's';
 		result.emplace(name);
+		name[name.size() - 1] = 'j';
+		result.emplace(name);
 	};
 	for (const auto &[key, value] : _draftsMap) {
 		push(value);
@@ -396,6 +466,7 @@ Account::ReadMapResult Account::readMapWith(
 	if (_locationsKey) {
 		readLocations();
 	}
+	prefetchDeferredFiles();
 	if (_legacyBackgroundKeyDay || _legacyBackgroundKeyNight) {
 		Local::moveLegacyBackground(
 			_basePath,
@@ -418,6 +489,40 @@ Account::ReadMapResult Account::readMapWith(
 	return ReadMapResult::Success;
 }
 
+void Account::prefetchDeferredFiles() {
+	// These are parsed only after the session is created or on demand,
+	// decrypt them in the meantime while the main thread does the rest.
+	const auto keys = {
+		_installedStickersKey,
+		_featuredStickersKey,
+		_recentStickersKey,
+		_favedStickersKey,
+		_savedGifsKey,
+		_recentHashtagsAndBotsKey,
+		_trustedBotsKey,
+	};
+	for (const auto key : keys) {
+		if (key) {
+			_prefetched.emplace(
+				key,
+				std::make_unique<EncryptedFilePrefetch>(
+					key,
+					_basePath,
+					_localKey));
+		}
+	}
+}
+
+bool Account::readEncryptedFile(FileReadDescriptor &result, FileKey key) {
+	const auto i = _prefetched.find(key);
+	if (i == end(_prefetched)) {
+		return ReadEncryptedFile(result, key, _basePath, _localKey);
+	}
+	const auto prefetched = std::move(i->second);
+	_prefetched.erase(i);
+	return prefetched->take(result);
+}
+
 void Account::writeMapDelayed() {
 	_mapChanged = true;
 	_writeMapTimer.callOnce(kDelayedWriteTimeout);
@@ -539,6 +644,8 @@ void Account::reset() {
 	_draftsMap.clear();
 	_draftCursorsMap.clear();
 	_draftsNotReadMap.clear();
+	_draftsWritten.clear();
+	_draftCursorsWritten.clear();
 	_locationsKey = _trustedBotsKey = 0;
 	_recentStickersKeyOld = 0;
 	_installedStickersKey = 0;
@@ -550,9 +657,14 @@ void Account::reset() {
 	_legacyBackgroundKeyDay = _legacyBackgroundKeyNight = 0;
 	_settingsKey = _recentHashtagsAndBotsKey = _exportSettingsKey = 0;
 	_oldMapVersion = 0;
+	_prefetched.clear();
+	_stickersWritten.clear();
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
 	_fileLocationAliases.clear();
+	_locationsJournalPending = QByteArray();
+	_locationsJournalSize = _locationsSnapshotSize = 0;
+	_locationsRewrite = false;
 	_cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
 	_cacheTotalTimeLimit = Database::Settings().totalTimeLimit;
 	_cacheBigFileTotalSizeLimit = Database::Settings().totalSizeLimit;
@@ -583,12 +695,15 @@ void Account::writeLocations() {
 	_locationsChanged = false;
 
 	if (_fileLocations.isEmpty()) {
+		_locationsJournalPending = QByteArray();
+		_locationsJournalSize = _locationsSnapshotSize = 0;
+		_locationsRewrite = false;
 		if (_locationsKey) {
 			ClearKey(_locationsKey, _basePath);
 			_locationsKey = 0;
 			writeMapDelayed();
 		}
-	} else {
+	} else if (!writeLocationsJournal()) {
 		if (!_locationsKey) {
 			_locationsKey = GenerateKey(_basePath);
 			writeMapQueued();
@@ -641,7 +756,98 @@ void Account::writeLocations() {
 
 		FileWriteDescriptor file(_locationsKey, _basePath);
 		file.writeEncrypted(data, _localKey);
+
+		// Everything in the journal is in the full file now.
+		ClearJournal(_locationsKey, _basePath);
+		_locationsJournalPending = QByteArray();
+		_locationsJournalSize = 0;
+		_locationsSnapshotSize = size;
+		_locationsRewrite = false;
+	}
+}
+
+bool Account::writeLocationsJournal() {
+	if (!_locationsKey || _locationsRewrite) {
+		return false;
+	} else if (_locationsJournalPending.isEmpty()) {
+		return true;
+	} else if (_locationsJournalSize > std::max(
+			kLocationsJournalMinCompactSize,
+			_locationsSnapshotSize)) {
+		return false;
+	}
+	EncryptedDescriptor data(_locationsJournalPending.size());
+	data.stream.writeRawData(
+		_locationsJournalPending.constData(),
+		_locationsJournalPending.size());
+	const auto size = AppendEncryptedJournal(
+		_locationsKey,
+		_basePath,
+		data,
+		_localKey);
+	if (size < 0) {
+		return false;
+	}
+	_locationsJournalPending = QByteArray();
+	_locationsJournalSize = size;
+	return true;
+}
+
+bool Account::applyLocationsJournal(QDataStream &stream) {
+	const auto readKey = [&] {
+		quint64 first = 0, second = 0;
+		stream >> first >> second;
+		return MediaKey(first, second);
+	};
+	const auto readLocation = [&] {
+		auto result = FileLocation();
+		auto bookmark = QByteArray();
+		stream >> result.fname >> bookmark >> result.modified >> result.size;
+		result.setBookmark(bookmark);
+		return result;
+	};
+	const auto erase = [&](MediaKey key, const FileLocation &location) {
+		for (auto i = _fileLocations.find(key)
+			; (i != _fileLocations.end()) && (i.key() == key)
+			;) {
+			if (i.value() == location) {
+				i = _fileLocations.erase(i);
+			} else {
+				++i;
+			}
+		}
+	};
+	while (!stream.atEnd()) {
+		auto type = quint32();
+		stream >> type;
+		switch (LocationsJournalRecord(type)) {
+		case LocationsJournalRecord::Insert: {
+			const auto key = readKey();
+			const auto location = readLocation();
+
+			// Records may be replayed over a full file that has them
+			// already, if we didn't get to removing the journal after it.
+			erase(key, location);
+			_fileLocations.insert(key, location);
+		} break;
+		case LocationsJournalRecord::Erase: {
+			const auto key = readKey();
+			erase(key, readLocation());
+		} break;
+		case LocationsJournalRecord::EraseAll: {
+			_fileLocations.remove(readKey());
+		} break;
+		case LocationsJournalRecord::Alias: {
+			const auto key = readKey();
+			_fileLocationAliases.insert(key, readKey());
+		} break;
+		default: return false;
+		}
+		if (!CheckStreamStatus(stream)) {
+			return false;
+		}
 	}
+	return true;
 }
 
 void Account::writeLocationsQueued() {
@@ -686,9 +892,6 @@ void Account::readLocations() {
 		MediaKey key(first, second);
 
 		_fileLocations.insert(key, loc);
-		if (!loc.inMediaCache()) {
-			_fileLocationPairs.insert(loc.fname, { key, loc });
-		}
 	}
 
 	if (endMarkFound) {
@@ -712,6 +915,26 @@ void Account::readLocations() {
 			}
 		}
 	}
+	_locationsSnapshotSize = locations.data.size();
+
+	const auto replayed = ReadEncryptedJournal(
+		_locationsKey,
+		_basePath,
+		_localKey,
+		[=](QDataStream &stream) { return applyLocationsJournal(stream); });
+	_locationsJournalSize = JournalSize(_locationsKey, _basePath);
+	if (!replayed) {
+		// Don't append after a bad record, rewrite everything instead.
+		_locationsRewrite = true;
+		writeLocationsDelayed();
+	}
+
+	_fileLocationPairs.clear();
+	for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
+		if (!i.value().inMediaCache()) {
+			_fileLocationPairs.insert(i.value().fname, { i.key(), i.value() });
+		}
+	}
 }
 
 void Account::writeSessionSettings() {
@@ -971,11 +1194,19 @@ void Account::writeDrafts(
 			_draftsMap.erase(i);
 			writeMapDelayed();
 		}
+		_draftsWritten.remove(peer);
 
 		_draftsNotReadMap.remove(peer);
 	} else {
 		auto i = _draftsMap.find(peer);
-		if (i == _draftsMap.cend()) {
+		const auto j = _draftsWritten.find(peer);
+		if (i != _draftsMap.cend()
+			&& j != _draftsWritten.cend()
+			&& SameDraft(j->second.first, localDraft)
+			&& SameDraft(j->second.second, editDraft)) {
+			_draftsNotReadMap.remove(peer);
+			return;
+		} else if (i == _draftsMap.cend()) {
 			i = _draftsMap.emplace(peer, GenerateKey(_basePath)).first;
 			writeMapQueued();
 		}
@@ -998,6 +1229,7 @@ void Account::writeDrafts(
 
 		FileWriteDescriptor file(i->second, _basePath);
 		file.writeEncrypted(data, _localKey);
+		_draftsWritten[peer] = std::make_pair(localDraft, editDraft);
 
 		_draftsNotReadMap.remove(peer);
 	}
@@ -1010,6 +1242,7 @@ void Account::clearDraftCursors(const PeerId &peer) {
 		_draftCursorsMap.erase(i);
 		writeMapDelayed();
 	}
+	_draftCursorsWritten.remove(peer);
 }
 
 void Account::readDraftCursors(
@@ -1131,7 +1364,13 @@ void Account::writeDraftCursors(
 		clearDraftCursors(peer);
 	} else {
 		auto i = _draftCursorsMap.find(peer);
-		if (i == _draftCursorsMap.cend()) {
+		const auto j = _draftCursorsWritten.find(peer);
+		if (i != _draftCursorsMap.cend()
+			&& j != _draftCursorsWritten.cend()
+			&& j->second.first == msgCursor
+			&& j->second.second == editCursor) {
+			return;
+		} else if (i == _draftCursorsMap.cend()) {
 			i = _draftCursorsMap.emplace(peer, GenerateKey(_basePath)).first;
 			writeMapQueued();
 		}
@@ -1149,6 +1388,7 @@ void Account::writeDraftCursors(
 
 		FileWriteDescriptor file(i->second, _basePath);
 		file.writeEncrypted(data, _localKey);
+		_draftCursorsWritten[peer] = std::make_pair(msgCursor, editCursor);
 	}
 }
 
@@ -1175,6 +1415,10 @@ void Account::writeFileLocation(MediaKey location, const FileLocation &local) {
 			if (i.value().second == local) {
 				if (i.value().first != location) {
 					_fileLocationAliases.insert(location, i.value().first);
+					JournalLocationAlias(
+						_locationsJournalPending,
+						location,
+						i.value().first);
 					writeLocationsQueued();
 				}
 				return;
@@ -1182,6 +1426,11 @@ void Account::writeFileLocation(MediaKey location, const FileLocation &local) {
 			if (i.value().first != location) {
 				for (auto j = _fileLocations.find(i.value().first), e = _fileLocations.end(); (j != e) && (j.key() == i.value().first); ++j) {
 					if (j.value() == i.value().second) {
+						JournalLocation(
+							_locationsJournalPending,
+							LocationsJournalRecord::Erase,
+							j.key(),
+							j.value());
 						_fileLocations.erase(j);
 						break;
 					}
@@ -1195,10 +1444,20 @@ void Account::writeFileLocation(MediaKey location, const FileLocation &local) {
 			if (i.value().inMediaCache() || i.value().check()) {
 				return;
 			}
+			JournalLocation(
+				_locationsJournalPending,
+				LocationsJournalRecord::Erase,
+				i.key(),
+				i.value());
 			i = _fileLocations.erase(i);
 		}
 	}
 	_fileLocations.insert(location, local);
+	JournalLocation(
+		_locationsJournalPending,
+		LocationsJournalRecord::Insert,
+		location,
+		local);
 	writeLocationsQueued();
 }
 
@@ -1210,6 +1469,7 @@ void Account::removeFileLocation(MediaKey location) {
 	while (i != _fileLocations.end() && (i.key() == location)) {
 		i = _fileLocations.erase(i);
 	}
+	JournalLocationsErased(_locationsJournalPending, location);
 	writeLocationsQueued();
 }
 
@@ -1222,6 +1482,11 @@ FileLocation Account::readFileLocation(MediaKey location) {
 	for (auto i = _fileLocations.find(location); (i != _fileLocations.end()) && (i.key() == location);) {
 		if (!i.value().inMediaCache() && !i.value().check()) {
 			_fileLocationPairs.remove(i.value().fname);
+			JournalLocation(
+				_locationsJournalPending,
+				LocationsJournalRecord::Erase,
+				i.key(),
+				i.value());
 			i = _fileLocations.erase(i);
 			writeLocationsDelayed();
 			continue;
@@ -1292,6 +1557,32 @@ Cache::Database::Settings Account::cacheBigFileSettings() const {
 	return result;
 }
 
+void Account::writeStickersFile(
+		FileKey &stickersKey,
+		EncryptedDescriptor &data) {
+	// Skip encrypting and writing the file if it didn't change.
+	auto digest = openssl::Sha256(
+		bytes::make_span(data.data).subspan(sizeof(uint32)));
+	auto &written = _stickersWritten[stickersKey];
+	if (written == digest) {
+		return;
+	}
+	written = std::move(digest);
+
+	_prefetched.remove(stickersKey);
+	FileWriteDescriptor file(stickersKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
+void Account::clearStickersFile(FileKey &stickersKey) {
+	if (stickersKey) {
+		_stickersWritten.remove(stickersKey);
+		ClearKey(stickersKey, _basePath);
+		stickersKey = 0;
+		writeMapDelayed();
+	}
+}
+
 void Account::writeStickerSet(
 		QDataStream &stream,
 		const Data::StickersSet &set) {
@@ -1350,11 +1641,7 @@ void Account::writeStickerSets(
 		const Data::StickersSetsOrder &order) {
 	const auto &sets = _owner->session().data().stickers().sets();
 	if (sets.empty()) {
-		if (stickersKey) {
-			ClearKey(stickersKey, _basePath);
-			stickersKey = 0;
-			writeMapDelayed();
-		}
+		clearStickersFile(stickersKey);
 		return;
 	}
 
@@ -1399,11 +1686,7 @@ void Account::writeStickerSets(
 		++setsCount;
 	}
 	if (!setsCount && order.isEmpty()) {
-		if (stickersKey) {
-			ClearKey(stickersKey, _basePath);
-			stickersKey = 0;
-			writeMapDelayed();
-		}
+		clearStickersFile(stickersKey);
 		return;
 	}
 	size += sizeof(qint32) + (order.size() * sizeof(quint64));
@@ -1428,8 +1711,7 @@ void Account::writeStickerSets(
 	}
 	data.stream << order;
 
-	FileWriteDescriptor file(stickersKey, _basePath);
-	file.writeEncrypted(data, _localKey);
+	writeStickersFile(stickersKey, data);
 }
 
 void Account::readStickerSets(
@@ -1437,7 +1719,7 @@ void Account::readStickerSets(
 		Data::StickersSetsOrder *outOrder,
 		MTPDstickerSet::Flags readingFlags) {
 	FileReadDescriptor stickers;
-	if (!ReadEncryptedFile(stickers, stickersKey, _basePath, _localKey)) {
+	if (!readEncryptedFile(stickers, stickersKey)) {
 		ClearKey(stickersKey, _basePath);
 		stickersKey = 0;
 		writeMapDelayed();
@@ -1899,11 +2181,7 @@ void Account::readArchivedStickers() {
 void Account::writeSavedGifs() {
 	auto &saved = _owner->session().data().stickers().savedGifs();
 	if (saved.isEmpty()) {
-		if (_savedGifsKey) {
-			ClearKey(_savedGifsKey, _basePath);
-			_savedGifsKey = 0;
-			writeMapDelayed();
-		}
+		clearStickersFile(_savedGifsKey);
 	} else {
 		quint32 size = sizeof(quint32); // count
 		for_const (auto gif, saved) {
@@ -1919,8 +2197,7 @@ void Account::writeSavedGifs() {
 		for_const (auto gif, saved) {
 			Serialize::Document::writeToStream(data.stream, gif);
 		}
-		FileWriteDescriptor file(_savedGifsKey, _basePath);
-		file.writeEncrypted(data, _localKey);
+		writeStickersFile(_savedGifsKey, data);
 	}
 }
 
@@ -1928,7 +2205,7 @@ void Account::readSavedGifs() {
 	if (!_savedGifsKey) return;
 
 	FileReadDescriptor gifs;
-	if (!ReadEncryptedFile(gifs, _savedGifsKey, _basePath, _localKey)) {
+	if (!readEncryptedFile(gifs, _savedGifsKey)) {
 		ClearKey(_savedGifsKey, _basePath);
 		_savedGifsKey = 0;
 		writeMapDelayed();
@@ -2014,6 +2291,7 @@ void Account::writeRecentHashtagsAndBots() {
 	for (auto i = bots.cbegin(), e = bots.cend(); i != e; ++i) {
 		Serialize::writePeer(data.stream, *i);
 	}
+	_prefetched.remove(_recentHashtagsAndBotsKey);
 	FileWriteDescriptor file(_recentHashtagsAndBotsKey, _basePath);
 	file.writeEncrypted(data, _localKey);
 }
@@ -2025,7 +2303,7 @@ void Account::readRecentHashtagsAndBots() {
 	if (!_recentHashtagsAndBotsKey) return;
 
 	FileReadDescriptor hashtags;
-	if (!ReadEncryptedFile(hashtags, _recentHashtagsAndBotsKey, _basePath, _localKey)) {
+	if (!readEncryptedFile(hashtags, _recentHashtagsAndBotsKey)) {
 		ClearKey(_recentHashtagsAndBotsKey, _basePath);
 		_recentHashtagsAndBotsKey = 0;
 		writeMapDelayed();
@@ -2142,6 +2420,7 @@ void Account::writeExportSettings(const Export::Settings &settings) {
 		&& settings.path == check.path
 		&& settings.format == check.format
 		&& settings.availableAt == check.availableAt
+		&& settings.incremental == check.incremental
 		&& !settings.onlySinglePeer()) {
 		if (_exportSettingsKey) {
 			ClearKey(_exportSettingsKey, _basePath);
@@ -2189,6 +2468,7 @@ void Account::writeExportSettings(const Export::Settings &settings) {
 	});
 	data.stream << qint32(settings.singlePeerFrom);
 	data.stream << qint32(settings.singlePeerTill);
+	data.stream << qint32(settings.incremental ? 1 : 0);
 
 	FileWriteDescriptor file(_exportSettingsKey, _basePath);
 	file.writeEncrypted(data, _localKey);
@@ -2210,6 +2490,7 @@ Export::Settings Account::readExportSettings() {
 	qint32 singlePeerType = 0, singlePeerBareId = 0;
 	quint64 singlePeerAccessHash = 0;
 	qint32 singlePeerFrom = 0, singlePeerTill = 0;
+	qint32 incremental = 0;
 	file.stream
 		>> types
 		>> fullChats
@@ -2234,6 +2515,9 @@ Export::Settings Account::readExportSettings() {
 	if (!file.stream.atEnd()) {
 		file.stream >> singlePeerFrom >> singlePeerTill;
 	}
+	if (!file.stream.atEnd()) {
+		file.stream >> incremental;
+	}
 	auto result = Export::Settings();
 	result.types = Export::Settings::Types::from_raw(types);
 	result.fullChats = Export::Settings::Types::from_raw(fullChats);
@@ -2263,6 +2547,7 @@ Export::Settings Account::readExportSettings() {
 	}();
 	result.singlePeerFrom = singlePeerFrom;
 	result.singlePeerTill = singlePeerTill;
+	result.incremental = (incremental == 1);
 	return (file.stream.status() == QDataStream::Ok && result.validate())
 		? result
 		: Export::Settings();
@@ -2317,6 +2602,7 @@ void Account::writeTrustedBots() {
 		data.stream << quint64(botId);
 	}
 
+	_prefetched.remove(_trustedBotsKey);
 	FileWriteDescriptor file(_trustedBotsKey, _basePath);
 	file.writeEncrypted(data, _localKey);
 }
@@ -2325,7 +2611,7 @@ void Account::readTrustedBots() {
 	if (!_trustedBotsKey) return;
 
 	FileReadDescriptor trusted;
-	if (!ReadEncryptedFile(trusted, _trustedBotsKey, _basePath, _localKey)) {
+	if (!readEncryptedFile(trusted, _trustedBotsKey)) {
 		ClearKey(_trustedBotsKey, _basePath);
 		_trustedBotsKey = 0;
 		writeMapDelayed();
@@ -36,6 +36,9 @@ using AuthKeyPtr = std::shared_ptr<AuthKey>;
 namespace Storage {
 namespace details {
 struct ReadSettingsContext;
+struct FileReadDescriptor;
+class EncryptedFilePrefetch;
+struct EncryptedDescriptor;
 } // namespace details
 
 class EncryptionKey;
@@ -166,10 +169,17 @@ private:
 	void writeMapQueued();
 	void writeMap();
 
+	void prefetchDeferredFiles();
+	[[nodiscard]] bool readEncryptedFile(
+		details::FileReadDescriptor &result,
+		FileKey key);
+
 	void readLocations();
 	void writeLocations();
 	void writeLocationsQueued();
 	void writeLocationsDelayed();
+	bool writeLocationsJournal();
+	bool applyLocationsJournal(QDataStream &stream);
 
 	std::unique_ptr<Main::SessionSettings> readSessionSettings();
 	void writeSessionSettings(Main::SessionSettings *stored);
@@ -188,6 +198,10 @@ private:
 	void writeStickerSet(
 		QDataStream &stream,
 		const Data::StickersSet &set);
+	void writeStickersFile(
+		FileKey &stickersKey,
+		details::EncryptedDescriptor &data);
+	void clearStickersFile(FileKey &stickersKey);
 	template <typename CheckSet>
 	void writeStickerSets(
 		FileKey &stickersKey,
@@ -219,10 +233,23 @@ private:
 	base::flat_map<PeerId, FileKey> _draftCursorsMap;
 	base::flat_map<PeerId, bool> _draftsNotReadMap;
 
+	// What was written last time, to skip rewriting the same files.
+	base::flat_map<
+		PeerId,
+		std::pair<MessageDraft, MessageDraft>> _draftsWritten;
+	base::flat_map<
+		PeerId,
+		std::pair<MessageCursor, MessageCursor>> _draftCursorsWritten;
+
 	QMultiMap<MediaKey, FileLocation> _fileLocations;
 	QMap<QString, QPair<MediaKey, FileLocation>> _fileLocationPairs;
 	QMap<MediaKey, MediaKey> _fileLocationAliases;
 
+	QByteArray _locationsJournalPending;
+	qint64 _locationsJournalSize = 0;
+	qint64 _locationsSnapshotSize = 0;
+	bool _locationsRewrite = false;
+
 	FileKey _locationsKey = 0;
 	FileKey _trustedBotsKey = 0;
 	FileKey _installedStickersKey = 0;
@@ -248,6 +275,13 @@ private:
 	bool _readingUserSettings = false;
 	bool _recentHashtagsAndBotsWereRead = false;
 
+	base::flat_map<
+		FileKey,
+		std::unique_ptr<details::EncryptedFilePrefetch>> _prefetched;
+
+	// Digests of the last written sticker files, to skip rewrites.
+	base::flat_map<FileKey, bytes::vector> _stickersWritten;
+
 	int _oldMapVersion = 0;
 
 	base::Timer _writeMapTimer;
@@ -253,6 +253,25 @@ bool Domain::checkPasscode(const QByteArray &passcode) const {
 	return checkKey->equals(_passcodeKey);
 }
 
+void Domain::checkPasscode(
+		const QByteArray &passcode,
+		Fn<void(bool correct)> done) const {
+	Expects(!_passcodeKeySalt.isEmpty());
+	Expects(_passcodeKey != nullptr);
+
+	crl::async([
+		passcode,
+		salt = _passcodeKeySalt,
+		key = _passcodeKey,
+		done = std::move(done)
+	]() mutable {
+		const auto correct = CreateLocalKey(passcode, salt)->equals(key);
+		crl::on_main([=, done = std::move(done)] {
+			done(correct);
+		});
+	});
+}
+
 void Domain::setPasscode(const QByteArray &passcode) {
 	Expects(!_passcodeKeySalt.isEmpty());
 	Expects(_localKey != nullptr);
@@ -38,6 +38,11 @@ public:
 	void startFromScratch();
 
 	[[nodiscard]] bool checkPasscode(const QByteArray &passcode) const;
+
+	// Derives the key in a background thread, calls done on main.
+	void checkPasscode(
+		const QByteArray &passcode,
+		Fn<void(bool correct)> done) const;
 	void setPasscode(const QByteArray &passcode);
 
 	[[nodiscard]] int oldVersion() const;
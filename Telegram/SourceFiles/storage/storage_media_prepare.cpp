@@ -21,6 +21,10 @@ namespace {
 
 constexpr auto kMaxAlbumCount = 10;
 
+// Smooth scaling of huge images, like pasted screenshots of several
+// screens, takes seconds, so they're first fast scaled near the target.
+constexpr auto kSmoothScaleMaxRatio = 4;
+
 bool HasExtensionFrom(const QString &file, const QStringList &extensions) {
 	for (const auto &extension : extensions) {
 		const auto ext = file.right(extension.size());
@@ -48,6 +52,13 @@ bool ValidVideoForAlbum(const FileMediaInformation::Video &video) {
 	return ValidateThumbDimensions(width, height);
 }
 
+[[nodiscard]] QImage ScaledToWidth(QImage image, int width) {
+	if (image.width() > width * kSmoothScaleMaxRatio) {
+		image = image.scaledToWidth(width * 2, Qt::FastTransformation);
+	}
+	return image.scaledToWidth(width, Qt::SmoothTransformation);
+}
+
 QSize PrepareShownDimensions(const QImage &preview) {
 	constexpr auto kMaxWidth = 1280;
 	constexpr auto kMaxHeight = 1280;
@@ -87,10 +98,10 @@ bool PrepareAlbumMediaIsWaiting(
 				&file.information->media)) {
 			if (ValidPhotoForAlbum(*image, file.mime)) {
 				file.shownDimensions = PrepareShownDimensions(image->data);
-				file.preview = Images::prepareOpaque(image->data.scaledToWidth(
+				file.preview = Images::prepareOpaque(ScaledToWidth(
+					image->data,
 					std::min(previewWidth, style::ConvertScale(image->data.width()))
-						* cIntRetinaFactor(),
-					Qt::SmoothTransformation));
+						* cIntRetinaFactor()));
 				Assert(!file.preview.isNull());
 				file.preview.setDevicePixelRatio(cRetinaFactor());
 				file.type = PreparedFile::AlbumType::Photo;
@@ -16,7 +16,11 @@ namespace {
 using namespace Media::Streaming;
 
 constexpr auto kPartSize = Loader::kPartSize;
-constexpr auto kRequestPartsCount = 8;
+
+// As many parts as there are in a slice of the streaming cache, so that
+// a slice read from the cache is saved at once. Not cached parts are
+// still requested from the cloud a few at a time by the Reader.
+constexpr auto kRequestPartsCount = 64;
 
 } // namespace
 
@@ -440,6 +440,19 @@ int CountMaxKeyLength(const TemplatesData &data) {
 	return result;
 }
 
+auto ComputeKeys(const TemplatesData &data)
+-> std::map<QString, std::vector<TemplatesIndex::Id>> {
+	auto result = std::map<QString, std::vector<TemplatesIndex::Id>>();
+	for (const auto &[path, file] : data.files) {
+		for (const auto &[normalized, question] : file.questions) {
+			for (const auto &key : question.normalizedKeys) {
+				result[key].emplace_back(path, normalized);
+			}
+		}
+	}
+	return result;
+}
+
 } // namespace
 } // namespace details
 
@@ -506,7 +519,25 @@ void Templates::load() {
 
 void Templates::setData(TemplatesData &&data) {
 	_data = std::move(data);
+	refreshKeys();
+}
+
+void Templates::refreshKeys() {
 	_maxKeyLength = CountMaxKeyLength(_data);
+	_keys = ComputeKeys(_data);
+}
+
+auto Templates::questionByKey(const QString &key, bool last) const
+-> std::optional<QuestionByKey> {
+	const auto i = _keys.find(key);
+	if (i == end(_keys) || i->second.empty()) {
+		return {};
+	}
+	const auto &id = last ? i->second.back() : i->second.front();
+	return QuestionByKey{
+		_data.files.at(id.first).questions.at(id.second),
+		key,
+	};
 }
 
 void Templates::ensureUpdatesCreated() {
@@ -597,6 +628,7 @@ void Templates::updateRequestFinished(QNetworkReply *reply) {
 				_session->data().serviceNotification({ full });
 			}
 			_data.files.at(path) = std::move(one.files.at(path));
+			refreshKeys();
 
 			_updates->requests.erase(path);
 			checkUpdateFinished();
@@ -620,18 +652,7 @@ auto Templates::matchExact(QString query) const
 		return {};
 	}
 
-	query = NormalizeKey(query);
-
-	for (const auto &[path, file] : _data.files) {
-		for (const auto &[normalized, question] : file.questions) {
-			for (const auto &key : question.normalizedKeys) {
-				if (key == query) {
-					return QuestionByKey{ question, key };
-				}
-			}
-		}
-	}
-	return {};
+	return questionByKey(NormalizeKey(query), false);
 }
 
 auto Templates::matchFromEnd(QString query) const
@@ -640,26 +661,17 @@ auto Templates::matchFromEnd(QString query) const
 		query = query.mid(query.size() - _maxKeyLength);
 	}
 
+	// The longest key wins, for equal keys the last one as before.
 	const auto size = query.size();
-	auto queries = std::vector<QString>();
-	queries.reserve(size);
-	for (auto i = 0; i != size; ++i) {
-		queries.push_back(NormalizeKey(query.mid(size - i - 1)));
-	}
-
-	auto result = std::optional<QuestionByKey>();
-	for (const auto &[path, file] : _data.files) {
-		for (const auto &[normalized, question] : file.questions) {
-			for (const auto &key : question.normalizedKeys) {
-				if (key.size() <= queries.size()
-					&& queries[key.size() - 1] == key
-					&& (!result || result->key.size() <= key.size())) {
-					result = QuestionByKey{ question, key };
-				}
+	for (auto i = size; i != 0; --i) {
+		const auto key = NormalizeKey(query.mid(size - i));
+		if (key.size() == i) {
+			if (auto result = questionByKey(key, true)) {
+				return result;
 			}
 		}
 	}
-	return result;
+	return {};
 }
 
 Templates::~Templates() = default;
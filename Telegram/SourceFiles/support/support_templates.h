@@ -78,11 +78,16 @@ private:
 	void updateRequestFinished(QNetworkReply *reply);
 	void checkUpdateFinished();
 	void setData(details::TemplatesData &&data);
+	void refreshKeys();
+	[[nodiscard]] std::optional<QuestionByKey> questionByKey(
+		const QString &key,
+		bool last) const;
 
 	not_null<Main::Session*> _session;
 
 	details::TemplatesData _data;
 	details::TemplatesIndex _index;
+	std::map<QString, std::vector<details::TemplatesIndex::Id>> _keys;
 	rpl::event_stream<QStringList> _errors;
 	base::binary_guard _reading;
 	bool _reloadAfterRead = false;
@@ -16,6 +16,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Ui {
 namespace {
 
+// Circled letter userpics are painted from pixmaps, shared by colors,
+// letters and size. The cache is cleared when it grows over the limit.
+constexpr auto kCirclesCacheLimit = 256;
+
+using CircleKey = std::tuple<QRgb, QRgb, int, QString>;
+
+[[nodiscard]] base::flat_map<CircleKey, QPixmap> &Circles() {
+	static auto result = base::flat_map<CircleKey, QPixmap>();
+	return result;
+}
+
 void PaintSavedMessagesInner(
 		Painter &p,
 		int x,
@@ -143,9 +154,33 @@ void EmptyUserpic::paint(
 		int y,
 		int outerWidth,
 		int size) const {
-	paint(p, x, y, outerWidth, size, [&p, x, y, size] {
-		p.drawEllipse(x, y, size, size);
-	});
+	auto &circles = Circles();
+	auto key = CircleKey(
+		_color->c.rgba(),
+		st::historyPeerUserpicFg->c.rgba(),
+		size,
+		_string);
+	auto i = circles.find(key);
+	if (i == end(circles)) {
+		if (circles.size() >= kCirclesCacheLimit) {
+			circles.clear();
+		}
+		auto image = QImage(
+			QSize(size, size) * cIntRetinaFactor(),
+			QImage::Format_ARGB32_Premultiplied);
+		image.setDevicePixelRatio(cRetinaFactor());
+		image.fill(Qt::transparent);
+		{
+			Painter q(&image);
+			paint(q, 0, 0, size, size, [&q, size] {
+				q.drawEllipse(0, 0, size, size);
+			});
+		}
+		i = circles.emplace(
+			std::move(key),
+			App::pixmapFromImageInPlace(std::move(image))).first;
+	}
+	p.drawPixmap(rtl() ? (outerWidth - x - size) : x, y, i->second);
 }
 
 void EmptyUserpic::paintRounded(Painter &p, int x, int y, int outerWidth, int size) const {
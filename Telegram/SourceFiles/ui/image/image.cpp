@@ -17,6 +17,39 @@ using namespace Images;
 namespace Images {
 namespace {
 
+// Pixmaps of all the images are limited by that, the least recently
+// used images forget their pixmaps when the limit is exceeded.
+constexpr auto kPixmapsCacheLimit = int64(96 * 1024 * 1024);
+constexpr auto kPixmapsCacheAfterClear = kPixmapsCacheLimit * 3 / 4;
+
+// Images painted that recently are on screen, they keep their pixmaps.
+constexpr auto kPixmapsKeepUsed = crl::time(1000);
+
+// Blurred copies are kept only for images like thumbnails.
+constexpr auto kKeepBlurredMaxArea = 512 * 512;
+
+struct PixmapsCache {
+	base::flat_set<not_null<const Image*>> images;
+	int64 bytes = 0;
+	bool clearScheduled = false;
+};
+
+std::atomic<int64> DataBytes = 0;
+
+[[nodiscard]] int64 ImageBytes(const QImage &image) {
+	return int64(image.bytesPerLine()) * image.height();
+}
+
+[[nodiscard]] PixmapsCache &Pixmaps() {
+	// Not destroyed on exit, static images use it in their destructors.
+	static const auto result = new PixmapsCache();
+	return *result;
+}
+
+[[nodiscard]] int64 PixmapBytes(const QPixmap &pixmap) {
+	return int64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
 [[nodiscard]] uint64 PixKey(int width, int height, Options options) {
 	return static_cast<uint64>(width)
 		| (static_cast<uint64>(height) << 24)
@@ -114,6 +147,21 @@ Image::Image(const QByteArray &content) : Image(ReadImage(content)) {
 Image::Image(QImage &&data)
 : _data(data.isNull() ? Empty()->original() : std::move(data)) {
 	Expects(!_data.isNull());
+
+	DataBytes.fetch_add(ImageBytes(_data), std::memory_order_relaxed);
+}
+
+Image::~Image() {
+	forgetPixmaps();
+	DataBytes.fetch_sub(ImageBytes(_data), std::memory_order_relaxed);
+}
+
+int64 Image::DataBytesTotal() {
+	return DataBytes.load(std::memory_order_relaxed);
+}
+
+int64 Image::PixmapsBytesTotal() {
+	return Pixmaps().bytes;
 }
 
 not_null<Image*> Image::Empty() {
@@ -148,6 +196,92 @@ QImage Image::original() const {
 	return _data;
 }
 
+void Image::prepareBlurredAsync() {
+	if (!_blurred.isNull()
+		|| isNull()
+		|| width() * height() > kKeepBlurredMaxArea) {
+		return;
+	}
+	crl::async([=, data = _data, guard = _blurring.make_guard()]() mutable {
+		auto blurred = prepareBlur(std::move(data));
+		crl::on_main(std::move(guard), [
+			=,
+			blurred = std::move(blurred)
+		]() mutable {
+			if (_blurred.isNull()) {
+				_blurred = std::move(blurred);
+			}
+		});
+	});
+}
+
+QImage Image::blurred() const {
+	if (!_blurred.isNull()) {
+		return _blurred;
+	} else if (width() * height() > kKeepBlurredMaxArea) {
+		return prepareBlur(_data);
+	}
+	_blurred = prepareBlur(_data);
+	return _blurred;
+}
+
+const QPixmap &Image::cached(uint64 key, QPixmap &&pixmap) const {
+	auto &pixmaps = Pixmaps();
+	if (_cache.empty()) {
+		pixmaps.images.emplace(this);
+	}
+	const auto i = _cache.find(key);
+	const auto removed = (i != end(_cache)) ? PixmapBytes(i->second) : 0;
+	const auto added = PixmapBytes(pixmap);
+	_cacheBytes += added - removed;
+	pixmaps.bytes += added - removed;
+	if (pixmaps.bytes > kPixmapsCacheLimit && !pixmaps.clearScheduled) {
+		// Pixmaps returned by reference may still be painted right now.
+		pixmaps.clearScheduled = true;
+		crl::on_main([] { ClearPixmapsOverLimit(); });
+	}
+	_lastUsed = crl::now();
+	return _cache.emplace_or_assign(key, std::move(pixmap)).first->second;
+}
+
+const QPixmap &Image::used(const QPixmap &pixmap) const {
+	_lastUsed = crl::now();
+	return pixmap;
+}
+
+void Image::forgetPixmaps() const {
+	if (_cache.empty()) {
+		return;
+	}
+	auto &pixmaps = Pixmaps();
+	pixmaps.images.remove(this);
+	pixmaps.bytes -= _cacheBytes;
+	_cacheBytes = 0;
+	_cache.clear();
+}
+
+void Image::ClearPixmapsOverLimit() {
+	auto &pixmaps = Pixmaps();
+	pixmaps.clearScheduled = false;
+	if (pixmaps.bytes <= kPixmapsCacheLimit) {
+		return;
+	}
+	auto images = std::vector<not_null<const Image*>>(
+		begin(pixmaps.images),
+		end(pixmaps.images));
+	ranges::sort(images, ranges::less(), [](not_null<const Image*> image) {
+		return image->_lastUsed;
+	});
+	const auto keepUsedAfter = crl::now() - kPixmapsKeepUsed;
+	for (const auto image : images) {
+		if (pixmaps.bytes <= kPixmapsCacheAfterClear
+			|| image->_lastUsed > keepUsedAfter) {
+			break;
+		}
+		image->forgetPixmaps();
+	}
+}
+
 const QPixmap &Image::pix(int w, int h) const {
 	if (w <= 0 || !width() || !height()) {
 		w = width();
@@ -161,9 +295,9 @@ const QPixmap &Image::pix(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixRounded(
@@ -196,9 +330,9 @@ const QPixmap &Image::pixRounded(
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixCircled(int w, int h) const {
@@ -214,9 +348,9 @@ const QPixmap &Image::pixCircled(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixBlurredCircled(int w, int h) const {
@@ -232,9 +366,9 @@ const QPixmap &Image::pixBlurredCircled(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixBlurred(int w, int h) const {
@@ -250,9 +384,9 @@ const QPixmap &Image::pixBlurred(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixColored(style::color add, int w, int h) const {
@@ -268,9 +402,9 @@ const QPixmap &Image::pixColored(style::color add, int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixColoredNoCache(add, w, h, true);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixBlurredColored(
@@ -289,9 +423,9 @@ const QPixmap &Image::pixBlurredColored(
 	if (i == _cache.cend()) {
 		auto p = pixBlurredColoredNoCache(add, w, h);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixSingle(
@@ -332,9 +466,9 @@ const QPixmap &Image::pixSingle(
 	if (i == _cache.cend() || i->second.width() != (outerw * cIntRetinaFactor()) || i->second.height() != (outerh * cIntRetinaFactor())) {
 		auto p = pixNoCache(w, h, options, outerw, outerh, colored);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 const QPixmap &Image::pixBlurredSingle(
@@ -371,9 +505,9 @@ const QPixmap &Image::pixBlurredSingle(
 	if (i == _cache.cend() || i->second.width() != (outerw * cIntRetinaFactor()) || i->second.height() != (outerh * cIntRetinaFactor())) {
 		auto p = pixNoCache(w, h, options, outerw, outerh);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		return cached(k, std::move(p));
 	}
-	return i->second;
+	return used(i->second);
 }
 
 QPixmap Image::pixNoCache(
@@ -430,6 +564,16 @@ QPixmap Image::pixNoCache(
 		return App::pixmapFromImageInPlace(std::move(result));
 	}
 
+	if (options & Option::Blurred) {
+		return App::pixmapFromImageInPlace(prepare(
+			blurred(),
+			w,
+			h,
+			(options & ~Option::Blurred),
+			outerw,
+			outerh,
+			colored));
+	}
 	return App::pixmapFromImageInPlace(prepare(_data, w, h, options, outerw, outerh, colored));
 }
 
@@ -460,7 +604,7 @@ QPixmap Image::pixBlurredColoredNoCache(
 		return Empty()->pix();
 	}
 
-	auto img = prepareBlur(_data);
+	auto img = blurred();
 	if (h <= 0) {
 		img = img.scaledToWidth(w, Qt::SmoothTransformation);
 	} else {
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "ui/image/image_prepare.h"
+#include "base/binary_guard.h"
 
 namespace Images {
 
@@ -24,10 +25,15 @@ public:
 	explicit Image(const QString &path);
 	explicit Image(const QByteArray &content);
 	explicit Image(QImage &&data);
+	~Image();
 
 	[[nodiscard]] static not_null<Image*> Empty(); // 1x1 transparent
 	[[nodiscard]] static not_null<Image*> BlankMedia(); // 1x1 black
 
+	// Memory usage of all the images, pixmaps are main thread only.
+	[[nodiscard]] static int64 DataBytesTotal();
+	[[nodiscard]] static int64 PixmapsBytesTotal();
+
 	[[nodiscard]] int width() const {
 		return _data.width();
 	}
@@ -44,6 +50,9 @@ public:
 
 	[[nodiscard]] QImage original() const;
 
+	// Blur the original on a worker thread before it is painted blurred.
+	void prepareBlurredAsync();
+
 	[[nodiscard]] const QPixmap &pix(int w = 0, int h = 0) const;
 	[[nodiscard]] const QPixmap &pixRounded(
 		int w = 0,
@@ -91,7 +100,23 @@ public:
 		int h = 0) const;
 
 private:
+	[[nodiscard]] const QPixmap &cached(
+		uint64 key,
+		QPixmap &&pixmap) const;
+	[[nodiscard]] const QPixmap &used(const QPixmap &pixmap) const;
+	void forgetPixmaps() const;
+	[[nodiscard]] QImage blurred() const;
+
+	// Drops pixmaps of the least recently used images over the limit.
+	static void ClearPixmapsOverLimit();
+
 	const QImage _data;
 	mutable base::flat_map<uint64, QPixmap> _cache;
+	mutable int64 _cacheBytes = 0;
+	mutable crl::time _lastUsed = 0;
+
+	// Blurred pixmaps of small images are scaled from one blurred original.
+	mutable QImage _blurred;
+	base::binary_guard _blurring;
 
 };
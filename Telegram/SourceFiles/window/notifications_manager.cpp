@@ -40,6 +40,8 @@ namespace {
 // not more than one sound in 500ms from one peer - grouping
 constexpr auto kMinimalAlertDelay = crl::time(500);
 constexpr auto kWaitingForAllGroupedDelay = crl::time(1000);
+constexpr auto kShowLimitCount = 3;
+constexpr auto kShowLimitPeriod = crl::time(1000);
 
 #ifdef Q_OS_MAC
 constexpr auto kSystemAlertDuration = crl::time(1000);
@@ -296,7 +298,7 @@ void System::showGrouped() {
 	if (const auto session = findSession(_lastHistorySessionId)) {
 		if (const auto lastItem = session->data().message(_lastHistoryItemId)) {
 			_waitForAllGroupedTimer.cancel();
-			_manager->showNotification(lastItem, _lastForwardedCount);
+			showNotification(lastItem, _lastForwardedCount);
 			_lastForwardedCount = 0;
 			_lastHistoryItemId = FullMsgId();
 			_lastHistorySessionId = 0;
@@ -304,6 +306,23 @@ void System::showGrouped() {
 	}
 }
 
+crl::time System::nextShowAllowed(crl::time now) {
+	while (!_lastShown.empty()
+		&& _lastShown.front() + kShowLimitPeriod <= now) {
+		_lastShown.pop_front();
+	}
+	return (int(_lastShown.size()) < kShowLimitCount)
+		? now
+		: (_lastShown.front() + kShowLimitPeriod);
+}
+
+void System::showNotification(
+		not_null<HistoryItem*> item,
+		int forwardedCount) {
+	_lastShown.push_back(crl::now());
+	_manager->showNotification(item, forwardedCount);
+}
+
 void System::showNext() {
 	if (App::quitting()) return;
 
@@ -423,6 +442,15 @@ void System::showNext() {
 				}
 				_waitTimer.callOnce(next - ms);
 				break;
+			} else if (const auto allowed = nextShowAllowed(ms); allowed > ms) {
+				// Bursts in busy chats are spread out, the native
+				// notification back-ends are slow with many calls.
+				if (nextAlert && nextAlert < allowed) {
+					_waitTimer.callOnce(nextAlert - ms);
+				} else {
+					_waitTimer.callOnce(allowed - ms);
+				}
+				break;
 			} else {
 				const auto isForwarded = notifyItem->Has<HistoryMessageForwarded>();
 				const auto isAlbum = notifyItem->groupId();
@@ -507,7 +535,7 @@ void System::showNext() {
 					// then there is no reason to wait for the timer
 					// to show the previous notification.
 					showGrouped();
-					_manager->showNotification(notifyItem, forwardedCount);
+					showNotification(notifyItem, forwardedCount);
 				}
 
 				if (!history->hasNotification()) {
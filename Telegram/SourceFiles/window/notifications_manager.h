@@ -107,6 +107,8 @@ private:
 	void showNext();
 	void showGrouped();
 	void ensureSoundCreated();
+	[[nodiscard]] crl::time nextShowAllowed(crl::time now);
+	void showNotification(not_null<HistoryItem*> item, int forwardedCount);
 
 	base::flat_map<
 		not_null<History*>,
@@ -129,6 +131,8 @@ private:
 	uint64 _lastHistorySessionId = 0;
 	FullMsgId _lastHistoryItemId;
 
+	std::deque<crl::time> _lastShown;
+
 };
 
 class Manager {
@@ -360,26 +360,34 @@ bool LoadTheme(
 	return true;
 }
 
+bool CacheIsValid(const QByteArray &content, const Cached &cache) {
+	return (cache.paletteChecksum == style::palette::Checksum())
+		&& (cache.contentChecksum
+			== base::crc32(content.constData(), content.size()));
+}
+
+bool ReadCachedBackground(const Cached &cache, QImage *out) {
+	if (cache.background.isEmpty()) {
+		return true;
+	}
+	QDataStream stream(cache.background);
+	QImageReader reader(stream.device());
+#ifndef OS_MAC_OLD
+	reader.setAutoTransform(true);
+#endif // OS_MAC_OLD
+	return reader.read(out) && !out->isNull();
+}
+
 bool InitializeFromCache(
 		const QByteArray &content,
 		const Cached &cache) {
-	if (cache.paletteChecksum != style::palette::Checksum()) {
-		return false;
-	}
-	if (cache.contentChecksum != base::crc32(content.constData(), content.size())) {
+	if (!CacheIsValid(content, cache)) {
 		return false;
 	}
 
 	QImage background;
-	if (!cache.background.isEmpty()) {
-		QDataStream stream(cache.background);
-		QImageReader reader(stream.device());
-#ifndef OS_MAC_OLD
-		reader.setAutoTransform(true);
-#endif // OS_MAC_OLD
-		if (!reader.read(&background) || background.isNull()) {
-			return false;
-		}
+	if (!ReadCachedBackground(cache, &background)) {
+		return false;
 	}
 
 	if (!style::main_palette::load(cache.colors)) {
@@ -393,6 +401,26 @@ bool InitializeFromCache(
 	return true;
 }
 
+// Same as LoadTheme() to an Instance, but from the parsed palette
+// and the decoded background image that were saved with the theme.
+bool LoadThemeFromCache(
+		const QByteArray &content,
+		const Cached &cache,
+		not_null<Instance*> out) {
+	if (!CacheIsValid(content, cache)) {
+		return false;
+	}
+	auto background = QImage();
+	if (!ReadCachedBackground(cache, &background)
+		|| !out->palette.load(cache.colors)) {
+		return false;
+	}
+	if (!background.isNull()) {
+		applyBackground(std::move(background), cache.tiled, out);
+	}
+	return true;
+}
+
 [[nodiscard]] std::optional<QByteArray> ReadEditingPalette() {
 	auto file = QFile(EditingPalettePath());
 	return file.open(QIODevice::ReadOnly)
@@ -1090,12 +1118,16 @@ void ChatBackground::reapplyWithNightMode(
 		auto preview = std::make_unique<Preview>();
 		preview->object = std::move(read.object);
 		preview->instance.cached = std::move(read.cache);
-		const auto loaded = LoadTheme(
+		const auto loaded = LoadThemeFromCache(
 			preview->object.content,
-			ColorizerForTheme(path),
-			std::nullopt,
-			&preview->instance.cached,
-			&preview->instance);
+			preview->instance.cached,
+			&preview->instance)
+			|| LoadTheme(
+				preview->object.content,
+				ColorizerForTheme(path),
+				std::nullopt,
+				&preview->instance.cached,
+				&preview->instance);
 		if (!loaded) {
 			return false;
 		}
@@ -37,6 +37,20 @@ namespace {
 
 constexpr auto kFakeCloudThemeId = 0xFFFFFFFFFFFFFFFAULL;
 constexpr auto kShowPerRow = 4;
+constexpr auto kCachedColorsLimit = 64;
+
+// Theme documents are never changed, a new version gets a new document.
+// So the colors computed for a document can be reused each time
+// the list is shown, without loading and parsing the theme again.
+base::flat_map<DocumentId, CloudListColors> CachedColors;
+
+void CacheColors(DocumentId documentId, const CloudListColors &colors) {
+	if (CachedColors.size() >= kCachedColorsLimit
+		&& !CachedColors.contains(documentId)) {
+		CachedColors.erase(begin(CachedColors));
+	}
+	CachedColors[documentId] = colors;
+}
 
 [[nodiscard]] Data::CloudTheme FakeCloudTheme(const Object &object) {
 	auto result = Data::CloudTheme();
@@ -560,6 +574,14 @@ void CloudList::refreshColors(Element &element) {
 		|| ((element.id() == currentId)
 			&& (!document || !document->isTheme()))) {
 		element.check->setColors(ColorsFromCurrentTheme());
+	} else if (const auto i = document
+		? CachedColors.find(document->id)
+		: end(CachedColors); i != end(CachedColors)) {
+		auto colors = i->second;
+		if (colors.background.isNull()) {
+			colors.background = ColorsFromCurrentTheme().background;
+		}
+		element.check->setColors(colors);
 	} else if (document) {
 		element.media = document ? document->createMediaView() : nullptr;
 		document->save(
@@ -641,6 +663,7 @@ void CloudList::refreshColorsFromDocument(Element &element) {
 	Expects(element.media->loaded());
 
 	const auto id = element.id();
+	const auto documentId = element.media->owner()->id;
 	const auto path = element.media->owner()->filepath();
 	const auto data = base::take(element.media)->bytes();
 	crl::async([=, guard = element.generating.make_guard()]() mutable {
@@ -648,6 +671,9 @@ void CloudList::refreshColorsFromDocument(Element &element) {
 			=,
 			result = ColorsFromTheme(path, data)
 		]() mutable {
+			if (result) {
+				CacheColors(documentId, *result);
+			}
 			const auto i = ranges::find(_elements, id, &Element::id);
 			if (i == end(_elements) || !result) {
 				return;
@@ -237,12 +237,17 @@ base::unique_qptr<Ui::SideBarButton> FiltersMenu::prepareButton(
 	const auto &icons = Ui::LookupFilterIcon(icon);
 	raw->setIconOverride(icons.normal, icons.active);
 	if (id >= 0) {
+		// Message counts change much more often than the chats counts.
 		UnreadStateValue(
 			&_session->session(),
 			id
-		) | rpl::start_with_next([=](const Dialogs::UnreadState &state) {
-			const auto count = (state.chats + state.marks);
-			const auto muted = (state.chatsMuted + state.marksMuted);
+		) | rpl::map([=](const Dialogs::UnreadState &state) {
+			return std::make_pair(
+				state.chats + state.marks,
+				state.chatsMuted + state.marksMuted);
+		}) | rpl::distinct_until_changed(
+		) | rpl::start_with_next([=](const std::pair<int, int> &counts) {
+			const auto &[count, muted] = counts;
 			const auto string = !count
 				? QString()
 				: (count > 99)
@@ -139,7 +139,9 @@ void PasscodeLockWidget::paintContent(Painter &p) {
 }
 
 void PasscodeLockWidget::submit() {
-	if (_passcode->text().isEmpty()) {
+	if (_checking) {
+		return;
+	} else if (_passcode->text().isEmpty()) {
 		_passcode->showError();
 		return;
 	}
@@ -152,10 +154,21 @@ void PasscodeLockWidget::submit() {
 
 	const auto passcode = _passcode->text().toUtf8();
 	auto &domain = Core::App().domain();
-	const auto correct = domain.started()
-		? domain.local().checkPasscode(passcode)
-		: (domain.start(passcode)
-			!= Storage::StartResult::IncorrectPasscode);
+	if (domain.started()) {
+		// The key derivation is slow, don't freeze the window with it.
+		_checking = true;
+		domain.local().checkPasscode(passcode, crl::guard(this, [=](
+				bool correct) {
+			_checking = false;
+			checkFinished(correct);
+		}));
+		return;
+	}
+	checkFinished(domain.start(passcode)
+		!= Storage::StartResult::IncorrectPasscode);
+}
+
+void PasscodeLockWidget::checkFinished(bool correct) {
 	if (!correct) {
 		cSetPasscodeBadTries(cPasscodeBadTries() + 1);
 		cSetPasscodeLastTry(crl::now());
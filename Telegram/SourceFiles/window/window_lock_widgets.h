@@ -65,12 +65,14 @@ private:
 	void paintContent(Painter &p) override;
 	void changed();
 	void submit();
+	void checkFinished(bool correct);
 	void error();
 
 	object_ptr<Ui::PasswordInput> _passcode;
 	object_ptr<Ui::RoundButton> _submit;
 	object_ptr<Ui::LinkButton> _logout;
 	QString _error;
+	bool _checking = false;
 
 };
 
@@ -9,6 +9,7 @@ option(TDESKTOP_USE_GTK_FILE_DIALOG "Use custom code for GTK file dialog (Linux
 option(TDESKTOP_DISABLE_REGISTER_CUSTOM_SCHEME "Disable automatic 'tg://' URL scheme handler registration." ${DESKTOP_APP_USE_PACKAGED})
 option(TDESKTOP_DISABLE_NETWORK_PROXY "Disable all code for working through Socks5 or MTProxy." OFF)
 option(TDESKTOP_DISABLE_GTK_INTEGRATION "Disable all code for GTK integration (Linux only)." OFF)
+option(TDESKTOP_DISABLE_STARTUP_TRACE "Disable the -tracestartup launch timeline recording." OFF)
 option(TDESKTOP_USE_PACKAGED_TGVOIP "Find libtgvoip using CMake instead of bundled one." ${DESKTOP_APP_USE_PACKAGED})
 option(TDESKTOP_API_TEST "Use test API credentials." OFF)
 set(TDESKTOP_API_ID "0" CACHE STRING "Provide 'api_id' for the Telegram API access.")
@@ -85,6 +86,10 @@ if (TDESKTOP_DISABLE_GTK_INTEGRATION)
     target_compile_definitions(Telegram PRIVATE TDESKTOP_DISABLE_GTK_INTEGRATION)
 endif()
 
+if (TDESKTOP_DISABLE_STARTUP_TRACE)
+    target_compile_definitions(Telegram PRIVATE TDESKTOP_DISABLE_STARTUP_TRACE)
+endif()
+
 if (DESKTOP_APP_DISABLE_DBUS_INTEGRATION)
     target_compile_definitions(Telegram PRIVATE TDESKTOP_DISABLE_DBUS_INTEGRATION)
 endif()